@@ -0,0 +1,226 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime con -std=c99
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+double benchNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+void benchSuiteInit(BenchSuite* suite) {
+    memset(suite, 0, sizeof(*suite));
+    suite->samples = BENCH_DEFAULT_SAMPLES;
+    suite->threshold = BENCH_DEFAULT_THRESHOLD;
+    suite->out = stdout;
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) suite->counters.fds[i] = -1;
+}
+
+void benchSuiteCleanup(BenchSuite* suite) {
+    perfCountersClose(&suite->counters);
+}
+
+static void printUsage(const char* prog) {
+    fprintf(stderr,
+            "Uso: %s [--filter texto] [--samples N] [--json salida.json]\n"
+            "          [--baseline base.json] [--threshold 0.10] [--counters]\n", prog);
+}
+
+int benchParseArgs(BenchSuite* suite, int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--filter") == 0 && value) {
+            suite->filter = value; i++;
+        } else if (strcmp(arg, "--samples") == 0 && value) {
+            suite->samples = atoi(value); i++;
+            if (suite->samples < 3) suite->samples = 3;
+            if (suite->samples > BENCH_MAX_SAMPLES) suite->samples = BENCH_MAX_SAMPLES;
+        } else if (strcmp(arg, "--json") == 0 && value) {
+            suite->jsonPath = value; i++;
+        } else if (strcmp(arg, "--baseline") == 0 && value) {
+            suite->baselinePath = value; i++;
+        } else if (strcmp(arg, "--threshold") == 0 && value) {
+            suite->threshold = atof(value); i++;
+        } else if (strcmp(arg, "--counters") == 0) {
+            suite->useCounters = 1;
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double* values, int n) {
+    qsort(values, (size_t)n, sizeof(double), compareDouble);
+    return (n % 2) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+static double timeIterations(BenchFunc fn, void* ctx, long iters) {
+    double start = benchNowNs();
+    for (long i = 0; i < iters; ++i) fn(ctx);
+    return benchNowNs() - start;
+}
+
+static void printCounters(FILE* out, const BenchResult* r) {
+    const double* v = r->perItem;
+    fprintf(out, "    ");
+    if (v[PERF_CTR_CYCLES] > 0.0 && v[PERF_CTR_INSTRUCTIONS] >= 0.0) {
+        fprintf(out, "IPC %.2f  ", v[PERF_CTR_INSTRUCTIONS] / v[PERF_CTR_CYCLES]);
+    }
+    for (int c = 0; c < PERF_CTR_COUNT; ++c) {
+        if (v[c] >= 0.0) fprintf(out, "%s/%s %.3g  ", perfCounterName((PerfCounterId)c), r->itemUnit, v[c]);
+        else fprintf(out, "%s n/d  ", perfCounterName((PerfCounterId)c));
+    }
+    fprintf(out, "\n");
+}
+
+int benchRun(BenchSuite* suite, const char* name, BenchFunc fn, void* ctx,
+             double itemsPerCall, const char* itemUnit) {
+    if (suite->filter && !strstr(name, suite->filter)) return 0;
+    if (suite->resultCount >= BENCH_MAX_RESULTS) {
+        fprintf(stderr, "ERROR::BENCH::RUN: Demasiados benchmarks (máx %d), '%s' no se ejecuta.\n",
+                BENCH_MAX_RESULTS, name);
+        suite->overflowed = 1;
+        return -1;
+    }
+
+    // Calentamiento: también sirve para estimar el coste por llamada.
+    long warmupCalls = 0;
+    double warmupStart = benchNowNs(), elapsed = 0.0;
+    do {
+        fn(ctx);
+        warmupCalls++;
+        elapsed = benchNowNs() - warmupStart;
+    } while (elapsed < BENCH_WARMUP_NS);
+
+    double perCall = elapsed / (double)warmupCalls;
+    long iters = (long)ceil(BENCH_MIN_SAMPLE_NS / (perCall > 1.0 ? perCall : 1.0));
+    if (iters < 1) iters = 1;
+
+    double perCallSamples[BENCH_MAX_SAMPLES];
+    for (int s = 0; s < suite->samples; ++s) {
+        perCallSamples[s] = timeIterations(fn, ctx, iters) / (double)iters;
+    }
+    double med = median(perCallSamples, suite->samples);
+    double deviations[BENCH_MAX_SAMPLES];
+    for (int s = 0; s < suite->samples; ++s) deviations[s] = fabs(perCallSamples[s] - med);
+    double mad = median(deviations, suite->samples);
+
+    BenchResult* r = &suite->results[suite->resultCount++];
+    memset(r, 0, sizeof(*r));
+    strncpy(r->name, name, sizeof(r->name) - 1);
+    strncpy(r->itemUnit, itemUnit ? itemUnit : "call", sizeof(r->itemUnit) - 1);
+    r->medianNs = med;
+    r->madNs = mad;
+    r->itemsPerCall = itemsPerCall > 0.0 ? itemsPerCall : 1.0;
+    r->itersPerSample = iters;
+    r->samples = suite->samples;
+
+    // Pasada aparte con contadores para no contaminar las muestras de tiempo
+    if (suite->useCounters && !suite->countersOpened) {
+        suite->countersOpened = 1;
+        perfCountersOpen(&suite->counters);
+    }
+    if (suite->counters.openCount > 0) {
+        PerfSample sample;
+        perfCountersStart(&suite->counters);
+        for (long i = 0; i < iters; ++i) fn(ctx);
+        perfCountersStop(&suite->counters, &sample);
+        double items = (double)iters * r->itemsPerCall;
+        for (int c = 0; c < PERF_CTR_COUNT; ++c) {
+            r->perItem[c] = sample.values[c] >= 0.0 ? sample.values[c] / items : -1.0;
+        }
+        r->hasCounters = 1;
+    }
+
+    double nsPerItem = med / r->itemsPerCall;
+    fprintf(suite->out, "%-32s %12.1f ns  ±%9.1f  %10.2f ns/%s  %12.3g %s/s\n",
+            r->name, med, mad, nsPerItem, r->itemUnit,
+            med > 0.0 ? 1e9 / nsPerItem : 0.0, r->itemUnit);
+    if (r->hasCounters) printCounters(suite->out, r);
+    fflush(suite->out);
+    return 1;
+}
+
+int benchWriteJSON(const BenchSuite* suite, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "ERROR::BENCH::WRITE_JSON: No se pudo abrir '%s'.\n", path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"benchmarks\": [\n");
+    for (int i = 0; i < suite->resultCount; ++i) {
+        const BenchResult* r = &suite->results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"median_ns\": %.3f, \"mad_ns\": %.3f, "
+                   "\"items_per_call\": %.1f, \"item_unit\": \"%s\", \"ns_per_item\": %.4f, "
+                   "\"iters_per_sample\": %ld, \"samples\": %d",
+                r->name, r->medianNs, r->madNs, r->itemsPerCall, r->itemUnit,
+                r->medianNs / r->itemsPerCall, r->itersPerSample, r->samples);
+        if (r->hasCounters) {
+            // Por item; null si el contador no existe en esta máquina
+            for (int c = 0; c < PERF_CTR_COUNT; ++c) {
+                if (r->perItem[c] >= 0.0) fprintf(f, ", \"%s_per_item\": %.5f", perfCounterName((PerfCounterId)c), r->perItem[c]);
+                else fprintf(f, ", \"%s_per_item\": null", perfCounterName((PerfCounterId)c));
+            }
+        }
+        fprintf(f, "}%s\n", (i + 1 < suite->resultCount) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+// Lector mínimo del JSON que escribe benchWriteJSON: busca pares
+// "name"/"median_ns" en orden. No pretende ser un parser JSON general.
+int benchCompareBaseline(const BenchSuite* suite, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "ADVERTENCIA::BENCH::COMPARE_BASELINE: No se pudo abrir '%s'; sin comparación.\n", path);
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = (char*)malloc((size_t)len + 1);
+    if (!text || fread(text, 1, (size_t)len, f) != (size_t)len) {
+        free(text);
+        fclose(f);
+        return 0;
+    }
+    text[len] = '\0';
+    fclose(f);
+
+    int regressions = 0;
+    fprintf(suite->out, "\n--- Comparación con %s (umbral +%.0f%%) ---\n", path, suite->threshold * 100.0);
+    for (int i = 0; i < suite->resultCount; ++i) {
+        const BenchResult* r = &suite->results[i];
+        char key[96];
+        snprintf(key, sizeof(key), "\"name\": \"%s\"", r->name);
+        const char* entry = strstr(text, key);
+        const char* medianField = entry ? strstr(entry, "\"median_ns\":") : NULL;
+        if (!medianField) {
+            fprintf(suite->out, "%-32s (nuevo, sin base)\n", r->name);
+            continue;
+        }
+        double base = atof(medianField + strlen("\"median_ns\":"));
+        if (base <= 0.0) continue;
+        double delta = (r->medianNs - base) / base;
+        int regressed = delta > suite->threshold;
+        regressions += regressed;
+        fprintf(suite->out, "%-32s %12.1f -> %12.1f ns  %+7.1f%%%s\n",
+                r->name, base, r->medianNs, delta * 100.0, regressed ? "  <-- REGRESIÓN" : "");
+    }
+    free(text);
+    return regressions;
+}
@@ -0,0 +1,65 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include "perf_counters.h"
+
+// Arnés de microbenchmarks para `make bench`.
+// Cada benchmark se calienta, se calibra para que una muestra dure al menos
+// BENCH_MIN_SAMPLE_NS y se mide en BENCH_DEFAULT_SAMPLES muestras. Se
+// informa mediana y MAD (desviación absoluta mediana) del tiempo por llamada.
+// Con --counters se hace además una pasada con contadores hardware
+// (ver perf_counters.h) y se informa IPC y fallos por item.
+
+#define BENCH_MAX_RESULTS 128
+#define BENCH_DEFAULT_SAMPLES 15
+#define BENCH_MAX_SAMPLES 101
+#define BENCH_WARMUP_NS 50000000.0    // 50 ms
+#define BENCH_MIN_SAMPLE_NS 2000000.0 // 2 ms
+#define BENCH_DEFAULT_THRESHOLD 0.10  // +10% sobre la mediana base = regresión
+
+typedef void (*BenchFunc)(void* ctx);
+
+typedef struct {
+    char name[64];
+    double medianNs;        // Por llamada a BenchFunc
+    double madNs;
+    double itemsPerCall;    // Caracteres, píxeles, glifos... por llamada
+    char itemUnit[16];
+    long itersPerSample;
+    int samples;
+    int hasCounters;
+    double perItem[PERF_CTR_COUNT]; // Contador / item; < 0 = no disponible
+} BenchResult;
+
+typedef struct {
+    int samples;
+    double threshold;
+    const char* filter;        // Subcadena; NULL = todos
+    const char* jsonPath;      // NULL = sin JSON
+    const char* baselinePath;  // NULL = sin comparación
+    FILE* out;                 // Informe legible
+    int useCounters;           // --counters
+    PerfCounters counters;     // Abiertos en la primera benchRun
+    int countersOpened;
+
+    BenchResult results[BENCH_MAX_RESULTS];
+    int resultCount;
+    int overflowed;            // Algún benchRun no cupo en results: la ejecución falla
+} BenchSuite;
+
+void benchSuiteInit(BenchSuite* suite);
+int benchParseArgs(BenchSuite* suite, int argc, char* argv[]);
+void benchSuiteCleanup(BenchSuite* suite);
+
+// Devuelve 1 si se ejecutó, 0 si el filtro lo excluye, -1 si ya no caben
+// más resultados (marca suite->overflowed).
+int benchRun(BenchSuite* suite, const char* name, BenchFunc fn, void* ctx,
+             double itemsPerCall, const char* itemUnit);
+
+double benchNowNs(void);
+int benchWriteJSON(const BenchSuite* suite, const char* path);
+// Devuelve el número de regresiones por encima de suite->threshold.
+int benchCompareBaseline(const BenchSuite* suite, const char* path);
+
+#endif // BENCH_H
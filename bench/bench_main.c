@@ -0,0 +1,846 @@
+#define _POSIX_C_SOURCE 200809L // dup, fdopen con -std=c99
+#include "bench.h"
+#include "freetype_handler.h"
+#include "tessellation_handler.h"
+#include "batch_tessellation.h"
+#include "glyph_mesh.h"         // GLYPH_MESH_FLATNESS
+#include "glyph_extrude.h"
+#include "mesh_optimizer.h"
+#include "glyph_manager.h"
+#include "text_layout.h"
+#include "keybindings.h"
+#include "utils.h"
+#include "utf8_decode.h"
+#include "sdf_generator.h"
+#include "sdf_backend.h"
+#include "bc4_encoder.h"
+#include "kerning.h"
+#include "text_shaper.h"
+#include "config.h"            // GLYPH_LOAD_PIXEL_SIZE
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Microbenchmarks de los caminos calientes. Se enlaza con los módulos
+// compilados con -DUNIT_TESTING (sin contexto GL), como los tests.
+// Uso: make bench [BENCH_ARGS="--filter sdf --counters --baseline bench/baseline.json"]
+
+static const char* benchFontPath = "tests/fonts/test_font.ttf";
+
+// Globals de main.c que usa input_handler.c
+extern char globalTextInputBuffer[];
+extern size_t globalCursorBytePos;
+extern void app_keyboard_callback(unsigned char key, int x, int y);
+extern void app_special_keyboard_callback(int key, int x, int y);
+
+// --- Dummies: main_module.o los referencia, pero no hay ventana ---
+void glutPostRedisplay(void) { }
+void cleanupOpenGL(GLuint program) { (void)program; }
+
+// Evita que el compilador elimine los resultados
+static volatile unsigned long benchSink;
+
+// --- utf8_to_codepoint ---
+typedef struct {
+    char* text;
+    size_t bytes;
+} Utf8Ctx;
+
+static void buildUtf8Text(Utf8Ctx* ctx, const char* pattern, size_t targetBytes) {
+    size_t patternLen = strlen(pattern);
+    size_t reps = targetBytes / patternLen;
+    ctx->bytes = reps * patternLen;
+    ctx->text = (char*)malloc(ctx->bytes + 1);
+    for (size_t i = 0; i < reps; ++i) memcpy(ctx->text + i * patternLen, pattern, patternLen);
+    ctx->text[ctx->bytes] = '\0';
+}
+
+// Los caracteres de pattern en orden aleatorio (xorshift, misma semilla): la
+// misma mezcla de longitudes, pero sin un patrón corto que los saltos del
+// decodificador escalar aprendan
+static void buildShuffledUtf8Text(Utf8Ctx* ctx, const char* pattern, size_t targetBytes) {
+    const char* starts[64];
+    size_t lengths[64], count = 0;
+    for (const char* s = pattern; *s != '\0' && count < 64; ++count) {
+        starts[count] = s;
+        utf8_to_codepoint(&s);
+        lengths[count] = (size_t)(s - starts[count]);
+    }
+    ctx->text = (char*)malloc(targetBytes + 1);
+    ctx->bytes = 0;
+    uint32_t state = 0x9E3779B9u;
+    for (;;) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        size_t k = state % count;
+        if (ctx->bytes + lengths[k] > targetBytes) break;
+        memcpy(ctx->text + ctx->bytes, starts[k], lengths[k]);
+        ctx->bytes += lengths[k];
+    }
+    ctx->text[ctx->bytes] = '\0';
+}
+
+static void benchUtf8Decode(void* arg) {
+    Utf8Ctx* ctx = (Utf8Ctx*)arg;
+    const char* s = ctx->text;
+    unsigned long sum = 0;
+    FT_ULong cp;
+    while ((cp = utf8_to_codepoint(&s)) != 0) sum += cp;
+    benchSink = sum;
+}
+
+// --- utf8DecodeBuffer: el texto entero a codepoints y offsets ---
+typedef struct {
+    Utf8Ctx text;
+    uint32_t* codepoints;
+    uint32_t* offsets;
+    int simd;
+} Utf8BulkCtx;
+
+static void benchUtf8Bulk(void* arg) {
+    Utf8BulkCtx* ctx = (Utf8BulkCtx*)arg;
+    utf8SimdEnabled = ctx->simd;
+    benchSink = (unsigned long)utf8DecodeBuffer(ctx->text.text, ctx->text.bytes, ctx->codepoints, ctx->offsets, NULL);
+}
+
+// --- calculateTextLayout ---
+// Métrica sin caché de glifos: aísla el coste del propio layout.
+static MinimalGlyphInfo benchFixedMetrics(FT_ULong codepoint) {
+    MinimalGlyphInfo info = {0};
+    info.advanceX = 20 + (long)(codepoint & 15);
+    info.codepoint = codepoint;
+    return info;
+}
+
+typedef struct {
+    const char* text;
+    size_t cursor;
+} LayoutCtx;
+
+static void benchLayout(void* arg) {
+    LayoutCtx* ctx = (LayoutCtx*)arg;
+    TextLayoutInfo info = calculateTextLayout(ctx->text, ctx->cursor, -0.95f, 0.8f, 0.003f,
+                                              1.9f, 0.15f, benchFixedMetrics);
+    benchSink = (unsigned long)(info.cursor_pos.x * 1000.0f);
+}
+
+// Con métricas reales de la fuente (avance e índice de glifo precalculados,
+// sin caché de glifos): coste del kerning en el bucle de layout
+#define LAYOUT_FONT_METRICS 0x180
+static MinimalGlyphInfo benchFontMetricsTable[LAYOUT_FONT_METRICS];
+
+static void loadBenchFontMetrics(void) {
+    FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE);
+    for (FT_ULong c = 0; c < LAYOUT_FONT_METRICS; ++c) {
+        MinimalGlyphInfo* info = &benchFontMetricsTable[c];
+        memset(info, 0, sizeof(*info));
+        info->codepoint = c;
+        info->glyphIndex = FT_Get_Char_Index(ftFace, c);
+        if (info->glyphIndex != 0 && FT_Load_Glyph(ftFace, info->glyphIndex, FT_LOAD_DEFAULT) == 0) {
+            info->advanceX = (long)(ftFace->glyph->advance.x / 64);
+        }
+    }
+}
+
+static MinimalGlyphInfo benchFontMetrics(FT_ULong codepoint) {
+    return codepoint < LAYOUT_FONT_METRICS ? benchFontMetricsTable[codepoint] : benchFixedMetrics(codepoint);
+}
+
+typedef struct {
+    const char* text;
+    size_t cursor;
+    const KerningTable* kerning; // NULL = solo avances
+} KernLayoutCtx;
+
+static void benchLayoutKerned(void* arg) {
+    KernLayoutCtx* ctx = (KernLayoutCtx*)arg;
+    TextLayoutInfo info = calculateTextLayoutKerned(ctx->text, ctx->cursor, -0.95f, 0.8f, 0.003f,
+                                                    1.9f, 0.15f, benchFontMetrics, ctx->kerning);
+    benchSink = (unsigned long)(info.cursor_pos.x * 1000.0f);
+}
+
+// --- shapeText: con la caché de palabras y dando forma a cada palabra ---
+typedef struct {
+    const char* text;
+    size_t bytes;
+    int cache;
+    ShapedText shaped;
+} ShapeCtx;
+
+static void benchShape(void* arg) {
+    ShapeCtx* ctx = (ShapeCtx*)arg;
+    shapeCacheEnabled = ctx->cache;
+    shapeText(ctx->text, ctx->bytes, &ctx->shaped);
+    benchSink = (unsigned long)ctx->shaped.count;
+}
+
+// --- generate_sdf_from_bitmap / generate_sdf_from_coverage ---
+typedef struct {
+    unsigned char* bitmap;
+    int width, rows, pitch;
+    int coverage;       // 1 = EDT antialiasado en lugar del umbral
+} SdfCtx;
+
+static int renderBitmap(SdfCtx* ctx, FT_ULong codepoint, int pixelSize) {
+    memset(ctx, 0, sizeof(*ctx));
+    if (FT_Set_Pixel_Sizes(ftFace, 0, pixelSize) != 0) return -1;
+    if (FT_Load_Char(ftFace, codepoint, FT_LOAD_RENDER) != 0) return -1;
+    FT_Bitmap* bm = &ftFace->glyph->bitmap;
+    if (!bm->buffer || bm->width == 0 || bm->rows == 0) return -1;
+    ctx->width = (int)bm->width;
+    ctx->rows = (int)bm->rows;
+    ctx->pitch = ctx->width;
+    ctx->bitmap = (unsigned char*)malloc((size_t)ctx->width * ctx->rows);
+    for (int r = 0; r < ctx->rows; ++r) {
+        memcpy(ctx->bitmap + (size_t)r * ctx->width, bm->buffer + r * bm->pitch, (size_t)ctx->width);
+    }
+    return 0;
+}
+
+static void benchSdf(void* arg) {
+    SdfCtx* ctx = (SdfCtx*)arg;
+    int w = 0, h = 0;
+    unsigned char* sdf = ctx->coverage
+        ? generate_sdf_from_coverage(ctx->bitmap, ctx->width, ctx->rows, ctx->pitch, 4, 2.0f, &w, &h)
+        : generate_sdf_from_bitmap(ctx->bitmap, ctx->width, ctx->rows, ctx->pitch, 4, 2.0f, &w, &h);
+    benchSink = sdf ? sdf[(h / 2) * w + w / 2] : 0;
+    free_sdf_bitmap(sdf);
+}
+
+// --- Compresión BC4 de un "atlas" de 512x512 con el SDF de un glifo repetido ---
+#define BC4_BENCH_SIZE 512
+typedef struct {
+    unsigned char* atlas;
+    unsigned char* compressed;
+    int simd;
+} Bc4Bench;
+
+static int buildBc4Atlas(Bc4Bench* b, FT_ULong codepoint) {
+    SdfCtx glyph;
+    int w = 0, h = 0;
+    if (renderBitmap(&glyph, codepoint, 48) != 0) return -1;
+    unsigned char* sdf = generate_sdf_from_coverage(glyph.bitmap, glyph.width, glyph.rows, glyph.pitch,
+                                                    sdfPaddingForSpread(SDF_SPREAD_TEXELS), SDF_SPREAD_TEXELS, &w, &h);
+    free(glyph.bitmap);
+    if (!sdf) return -1;
+    b->atlas = (unsigned char*)malloc((size_t)BC4_BENCH_SIZE * BC4_BENCH_SIZE);
+    b->compressed = (unsigned char*)malloc(bc4CompressedSize(BC4_BENCH_SIZE, BC4_BENCH_SIZE));
+    for (int y = 0; y < BC4_BENCH_SIZE; ++y) {
+        for (int x = 0; x < BC4_BENCH_SIZE; ++x) b->atlas[y * BC4_BENCH_SIZE + x] = sdf[(y % h) * w + x % w];
+    }
+    free_sdf_bitmap(sdf);
+    return 0;
+}
+
+static void benchBc4(void* arg) {
+    Bc4Bench* b = (Bc4Bench*)arg;
+    bc4SimdEnabled = b->simd;
+    bc4EncodeImage(b->atlas, BC4_BENCH_SIZE, BC4_BENCH_SIZE, BC4_BENCH_SIZE, b->compressed);
+    bc4SimdEnabled = 1;
+    benchSink = b->compressed[0];
+}
+
+// --- SDF de un juego de glifos sobre una página de atlas: uno a uno (buffer
+// propio, copia fila a fila a la página) frente a generate_sdf_batch_into_page ---
+#define SDF_PAGE_BENCH_SIZE 512
+#define SDF_PAGE_BENCH_PX 32
+typedef struct {
+    SdfCtx glyphs[96];
+    SdfBatchGlyph items[96];
+    int count;
+    long texels;
+    unsigned char* page;
+    int threads;        // 0 = todas las CPUs; -1 = glifo a glifo
+} SdfPageBench;
+
+static int buildSdfPage(SdfPageBench* b) {
+    int padding = sdfPaddingForSpread(SDF_SPREAD_TEXELS);
+    int penX = 0, penY = 0, rowHeight = 0;
+    memset(b, 0, sizeof(*b));
+    for (FT_ULong c = 33; c < 127; ++c) { // ASCII imprimible, en estantes
+        SdfCtx* g = &b->glyphs[b->count];
+        if (renderBitmap(g, c, SDF_PAGE_BENCH_PX) != 0) continue;
+        int w = g->width + 2 * padding, h = g->rows + 2 * padding;
+        if (penX + w > SDF_PAGE_BENCH_SIZE) {
+            penX = 0;
+            penY += rowHeight;
+            rowHeight = 0;
+        }
+        if (penY + h > SDF_PAGE_BENCH_SIZE) {
+            free(g->bitmap);
+            break;
+        }
+        SdfBatchGlyph item = { g->bitmap, g->width, g->rows, g->pitch, padding, penX, penY };
+        b->items[b->count++] = item;
+        b->texels += (long)w * h;
+        penX += w;
+        rowHeight = h > rowHeight ? h : rowHeight;
+    }
+    b->page = (unsigned char*)malloc((size_t)SDF_PAGE_BENCH_SIZE * SDF_PAGE_BENCH_SIZE);
+    return b->count > 0 && b->page ? 0 : -1;
+}
+
+static void freeSdfPage(SdfPageBench* b) {
+    for (int i = 0; i < b->count; ++i) free(b->glyphs[i].bitmap);
+    free(b->page);
+}
+
+static void benchSdfPage(void* arg) {
+    SdfPageBench* b = (SdfPageBench*)arg;
+    if (b->threads >= 0) {
+        SdfPageRegion dirty;
+        generate_sdf_batch_into_page(b->items, b->count, SDF_SPREAD_TEXELS, b->page, SDF_PAGE_BENCH_SIZE,
+                                     SDF_PAGE_BENCH_SIZE, SDF_PAGE_BENCH_SIZE, b->threads, &dirty);
+        benchSink = (unsigned long)dirty.height;
+        return;
+    }
+    for (int i = 0; i < b->count; ++i) {
+        const SdfBatchGlyph* g = &b->items[i];
+        int w = 0, h = 0;
+        unsigned char* sdf = generate_sdf_from_coverage(g->coverage, g->width, g->height, g->pitch, g->padding,
+                                                        SDF_SPREAD_TEXELS, &w, &h);
+        for (int y = 0; sdf && y < h; ++y) {
+            memcpy(b->page + (size_t)(g->dst_y + y) * SDF_PAGE_BENCH_SIZE + g->dst_x, sdf + (size_t)y * w, (size_t)w);
+        }
+        free_sdf_bitmap(sdf);
+    }
+    benchSink = b->page[0];
+}
+
+// --- SDF completo de un glifo con cada backend (sdf_backend.h), como lo
+// pide la caché: FT_Load_Glyph a GLYPH_LOAD_PIXEL_SIZE + generateGlyphSdf ---
+typedef struct {
+    SdfBackend backend;
+    FT_UInt glyphIndex;
+    int emPixelSize;    // 0 = el del backend; si no, un nivel de SDF_LEVEL_SIZES
+} SdfBackendBench;
+
+static void benchSdfBackend(void* arg) {
+    SdfBackendBench* b = (SdfBackendBench*)arg;
+    SdfGlyphImage img;
+    FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE);
+    if (FT_Load_Glyph(ftFace, b->glyphIndex, FT_LOAD_DEFAULT) != 0) return;
+    if (generateGlyphSdfAtSize(b->backend, ftFace, b->glyphIndex, b->emPixelSize,
+                               sdfPaddingForSpread(SDF_SPREAD_TEXELS), SDF_SPREAD_TEXELS, &img) != 0) return;
+    trimSdfImage(&img);
+    benchSink = (unsigned long)(img.width * img.height * img.channels);
+    free_sdf_bitmap(img.data);
+}
+
+// Calidad de cada backend: error absoluto medio de cobertura al reconstruir
+// el glifo a SDF_QUALITY_REFERENCE_PX desde su SDF (bilineal, mediana en
+// MSDF, rampa de 1 px) frente a la cobertura sin hinting de FreeType
+#define SDF_QUALITY_REFERENCE_PX 192
+static const char* sdfQualityCharset = "AaBgQRe@&%8sw";
+
+static float sampleSdfBilinear(const SdfGlyphImage* s, float tx, float ty) {
+    float x = tx - 0.5f, y = ty - 0.5f;
+    int x0 = (int)floorf(x), y0 = (int)floorf(y);
+    float fx = x - x0, fy = y - y0;
+    float filtered[3];
+    for (int ch = 0; ch < s->channels; ++ch) {
+        float v[2][2];
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                int xi = x0 + dx, yi = y0 + dy;
+                xi = xi < 0 ? 0 : (xi >= s->width ? s->width - 1 : xi);
+                yi = yi < 0 ? 0 : (yi >= s->height ? s->height - 1 : yi);
+                v[dy][dx] = s->data[(yi * s->width + xi) * s->channels + ch];
+            }
+        }
+        filtered[ch] = (v[0][0] * (1 - fx) + v[0][1] * fx) * (1 - fy) + (v[1][0] * (1 - fx) + v[1][1] * fx) * fy;
+    }
+    if (s->channels != 3) return filtered[0];
+    float r = filtered[0], g = filtered[1], b = filtered[2];
+    return fmaxf(fminf(r, g), fminf(fmaxf(r, g), b));
+}
+
+static double sdfBackendError(SdfBackend backend, FT_ULong codepoint, long* texels) {
+    FT_UInt index = FT_Get_Char_Index(ftFace, codepoint);
+    SdfGlyphImage img;
+    FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE);
+    if (FT_Load_Glyph(ftFace, index, FT_LOAD_NO_HINTING) != 0) return -1.0;
+    if (generateGlyphSdf(backend, ftFace, index, sdfPaddingForSpread(SDF_SPREAD_TEXELS), SDF_SPREAD_TEXELS, &img) != 0) {
+        return -1.0;
+    }
+    trimSdfImage(&img);
+    *texels += (long)img.width * img.height;
+
+    FT_Set_Pixel_Sizes(ftFace, 0, SDF_QUALITY_REFERENCE_PX);
+    double total = -1.0;
+    if (FT_Load_Glyph(ftFace, index, FT_LOAD_NO_HINTING | FT_LOAD_RENDER) == 0) {
+        const FT_Bitmap* ref = &ftFace->glyph->bitmap;
+        float texelsPerRefPx = (float)GLYPH_LOAD_PIXEL_SIZE / SDF_QUALITY_REFERENCE_PX / img.texelSize;
+        total = 0.0;
+        for (int v = 0; v < (int)ref->rows; ++v) {
+            for (int u = 0; u < (int)ref->width; ++u) {
+                float refX = (float)ftFace->glyph->bitmap_left + u + 0.5f;
+                float refY = (float)ftFace->glyph->bitmap_top - v - 0.5f;
+                float tx = refX * texelsPerRefPx - (float)(img.left - img.padding);
+                float ty = (float)(img.top + img.padding) - refY * texelsPerRefPx;
+                float distance = (sampleSdfBilinear(&img, tx, ty) / 255.0f * 2.0f - 1.0f) * SDF_SPREAD_TEXELS / texelsPerRefPx;
+                float alpha = 0.5f - distance;
+                alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+                total += fabsf(alpha - ref->buffer[v * ref->pitch + u] / 255.0f);
+            }
+        }
+        total /= (double)ref->width * ref->rows;
+    }
+    FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE);
+    free_sdf_bitmap(img.data);
+    return total;
+}
+
+static void reportSdfBackendQuality(FILE* report) {
+    fprintf(report, "\n%-32s %9s  %9s  %13s  ('%s' a %dpx)\n", "calidad sdf_backend", "error", "peor",
+            "texels/glifo", sdfQualityCharset, SDF_QUALITY_REFERENCE_PX);
+    for (int b = 0; b < SDF_BACKEND_COUNT; ++b) {
+        double sum = 0.0, worst = 0.0;
+        long texels = 0;
+        int glyphs = 0;
+        for (const char* c = sdfQualityCharset; *c; ++c) {
+            double error = sdfBackendError((SdfBackend)b, (FT_ULong)*c, &texels);
+            if (error < 0.0) continue;
+            sum += error;
+            worst = error > worst ? error : worst;
+            glyphs++;
+        }
+        if (glyphs == 0) continue;
+        fprintf(report, "%-32s %9.4f  %9.4f  %13ld\n", sdfBackendName((SdfBackend)b), sum / glyphs, worst,
+                texels / glyphs);
+    }
+    fprintf(report, "\n");
+}
+
+// --- Caché de glifos ---
+static const char* cacheCharset = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+static void benchCacheHit(void* arg) {
+    (void)arg;
+    float sum = 0.0f;
+    for (const char* c = cacheCharset; *c; ++c) sum += getGlyphInfo((FT_ULong)*c).advanceX;
+    benchSink = (unsigned long)sum;
+}
+
+#define CACHE_MISS_GLYPHS 8
+static void benchCacheMiss(void* arg) {
+    (void)arg;
+    float sum = 0.0f;
+    for (int i = 0; i < CACHE_MISS_GLYPHS; ++i) sum += getGlyphInfo((FT_ULong)cacheCharset[i]).advanceX;
+    cleanupGlyphCache();
+    benchSink = (unsigned long)sum;
+}
+
+// --- generateGlyphTessellation ---
+static int decomposeGlyph(OutlineDataC* outline, FT_ULong codepoint) {
+    if (FT_Set_Pixel_Sizes(ftFace, 0, 48) != 0) return -1;
+    if (FT_Load_Char(ftFace, codepoint, FT_LOAD_NO_BITMAP) != 0) return -1;
+    if (ftFace->glyph->format != FT_GLYPH_FORMAT_OUTLINE) return -1;
+    FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    if (initOutlineData(outline, 4) != 0) return -1;
+    return FT_Outline_Decompose(&ftFace->glyph->outline, &funcs, outline) == 0 ? 0 : -1;
+}
+
+// --- Extracción de contornos de toda la fuente (callbacks frente a recorrido directo) ---
+// Los FT_Outline se copian una vez: solo se mide la extracción, no FT_Load_Glyph.
+typedef struct {
+    FT_Outline* outlines;
+    int outlineCount;
+    OutlineDataC outline;
+    int direct;
+} OutlineFontBench;
+
+static void benchOutlineFont(void* arg) {
+    OutlineFontBench* b = (OutlineFontBench*)arg;
+    static const FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    size_t points = 0;
+    for (int g = 0; g < b->outlineCount; ++g) {
+        resetOutlineData(&b->outline);
+        if (b->direct) extractOutline(&b->outlines[g], &b->outline);
+        else FT_Outline_Decompose(&b->outlines[g], &funcs, &b->outline);
+        points += b->outline.pointCount;
+    }
+    benchSink = (unsigned long)points;
+}
+
+static int loadFontOutlines(OutlineFontBench* b) {
+    b->outlines = (FT_Outline*)calloc((size_t)ftFace->num_glyphs, sizeof(FT_Outline));
+    if (!b->outlines || initOutlineData(&b->outline, 8) != 0) return -1;
+    FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE);
+    for (FT_Long g = 0; g < ftFace->num_glyphs; ++g) {
+        if (FT_Load_Glyph(ftFace, (FT_UInt)g, FT_LOAD_NO_BITMAP) != 0) continue;
+        if (ftFace->glyph->format != FT_GLYPH_FORMAT_OUTLINE) continue;
+        const FT_Outline* src = &ftFace->glyph->outline;
+        FT_Outline* dst = &b->outlines[b->outlineCount];
+        if (FT_Outline_New(ftLibrary, (FT_UInt)src->n_points, src->n_contours, dst) != 0) continue;
+        FT_Outline_Copy(src, dst);
+        b->outlineCount++;
+    }
+    return 0;
+}
+
+static void freeFontOutlines(OutlineFontBench* b) {
+    for (int g = 0; g < b->outlineCount; ++g) FT_Outline_Done(ftLibrary, &b->outlines[g]);
+    free(b->outlines);
+    freeOutlineData(&b->outline);
+}
+
+static void benchTessellate(void* arg) {
+    TessellationResult result = generateGlyphTessellation((OutlineDataC*)arg);
+    benchSink = (unsigned long)result.elementCount;
+    free(result.vertices);
+    free(result.elements);
+}
+
+typedef struct {
+    TessellationContext ctx;
+    OutlineDataC* outline;
+    GlyphMeshBuffer mesh;
+} TessCtxBench;
+
+static void benchTessellateContext(void* arg) {
+    TessCtxBench* b = (TessCtxBench*)arg;
+    tessellateOutlineInto(&b->ctx, b->outline, &b->mesh);
+    benchSink = (unsigned long)b->mesh.indexCount;
+}
+
+// --- Post-proceso de mallas (soldado, Forsyth, 16 bits, int16) ---
+typedef struct {
+    const GlyphMeshBuffer* mesh;
+    OptimizedMesh out;
+} MeshOptBench;
+
+static void benchMeshOptimize(void* arg) {
+    MeshOptBench* b = (MeshOptBench*)arg;
+    static const MeshOptimizeOptions options = { 1, 1, GLYPH_MESH_QUANTIZE_SCALE };
+    optimizeGlyphMesh(b->mesh, &options, &b->out);
+    benchSink = (unsigned long)b->out.indexCount;
+}
+
+// --- Extrusión 3D (tapas + paredes con bisel) ---
+typedef struct {
+    GlyphExtruder extruder;
+    OutlineDataC* outline;
+    ExtrudeParams params;
+} ExtrudeBench;
+
+static void benchExtrude(void* arg) {
+    ExtrudeBench* b = (ExtrudeBench*)arg;
+    extrudeOutline(&b->extruder, b->outline, &b->params);
+    benchSink = (unsigned long)b->extruder.mesh.indexCount;
+}
+
+// --- Teselación por lotes (Latin básico + Latin-1 + Latin extendido A) ---
+#define BATCH_FIRST_CODEPOINT 0x20
+#define BATCH_LAST_CODEPOINT 0x17F
+
+typedef struct {
+    int threads;
+} BatchTessBench;
+
+static void benchBatchTessellate(void* arg) {
+    GlyphMeshBatch batch;
+    if (batchTessellateRange(benchFontPath, BATCH_FIRST_CODEPOINT, BATCH_LAST_CODEPOINT, GLYPH_LOAD_PIXEL_SIZE, GLYPH_MESH_FLATNESS,
+                             ((BatchTessBench*)arg)->threads, &batch) == 0) {
+        benchSink = (unsigned long)batch.indexCount;
+        freeGlyphMeshBatch(&batch);
+    }
+}
+
+// --- Teclado ---
+// Cada llamada inserta y borra un carácter, así el buffer no crece.
+static void benchKeyboardBackspace(void* arg) {
+    (void)arg;
+    app_keyboard_callback('x', 0, 0);
+    app_keyboard_callback(APP_KEY_BACKSPACE, 0, 0);
+}
+
+static void benchKeyboardDelete(void* arg) {
+    (void)arg;
+    app_keyboard_callback('x', 0, 0);
+    app_special_keyboard_callback(APP_KEY_LEFT, 0, 0);
+    app_keyboard_callback(APP_KEY_DEL, 0, 0);
+}
+
+static void resetTextBuffer(const char* text, size_t cursor) {
+    strcpy(globalTextInputBuffer, text);
+    globalCursorBytePos = cursor;
+}
+
+int main(int argc, char* argv[]) {
+    BenchSuite suite;
+    benchSuiteInit(&suite);
+    if (benchParseArgs(&suite, argc, argv) != 0) return 2;
+
+    // Los módulos imprimen trazas de depuración por stdout en los caminos
+    // medidos; se mandan a /dev/null y el informe va al stdout original.
+    fflush(stdout);
+    int reportFd = dup(STDOUT_FILENO);
+    FILE* report = reportFd >= 0 ? fdopen(reportFd, "w") : NULL;
+    int devNull = open("/dev/null", O_WRONLY);
+    if (!report || devNull < 0) {
+        fprintf(stderr, "ERROR::BENCH::MAIN: No se pudo redirigir stdout.\n");
+        return 1;
+    }
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+    suite.out = report;
+
+    if (initFreeType() != 0 || loadFonts(benchFontPath, NULL) != 0) {
+        fprintf(stderr, "ERROR::BENCH::MAIN: No se pudo cargar la fuente '%s'.\n", benchFontPath);
+        return 1;
+    }
+
+    fprintf(report, "%-32s %15s  %10s  %13s  %14s\n", "benchmark", "mediana", "MAD", "por item", "throughput");
+
+    Utf8Ctx ascii, mixed;
+    buildUtf8Text(&ascii, "The quick brown fox jumps over the lazy dog. ", 64 * 1024);
+    buildUtf8Text(&mixed, "Texto ¡Hola €! ñandú 𝄞 ", 64 * 1024);
+    benchRun(&suite, "utf8_decode_ascii", benchUtf8Decode, &ascii, (double)ascii.bytes, "byte");
+    benchRun(&suite, "utf8_decode_mixed", benchUtf8Decode, &mixed, (double)mixed.bytes, "byte");
+    free(ascii.text);
+    free(mixed.text);
+
+    // Decodificación por bloques, SSE2 frente a escalar, sobre textos de 1, 2 y 3 bytes por carácter
+    static const struct { const char* name; const char* pattern; } bulkSamples[] = {
+        { "ascii", "The quick brown fox jumps over the lazy dog. " },
+        { "mixed", "Texto ¡Hola €! ñandú 𝄞 " },
+        { "arabic", "\xD9\x85\xD8\xB1\xD8\xAD\xD8\xA8\xD8\xA7 \xD8\xA8\xD8\xA7\xD9\x84\xD8\xB9\xD8\xA7\xD9\x84\xD9\x85. " },
+        { "devanagari", "\xE0\xA4\xA8\xE0\xA4\xAE\xE0\xA4\xB8\xE0\xA5\x8D\xE0\xA4\xA4\xE0\xA5\x87 "
+                        "\xE0\xA4\xA6\xE0\xA5\x81\xE0\xA4\xA8\xE0\xA4\xBF\xE0\xA4\xAF\xE0\xA4\xBE. " },
+    };
+    // _shuffled: los mismos caracteres en orden aleatorio (texto real); el
+    // patrón repetido favorece a la ruta escalar, que acaba prediciendo cada salto
+    for (size_t i = 0; i < 2 * sizeof(bulkSamples) / sizeof(bulkSamples[0]); ++i) {
+        size_t sample = i / 2;
+        int shuffled = (int)(i % 2);
+        Utf8BulkCtx bulk;
+        char name[64];
+        if (shuffled) {
+            buildShuffledUtf8Text(&bulk.text, bulkSamples[sample].pattern, 64 * 1024);
+        } else {
+            buildUtf8Text(&bulk.text, bulkSamples[sample].pattern, 64 * 1024);
+        }
+        bulk.codepoints = (uint32_t*)malloc(bulk.text.bytes * sizeof(uint32_t));
+        bulk.offsets = (uint32_t*)malloc(bulk.text.bytes * sizeof(uint32_t));
+        bulk.simd = 1;
+        snprintf(name, sizeof(name), "utf8_bulk_%s%s_sse2", bulkSamples[sample].name, shuffled ? "_shuffled" : "");
+        benchRun(&suite, name, benchUtf8Bulk, &bulk, (double)bulk.text.bytes, "byte");
+        bulk.simd = 0;
+        snprintf(name, sizeof(name), "utf8_bulk_%s%s_scalar", bulkSamples[sample].name, shuffled ? "_shuffled" : "");
+        benchRun(&suite, name, benchUtf8Bulk, &bulk, (double)bulk.text.bytes, "byte");
+        free(bulk.codepoints);
+        free(bulk.offsets);
+        free(bulk.text.text);
+    }
+    utf8SimdEnabled = 1;
+
+    Utf8Ctx longText;
+    buildUtf8Text(&longText, "Lorem ipsum dolor sit amet, ñandú €. ", 4096);
+    LayoutCtx layoutShort = { "Texto ¡Hola €!", 6 };
+    LayoutCtx layoutLong = { longText.text, longText.bytes / 2 };
+    benchRun(&suite, "layout_short", benchLayout, &layoutShort, 14.0, "char");
+    benchRun(&suite, "layout_long", benchLayout, &layoutLong, (double)longText.bytes, "byte");
+    free(longText.text);
+
+    // Mismo texto con kerning (tabla 'kern' a GLYPH_LOAD_PIXEL_SIZE) y sin él
+    Utf8Ctx kernText;
+    KerningTable kerning;
+    buildUtf8Text(&kernText, "AVATAR Typography: To, We, Yo, LT. The quick brown fox jumps over the lazy dog. ", 4096);
+    loadBenchFontMetrics();
+    if (buildKerningTable(ftFace, GLYPH_LOAD_PIXEL_SIZE, &kerning) == 0) {
+        KernLayoutCtx plain = { kernText.text, kernText.bytes / 2, NULL };
+        KernLayoutCtx kerned = { kernText.text, kernText.bytes / 2, &kerning };
+        benchRun(&suite, "layout_font_nokern", benchLayoutKerned, &plain, (double)kernText.bytes, "byte");
+        benchRun(&suite, "layout_font_kern", benchLayoutKerned, &kerned, (double)kernText.bytes, "byte");
+    }
+    freeKerningTable(&kerning);
+    free(kernText.text);
+
+    // Shaping (HarfBuzz con make HARFBUZZ=1; si no, el básico) con y sin la
+    // caché de palabras: inglés repetitivo, árabe y devanagari (la fuente de
+    // test no tiene devanagari: solo mide el camino de glifos ausentes)
+    static const struct { const char* name; const char* pattern; } shapeSamples[] = {
+        { "english", "The quick brown fox jumps over the lazy dog and the cat. " },
+        { "arabic", "\xD9\x85\xD8\xB1\xD8\xAD\xD8\xA8\xD8\xA7 \xD8\xA8\xD8\xA7\xD9\x84\xD8\xB9\xD8\xA7\xD9\x84\xD9\x85 "
+                    "\xD9\x87\xD8\xB0\xD8\xA7 \xD9\x86\xD8\xB5 \xD8\xB9\xD8\xB1\xD8\xA8\xD9\x8A. " }, // "مرحبا بالعالم هذا نص عربي. "
+        { "devanagari", "\xE0\xA4\xA8\xE0\xA4\xAE\xE0\xA4\xB8\xE0\xA5\x8D\xE0\xA4\xA4\xE0\xA5\x87 "
+                        "\xE0\xA4\xA6\xE0\xA5\x81\xE0\xA4\xA8\xE0\xA4\xBF\xE0\xA4\xAF\xE0\xA4\xBE. " }, // "नमस्ते दुनिया. "
+    };
+    buildKerningTable(ftFace, GLYPH_LOAD_PIXEL_SIZE, &fontKerningTable);
+    if (initTextShaper(ftFace, GLYPH_LOAD_PIXEL_SIZE) == 0) {
+        for (size_t i = 0; i < sizeof(shapeSamples) / sizeof(shapeSamples[0]); ++i) {
+            Utf8Ctx sample;
+            char name[64];
+            buildUtf8Text(&sample, shapeSamples[i].pattern, 4096);
+            ShapeCtx shape = { sample.text, sample.bytes, 1, { NULL, 0, 0 } };
+            snprintf(name, sizeof(name), "shape_%s_cached", shapeSamples[i].name);
+            benchRun(&suite, name, benchShape, &shape, (double)shape.bytes, "byte");
+            shape.cache = 0;
+            snprintf(name, sizeof(name), "shape_%s_uncached", shapeSamples[i].name);
+            benchRun(&suite, name, benchShape, &shape, (double)shape.bytes, "byte");
+            freeShapedText(&shape.shaped);
+            free(sample.text);
+        }
+        shapeCacheEnabled = 1;
+        cleanupTextShaper();
+    }
+    freeKerningTable(&fontKerningTable);
+
+    static const int sdfSizes[] = { 16, 32, 48, 64, 128 };
+    for (size_t i = 0; i < sizeof(sdfSizes) / sizeof(sdfSizes[0]); ++i) {
+        SdfCtx sdf;
+        char name[64];
+        snprintf(name, sizeof(name), "sdf_generate_%dpx", sdfSizes[i]);
+        if (renderBitmap(&sdf, 'g', sdfSizes[i]) != 0) {
+            fprintf(stderr, "ADVERTENCIA::BENCH::MAIN: No se pudo rasterizar 'g' a %dpx.\n", sdfSizes[i]);
+            continue;
+        }
+        sdf.coverage = 0;
+        benchRun(&suite, name, benchSdf, &sdf, (double)(sdf.width + 8) * (sdf.rows + 8), "px");
+        snprintf(name, sizeof(name), "sdf_coverage_%dpx", sdfSizes[i]);
+        sdf.coverage = 1;
+        benchRun(&suite, name, benchSdf, &sdf, (double)(sdf.width + 8) * (sdf.rows + 8), "px");
+        free(sdf.bitmap);
+    }
+
+    Bc4Bench bc4 = { NULL, NULL, 1 };
+    if (buildBc4Atlas(&bc4, 'g') == 0) {
+        benchRun(&suite, "bc4_encode_sse2", benchBc4, &bc4, (double)BC4_BENCH_SIZE * BC4_BENCH_SIZE, "texel");
+        bc4.simd = 0;
+        benchRun(&suite, "bc4_encode_scalar", benchBc4, &bc4, (double)BC4_BENCH_SIZE * BC4_BENCH_SIZE, "texel");
+    }
+    free(bc4.atlas);
+    free(bc4.compressed);
+
+    SdfPageBench page;
+    if (buildSdfPage(&page) == 0) {
+        page.threads = -1;
+        benchRun(&suite, "sdf_page_per_glyph", benchSdfPage, &page, (double)page.texels, "texel");
+        page.threads = 1;
+        benchRun(&suite, "sdf_page_batch_1thread", benchSdfPage, &page, (double)page.texels, "texel");
+        page.threads = 0;
+        benchRun(&suite, "sdf_page_batch_allcpus", benchSdfPage, &page, (double)page.texels, "texel");
+    }
+    freeSdfPage(&page);
+
+    for (int b = 0; b < SDF_BACKEND_COUNT; ++b) {
+        SdfBackendBench backendBench = { (SdfBackend)b, FT_Get_Char_Index(ftFace, 'g'), 0 };
+        char name[64];
+        snprintf(name, sizeof(name), "sdf_backend_%s", sdfBackendName((SdfBackend)b));
+        benchRun(&suite, name, benchSdfBackend, &backendBench, 1.0, "glyph");
+    }
+    if (!suite.filter || strstr("sdf_backend", suite.filter)) reportSdfBackendQuality(report);
+
+    // Coste de cada nivel de SDF (sdfBackend por defecto), por texel generado
+    static const int sdfLevelSizes[SDF_LEVEL_COUNT] = SDF_LEVEL_SIZES;
+    for (int i = 0; i < SDF_LEVEL_COUNT; ++i) {
+        SdfBackendBench levelBench = { sdfBackend, FT_Get_Char_Index(ftFace, 'g'), sdfLevelSizes[i] };
+        SdfGlyphImage img;
+        char name[64];
+        FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE);
+        if (FT_Load_Glyph(ftFace, levelBench.glyphIndex, FT_LOAD_DEFAULT) != 0 ||
+            generateGlyphSdfAtSize(sdfBackend, ftFace, levelBench.glyphIndex, sdfLevelSizes[i],
+                                   sdfPaddingForSpread(SDF_SPREAD_TEXELS), SDF_SPREAD_TEXELS, &img) != 0) {
+            continue;
+        }
+        snprintf(name, sizeof(name), "sdf_level_%dpx", sdfLevelSizes[i]);
+        benchRun(&suite, name, benchSdfBackend, &levelBench, (double)img.width * img.height, "texel");
+        free_sdf_bitmap(img.data);
+    }
+
+    initGlyphCache();
+    benchRun(&suite, "glyph_cache_miss", benchCacheMiss, NULL, CACHE_MISS_GLYPHS, "glyph");
+    for (const char* c = cacheCharset; *c; ++c) getGlyphInfo((FT_ULong)*c);
+    benchRun(&suite, "glyph_cache_hit", benchCacheHit, NULL, (double)strlen(cacheCharset), "glyph");
+    cleanupGlyphCache();
+
+    static const FT_ULong tessGlyphs[] = { 'A', 'g', '@' };
+    for (size_t i = 0; i < sizeof(tessGlyphs) / sizeof(tessGlyphs[0]); ++i) {
+        OutlineDataC outline;
+        char name[64];
+        snprintf(name, sizeof(name), "tessellate_%c", (char)tessGlyphs[i]);
+        if (decomposeGlyph(&outline, tessGlyphs[i]) != 0) {
+            fprintf(stderr, "ADVERTENCIA::BENCH::MAIN: No se pudo descomponer '%c'.\n", (char)tessGlyphs[i]);
+            freeOutlineData(&outline);
+            continue;
+        }
+        benchRun(&suite, name, benchTessellate, &outline, 1.0, "glyph");
+
+        static TESSreal meshVertices[2 * 4096];
+        static TESSindex meshIndices[3 * 8192];
+        TessCtxBench ctxBench = { .outline = &outline,
+                                  .mesh = { meshVertices, 4096, meshIndices, 3 * 8192, 0, 0 } };
+        if (initTessellationContext(&ctxBench.ctx, 0) == 0) {
+            snprintf(name, sizeof(name), "tessellate_ctx_%c", (char)tessGlyphs[i]);
+            benchRun(&suite, name, benchTessellateContext, &ctxBench, 1.0, "glyph");
+            // Mismo glifo sin el recorte de orejas: cuánto ahorra el camino rápido
+            tessellationFastPathEnabled = 0;
+            snprintf(name, sizeof(name), "tessellate_ctx_libtess_%c", (char)tessGlyphs[i]);
+            benchRun(&suite, name, benchTessellateContext, &ctxBench, 1.0, "glyph");
+            tessellationFastPathEnabled = 1;
+
+            tessellateOutlineInto(&ctxBench.ctx, &outline, &ctxBench.mesh); // Por si --filter saltó las anteriores
+            MeshOptBench optBench = { .mesh = &ctxBench.mesh };
+            snprintf(name, sizeof(name), "mesh_optimize_%c", (char)tessGlyphs[i]);
+            benchRun(&suite, name, benchMeshOptimize, &optBench, 1.0, "glyph");
+            freeOptimizedMesh(&optBench.out);
+            freeTessellationContext(&ctxBench.ctx);
+        }
+
+        ExtrudeBench extrudeBench = { .outline = &outline,
+                                      .params = { EXTRUDE_DEFAULT_DEPTH_PX, EXTRUDE_DEFAULT_BEVEL_PX, EXTRUDE_DEFAULT_BEVEL_STEPS } };
+        if (initGlyphExtruder(&extrudeBench.extruder) == 0) {
+            snprintf(name, sizeof(name), "extrude_%c", (char)tessGlyphs[i]);
+            benchRun(&suite, name, benchExtrude, &extrudeBench, 1.0, "glyph");
+            freeGlyphExtruder(&extrudeBench.extruder);
+        }
+        freeOutlineData(&outline);
+    }
+
+    OutlineFontBench outlineBench = {0};
+    if (loadFontOutlines(&outlineBench) == 0) {
+        outlineBench.direct = 0;
+        benchRun(&suite, "outline_font_decompose", benchOutlineFont, &outlineBench, (double)outlineBench.outlineCount, "glyph");
+        outlineBench.direct = 1;
+        benchRun(&suite, "outline_font_extract", benchOutlineFont, &outlineBench, (double)outlineBench.outlineCount, "glyph");
+    }
+    freeFontOutlines(&outlineBench);
+
+    // Incluye abrir una FT_Face por hilo: es el coste real de pre-teselar una fuente
+    BatchTessBench batchSingle = { 1 }, batchAll = { 0 };
+    double batchGlyphs = (double)(BATCH_LAST_CODEPOINT - BATCH_FIRST_CODEPOINT + 1);
+    benchRun(&suite, "batch_tessellate_1thread", benchBatchTessellate, &batchSingle, batchGlyphs, "glyph");
+    benchRun(&suite, "batch_tessellate_allcpus", benchBatchTessellate, &batchAll, batchGlyphs, "glyph");
+
+    resetTextBuffer("Texto de prueba para el teclado", 15);
+    benchRun(&suite, "keyboard_insert_backspace", benchKeyboardBackspace, NULL, 2.0, "key");
+    resetTextBuffer("Texto de prueba para el teclado", 15);
+    benchRun(&suite, "keyboard_insert_delete", benchKeyboardDelete, NULL, 3.0, "key");
+
+    cleanupFreeType();
+    benchSuiteCleanup(&suite);
+
+    int status = 0;
+    if (suite.overflowed) {
+        fprintf(stderr, "ERROR::BENCH::MAIN: Faltan resultados; sube BENCH_MAX_RESULTS en bench/bench.h.\n");
+        status = 1;
+    }
+    if (suite.jsonPath && benchWriteJSON(&suite, suite.jsonPath) == 0) {
+        fprintf(report, "\nResultados JSON en %s\n", suite.jsonPath);
+    }
+    if (suite.baselinePath) {
+        int regressions = benchCompareBaseline(&suite, suite.baselinePath);
+        if (regressions > 0) {
+            fprintf(report, "%d regresión(es) por encima del umbral.\n", regressions);
+            status = 1;
+        }
+    }
+    fclose(report);
+    return status;
+}
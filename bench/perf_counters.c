@@ -0,0 +1,110 @@
+#define _GNU_SOURCE // syscall
+#include "perf_counters.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+static const char* counterNames[PERF_CTR_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+};
+
+const char* perfCounterName(PerfCounterId id) {
+    return (id >= 0 && id < PERF_CTR_COUNT) ? counterNames[id] : "?";
+}
+
+#ifdef __linux__
+
+static int openCounter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; // Funciona con perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0 /* este proceso */, -1 /* cualquier CPU */, -1, 0);
+}
+
+int perfCountersOpen(PerfCounters* pc) {
+    static const struct { uint32_t type; uint64_t config; } events[PERF_CTR_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    pc->openCount = 0;
+    int firstErrno = 0;
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) {
+        pc->fds[i] = openCounter(events[i].type, events[i].config);
+        if (pc->fds[i] >= 0) pc->openCount++;
+        else if (!firstErrno) firstErrno = errno;
+    }
+    if (pc->openCount == 0) {
+        fprintf(stderr, "ADVERTENCIA::PERF_COUNTERS::OPEN: perf_event_open no disponible (%s); solo se medirá tiempo.\n",
+                strerror(firstErrno));
+    }
+    return pc->openCount;
+}
+
+void perfCountersClose(PerfCounters* pc) {
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) {
+        if (pc->fds[i] >= 0) close(pc->fds[i]);
+        pc->fds[i] = -1;
+    }
+    pc->openCount = 0;
+}
+
+void perfCountersStart(PerfCounters* pc) {
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perfCountersStop(PerfCounters* pc, PerfSample* out) {
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) {
+        if (pc->fds[i] >= 0) ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) {
+        out->values[i] = -1.0;
+        if (pc->fds[i] < 0) continue;
+        uint64_t data[3]; // valor, tiempo habilitado, tiempo corriendo
+        if (read(pc->fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+        if (data[2] == 0) continue; // Nunca llegó a contar (PMU ocupada)
+        out->values[i] = (double)data[0] * ((double)data[1] / (double)data[2]);
+    }
+}
+
+#else // !__linux__
+
+int perfCountersOpen(PerfCounters* pc) {
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) pc->fds[i] = -1;
+    pc->openCount = 0;
+    fprintf(stderr, "ADVERTENCIA::PERF_COUNTERS::OPEN: perf_event_open solo existe en Linux; solo se medirá tiempo.\n");
+    return 0;
+}
+void perfCountersClose(PerfCounters* pc) { (void)pc; }
+void perfCountersStart(PerfCounters* pc) { (void)pc; }
+void perfCountersStop(PerfCounters* pc, PerfSample* out) {
+    (void)pc;
+    for (int i = 0; i < PERF_CTR_COUNT; ++i) out->values[i] = -1.0;
+}
+
+#endif // __linux__
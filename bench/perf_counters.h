@@ -0,0 +1,37 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+// Contadores hardware vía perf_event_open (solo Linux). Cada evento se abre
+// por separado: si uno no existe en esta CPU los demás siguen funcionando.
+// En contenedores sin permiso (perf_event_paranoid, seccomp) perfCountersOpen
+// devuelve 0 contadores y el arnés sigue midiendo solo tiempo.
+
+typedef enum {
+    PERF_CTR_CYCLES = 0,
+    PERF_CTR_INSTRUCTIONS,
+    PERF_CTR_L1D_MISSES,
+    PERF_CTR_LLC_MISSES,
+    PERF_CTR_BRANCH_MISSES,
+    PERF_CTR_COUNT
+} PerfCounterId;
+
+typedef struct {
+    int fds[PERF_CTR_COUNT]; // -1 = no disponible
+    int openCount;
+} PerfCounters;
+
+typedef struct {
+    // Valores escalados por multiplexado; < 0 si el contador no está disponible
+    double values[PERF_CTR_COUNT];
+} PerfSample;
+
+// Devuelve cuántos contadores se pudieron abrir (0 = sin contadores).
+int perfCountersOpen(PerfCounters* pc);
+void perfCountersClose(PerfCounters* pc);
+void perfCountersStart(PerfCounters* pc);   // Reset + enable
+void perfCountersStop(PerfCounters* pc, PerfSample* out);
+const char* perfCounterName(PerfCounterId id);
+
+#endif // PERF_COUNTERS_H
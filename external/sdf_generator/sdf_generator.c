@@ -1,8 +1,13 @@
+#define _GNU_SOURCE // sysconf(_SC_NPROCESSORS_ONLN)
 #include <stdlib.h> // Para malloc, free
 #include <string.h> // Para memset, memcpy
 #include <float.h>  // Para FLT_MAX
 #include <math.h>   // Para sqrtf, fminf, fabsf
 #include <stdio.h>
+#include <pthread.h>
+#include <unistd.h> // sysconf
+#include "sdf_generator.h"
+#include "trace.h"  // TRACE_SCOPE (solo con TEXT3D_TRACE)
 
 // Estructura para un punto en el grid 2D (para cálculos de distancia)
 typedef struct {
@@ -102,6 +107,7 @@ unsigned char* generate_sdf_from_bitmap(
     float spread,   // Spread para normalización (ej: valor del padding)
     int* out_sdf_width,
     int* out_sdf_height) {
+    TRACE_SCOPE("generate_sdf_from_bitmap");
 
     if (!mono_bitmap_buffer || width <= 0 || height <= 0 || padding < 0 || spread <= 0.0f) {
         if (out_sdf_width) *out_sdf_width = 0;
@@ -212,6 +218,363 @@ unsigned char* generate_sdf_from_bitmap(
     return sdf_output_buffer; // Devolver el bitmap SDF calculado
 }
 
+// --- EDT antialiasado (Gustavson y Strand, "Anti-aliased Euclidean distance
+// transform", 2011). En lugar de umbralizar, la cobertura de cada píxel de
+// borde y el gradiente local estiman dónde pasa el borde dentro del píxel, y
+// la propagación de 8 vecinos suma esa corrección a la distancia entera. ---
+
+#define AA_EDT_FAR 1000000.0 // "Todavía sin distancia"
+#define AA_EDT_EPSILON 1e-3
+#define AA_EDT_MAX_CORRECTION 0.7072 // max |edge_distance| (borde a 45 grados)
+
+typedef struct {
+    const double* coverage; // [0, 1], con el padding ya aplicado
+    const double* gx;
+    const double* gy;
+    short* distx;           // Desplazamiento desde el píxel de borde más cercano
+    short* disty;
+    double* dist;
+    int width, height;
+    double limit;           // Más allá (spread + margen) el SDF satura: no se propaga
+} AaEdt;
+
+// Gradiente normalizado (Sobel con pesos sqrt(2)) en los píxeles de borde
+static void compute_coverage_gradient(const double* img, int w, int h, double* gx, double* gy) {
+    const double sqrt2 = 1.4142136;
+    for (int i = 0; i < w * h; ++i) gx[i] = gy[i] = 0.0;
+    for (int y = 1; y < h - 1; ++y) {
+        for (int x = 1; x < w - 1; ++x) {
+            int k = y * w + x;
+            if (img[k] <= 0.0 || img[k] >= 1.0) continue;
+            gx[k] = -img[k - w - 1] - sqrt2 * img[k - 1] - img[k + w - 1] + img[k - w + 1] + sqrt2 * img[k + 1] + img[k + w + 1];
+            gy[k] = -img[k - w - 1] - sqrt2 * img[k - w] - img[k - w + 1] + img[k + w - 1] + sqrt2 * img[k + w] + img[k + w + 1];
+            double length = sqrt(gx[k] * gx[k] + gy[k] * gy[k]);
+            if (length > 0.0) {
+                gx[k] /= length;
+                gy[k] /= length;
+            }
+        }
+    }
+}
+
+// Distancia del centro del píxel al borde que deja una cobertura `a` con la
+// normal (gx, gy): exacta para un borde recto que cruza el píxel
+static double edge_distance(double gx, double gy, double a) {
+    if (gx == 0.0 || gy == 0.0) return 0.5 - a; // Borde alineado con los ejes (o sin gradiente)
+    double length = sqrt(gx * gx + gy * gy);
+    gx = fabs(gx / length);
+    gy = fabs(gy / length);
+    if (gx < gy) { double t = gx; gx = gy; gy = t; } // Primer octante
+    double a1 = 0.5 * gy / gx;
+    if (a < a1) return 0.5 * (gx + gy) - sqrt(2.0 * gx * gy * a);
+    if (a < 1.0 - a1) return (0.5 - a) * gx;
+    return -0.5 * (gx + gy) + sqrt(2.0 * gx * gy * (1.0 - a));
+}
+
+// Distancia desde el píxel que apunta a `closest` con el vector entero (xi, yi)
+static double aa_distance(const AaEdt* e, int closest, int xi, int yi) {
+    double a = e->coverage[closest];
+    if (a > 1.0) a = 1.0;
+    if (a <= 0.0) return AA_EDT_FAR;
+    double di = sqrt((double)xi * xi + (double)yi * yi);
+    // En el propio borde manda el gradiente; lejos, la dirección al borde es más fiable
+    double df = di == 0.0 ? edge_distance(e->gx[closest], e->gy[closest], a) : edge_distance((double)xi, (double)yi, a);
+    return di + df;
+}
+
+// Prueba el más cercano del vecino c, desplazado (dx, dy), como más cercano de i
+static int aa_try_neighbor(AaEdt* e, int i, int c, short dx, short dy) {
+    short cdx = e->distx[c], cdy = e->disty[c];
+    int xi = cdx + dx, yi = cdy + dy;
+    // La corrección subpíxel nunca baja de -sqrt(2)/2: si la distancia entera ya
+    // no puede mejorar (o queda fuera de `limit`), se evita la raíz y edge_distance
+    double bound = (e->dist[i] < e->limit ? e->dist[i] : e->limit) + AA_EDT_MAX_CORRECTION;
+    if ((double)xi * xi + (double)yi * yi >= bound * bound) return 0;
+    int closest = c - cdx - cdy * e->width;
+    double candidate = aa_distance(e, closest, xi, yi);
+    if (candidate < e->dist[i] - AA_EDT_EPSILON) {
+        e->distx[i] = (short)xi;
+        e->disty[i] = (short)yi;
+        e->dist[i] = candidate;
+        return 1;
+    }
+    return 0;
+}
+
+// Barridos de 8 vecinos (como propagate_distances_8ssedt) hasta que nada cambia:
+// la métrica no es monótona en los bordes y a veces hace falta más de una pasada
+static void propagate_distances_aa(AaEdt* e) {
+    int w = e->width, h = e->height;
+    for (int i = 0; i < w * h; ++i) {
+        e->distx[i] = 0;
+        e->disty[i] = 0;
+        double a = e->coverage[i];
+        if (a <= 0.0) e->dist[i] = AA_EDT_FAR;
+        else if (a < 1.0) e->dist[i] = edge_distance(e->gx[i], e->gy[i], a);
+        else e->dist[i] = 0.0;
+    }
+    int changed;
+    do {
+        changed = 0;
+        for (int y = 1; y < h; ++y) { // Desde arriba e izquierda, luego desde la derecha
+            for (int x = 0; x < w; ++x) {
+                int i = y * w + x;
+                if (e->dist[i] <= 0.0) continue;
+                if (x > 0) changed |= aa_try_neighbor(e, i, i - 1, 1, 0);
+                if (x > 0) changed |= aa_try_neighbor(e, i, i - w - 1, 1, 1);
+                changed |= aa_try_neighbor(e, i, i - w, 0, 1);
+                if (x < w - 1) changed |= aa_try_neighbor(e, i, i - w + 1, -1, 1);
+            }
+            for (int x = w - 2; x >= 0; --x) {
+                int i = y * w + x;
+                if (e->dist[i] > 0.0) changed |= aa_try_neighbor(e, i, i + 1, -1, 0);
+            }
+        }
+        for (int y = h - 2; y >= 0; --y) { // Desde abajo y derecha, luego desde la izquierda
+            for (int x = w - 1; x >= 0; --x) {
+                int i = y * w + x;
+                if (e->dist[i] <= 0.0) continue;
+                if (x < w - 1) changed |= aa_try_neighbor(e, i, i + 1, -1, 0);
+                if (x < w - 1) changed |= aa_try_neighbor(e, i, i + w + 1, -1, -1);
+                changed |= aa_try_neighbor(e, i, i + w, 0, -1);
+                if (x > 0) changed |= aa_try_neighbor(e, i, i + w - 1, 1, -1);
+            }
+            for (int x = 1; x < w; ++x) {
+                int i = y * w + x;
+                if (e->dist[i] > 0.0) changed |= aa_try_neighbor(e, i, i - 1, 1, 0);
+            }
+        }
+    } while (changed);
+}
+
+// Buffers de trabajo del EDT antialiasado; crecen y se reutilizan entre glifos
+// (en el lote, uno por hilo)
+typedef struct {
+    double* img;
+    double* gx;
+    double* gy;
+    double* outside;
+    double* inside;
+    short* distx;
+    short* disty;
+    size_t capacity; // En píxeles
+} CoverageScratch;
+
+static void free_coverage_scratch(CoverageScratch* s) {
+    free(s->img);
+    free(s->gx);
+    free(s->gy);
+    free(s->outside);
+    free(s->inside);
+    free(s->distx);
+    free(s->disty);
+    memset(s, 0, sizeof(*s));
+}
+
+static int reserve_coverage_scratch(CoverageScratch* s, size_t n) {
+    if (n <= s->capacity) return 0;
+    free_coverage_scratch(s);
+    s->img = (double*)malloc(n * sizeof(double));
+    s->gx = (double*)malloc(n * sizeof(double));
+    s->gy = (double*)malloc(n * sizeof(double));
+    s->outside = (double*)malloc(n * sizeof(double));
+    s->inside = (double*)malloc(n * sizeof(double));
+    s->distx = (short*)malloc(n * sizeof(short));
+    s->disty = (short*)malloc(n * sizeof(short));
+    if (!s->img || !s->gx || !s->gy || !s->outside || !s->inside || !s->distx || !s->disty) {
+        free_coverage_scratch(s);
+        return -1;
+    }
+    s->capacity = n;
+    return 0;
+}
+
+// SDF de (width + 2 * padding) x (height + 2 * padding) escrito en dst, con
+// dst_stride bytes por fila. El scratch debe tener sitio para ese tamaño.
+static void coverage_sdf_into(CoverageScratch* s, const unsigned char* coverage_buffer, int width, int height,
+                              int pitch, int padding, float spread, unsigned char* dst, int dst_stride) {
+    int sdf_w = width + 2 * padding;
+    int sdf_h = height + 2 * padding;
+    size_t n = (size_t)sdf_w * sdf_h;
+    double* img = s->img;
+    double* gx = s->gx;
+    double* gy = s->gy;
+
+    // 1. Cobertura en [0, 1] con el padding (exterior) alrededor
+    memset(img, 0, n * sizeof(double));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            img[(y + padding) * sdf_w + x + padding] = coverage_buffer[y * pitch + x] / 255.0;
+        }
+    }
+
+    // 2. Distancia desde fuera hasta la forma, y desde dentro hasta el fondo
+    //    (cobertura invertida, gradiente opuesto)
+    compute_coverage_gradient(img, sdf_w, sdf_h, gx, gy);
+    AaEdt edt = { img, gx, gy, s->distx, s->disty, s->outside, sdf_w, sdf_h, (double)spread + 1.0 };
+    propagate_distances_aa(&edt);
+    for (size_t i = 0; i < n; ++i) {
+        img[i] = 1.0 - img[i];
+        gx[i] = -gx[i];
+        gy[i] = -gy[i];
+    }
+    edt.dist = s->inside;
+    propagate_distances_aa(&edt);
+
+    // 3. Distancia con signo (exterior positivo) y normalización
+    for (int y = 0; y < sdf_h; ++y) {
+        const double* outside = s->outside + (size_t)y * sdf_w;
+        const double* inside = s->inside + (size_t)y * sdf_w;
+        unsigned char* row = dst + (size_t)y * dst_stride;
+        for (int x = 0; x < sdf_w; ++x) {
+            double d_out = outside[x] > 0.0 ? outside[x] : 0.0;
+            double d_in = inside[x] > 0.0 ? inside[x] : 0.0;
+            row[x] = normalize_distance((float)(d_out - d_in), spread);
+        }
+    }
+}
+
+unsigned char* generate_sdf_from_coverage(
+    const unsigned char* coverage_buffer,
+    int width,
+    int height,
+    int pitch,
+    int padding,
+    float spread,
+    int* out_sdf_width,
+    int* out_sdf_height) {
+    TRACE_SCOPE("generate_sdf_from_coverage");
+    if (out_sdf_width) *out_sdf_width = 0;
+    if (out_sdf_height) *out_sdf_height = 0;
+    if (!coverage_buffer || width <= 0 || height <= 0 || padding < 0 || spread <= 0.0f) return NULL;
+
+    int sdf_w = width + 2 * padding;
+    int sdf_h = height + 2 * padding;
+    size_t n = (size_t)sdf_w * sdf_h;
+
+    CoverageScratch scratch = {0};
+    unsigned char* sdf_output_buffer = (unsigned char*)malloc(n);
+    if (!sdf_output_buffer || reserve_coverage_scratch(&scratch, n) != 0) {
+        fprintf(stderr, "ERROR::SDF_GENERATOR::COVERAGE: Malloc falló (%dx%d).\n", sdf_w, sdf_h);
+        free(sdf_output_buffer);
+        return NULL;
+    }
+    coverage_sdf_into(&scratch, coverage_buffer, width, height, pitch, padding, spread, sdf_output_buffer, sdf_w);
+    free_coverage_scratch(&scratch);
+    if (out_sdf_width) *out_sdf_width = sdf_w;
+    if (out_sdf_height) *out_sdf_height = sdf_h;
+    return sdf_output_buffer;
+}
+
+// --- Lote de glifos sobre una página de atlas. Los hilos toman el siguiente
+// glifo de un contador compartido (los glifos grandes no dejan a un hilo con
+// todo el trabajo) y escriben directamente en su rectángulo: como no se
+// solapan, no hace falta más sincronización. ---
+
+typedef struct {
+    const SdfBatchGlyph* glyphs;
+    int count;
+    float spread;
+    unsigned char* page;
+    int page_width, page_height, page_stride;
+    unsigned char* written; // 1 por glifo escrito
+    int next;               // Siguiente glifo libre (bajo `lock`)
+    pthread_mutex_t lock;
+} SdfBatchJob;
+
+static int batch_glyph_fits(const SdfBatchJob* job, const SdfBatchGlyph* g) {
+    if (!g->coverage || g->width <= 0 || g->height <= 0 || g->padding < 0) return 0;
+    return g->dst_x >= 0 && g->dst_y >= 0 && g->dst_x + g->width + 2 * g->padding <= job->page_width &&
+           g->dst_y + g->height + 2 * g->padding <= job->page_height;
+}
+
+static void* sdf_batch_worker(void* arg) {
+    SdfBatchJob* job = (SdfBatchJob*)arg;
+    CoverageScratch scratch = {0};
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        int i = job->next++;
+        pthread_mutex_unlock(&job->lock);
+        if (i >= job->count) break;
+
+        const SdfBatchGlyph* g = &job->glyphs[i];
+        if (!batch_glyph_fits(job, g)) continue;
+        size_t n = (size_t)(g->width + 2 * g->padding) * (g->height + 2 * g->padding);
+        if (reserve_coverage_scratch(&scratch, n) != 0) continue;
+        unsigned char* dst = job->page + (size_t)g->dst_y * job->page_stride + g->dst_x;
+        coverage_sdf_into(&scratch, g->coverage, g->width, g->height, g->pitch, g->padding, job->spread, dst,
+                          job->page_stride);
+        job->written[i] = 1;
+    }
+    free_coverage_scratch(&scratch);
+    return NULL;
+}
+
+int generate_sdf_batch_into_page(
+    const SdfBatchGlyph* glyphs,
+    int count,
+    float spread,
+    unsigned char* page,
+    int page_width,
+    int page_height,
+    int page_stride,
+    int thread_count,
+    SdfPageRegion* out_dirty) {
+    TRACE_SCOPE("generate_sdf_batch_into_page");
+    if (out_dirty) memset(out_dirty, 0, sizeof(*out_dirty));
+    if (!glyphs || count < 0 || !page || page_width <= 0 || page_height <= 0 || page_stride < page_width ||
+        spread <= 0.0f) {
+        return -1;
+    }
+    if (count == 0) return 0;
+
+    SdfBatchJob job = { .glyphs = glyphs, .count = count, .spread = spread, .page = page, .page_width = page_width,
+                        .page_height = page_height, .page_stride = page_stride };
+    job.written = (unsigned char*)calloc((size_t)count, 1);
+    if (!job.written) {
+        fprintf(stderr, "ERROR::SDF_GENERATOR::BATCH: Malloc falló (%d glifos).\n", count);
+        return -1;
+    }
+    pthread_mutex_init(&job.lock, NULL);
+
+    if (thread_count <= 0) thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (thread_count > count) thread_count = count;
+    if (thread_count < 1) thread_count = 1;
+    pthread_t* threads = thread_count > 1 ? (pthread_t*)calloc((size_t)thread_count - 1, sizeof(pthread_t)) : NULL;
+    int started = 0;
+    for (int t = 0; threads && t < thread_count - 1; ++t) {
+        if (pthread_create(&threads[t], NULL, sdf_batch_worker, &job) != 0) break;
+        started++;
+    }
+    sdf_batch_worker(&job); // El hilo que llama también trabaja (y termina el lote si no arrancó ninguno)
+    for (int t = 0; t < started; ++t) pthread_join(threads[t], NULL);
+    free(threads);
+    pthread_mutex_destroy(&job.lock);
+
+    // Región sucia: la unión de los rectángulos escritos
+    int failed = 0, x0 = page_width, y0 = page_height, x1 = 0, y1 = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!job.written[i]) {
+            failed++;
+            continue;
+        }
+        const SdfBatchGlyph* g = &glyphs[i];
+        int gx1 = g->dst_x + g->width + 2 * g->padding, gy1 = g->dst_y + g->height + 2 * g->padding;
+        x0 = g->dst_x < x0 ? g->dst_x : x0;
+        y0 = g->dst_y < y0 ? g->dst_y : y0;
+        x1 = gx1 > x1 ? gx1 : x1;
+        y1 = gy1 > y1 ? gy1 : y1;
+    }
+    if (out_dirty && x1 > x0 && y1 > y0) {
+        out_dirty->x = x0;
+        out_dirty->y = y0;
+        out_dirty->width = x1 - x0;
+        out_dirty->height = y1 - y0;
+    }
+    free(job.written);
+    return failed;
+}
+
 // La función free_sdf_bitmap proporcionada sigue siendo válida
 void free_sdf_bitmap(unsigned char* sdf_data) {
     if (sdf_data) {
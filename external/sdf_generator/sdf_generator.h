@@ -20,6 +20,64 @@ unsigned char* generate_sdf_from_bitmap(
     int* out_sdf_height
 );
 
+// Same contract as generate_sdf_from_bitmap, but reads the 8-bit anti-aliased
+// coverage instead of thresholding it at 128: edge pixels place the contour
+// at sub-pixel precision (Gustavson's anti-aliased EDT), so a smaller render
+// size gives the same edge quality. Returns NULL (and 0x0) on failure.
+unsigned char* generate_sdf_from_coverage(
+    const unsigned char* coverage_buffer,
+    int width,
+    int height,
+    int pitch,
+    int padding,
+    float spread,
+    int* out_sdf_width,
+    int* out_sdf_height
+);
+
+// One glyph of a batch: its coverage bitmap and the top-left corner of its
+// pre-packed rectangle in the atlas page. The rectangle is
+// (width + 2 * padding) x (height + 2 * padding), the same size that
+// generate_sdf_from_coverage would return.
+typedef struct {
+    const unsigned char* coverage;
+    int width;
+    int height;
+    int pitch;
+    int padding;
+    int dst_x;
+    int dst_y;
+} SdfBatchGlyph;
+
+typedef struct {
+    int x, y, width, height;
+} SdfPageRegion;
+
+// Generates the anti-aliased EDT SDF (as generate_sdf_from_coverage) of every
+// glyph straight into its rectangle of `page` (8-bit, page_stride bytes per
+// row), spread over thread_count threads (<= 0: one per CPU). Rectangles must
+// not overlap; texels outside them are left untouched. There is no per-glyph
+// output buffer: the page can go to the GPU with a single glTexSubImage2D of
+// *out_dirty, the bounding box of the rectangles written (0x0 if none).
+// Returns the number of glyphs skipped (empty bitmap, rectangle outside the
+// page, out of memory), or -1 if the page or the arguments are invalid.
+//
+// Groundwork for a glyph atlas. Nothing outside the tests and the bench calls
+// this yet: glyph_manager still generates one SDF and one texture per glyph,
+// and doing the per-page glTexSubImage2D upload needs atlas UVs in GlyphInfo
+// and in the shaders first.
+int generate_sdf_batch_into_page(
+    const SdfBatchGlyph* glyphs,
+    int count,
+    float spread,
+    unsigned char* page,
+    int page_width,
+    int page_height,
+    int page_stride,
+    int thread_count,
+    SdfPageRegion* out_dirty
+);
+
 void free_sdf_bitmap(unsigned char* sdf_data);
 
 #endif // SDF_GENERATOR_H
@@ -0,0 +1,14 @@
+#version 330 core
+
+in vec3 vNormal;
+out vec4 FragColor;
+
+uniform vec3 textColor;
+
+const vec3 lightDir = normalize(vec3(-0.4, 0.6, 1.0)); // Hacia la luz, en espacio de vista
+const float ambient = 0.35;
+
+void main() {
+    float diffuse = max(dot(normalize(vNormal), lightDir), 0.0);
+    FragColor = vec4(textColor * (ambient + (1.0 - ambient) * diffuse), 1.0);
+}
@@ -0,0 +1,17 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;    // Vértice extruido, en píxeles de la fuente (origen = pen)
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aOffset; // Posición del pen en mundo (una por instancia)
+
+uniform mat4 view;        // Rotación de la escena (sin escala)
+uniform float glyphScale; // Píxeles de la fuente -> mundo
+
+out vec3 vNormal;
+
+void main() {
+    vec4 world = view * vec4(aOffset + aPos.xy * glyphScale, aPos.z * glyphScale, 1.0);
+    // Ortográfica con z invertida, como glOrtho(-1, 1, -1, 1, -2, 2)
+    gl_Position = vec4(world.xy, -world.z * 0.5, 1.0);
+    vNormal = mat3(view) * aNormal;
+}
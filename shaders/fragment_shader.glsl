@@ -4,7 +4,8 @@ in vec2 TexCoords; // Coordenadas de textura del vertex shader
 
 out vec4 FragColor;
 
-uniform sampler2D sdfTexture;   // Tu textura SDF (monocanal, GL_R8)
+uniform sampler2D sdfTexture;   // Tu textura SDF (monocanal, GL_R8; GL_RGB8 si msdfMode)
+uniform bool msdfMode;          // MSDF: la distancia es la mediana de los tres canales
 uniform vec3 textColor;           // Color base del texto
 uniform float sdfEdgeValue;       // El valor en la textura que representa el contorno (ej. 0.5)
 uniform float smoothingFactor;    // Factor para controlar el suavizado del borde
@@ -20,8 +21,17 @@ uniform vec4 shadowColor;         // << CORREGIDO AQUÍ: de vec3 a vec4
 // uniform vec2 shadowOffsetScreen; // Si decides usarlo, necesitarás convertirlo a UV
 uniform float shadowSoftnessSDF;   // Suavizado de la sombra en unidades SDF
 
+float median(float r, float g, float b) {
+    return max(min(r, g), min(max(r, g), b));
+}
+
+float sampleDistance(vec2 uv) {
+    vec3 s = texture(sdfTexture, uv).rgb;
+    return msdfMode ? median(s.r, s.g, s.b) : s.r;
+}
+
 void main() {
-    float originalDistanceSample = texture(sdfTexture, TexCoords).r;
+    float originalDistanceSample = sampleDistance(TexCoords);
     float distanceSample = 1.0 - originalDistanceSample; // <---- INVERTIR AQUÍ    // --- Opción A: Para usar con fwidth (la que tenías que daba glifos negros sobre amarillo) ---
     float screenPixelRange = fwidth(distanceSample);
     float antialiasWidth = screenPixelRange * smoothingFactor;
@@ -62,7 +72,7 @@ void main() {
         // Podrías hacerlo un uniform vec2 shadowOffsetUV si quieres controlarlo desde C.
         vec2 shadowOffsetUV = vec2(0.003, -0.003); 
         
-        float shadowDistanceSample = texture(sdfTexture, TexCoords - shadowOffsetUV).r;
+        float shadowDistanceSample = sampleDistance(TexCoords - shadowOffsetUV);
         
         float shadowAntialiasWidth = screenPixelRange * shadowSoftnessSDF;
         float calculatedShadowAlpha = smoothstep(sdfEdgeValue - shadowAntialiasWidth, 
@@ -0,0 +1,10 @@
+#version 330 core
+
+// Ruta vectorial: el antialiasing lo da el MSAA del framebuffer.
+out vec4 FragColor;
+
+uniform vec3 textColor;
+
+void main() {
+    FragColor = vec4(textColor, 1.0);
+}
@@ -0,0 +1,9 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos; // Vértice de la malla (origen = pen), en unidades de la arena (ver glyph_mesh.h)
+
+uniform mat4 transform; // Escala unidades->NDC y traslación a la posición del pen
+
+void main() {
+   gl_Position = transform * vec4(aPos, 0.0, 1.0);
+}
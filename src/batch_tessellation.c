@@ -0,0 +1,243 @@
+#define _GNU_SOURCE // sysconf(_SC_NPROCESSORS_ONLN)
+#include "batch_tessellation.h"
+#include "freetype_handler.h" // OutlineDataC, extractOutline
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define BATCH_MAX_THREADS 64
+#define BATCH_CHUNK_GLYPHS 16 // Codepoints que toma un hilo de una vez
+
+// Salida local de un hilo; se copia al blob final tras el join
+typedef struct {
+    TESSreal* vertices;
+    int vertexCount, vertexCapacity;
+    TESSindex* indices;
+    int indexCount, indexCapacity;
+} WorkerBlob;
+
+typedef struct {
+    const char* fontPath;
+    FT_ULong firstCodepoint;
+    size_t glyphCount;
+    int pixelSize;
+    float flatnessTolerance;
+    size_t nextGlyph;          // Contador atómico de reparto
+    GlyphMeshEntry* entries;   // Offsets locales al blob del hilo hasta el empaquetado
+    unsigned char* owner;      // Hilo que teseló cada entrada
+    int failed;
+} BatchJob;
+
+typedef struct {
+    BatchJob* job;
+    int id;
+    WorkerBlob blob;
+} BatchWorker;
+
+static int appendToBlob(WorkerBlob* blob, const GlyphMeshBuffer* mesh) {
+    if (blob->vertexCount + mesh->vertexCount > blob->vertexCapacity) {
+        int capacity = blob->vertexCapacity ? blob->vertexCapacity : 4096;
+        while (capacity < blob->vertexCount + mesh->vertexCount) capacity *= 2;
+        TESSreal* v = (TESSreal*)realloc(blob->vertices, (size_t)capacity * 2 * sizeof(TESSreal));
+        if (!v) return -1;
+        blob->vertices = v;
+        blob->vertexCapacity = capacity;
+    }
+    if (blob->indexCount + mesh->indexCount > blob->indexCapacity) {
+        int capacity = blob->indexCapacity ? blob->indexCapacity : 8192;
+        while (capacity < blob->indexCount + mesh->indexCount) capacity *= 2;
+        TESSindex* i = (TESSindex*)realloc(blob->indices, (size_t)capacity * sizeof(TESSindex));
+        if (!i) return -1;
+        blob->indices = i;
+        blob->indexCapacity = capacity;
+    }
+    memcpy(blob->vertices + (size_t)blob->vertexCount * 2, mesh->vertices, (size_t)mesh->vertexCount * 2 * sizeof(TESSreal));
+    memcpy(blob->indices + blob->indexCount, mesh->indices, (size_t)mesh->indexCount * sizeof(TESSindex));
+    blob->vertexCount += mesh->vertexCount;
+    blob->indexCount += mesh->indexCount;
+    return 0;
+}
+
+static void* batchWorkerMain(void* arg) {
+    BatchWorker* worker = (BatchWorker*)arg;
+    BatchJob* job = worker->job;
+    TRACE_SCOPE("batchWorkerMain");
+
+    FT_Library library = NULL;
+    FT_Face face = NULL;
+    OutlineDataC outline = {0};
+    TessellationContext tessContext = {0};
+    GlyphMeshBuffer mesh = {0};
+    int ok = 0;
+
+    if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, job->fontPath, 0, &face) != 0 ||
+        FT_Set_Pixel_Sizes(face, 0, (FT_UInt)job->pixelSize) != 0) {
+        fprintf(stderr, "ERROR::BATCH_TESSELLATION::WORKER: El hilo %d no pudo abrir '%s'.\n", worker->id, job->fontPath);
+        goto done;
+    }
+    if (initOutlineData(&outline, 8) != 0 || initTessellationContext(&tessContext, 0) != 0) goto done;
+    outline.flatnessTolerance = job->flatnessTolerance;
+
+    for (;;) {
+        size_t begin = __atomic_fetch_add(&job->nextGlyph, BATCH_CHUNK_GLYPHS, __ATOMIC_RELAXED);
+        if (begin >= job->glyphCount || __atomic_load_n(&job->failed, __ATOMIC_RELAXED)) break;
+        size_t end = begin + BATCH_CHUNK_GLYPHS < job->glyphCount ? begin + BATCH_CHUNK_GLYPHS : job->glyphCount;
+
+        for (size_t g = begin; g < end; ++g) {
+            GlyphMeshEntry* entry = &job->entries[g];
+            entry->codepoint = job->firstCodepoint + g;
+            job->owner[g] = (unsigned char)worker->id;
+
+            FT_UInt glyphIndex = FT_Get_Char_Index(face, entry->codepoint);
+            if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_BITMAP) != 0) continue;
+            entry->advanceX = (float)face->glyph->advance.x / 64.0f;
+            if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE || face->glyph->outline.n_contours == 0) continue;
+
+            resetOutlineData(&outline);
+            if (extractOutline(&face->glyph->outline, &outline) != 0) continue;
+
+            int status = tessellateOutlineInto(&tessContext, &outline, &mesh);
+            if (status == TESS_CONTEXT_BUFFER_TOO_SMALL) {
+                // Crece el buffer de trabajo y repite (solo ocurre las primeras veces)
+                TESSreal* v = (TESSreal*)realloc(mesh.vertices, (size_t)mesh.vertexCount * 2 * sizeof(TESSreal));
+                TESSindex* i = v ? (TESSindex*)realloc(mesh.indices, (size_t)mesh.indexCount * sizeof(TESSindex)) : NULL;
+                if (v) { mesh.vertices = v; mesh.vertexCapacity = mesh.vertexCount; }
+                if (i) { mesh.indices = i; mesh.indexCapacity = mesh.indexCount; }
+                if (!v || !i) goto done;
+                status = tessellateOutlineInto(&tessContext, &outline, &mesh);
+            }
+            if (status != TESS_CONTEXT_OK || mesh.indexCount == 0) continue;
+
+            entry->vertexOffset = worker->blob.vertexCount;
+            entry->indexOffset = worker->blob.indexCount;
+            if (appendToBlob(&worker->blob, &mesh) != 0) {
+                fprintf(stderr, "ERROR::BATCH_TESSELLATION::WORKER: Realloc falló en el hilo %d.\n", worker->id);
+                goto done;
+            }
+            entry->vertexCount = mesh.vertexCount;
+            entry->indexCount = mesh.indexCount;
+        }
+    }
+    ok = 1;
+
+done:
+    if (!ok) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    free(mesh.vertices);
+    free(mesh.indices);
+    freeTessellationContext(&tessContext);
+    freeOutlineData(&outline);
+    if (face) FT_Done_Face(face);
+    if (library) FT_Done_FreeType(library);
+    return NULL;
+}
+
+int batchTessellateRange(const char* fontPath, FT_ULong firstCodepoint, FT_ULong lastCodepoint,
+                         int pixelSize, float flatnessTolerance, int threadCount, GlyphMeshBatch* out) {
+    TRACE_SCOPE("batchTessellateRange");
+    if (!fontPath || !out || lastCodepoint < firstCodepoint || pixelSize <= 0) {
+        fprintf(stderr, "ERROR::BATCH_TESSELLATION::RANGE: Parámetros inválidos.\n");
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+
+    if (threadCount <= 0) threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > BATCH_MAX_THREADS) threadCount = BATCH_MAX_THREADS;
+
+    BatchJob job = {0};
+    job.fontPath = fontPath;
+    job.firstCodepoint = firstCodepoint;
+    job.glyphCount = (size_t)(lastCodepoint - firstCodepoint) + 1;
+    job.pixelSize = pixelSize;
+    job.flatnessTolerance = flatnessTolerance;
+    job.entries = (GlyphMeshEntry*)calloc(job.glyphCount, sizeof(GlyphMeshEntry));
+    job.owner = (unsigned char*)calloc(job.glyphCount, 1);
+    BatchWorker* workers = (BatchWorker*)calloc((size_t)threadCount, sizeof(BatchWorker));
+    pthread_t* threads = (pthread_t*)calloc((size_t)threadCount, sizeof(pthread_t));
+    if (!job.entries || !job.owner || !workers || !threads) {
+        fprintf(stderr, "ERROR::BATCH_TESSELLATION::RANGE: Calloc falló.\n");
+        free(job.entries); free(job.owner); free(workers); free(threads);
+        return -1;
+    }
+
+    int started = 0;
+    for (int t = 0; t < threadCount; ++t) {
+        workers[t].job = &job;
+        workers[t].id = t;
+        if (pthread_create(&threads[t], NULL, batchWorkerMain, &workers[t]) != 0) break;
+        started++;
+    }
+    if (started == 0) { // Sin hilos: se hace en el llamador
+        batchWorkerMain(&workers[0]);
+        started = 1;
+    } else {
+        for (int t = 0; t < started; ++t) pthread_join(threads[t], NULL);
+    }
+
+    // Empaquetado en orden de codepoint: el blob final no depende del reparto
+    int totalVertices = 0, totalIndices = 0;
+    for (int t = 0; t < started; ++t) {
+        totalVertices += workers[t].blob.vertexCount;
+        totalIndices += workers[t].blob.indexCount;
+    }
+    int status = job.failed ? -1 : 0;
+    if (status == 0) {
+        out->vertices = (TESSreal*)malloc((size_t)(totalVertices ? totalVertices : 1) * 2 * sizeof(TESSreal));
+        out->indices = (TESSindex*)malloc((size_t)(totalIndices ? totalIndices : 1) * sizeof(TESSindex));
+        if (!out->vertices || !out->indices) status = -1;
+    }
+    if (status == 0) {
+        for (size_t g = 0; g < job.glyphCount; ++g) {
+            GlyphMeshEntry* entry = &job.entries[g];
+            const WorkerBlob* blob = &workers[job.owner[g]].blob;
+            int localVertex = entry->vertexOffset, localIndex = entry->indexOffset;
+            entry->vertexOffset = out->vertexCount;
+            entry->indexOffset = out->indexCount;
+            if (entry->indexCount == 0) continue;
+            memcpy(out->vertices + (size_t)out->vertexCount * 2, blob->vertices + (size_t)localVertex * 2,
+                   (size_t)entry->vertexCount * 2 * sizeof(TESSreal));
+            memcpy(out->indices + out->indexCount, blob->indices + localIndex,
+                   (size_t)entry->indexCount * sizeof(TESSindex));
+            out->vertexCount += entry->vertexCount;
+            out->indexCount += entry->indexCount;
+        }
+        out->entries = job.entries;
+        out->entryCount = job.glyphCount;
+        out->firstCodepoint = firstCodepoint;
+        out->pixelSize = pixelSize;
+        out->flatnessTolerance = flatnessTolerance;
+        job.entries = NULL;
+    } else {
+        fprintf(stderr, "ERROR::BATCH_TESSELLATION::RANGE: Falló la teselación del rango U+%04lX..U+%04lX.\n",
+                firstCodepoint, lastCodepoint);
+        freeGlyphMeshBatch(out);
+    }
+
+    for (int t = 0; t < started; ++t) {
+        free(workers[t].blob.vertices);
+        free(workers[t].blob.indices);
+    }
+    free(job.entries);
+    free(job.owner);
+    free(workers);
+    free(threads);
+    return status;
+}
+
+void freeGlyphMeshBatch(GlyphMeshBatch* batch) {
+    if (!batch) return;
+    free(batch->vertices);
+    free(batch->indices);
+    free(batch->entries);
+    memset(batch, 0, sizeof(*batch));
+}
+
+const GlyphMeshEntry* findBatchGlyphMesh(const GlyphMeshBatch* batch, FT_ULong codepoint) {
+    if (!batch || !batch->entries || codepoint < batch->firstCodepoint) return NULL;
+    size_t index = (size_t)(codepoint - batch->firstCodepoint);
+    return index < batch->entryCount ? &batch->entries[index] : NULL;
+}
@@ -0,0 +1,42 @@
+#ifndef BATCH_TESSELLATION_H
+#define BATCH_TESSELLATION_H
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "tessellation_handler.h"
+
+// Teselación de un rango de codepoints en varios hilos. Cada hilo abre su
+// propio FT_Library/FT_Face (FreeType no es thread-safe por cara) y usa su
+// propio TessellationContext. Al final todo se empaqueta en un único blob de
+// vértices/índices, en orden de codepoint, con una tabla de offsets por glifo.
+
+typedef struct {
+    FT_ULong codepoint;
+    int vertexOffset;   // En vértices dentro de GlyphMeshBatch.vertices
+    int vertexCount;    // 0 = el glifo no existe o no tiene contorno
+    int indexOffset;    // En índices dentro de GlyphMeshBatch.indices
+    int indexCount;     // Índices locales al glifo (usar vertexOffset como base)
+    float advanceX;     // Píxeles al tamaño de teselación
+} GlyphMeshEntry;
+
+typedef struct {
+    TESSreal* vertices;      // x, y por vértice
+    TESSindex* indices;
+    int vertexCount;
+    int indexCount;
+    GlyphMeshEntry* entries; // Una por codepoint del rango, en orden
+    size_t entryCount;
+    FT_ULong firstCodepoint;
+    int pixelSize;
+    float flatnessTolerance;
+} GlyphMeshBatch;
+
+// threadCount <= 0 usa el número de CPUs. Devuelve 0 si todo fue bien.
+int batchTessellateRange(const char* fontPath, FT_ULong firstCodepoint, FT_ULong lastCodepoint,
+                         int pixelSize, float flatnessTolerance, int threadCount, GlyphMeshBatch* out);
+void freeGlyphMeshBatch(GlyphMeshBatch* batch);
+
+// NULL si el codepoint está fuera del rango
+const GlyphMeshEntry* findBatchGlyphMesh(const GlyphMeshBatch* batch, FT_ULong codepoint);
+
+#endif // BATCH_TESSELLATION_H
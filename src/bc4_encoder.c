@@ -0,0 +1,230 @@
+#include "bc4_encoder.h"
+#include "trace.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+int bc4SimdEnabled = 1;
+
+size_t bc4CompressedSize(int width, int height) {
+    if (width <= 0 || height <= 0) return 0;
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * BC4_BLOCK_BYTES;
+}
+
+// Paleta que reconstruye el decodificador (redondeo al más cercano, como la
+// mayoría del hardware; alguno trunca, con diferencias de 1)
+static void buildPalette(int e0, int e1, unsigned char palette[8]) {
+    palette[0] = (unsigned char)e0;
+    palette[1] = (unsigned char)e1;
+    if (e0 > e1) {
+        for (int i = 1; i <= 6; ++i) palette[i + 1] = (unsigned char)(((7 - i) * e0 + i * e1 + 3) / 7);
+    } else {
+        for (int i = 1; i <= 4; ++i) palette[i + 1] = (unsigned char)(((5 - i) * e0 + i * e1 + 2) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+// Índice de la entrada más cercana de la paleta para cada texel (la primera
+// en caso de empate) y suma de errores al cuadrado
+static unsigned int nearestIndicesScalar(const unsigned char texels[16], const unsigned char palette[8],
+                                         unsigned char indices[16]) {
+    unsigned int error = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 256, bestIndex = 0;
+        for (int k = 0; k < 8; ++k) {
+            int d = texels[i] > palette[k] ? texels[i] - palette[k] : palette[k] - texels[i];
+            if (d < best) {
+                best = d;
+                bestIndex = k;
+            }
+        }
+        indices[i] = (unsigned char)bestIndex;
+        error += (unsigned int)(best * best);
+    }
+    return error;
+}
+
+#ifdef __SSE2__
+static unsigned int nearestIndicesSse2(const unsigned char texels[16], const unsigned char palette[8],
+                                       unsigned char indices[16]) {
+    __m128i px = _mm_loadu_si128((const __m128i*)texels);
+    __m128i entry = _mm_set1_epi8((char)palette[0]);
+    __m128i best = _mm_or_si128(_mm_subs_epu8(px, entry), _mm_subs_epu8(entry, px)); // |px - entry|
+    __m128i bestIndex = _mm_setzero_si128();
+    __m128i ones = _mm_set1_epi8((char)0xFF);
+    for (int k = 1; k < 8; ++k) {
+        entry = _mm_set1_epi8((char)palette[k]);
+        __m128i d = _mm_or_si128(_mm_subs_epu8(px, entry), _mm_subs_epu8(entry, px));
+        // d < best (estricto, para quedarse con la primera en un empate): max(d, best) != d
+        __m128i less = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_max_epu8(d, best), d), ones);
+        best = _mm_min_epu8(best, d);
+        bestIndex = _mm_or_si128(_mm_andnot_si128(less, bestIndex), _mm_and_si128(less, _mm_set1_epi8((char)k)));
+    }
+    _mm_storeu_si128((__m128i*)indices, bestIndex);
+
+    // Suma de cuadrados: a 16 bits y madd (d * d + d * d por par) a 32 bits
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(best, zero), hi = _mm_unpackhi_epi8(best, zero);
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (unsigned int)_mm_cvtsi128_si32(sum);
+}
+#endif
+
+static unsigned int nearestIndices(const unsigned char texels[16], const unsigned char palette[8],
+                                   unsigned char indices[16]) {
+#ifdef __SSE2__
+    if (bc4SimdEnabled) return nearestIndicesSse2(texels, palette, indices);
+#endif
+    return nearestIndicesScalar(texels, palette, indices);
+}
+
+static void writeBlock(int e0, int e1, const unsigned char indices[16], unsigned char out[BC4_BLOCK_BYTES]) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; ++i) bits |= (uint64_t)(indices[i] & 7) << (3 * i);
+    out[0] = (unsigned char)e0;
+    out[1] = (unsigned char)e1;
+    for (int i = 0; i < 6; ++i) out[2 + i] = (unsigned char)(bits >> (8 * i));
+}
+
+// Ajusta e0/e1 por mínimos cuadrados a los índices elegidos (cada índice es
+// un peso t fijo entre e0 y e1) y reasigna una vez; se queda con el
+// resultado si baja el error. En los SDF la rampa del borde casi nunca
+// empieza y acaba justo en el mínimo y el máximo del bloque.
+static void refineEndpoints(const unsigned char texels[16], int* e0, int* e1, unsigned char indices[16],
+                            unsigned int* error) {
+    int eightValues = *e0 > *e1;
+    float a = 0.0f, b = 0.0f, c = 0.0f, x = 0.0f, y = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        int k = indices[i];
+        float t;
+        if (k <= 1) {
+            t = (float)k;
+        } else if (eightValues) {
+            t = (float)(k - 1) / 7.0f;
+        } else if (k <= 5) {
+            t = (float)(k - 1) / 5.0f;
+        } else {
+            continue; // 0 y 255 exactos: no dependen de los extremos
+        }
+        float v = (float)texels[i];
+        a += (1.0f - t) * (1.0f - t);
+        b += t * (1.0f - t);
+        c += t * t;
+        x += (1.0f - t) * v;
+        y += t * v;
+    }
+    float det = a * c - b * b;
+    if (fabsf(det) < 1e-6f) return;
+    int n0 = (int)lroundf((x * c - y * b) / det), n1 = (int)lroundf((a * y - b * x) / det);
+    n0 = n0 < 0 ? 0 : (n0 > 255 ? 255 : n0);
+    n1 = n1 < 0 ? 0 : (n1 > 255 ? 255 : n1);
+    if ((n0 > n1) != eightValues || (n0 == *e0 && n1 == *e1)) return; // Cambiaría de modo, o ya está
+
+    unsigned char palette[8], candidate[16];
+    buildPalette(n0, n1, palette);
+    unsigned int candidateError = nearestIndices(texels, palette, candidate);
+    if (candidateError >= *error) return;
+    *e0 = n0;
+    *e1 = n1;
+    *error = candidateError;
+    memcpy(indices, candidate, 16);
+}
+
+void bc4EncodeBlock(const unsigned char texels[16], unsigned char out[BC4_BLOCK_BYTES]) {
+    int lo = 255, hi = 0;          // Rango del bloque
+    int innerLo = 255, innerHi = 0; // Rango sin los 0 y 255 (modo de 6 valores)
+    int hasExtremes = 0;
+    for (int i = 0; i < 16; ++i) {
+        int v = texels[i];
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+        if (v == 0 || v == 255) {
+            hasExtremes = 1;
+        } else {
+            innerLo = v < innerLo ? v : innerLo;
+            innerHi = v > innerHi ? v : innerHi;
+        }
+    }
+
+    unsigned char indices[16];
+    if (lo == hi) { // Bloque uniforme (el exterior saturado, casi siempre): exacto
+        memset(indices, 0, sizeof(indices));
+        writeBlock(lo, lo, indices, out);
+        return;
+    }
+
+    // Modo de 8 valores sobre todo el rango
+    unsigned char palette[8];
+    buildPalette(hi, lo, palette);
+    unsigned int error = nearestIndices(texels, palette, indices);
+    int e0 = hi, e1 = lo;
+    refineEndpoints(texels, &e0, &e1, indices, &error);
+
+    // Modo de 6 valores con 0/255 exactos: solo el resto ocupa la rampa
+    if (hasExtremes) {
+        if (innerLo > innerHi) innerLo = innerHi = 0; // Solo hay 0 y 255
+        unsigned char palette6[8], indices6[16];
+        buildPalette(innerLo, innerHi, palette6);
+        unsigned int error6 = nearestIndices(texels, palette6, indices6);
+        int e0Six = innerLo, e1Six = innerHi;
+        refineEndpoints(texels, &e0Six, &e1Six, indices6, &error6);
+        if (error6 < error) {
+            e0 = e0Six;
+            e1 = e1Six;
+            memcpy(indices, indices6, sizeof(indices));
+        }
+    }
+    writeBlock(e0, e1, indices, out);
+}
+
+void bc4DecodeBlock(const unsigned char in[BC4_BLOCK_BYTES], unsigned char texels[16]) {
+    unsigned char palette[8];
+    buildPalette(in[0], in[1], palette);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) bits |= (uint64_t)in[2 + i] << (8 * i);
+    for (int i = 0; i < 16; ++i) texels[i] = palette[(bits >> (3 * i)) & 7];
+}
+
+int bc4EncodeImage(const unsigned char* src, int width, int height, int stride, unsigned char* dst) {
+    TRACE_SCOPE("bc4EncodeImage");
+    if (!src || !dst || width <= 0 || height <= 0 || stride < width) return -1;
+    unsigned char block[16];
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            for (int y = 0; y < 4; ++y) {
+                const unsigned char* row = src + (size_t)(by + y < height ? by + y : height - 1) * stride;
+                if (bx + 4 <= width) {
+                    memcpy(block + 4 * y, row + bx, 4);
+                } else {
+                    for (int x = 0; x < 4; ++x) block[4 * y + x] = row[bx + x < width ? bx + x : width - 1];
+                }
+            }
+            bc4EncodeBlock(block, dst);
+            dst += BC4_BLOCK_BYTES;
+        }
+    }
+    return 0;
+}
+
+int bc4DecodeImage(const unsigned char* src, int width, int height, unsigned char* dst) {
+    if (!src || !dst || width <= 0 || height <= 0) return -1;
+    unsigned char block[16];
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            bc4DecodeBlock(src, block);
+            src += BC4_BLOCK_BYTES;
+            for (int y = 0; y < 4 && by + y < height; ++y) {
+                for (int x = 0; x < 4 && bx + x < width; ++x) dst[(size_t)(by + y) * width + bx + x] = block[4 * y + x];
+            }
+        }
+    }
+    return 0;
+}
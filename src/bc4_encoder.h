@@ -0,0 +1,36 @@
+#ifndef BC4_ENCODER_H
+#define BC4_ENCODER_H
+
+#include <stddef.h>
+
+// Compresor BC4 (RGTC1, GL_COMPRESSED_RED_RGTC1) de imágenes de un canal:
+// bloques de 4x4 texels en 8 bytes (2:1 frente a GL_R8). Cada bloque guarda
+// dos extremos e0/e1 y un índice de 3 bits por texel:
+//   - e0 > e1: 8 valores, e0, e1 y 6 interpolados;
+//   - e0 <= e1: 6 valores (e0, e1 y 4 interpolados) más 0 y 255 exactos.
+// El segundo modo encaja con los SDF, donde el exterior saturado (255) convive
+// en un mismo bloque con la rampa del borde.
+//
+// No depende de GL: sirve igual para la subida a la GPU que para guardar
+// SDF ya comprimidos en disco. Con SSE2 (x86-64) la búsqueda de índices va en
+// registros de 16 bytes, un bloque entero a la vez.
+
+#define BC4_BLOCK_BYTES 8
+
+extern int bc4SimdEnabled; // 0 = ruta escalar (las dos dan el mismo resultado)
+
+// Bytes de la imagen comprimida (bloques de 4x4, los del borde incompletos)
+size_t bc4CompressedSize(int width, int height);
+
+// texels: 16 valores en orden de filas
+void bc4EncodeBlock(const unsigned char texels[16], unsigned char out[BC4_BLOCK_BYTES]);
+void bc4DecodeBlock(const unsigned char in[BC4_BLOCK_BYTES], unsigned char texels[16]);
+
+// Comprime una imagen width x height (stride bytes por fila) en dst, que debe
+// tener bc4CompressedSize bytes. Los bloques del borde repiten el último
+// texel. Devuelve 0, o -1 si los parámetros no son válidos.
+int bc4EncodeImage(const unsigned char* src, int width, int height, int stride, unsigned char* dst);
+// Inversa (filas de width bytes sin relleno), para comprobar la calidad en CPU
+int bc4DecodeImage(const unsigned char* src, int width, int height, unsigned char* dst);
+
+#endif // BC4_ENCODER_H
@@ -7,4 +7,53 @@
 #define APP_TEXT_BUFFER_SIZE 1024
 #endif
 
+// Tamaño (px) al que se cargan los glifos para SDF y mallas
+#define GLYPH_LOAD_PIXEL_SIZE 48
+// Distancia (texels del SDF) que cubre el rango [0, 255]; el padding de cada
+// glifo se deriva de ella (sdfPaddingForSpread)
+#define SDF_SPREAD_TEXELS 2.0f
+// Tamaño de em (texels) de los SDF calculados desde el contorno (ver
+// outline_sdf.h). Con distancias exactas, 24-32 igualan al SDF de bitmap a 48.
+#define SDF_OUTLINE_PIXEL_SIZE 32
+// Tamaño de em (texels) de los MSDF (TEXT3D_MSDF=1). Las esquinas se
+// conservan con la mediana, así que basta menos resolución que para el SDF.
+#define MSDF_PIXEL_SIZE 20
+// Tamaño de render (px) de la ruta de bitmap con el EDT antialiasado
+// (generate_sdf_from_coverage). A 24 su error ya es menor que el del umbral a 48.
+#define SDF_COVERAGE_PIXEL_SIZE 24
+// Tamaño de render (px) de los backends de FreeType (FT_RENDER_MODE_SDF, sdf y bsdf)
+#define SDF_FREETYPE_PIXEL_SIZE 32
+// Niveles de SDF por glifo (tamaño de em en texels), generados bajo demanda.
+// El renderer elige el menor con al menos SDF_LEVEL_TEXELS_PER_SCREEN_PX
+// texels por píxel de pantalla (el SDF aguanta bien ampliarse x2).
+#define SDF_LEVEL_COUNT 3
+#define SDF_LEVEL_SIZES { 16, 32, 64 }
+#define SDF_LEVEL_TEXELS_PER_SCREEN_PX 0.5f
+
+// --- Ruta vectorial (mallas teseladas) para glifos grandes ---
+// Por encima de este tamaño de em en pantalla se dibujan mallas en lugar de
+// SDF. Se puede cambiar en ejecución con TEXT3D_VECTOR_MIN_PX.
+#define VECTOR_GLYPH_MIN_SCREEN_PX 160.0f
+// Error geométrico máximo (px de pantalla) al tamaño VECTOR_MESH_MAX_SCREEN_PX
+#define VECTOR_MESH_TOLERANCE_PX 0.25f
+#define VECTOR_MESH_MAX_SCREEN_PX 1024.0f
+// Capacidad de la arena VBO/IBO compartida
+#define VECTOR_MESH_ARENA_VERTICES (256 * 1024)
+#define VECTOR_MESH_ARENA_INDICES  (768 * 1024)
+// Posiciones de las mallas en int16, en 1/N de em (0 = float en px). Con 4096
+// el redondeo (1/8192 em) queda por debajo de VECTOR_MESH_TOLERANCE_PX.
+#define VECTOR_MESH_QUANTIZE_UNITS_PER_EM 4096
+
+// --- Texto extruido 3D (ver glyph_extrude.h) ---
+// Profundidad y bisel en px de la fuente al tamaño de construcción
+#define EXTRUDE_DEFAULT_DEPTH_PX 8.0f
+#define EXTRUDE_DEFAULT_BEVEL_PX 1.0f
+#define EXTRUDE_DEFAULT_BEVEL_STEPS 2
+#define EXTRUDE_MAX_BEVEL_STEPS 16
+// Ángulo máximo entre caras de pared que se sombrean suaves (grados)
+#define EXTRUDE_SMOOTH_ANGLE_DEG 30.0f
+// Capacidad de la arena VBO/IBO de mallas extruidas (x, y, z, nx, ny, nz)
+#define EXTRUDE_ARENA_VERTICES (512 * 1024)
+#define EXTRUDE_ARENA_INDICES  (1536 * 1024)
+
 #endif // CONFIG_H
@@ -0,0 +1,467 @@
+#include "ear_clipping.h"
+#include "freetype_handler.h" // OutlineDataC
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Recorte de orejas con puentes a los agujeros, en la línea de earcut
+// (Mapbox): anillos exteriores antihorarios, agujeros horarios, y el puente
+// de cada agujero se busca con el método de David Eberly.
+
+struct EarNode {
+    int i;          // Índice del vértice en scratch->vertices
+    double x, y;
+    EarNode* prev;
+    EarNode* next;
+};
+
+struct EarEdge {
+    float minX, maxX, minY, maxY;
+    int a, b;       // Vértices
+    int ring;
+    int k;          // Posición de la arista dentro del anillo
+};
+
+struct EarRing {
+    int start;      // Primer vértice en scratch->vertices
+    int count;
+    int depth;      // Anillos que lo contienen: par = exterior, impar = agujero
+    uint32_t containedBy;
+    double area;    // > 0 si es antihorario
+};
+
+static int growBuffer(void** buffer, size_t* capacity, size_t needed, size_t elementSize) {
+    if (needed <= *capacity) return 0;
+    size_t newCapacity = *capacity ? *capacity : 64;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* grown = realloc(*buffer, newCapacity * elementSize);
+    if (!grown) return -1;
+    *buffer = grown;
+    *capacity = newCapacity;
+    return 0;
+}
+
+void freeEarClipScratch(EarClipScratch* scratch) {
+    if (!scratch) return;
+    free(scratch->nodes);
+    free(scratch->edges);
+    free(scratch->active);
+    free(scratch->rings);
+    free(scratch->vertices);
+    free(scratch->indices);
+    memset(scratch, 0, sizeof(*scratch));
+}
+
+// ---- Geometría (mismas convenciones de signo que earcut) ----
+
+// < 0 si p, q, r giran en sentido antihorario
+static inline double earArea(const EarNode* p, const EarNode* q, const EarNode* r) {
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+static inline int earEquals(const EarNode* a, const EarNode* b) {
+    return a->x == b->x && a->y == b->y;
+}
+
+// Triángulo abc antihorario, bordes incluidos
+static inline int pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+           (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+           (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+static inline double orient(double ax, double ay, double bx, double by, double cx, double cy) {
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+static inline int signOf(double v) {
+    return (v > 0.0) - (v < 0.0);
+}
+
+static inline int onSegment(double ax, double ay, double bx, double by, double px, double py) {
+    return px <= (ax > bx ? ax : bx) && px >= (ax < bx ? ax : bx) &&
+           py <= (ay > by ? ay : by) && py >= (ay < by ? ay : by);
+}
+
+// Cortes propios, contactos y solapes colineales cuentan como intersección
+static int segmentsIntersect(const TESSreal* v, int a0, int a1, int b0, int b1) {
+    double p1x = v[2 * a0], p1y = v[2 * a0 + 1], q1x = v[2 * a1], q1y = v[2 * a1 + 1];
+    double p2x = v[2 * b0], p2y = v[2 * b0 + 1], q2x = v[2 * b1], q2y = v[2 * b1 + 1];
+    int o1 = signOf(orient(p1x, p1y, q1x, q1y, p2x, p2y));
+    int o2 = signOf(orient(p1x, p1y, q1x, q1y, q2x, q2y));
+    int o3 = signOf(orient(p2x, p2y, q2x, q2y, p1x, p1y));
+    int o4 = signOf(orient(p2x, p2y, q2x, q2y, q1x, q1y));
+    if (o1 != o2 && o3 != o4) return 1;
+    if (o1 == 0 && onSegment(p1x, p1y, q1x, q1y, p2x, p2y)) return 1;
+    if (o2 == 0 && onSegment(p1x, p1y, q1x, q1y, q2x, q2y)) return 1;
+    if (o3 == 0 && onSegment(p2x, p2y, q2x, q2y, p1x, p1y)) return 1;
+    if (o4 == 0 && onSegment(p2x, p2y, q2x, q2y, q1x, q1y)) return 1;
+    return 0;
+}
+
+static int pointInRing(const EarClipScratch* s, const EarRing* ring, double px, double py) {
+    const TESSreal* v = s->vertices + 2 * ring->start;
+    int inside = 0;
+    for (int i = 0, j = ring->count - 1; i < ring->count; j = i++) {
+        double xi = v[2 * i], yi = v[2 * i + 1], xj = v[2 * j], yj = v[2 * j + 1];
+        if ((yi > py) != (yj > py) && px < (xj - xi) * (py - yi) / (yj - yi) + xi) inside = !inside;
+    }
+    return inside;
+}
+
+// ---- Lista circular ----
+
+static void removeNode(EarNode* p) {
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+}
+
+static EarNode* insertNode(EarClipScratch* s, int* used, int i, EarNode* last) {
+    EarNode* p = &s->nodes[(*used)++];
+    p->i = i;
+    p->x = s->vertices[2 * i];
+    p->y = s->vertices[2 * i + 1];
+    if (!last) {
+        p->prev = p;
+        p->next = p;
+    } else {
+        p->next = last->next;
+        p->prev = last;
+        last->next->prev = p;
+        last->next = p;
+    }
+    return p;
+}
+
+static EarNode* linkRing(EarClipScratch* s, int* used, const EarRing* ring, int counterClockwise) {
+    EarNode* last = NULL;
+    if (counterClockwise == (ring->area > 0.0)) {
+        for (int k = 0; k < ring->count; ++k) last = insertNode(s, used, ring->start + k, last);
+    } else {
+        for (int k = ring->count - 1; k >= 0; --k) last = insertNode(s, used, ring->start + k, last);
+    }
+    return last;
+}
+
+// Quita puntos repetidos y colineales entre start y end
+static EarNode* filterPoints(EarNode* start, EarNode* end) {
+    if (!end) end = start;
+    EarNode* p = start;
+    int again;
+    do {
+        again = 0;
+        if (earEquals(p, p->next) || earArea(p->prev, p, p->next) == 0.0) {
+            removeNode(p);
+            p = end = p->prev;
+            if (p == p->next) break;
+            again = 1;
+        } else {
+            p = p->next;
+        }
+    } while (again || p != end);
+    return end;
+}
+
+static int isEar(const EarNode* ear) {
+    const EarNode* a = ear->prev;
+    const EarNode* b = ear;
+    const EarNode* c = ear->next;
+    if (earArea(a, b, c) >= 0.0) return 0; // Vértice reflejo
+
+    double x0 = a->x < b->x ? (a->x < c->x ? a->x : c->x) : (b->x < c->x ? b->x : c->x);
+    double y0 = a->y < b->y ? (a->y < c->y ? a->y : c->y) : (b->y < c->y ? b->y : c->y);
+    double x1 = a->x > b->x ? (a->x > c->x ? a->x : c->x) : (b->x > c->x ? b->x : c->x);
+    double y1 = a->y > b->y ? (a->y > c->y ? a->y : c->y) : (b->y > c->y ? b->y : c->y);
+
+    for (const EarNode* p = c->next; p != a; p = p->next) {
+        if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+            !(p->x == a->x && p->y == a->y) &&
+            pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+            earArea(p->prev, p, p->next) >= 0.0) return 0;
+    }
+    return 1;
+}
+
+static int locallyInside(const EarNode* a, const EarNode* b) {
+    return earArea(a->prev, a, a->next) < 0.0 ?
+        earArea(a, b, a->next) >= 0.0 && earArea(a, a->prev, b) >= 0.0 :
+        earArea(a, b, a->prev) < 0.0 || earArea(a, a->next, b) < 0.0;
+}
+
+static int sectorContainsSector(const EarNode* m, const EarNode* p) {
+    return earArea(m->prev, m, p->prev) < 0.0 && earArea(p->next, m, m->next) < 0.0;
+}
+
+// Vértice del exterior visible desde el punto más a la izquierda del agujero
+static EarNode* findHoleBridge(EarNode* hole, EarNode* outerNode) {
+    EarNode* p = outerNode;
+    EarNode* m = NULL;
+    double hx = hole->x, hy = hole->y;
+    double qx = -1e300;
+
+    // Rayo hacia la izquierda: la arista más cercana que corta da un candidato
+    do {
+        if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+            double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+            if (x <= hx && x > qx) {
+                qx = x;
+                m = p->x < p->next->x ? p : p->next;
+                if (x == hx) return m; // El agujero toca la arista
+            }
+        }
+        p = p->next;
+    } while (p != outerNode);
+    if (!m) return NULL;
+
+    // Si hay vértices dentro del triángulo (agujero, corte, candidato), gana el de menor ángulo con el rayo
+    EarNode* stop = m;
+    double mx = m->x, my = m->y;
+    double tanMin = 1e300;
+    p = m;
+    do {
+        if (hx >= p->x && p->x >= mx && hx != p->x &&
+            pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+            double tan = (hy > p->y ? hy - p->y : p->y - hy) / (hx - p->x);
+            if (locallyInside(p, hole) &&
+                (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p)))))) {
+                m = p;
+                tanMin = tan;
+            }
+        }
+        p = p->next;
+    } while (p != stop);
+    return m;
+}
+
+// Une a y b con una diagonal duplicando ambos nodos; devuelve la copia de b
+static EarNode* splitPolygon(EarClipScratch* s, int* used, EarNode* a, EarNode* b) {
+    EarNode* a2 = &s->nodes[(*used)++];
+    EarNode* b2 = &s->nodes[(*used)++];
+    *a2 = *a;
+    *b2 = *b;
+    EarNode* an = a->next;
+    EarNode* bp = b->prev;
+
+    a->next = b;
+    b->prev = a;
+    a2->next = an;
+    an->prev = a2;
+    b2->next = a2;
+    a2->prev = b2;
+    bp->next = b2;
+    b2->prev = bp;
+    return b2;
+}
+
+static EarNode* getLeftmost(EarNode* start) {
+    EarNode* p = start;
+    EarNode* leftmost = start;
+    do {
+        if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) leftmost = p;
+        p = p->next;
+    } while (p != start);
+    return leftmost;
+}
+
+static int compareHoles(const void* a, const void* b) {
+    const EarNode* ha = *(const EarNode* const*)a;
+    const EarNode* hb = *(const EarNode* const*)b;
+    if (ha->x != hb->x) return ha->x < hb->x ? -1 : 1;
+    return (ha->y > hb->y) - (ha->y < hb->y);
+}
+
+static int compareEdges(const void* a, const void* b) {
+    const EarEdge* ea = (const EarEdge*)a;
+    const EarEdge* eb = (const EarEdge*)b;
+    return (ea->minY > eb->minY) - (ea->minY < eb->minY);
+}
+
+// Ningún par de aristas no consecutivas se toca (barrido por y mínima)
+static int contoursAreSimple(EarClipScratch* s, int ringCount) {
+    int edgeCount = 0;
+    for (int r = 0; r < ringCount; ++r) {
+        const EarRing* ring = &s->rings[r];
+        for (int k = 0; k < ring->count; ++k) {
+            EarEdge* e = &s->edges[edgeCount++];
+            e->a = ring->start + k;
+            e->b = ring->start + (k + 1) % ring->count;
+            e->ring = r;
+            e->k = k;
+            float ax = s->vertices[2 * e->a], ay = s->vertices[2 * e->a + 1];
+            float bx = s->vertices[2 * e->b], by = s->vertices[2 * e->b + 1];
+            e->minX = ax < bx ? ax : bx;
+            e->maxX = ax > bx ? ax : bx;
+            e->minY = ay < by ? ay : by;
+            e->maxY = ay > by ? ay : by;
+        }
+    }
+    qsort(s->edges, (size_t)edgeCount, sizeof(EarEdge), compareEdges);
+
+    int activeCount = 0;
+    for (int i = 0; i < edgeCount; ++i) {
+        const EarEdge* e = &s->edges[i];
+        int keep = 0;
+        for (int j = 0; j < activeCount; ++j) {
+            const EarEdge* f = &s->edges[s->active[j]];
+            if (f->maxY < e->minY) continue; // Ya no puede cortar a nadie más
+            s->active[keep++] = s->active[j];
+            if (f->maxX < e->minX || f->minX > e->maxX) continue;
+            if (f->ring == e->ring) {
+                int n = s->rings[e->ring].count;
+                if ((e->k + 1) % n == f->k || (f->k + 1) % n == e->k) continue; // Consecutivas
+            }
+            if (segmentsIntersect(s->vertices, e->a, e->b, f->a, f->b)) return 0;
+        }
+        activeCount = keep;
+        s->active[activeCount++] = i;
+    }
+    return 1;
+}
+
+static int earcutLinked(EarClipScratch* s, EarNode* ear) {
+    EarNode* stop = ear;
+    int filtered = 0;
+    while (ear->prev != ear->next) {
+        EarNode* prev = ear->prev;
+        EarNode* next = ear->next;
+        if (isEar(ear)) {
+            TESSindex* tri = s->indices + s->indexCount;
+            tri[0] = prev->i;
+            tri[1] = ear->i;
+            tri[2] = next->i;
+            s->indexCount += 3;
+            removeNode(ear);
+            ear = next->next;
+            stop = next->next;
+            filtered = 0;
+            continue;
+        }
+        ear = next;
+        if (ear == stop) {
+            // Una vuelta sin orejas: se limpian colineales y se reintenta una vez
+            if (filtered) return 0;
+            ear = stop = filterPoints(ear, NULL);
+            filtered = 1;
+        }
+    }
+    return 1;
+}
+
+int earClipOutline(const OutlineDataC* outline, EarClipScratch* s) {
+    TRACE_SCOPE("earClipOutline");
+    if (!outline || !s) return EAR_CLIP_ERROR;
+    s->vertexCount = 0;
+    s->indexCount = 0;
+    if (outline->count > EAR_CLIP_MAX_RINGS || outline->pointCount > EAR_CLIP_MAX_POINTS) return EAR_CLIP_FALLBACK;
+
+    size_t points = outline->pointCount;
+    size_t nodesNeeded = points + 2 * outline->count; // Cada puente duplica dos nodos
+    if (growBuffer((void**)&s->vertices, &s->vertexCapacity, points * 2 + 2, sizeof(TESSreal)) != 0 ||
+        growBuffer((void**)&s->indices, &s->indexCapacity, 3 * nodesNeeded + 3, sizeof(TESSindex)) != 0 ||
+        growBuffer((void**)&s->nodes, &s->nodeCapacity, nodesNeeded + 1, sizeof(EarNode)) != 0 ||
+        growBuffer((void**)&s->rings, &s->ringCapacity, outline->count + 1, sizeof(EarRing)) != 0) {
+        fprintf(stderr, "ERROR::EAR_CLIPPING::EAR_CLIP_OUTLINE: Sin memoria para %zu puntos.\n", points);
+        return EAR_CLIP_ERROR;
+    }
+    if (points + 1 > s->edgeCapacity) {
+        size_t edgeCapacity = s->edgeCapacity;
+        if (growBuffer((void**)&s->edges, &edgeCapacity, points + 1, sizeof(EarEdge)) != 0) return EAR_CLIP_ERROR;
+        int* active = (int*)realloc(s->active, edgeCapacity * sizeof(int));
+        if (!active) return EAR_CLIP_ERROR;
+        s->active = active;
+        s->edgeCapacity = edgeCapacity;
+    }
+
+    // --- Anillos limpios: sin puntos repetidos ni cierre duplicado ---
+    int ringCount = 0;
+    int v = 0;
+    for (size_t c = 0; c < outline->count; ++c) {
+        const ContourC* contour = &outline->contours[c];
+        const Point2D* p = outlineContourPoints(outline, contour);
+        int start = v;
+        for (size_t i = 0; i < contour->count; ++i) {
+            if (v > start && p[i].x == s->vertices[2 * v - 2] && p[i].y == s->vertices[2 * v - 1]) continue;
+            s->vertices[2 * v] = p[i].x;
+            s->vertices[2 * v + 1] = p[i].y;
+            v++;
+        }
+        while (v - start > 1 && s->vertices[2 * start] == s->vertices[2 * v - 2] &&
+               s->vertices[2 * start + 1] == s->vertices[2 * v - 1]) v--;
+        if (v - start < 3) { // Sin área: no aporta nada al relleno par-impar
+            v = start;
+            continue;
+        }
+
+        EarRing* ring = &s->rings[ringCount];
+        ring->start = start;
+        ring->count = v - start;
+        ring->depth = 0;
+        ring->containedBy = 0;
+        ring->area = 0.0;
+        const TESSreal* rv = s->vertices + 2 * start;
+        for (int i = 0, j = ring->count - 1; i < ring->count; j = i++) {
+            ring->area += (double)rv[2 * j] * rv[2 * i + 1] - (double)rv[2 * i] * rv[2 * j + 1];
+            // Punta que vuelve sobre sí misma: libtess2 sabe tratarla, nosotros no
+            int k = (i + 1) % ring->count;
+            double o = orient(rv[2 * j], rv[2 * j + 1], rv[2 * i], rv[2 * i + 1], rv[2 * k], rv[2 * k + 1]);
+            double dot = ((double)rv[2 * i] - rv[2 * j]) * ((double)rv[2 * k] - rv[2 * i]) +
+                         ((double)rv[2 * i + 1] - rv[2 * j + 1]) * ((double)rv[2 * k + 1] - rv[2 * i + 1]);
+            if (o == 0.0 && dot < 0.0) return EAR_CLIP_FALLBACK;
+        }
+        if (ring->area == 0.0) return EAR_CLIP_FALLBACK;
+        ringCount++;
+    }
+    s->vertexCount = v;
+    if (ringCount == 0) return EAR_CLIP_OK;
+
+    if (!contoursAreSimple(s, ringCount)) {
+        s->vertexCount = 0;
+        return EAR_CLIP_FALLBACK;
+    }
+
+    // --- Anidamiento: sin cortes basta con probar un punto de cada anillo ---
+    for (int r = 0; r < ringCount; ++r) {
+        double px = s->vertices[2 * s->rings[r].start], py = s->vertices[2 * s->rings[r].start + 1];
+        for (int o = 0; o < ringCount; ++o) {
+            if (o != r && pointInRing(s, &s->rings[o], px, py)) {
+                s->rings[r].depth++;
+                s->rings[r].containedBy |= 1u << o;
+            }
+        }
+    }
+
+    // --- Un polígono por anillo exterior, con sus agujeros unidos por puentes ---
+    int used = 0;
+    for (int r = 0; r < ringCount; ++r) {
+        if (s->rings[r].depth % 2 != 0) continue;
+        EarNode* outer = linkRing(s, &used, &s->rings[r], 1);
+
+        EarNode* holes[EAR_CLIP_MAX_RINGS];
+        int holeCount = 0;
+        for (int h = 0; h < ringCount; ++h) {
+            const EarRing* hole = &s->rings[h];
+            if (hole->depth != s->rings[r].depth + 1 || !(hole->containedBy & (1u << r))) continue;
+            holes[holeCount++] = getLeftmost(linkRing(s, &used, hole, 0));
+        }
+        qsort(holes, (size_t)holeCount, sizeof(EarNode*), compareHoles);
+        for (int h = 0; h < holeCount; ++h) {
+            EarNode* bridge = findHoleBridge(holes[h], outer);
+            if (!bridge) {
+                s->vertexCount = s->indexCount = 0;
+                return EAR_CLIP_FALLBACK;
+            }
+            EarNode* bridgeReverse = splitPolygon(s, &used, bridge, holes[h]);
+            filterPoints(bridgeReverse, bridgeReverse->next);
+            outer = filterPoints(bridge, bridge->next);
+        }
+
+        if (!earcutLinked(s, outer)) {
+            s->vertexCount = s->indexCount = 0;
+            return EAR_CLIP_FALLBACK;
+        }
+    }
+    return EAR_CLIP_OK;
+}
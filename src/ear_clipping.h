@@ -0,0 +1,47 @@
+#ifndef EAR_CLIPPING_H
+#define EAR_CLIPPING_H
+
+#include "tesselator.h" // TESSreal, TESSindex
+#include <stddef.h>
+
+struct OutlineDataC;
+
+// Camino rápido de teselación para contornos simples: si ningún contorno se
+// corta ni se toca con otro, el relleno par-impar (TESS_WINDING_ODD) se
+// obtiene uniendo cada agujero a su contorno exterior con un puente y
+// recortando orejas. Si el conjunto no es simple, o el recorte se atasca,
+// se devuelve EAR_CLIP_FALLBACK y el llamador usa libtess2.
+
+#define EAR_CLIP_OK 0
+#define EAR_CLIP_FALLBACK 1
+#define EAR_CLIP_ERROR -1
+
+// Más allá de esto la búsqueda de orejas (O(n^2)) deja de compensar
+#define EAR_CLIP_MAX_RINGS 32
+#define EAR_CLIP_MAX_POINTS 1024
+
+typedef struct EarNode EarNode;
+typedef struct EarEdge EarEdge;
+typedef struct EarRing EarRing;
+
+// Memoria de trabajo reutilizable; la salida queda en vertices/indices
+typedef struct {
+    EarNode* nodes;
+    size_t nodeCapacity;
+    EarEdge* edges;
+    size_t edgeCapacity;
+    int* active;            // Aristas activas del barrido de intersecciones
+    EarRing* rings;
+    size_t ringCapacity;
+    TESSreal* vertices;     // x, y de los puntos de los contornos limpios
+    size_t vertexCapacity;
+    TESSindex* indices;     // 3 por triángulo, antihorarios
+    size_t indexCapacity;
+    int vertexCount;
+    int indexCount;
+} EarClipScratch;
+
+int earClipOutline(const struct OutlineDataC* outline, EarClipScratch* scratch);
+void freeEarClipScratch(EarClipScratch* scratch);
+
+#endif // EAR_CLIPPING_H
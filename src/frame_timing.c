@@ -0,0 +1,190 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime con -std=c99
+#include "frame_timing.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef UNIT_TESTING
+#include <GL/glew.h>
+#endif
+
+int frameTimingEnabled = 0;
+
+// Ventana móvil por fase: los últimos FRAME_TIMING_WINDOW valores, en ns.
+static uint64_t phaseSamples[FRAME_PHASE_COUNT][FRAME_TIMING_WINDOW];
+static int phaseSampleCount[FRAME_PHASE_COUNT];
+static int phaseSampleHead[FRAME_PHASE_COUNT];
+
+// Acumuladores del frame en curso.
+static uint64_t frameAccum[FRAME_PHASE_COUNT];
+static uint64_t frameStartNs = 0;
+static int frameOpen = 0;
+
+#ifndef UNIT_TESTING
+static GLuint gpuQueries[FRAME_TIMING_GPU_QUERIES];
+static int gpuQueriesCreated = 0;
+static int gpuHead = 0;     // Próxima query a emitir
+static int gpuTail = 0;     // Query pendiente más antigua
+static int gpuPending = 0;
+static int gpuQueryActive = 0;
+#endif
+
+static const char* phaseNames[FRAME_PHASE_COUNT] = {
+    "layout", "glyph_miss", "uniforms", "draw", "swap", "total", "gpu"
+};
+
+uint64_t frameTimingNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void pushSample(FramePhase phase, uint64_t ns) {
+    phaseSamples[phase][phaseSampleHead[phase]] = ns;
+    phaseSampleHead[phase] = (phaseSampleHead[phase] + 1) % FRAME_TIMING_WINDOW;
+    if (phaseSampleCount[phase] < FRAME_TIMING_WINDOW) phaseSampleCount[phase]++;
+}
+
+void frameTimingReset(void) {
+    memset(phaseSamples, 0, sizeof(phaseSamples));
+    memset(phaseSampleCount, 0, sizeof(phaseSampleCount));
+    memset(phaseSampleHead, 0, sizeof(phaseSampleHead));
+    memset(frameAccum, 0, sizeof(frameAccum));
+    frameOpen = 0;
+}
+
+void frameTimingSetEnabled(int enabled) {
+    frameTimingEnabled = enabled ? 1 : 0;
+    frameOpen = 0; // Un frame a medio medir no es comparable
+}
+
+void frameTimingAdd(FramePhase phase, uint64_t ns) {
+    if (phase < 0 || phase >= FRAME_PHASE_COUNT) return;
+    frameAccum[phase] += ns;
+}
+
+void frameTimingBeginFrame(void) {
+    if (!frameTimingEnabled) return;
+    memset(frameAccum, 0, sizeof(frameAccum));
+    frameStartNs = frameTimingNow();
+    frameOpen = 1;
+}
+
+void frameTimingEndFrame(void) {
+    if (!frameTimingEnabled || !frameOpen) return;
+    frameAccum[FRAME_PHASE_TOTAL] = frameTimingNow() - frameStartNs;
+    for (int p = 0; p < FRAME_PHASE_COUNT; ++p) {
+        if (p == FRAME_PHASE_GPU) continue; // Llega asíncrona, ver frameTimingGpuEnd
+        // Un frame sin misses no es una muestra de "coste de un miss".
+        if (p == FRAME_PHASE_GLYPH_MISS && frameAccum[p] == 0) continue;
+        pushSample((FramePhase)p, frameAccum[p]);
+    }
+    frameOpen = 0;
+}
+
+void frameTimingGpuBegin(void) {
+#ifndef UNIT_TESTING
+    gpuQueryActive = 0;
+    if (!frameTimingEnabled) return;
+    if (!gpuQueriesCreated) {
+        glGenQueries(FRAME_TIMING_GPU_QUERIES, gpuQueries);
+        gpuQueriesCreated = 1;
+    }
+    // Todas en vuelo: saltamos este frame antes que bloquear la CPU.
+    if (gpuPending == FRAME_TIMING_GPU_QUERIES) return;
+    glBeginQuery(GL_TIME_ELAPSED, gpuQueries[gpuHead]);
+    gpuQueryActive = 1;
+#endif
+}
+
+void frameTimingGpuEnd(void) {
+#ifndef UNIT_TESTING
+    if (!gpuQueriesCreated) return;
+    if (gpuQueryActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        gpuHead = (gpuHead + 1) % FRAME_TIMING_GPU_QUERIES;
+        gpuPending++;
+        gpuQueryActive = 0;
+    }
+    // Recoger en orden los resultados ya disponibles, sin esperar.
+    while (gpuPending > 0) {
+        GLint available = 0;
+        glGetQueryObjectiv(gpuQueries[gpuTail], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(gpuQueries[gpuTail], GL_QUERY_RESULT, &elapsed);
+        if (frameTimingEnabled) pushSample(FRAME_PHASE_GPU, (uint64_t)elapsed);
+        gpuTail = (gpuTail + 1) % FRAME_TIMING_GPU_QUERIES;
+        gpuPending--;
+    }
+#endif
+}
+
+static int compareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+FramePhaseStats frameTimingGetStats(FramePhase phase) {
+    FramePhaseStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (phase < 0 || phase >= FRAME_PHASE_COUNT) return stats;
+    int n = phaseSampleCount[phase];
+    if (n == 0) return stats;
+
+    uint64_t sorted[FRAME_TIMING_WINDOW];
+    memcpy(sorted, phaseSamples[phase], (size_t)n * sizeof(uint64_t));
+    qsort(sorted, (size_t)n, sizeof(uint64_t), compareU64);
+
+    uint64_t sum = 0;
+    for (int i = 0; i < n; ++i) sum += sorted[i];
+    stats.minNs = sorted[0];
+    stats.maxNs = sorted[n - 1];
+    stats.avgNs = sum / (uint64_t)n;
+    stats.p99Ns = sorted[(n - 1) * 99 / 100];
+    stats.samples = n;
+    return stats;
+}
+
+const char* frameTimingPhaseName(FramePhase phase) {
+    if (phase < 0 || phase >= FRAME_PHASE_COUNT) return "?";
+    return phaseNames[phase];
+}
+
+void frameTimingReport(FILE* out) {
+    if (!out) return;
+    fprintf(out, "--- Frame timing (ultimos %d frames, us) ---\n", FRAME_TIMING_WINDOW);
+    fprintf(out, "%-12s %10s %10s %10s %10s %8s\n", "fase", "min", "avg", "p99", "max", "n");
+    for (int p = 0; p < FRAME_PHASE_COUNT; ++p) {
+        FramePhaseStats s = frameTimingGetStats((FramePhase)p);
+        fprintf(out, "%-12s %10.1f %10.1f %10.1f %10.1f %8d\n", phaseNames[p],
+                s.minNs / 1000.0, s.avgNs / 1000.0, s.p99Ns / 1000.0, s.maxNs / 1000.0, s.samples);
+    }
+}
+
+int frameTimingExportCSV(const char* path) {
+    FILE* f = path ? fopen(path, "w") : NULL;
+    if (!f) {
+        fprintf(stderr, "ERROR::FRAME_TIMING::EXPORT_CSV: No se pudo abrir '%s'.\n", path ? path : "(null)");
+        return -1;
+    }
+    fprintf(f, "phase,min_ns,avg_ns,p99_ns,max_ns,samples\n");
+    for (int p = 0; p < FRAME_PHASE_COUNT; ++p) {
+        FramePhaseStats s = frameTimingGetStats((FramePhase)p);
+        fprintf(f, "%s,%llu,%llu,%llu,%llu,%d\n", phaseNames[p],
+                (unsigned long long)s.minNs, (unsigned long long)s.avgNs,
+                (unsigned long long)s.p99Ns, (unsigned long long)s.maxNs, s.samples);
+    }
+    fclose(f);
+    return 0;
+}
+
+void frameTimingCleanup(void) {
+#ifndef UNIT_TESTING
+    if (gpuQueriesCreated) {
+        glDeleteQueries(FRAME_TIMING_GPU_QUERIES, gpuQueries);
+        gpuQueriesCreated = 0;
+        gpuHead = gpuTail = gpuPending = gpuQueryActive = 0;
+    }
+#endif
+}
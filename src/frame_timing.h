@@ -0,0 +1,62 @@
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <stdint.h> // Para uint64_t
+#include <stdio.h>  // Para FILE
+
+// Instrumentación por fases de renderText(). Desactivada, cada punto de
+// medida cuesta una sola comprobación de frameTimingEnabled: no se lee el
+// reloj ni se emiten queries GL.
+
+#define FRAME_TIMING_WINDOW 512     // Frames en la ventana móvil por fase
+#define FRAME_TIMING_GPU_QUERIES 4  // Queries GL_TIME_ELAPSED en vuelo
+
+typedef enum {
+    FRAME_PHASE_LAYOUT,     // calculateTextLayout
+    FRAME_PHASE_GLYPH_MISS, // Generación de glifos en getGlyphInfo (incluido en layout/draw)
+    FRAME_PHASE_UNIFORMS,   // Localización y carga de uniforms
+    FRAME_PHASE_DRAW,       // Bucle de dibujo del texto y el cursor
+    FRAME_PHASE_SWAP,       // glutSwapBuffers
+    FRAME_PHASE_TOTAL,      // renderText completo (CPU)
+    FRAME_PHASE_GPU,        // Trabajo GPU del frame (GL_TIME_ELAPSED)
+    FRAME_PHASE_COUNT
+} FramePhase;
+
+typedef struct {
+    uint64_t minNs;
+    uint64_t avgNs;
+    uint64_t p99Ns;
+    uint64_t maxNs;
+    int samples;
+} FramePhaseStats;
+
+extern int frameTimingEnabled;
+
+void frameTimingSetEnabled(int enabled);
+void frameTimingReset(void);
+uint64_t frameTimingNow(void);
+
+// Acumula tiempo en la fase dentro del frame actual (puede llamarse varias
+// veces por frame, p.ej. un miss de glifo por carácter nuevo).
+void frameTimingAdd(FramePhase phase, uint64_t ns);
+void frameTimingBeginFrame(void);
+void frameTimingEndFrame(void); // Vuelca los acumuladores a la ventana móvil
+
+// Query GPU del frame. La lectura es asíncrona: se recogen resultados de
+// frames anteriores solo si GL_QUERY_RESULT_AVAILABLE, nunca se espera.
+void frameTimingGpuBegin(void);
+void frameTimingGpuEnd(void);
+
+FramePhaseStats frameTimingGetStats(FramePhase phase);
+const char* frameTimingPhaseName(FramePhase phase);
+void frameTimingReport(FILE* out);
+int frameTimingExportCSV(const char* path);
+void frameTimingCleanup(void); // Libera las queries GL
+
+// Puntos de medida. FRAME_TIMING_BEGIN declara la variable de inicio.
+#define FRAME_TIMING_BEGIN(var) \
+    uint64_t var = frameTimingEnabled ? frameTimingNow() : 0
+#define FRAME_TIMING_END(phase, var) \
+    do { if (frameTimingEnabled) frameTimingAdd((phase), frameTimingNow() - (var)); } while (0)
+
+#endif // FRAME_TIMING_H
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <stdlib.h> // Para malloc, realloc, free
 #include <string.h> // Para strlen
+#include <math.h>   // Para sqrtf, ceilf (aplanado adaptativo)
+#include "trace.h"  // TRACE_SCOPE (solo con TEXT3D_TRACE)
 
 FT_Library ftLibrary = NULL;
 FT_Face ftFace = NULL;
@@ -79,90 +81,86 @@ long getFontNumGlyphs() {
     return ftFace->num_glyphs;
 }
 
-// --- ContourC Helpers (AHORA NO ESTÁTICOS) ---
-int initContour(ContourC* contour, size_t initialCapacity) { // Se quitó 'static'
-    contour->points = (Point2D*)malloc(initialCapacity * sizeof(Point2D));
-    if (!contour->points) {
-        fprintf(stderr, "ERROR::FREETYPE_HANDLER::INIT_CONTOUR: Malloc failed for points.\n");
-        return -1;
-    }
-    contour->count = 0;
-    contour->capacity = initialCapacity;
-    return 0;
-}
-
-int addPointToContour(ContourC* contour, Point2D point) { // Se quitó 'static'
-    if (contour->count >= contour->capacity) {
-        size_t newCapacity = (contour->capacity == 0) ? 8 : contour->capacity * 2;
-        Point2D* newPoints = (Point2D*)realloc(contour->points, newCapacity * sizeof(Point2D));
-        if (!newPoints) {
-            fprintf(stderr, "ERROR::FREETYPE_HANDLER::ADD_POINT_TO_CONTOUR: Realloc failed for points.\n");
-            return -1;
-        }
-        contour->points = newPoints;
-        contour->capacity = newCapacity;
-    }
-    contour->points[contour->count++] = point;
-    return 0;
-}
-
-void freeContour(ContourC* contour) { // Se quitó 'static'
-    if (contour && contour->points) {
-        free(contour->points);
-        contour->points = NULL;
-        contour->count = 0;
-        contour->capacity = 0;
-    }
-}
-
 // --- OutlineDataC Helpers ---
 int initOutlineData(OutlineDataC* data, size_t initialCapacity) {
     if (!data) return -1;
-    data->contours = (ContourC*)malloc(initialCapacity * sizeof(ContourC));
-    if (!data->contours) {
-        fprintf(stderr, "ERROR::FREETYPE_HANDLER::INIT_OUTLINE_DATA: Malloc failed for contours.\n");
+    data->points = (Point2D*)malloc(OUTLINE_INITIAL_POINTS * sizeof(Point2D));
+    data->contours = (ContourC*)malloc((initialCapacity ? initialCapacity : 1) * sizeof(ContourC));
+    if (!data->points || !data->contours) {
+        fprintf(stderr, "ERROR::FREETYPE_HANDLER::INIT_OUTLINE_DATA: Malloc failed for points/contours.\n");
+        free(data->points);
+        free(data->contours);
+        data->points = NULL;
+        data->contours = NULL;
         return -1;
     }
+    data->pointCount = 0;
+    data->pointCapacity = OUTLINE_INITIAL_POINTS;
     data->count = 0;
-    data->capacity = initialCapacity;
+    data->capacity = initialCapacity ? initialCapacity : 1;
     data->currentPoint = (Point2D){0.0f, 0.0f};
     data->subdivisionSteps = 10; 
+    data->flatnessTolerance = OUTLINE_DEFAULT_FLATNESS;
     return 0;
 }
 
-// Esta función addContourToOutline sigue siendo static porque es una utilidad interna para los callbacks de FreeType
-// que se definen en este mismo archivo. No necesita ser llamada desde fuera.
-static ContourC* addContourToOutline(OutlineDataC* data) {
-    if (!data) return NULL;
+void resetOutlineData(OutlineDataC* data) {
+    if (!data) return;
+    data->pointCount = 0;
+    data->count = 0;
+    data->currentPoint = (Point2D){0.0f, 0.0f};
+}
+
+int beginOutlineContour(OutlineDataC* data) {
+    if (!data) return -1;
     if (data->count >= data->capacity) {
         size_t newCapacity = (data->capacity == 0) ? 4 : data->capacity * 2;
         ContourC* newContours = (ContourC*)realloc(data->contours, newCapacity * sizeof(ContourC));
         if (!newContours) {
-            fprintf(stderr, "ERROR::FREETYPE_HANDLER::ADD_CONTOUR_TO_OUTLINE: Realloc failed.\n");
-            return NULL;
+            fprintf(stderr, "ERROR::FREETYPE_HANDLER::BEGIN_OUTLINE_CONTOUR: Realloc failed.\n");
+            return -1;
         }
         data->contours = newContours;
         data->capacity = newCapacity;
     }
-    // Usa la función initContour (ahora no estática)
-    if (initContour(&data->contours[data->count], 16) != 0) { 
-         fprintf(stderr, "ERROR::FREETYPE_HANDLER::ADD_CONTOUR_TO_OUTLINE: initContour failed.\n");
-        return NULL;
+    data->contours[data->count].start = data->pointCount;
+    data->contours[data->count].count = 0;
+    data->count++;
+    return 0;
+}
+
+// Garantiza hueco para `extra` puntos más sin realloc
+static int reserveOutlinePoints(OutlineDataC* data, size_t extra) {
+    size_t needed = data->pointCount + extra;
+    if (needed <= data->pointCapacity) return 0;
+    size_t newCapacity = (data->pointCapacity == 0) ? OUTLINE_INITIAL_POINTS : data->pointCapacity * 2;
+    while (newCapacity < needed) newCapacity *= 2;
+    Point2D* newPoints = (Point2D*)realloc(data->points, newCapacity * sizeof(Point2D));
+    if (!newPoints) {
+        fprintf(stderr, "ERROR::FREETYPE_HANDLER::ADD_OUTLINE_POINT: Realloc failed for points.\n");
+        return -1;
     }
-    return &data->contours[data->count++];
+    data->points = newPoints;
+    data->pointCapacity = newCapacity;
+    return 0;
+}
+
+int addOutlinePoint(OutlineDataC* data, Point2D point) {
+    if (data->count == 0) return -1;
+    if (reserveOutlinePoints(data, 1) != 0) return -1;
+    data->points[data->pointCount++] = point;
+    data->contours[data->count - 1].count++;
+    return 0;
 }
 
 void freeOutlineData(OutlineDataC* data) {
-    if (data && data->contours) {
-        for (size_t i = 0; i < data->count; ++i) {
-            // Usa la función freeContour (ahora no estática)
-            freeContour(&data->contours[i]);
-        }
-        free(data->contours);
-        data->contours = NULL;
-        data->count = 0;
-        data->capacity = 0;
-    }
+    if (!data) return;
+    free(data->points);
+    free(data->contours);
+    data->points = NULL;
+    data->contours = NULL;
+    data->pointCount = data->pointCapacity = 0;
+    data->count = data->capacity = 0;
 }
 
 // --- FreeType Callbacks ---
@@ -170,83 +168,212 @@ static Point2D ftVecToPoint2D(const FT_Vector* vec) {
     return (Point2D){ (float)vec->x / 64.0f, (float)vec->y / 64.0f };
 }
 
-static Point2D evaluateQuadraticBezier(float t, Point2D p0, Point2D p1, Point2D p2) {
-    float u = 1.0f - t;
-    float tt = t * t;
-    float uu = u * u;
-    float ut2 = 2.0f * u * t;
-    return (Point2D){
-        uu * p0.x + ut2 * p1.x + tt * p2.x,
-        uu * p0.y + ut2 * p1.y + tt * p2.y
-    };
+// Número de segmentos uniformes para que el error de cuerda no supere la
+// tolerancia. Para un segmento de longitud h en t el error es <= max|B''| h^2 / 8:
+//  - cuadrática: B'' = 2(p0 - 2p1 + p2)            -> n = sqrt(|p0 - 2p1 + p2| / (4 tol))
+//  - cúbica:     |B''| <= 6 max(|d1|, |d2|) = 6M   -> n = sqrt(3M / (4 tol))
+static int curveSegmentCount(const OutlineDataC* data, float deviation, float factor) {
+    if (data->flatnessTolerance <= 0.0f) {
+        return data->subdivisionSteps > 0 ? data->subdivisionSteps : 1;
+    }
+    float n = ceilf(sqrtf(factor * deviation / data->flatnessTolerance));
+    if (n < 1.0f) return 1;
+    if (n > (float)OUTLINE_MAX_CURVE_SEGMENTS) return OUTLINE_MAX_CURVE_SEGMENTS;
+    return (int)n;
 }
 
-static Point2D evaluateCubicBezier(float t, Point2D p0, Point2D p1, Point2D p2, Point2D p3) {
-    float u = 1.0f - t;
-    float tt = t * t;
-    float uu = u * u;
-    float uuu = uu * u;
-    float ttt = tt * t;
-    Point2D p;
-    p.x = uuu * p0.x + 3 * uu * t * p1.x + 3 * u * tt * p2.x + ttt * p3.x;
-    p.y = uuu * p0.y + 3 * uu * t * p1.y + 3 * u * tt * p2.y + ttt * p3.y;
-    return p;
+static float pointLength(float x, float y) {
+    return sqrtf(x * x + y * y);
 }
 
-int ftMoveToFunc(const FT_Vector* to, void* userData) {
-    OutlineDataC* data = (OutlineDataC*)userData;
-    ContourC* newContour = addContourToOutline(data); // Esta sigue siendo static y está bien
-    if (!newContour) return 1; 
-    data->currentPoint = ftVecToPoint2D(to);
-    // Usa la función addPointToContour (ahora no estática)
-    if (addPointToContour(newContour, data->currentPoint) != 0) return 1; 
-    return 0; 
+// --- Emisión de segmentos (compartida por los callbacks y extractOutline) ---
+// Cada curva reserva sus puntos de una vez y los escribe sin más comprobaciones.
+
+static int emitMoveTo(OutlineDataC* data, Point2D to) {
+    if (beginOutlineContour(data) != 0) return 1;
+    data->currentPoint = to;
+    return addOutlinePoint(data, to) != 0;
 }
 
-int ftLineToFunc(const FT_Vector* to, void* userData) {
-    OutlineDataC* data = (OutlineDataC*)userData;
-    if (data->count == 0) return 1; 
-    data->currentPoint = ftVecToPoint2D(to);
-    // Usa la función addPointToContour (ahora no estática)
-    if (addPointToContour(&data->contours[data->count - 1], data->currentPoint) != 0) return 1; 
-    return 0; 
+static int emitLineTo(OutlineDataC* data, Point2D to) {
+    data->currentPoint = to;
+    return addOutlinePoint(data, to) != 0;
 }
 
-int ftConicToFunc(const FT_Vector* control, const FT_Vector* to, void* userData) {
-    OutlineDataC* data = (OutlineDataC*)userData;
-    if (data->count == 0) return 1; 
+static int emitConicTo(OutlineDataC* data, Point2D ctrlPt, Point2D endPt) {
+    Point2D startPt = data->currentPoint;
+    // B(t) = a t^2 + b t + p0, evaluada por diferencias hacia adelante
+    float ax = startPt.x - 2.0f * ctrlPt.x + endPt.x, ay = startPt.y - 2.0f * ctrlPt.y + endPt.y;
+    float bx = 2.0f * (ctrlPt.x - startPt.x),        by = 2.0f * (ctrlPt.y - startPt.y);
+    int steps = curveSegmentCount(data, pointLength(ax, ay), 0.25f);
+    if (reserveOutlinePoints(data, (size_t)steps) != 0) return 1;
+    float h = 1.0f / (float)steps;
+    Point2D p = startPt;
+    float dx = ax * h * h + bx * h,  dy = ay * h * h + by * h;
+    float ddx = 2.0f * ax * h * h,   ddy = 2.0f * ay * h * h;
 
-    Point2D ctrlPt = ftVecToPoint2D(control);
-    Point2D endPt = ftVecToPoint2D(to);
+    Point2D* out = data->points + data->pointCount;
+    for (int i = 1; i < steps; ++i) {
+        p.x += dx; p.y += dy;
+        dx += ddx; dy += ddy;
+        *out++ = p;
+    }
+    // El último punto es exacto: sin deriva acumulada en la unión con la siguiente curva
+    *out = endPt;
+    data->pointCount += (size_t)steps;
+    data->contours[data->count - 1].count += (size_t)steps;
+    data->currentPoint = endPt;
+    return 0;
+}
+
+static int emitCubicTo(OutlineDataC* data, Point2D ctrlPt1, Point2D ctrlPt2, Point2D endPt) {
     Point2D startPt = data->currentPoint;
-    ContourC* currentContour = &data->contours[data->count - 1];
+    // Segundas diferencias de los puntos de control
+    float d1 = pointLength(startPt.x - 2.0f * ctrlPt1.x + ctrlPt2.x, startPt.y - 2.0f * ctrlPt1.y + ctrlPt2.y);
+    float d2 = pointLength(ctrlPt1.x - 2.0f * ctrlPt2.x + endPt.x,   ctrlPt1.y - 2.0f * ctrlPt2.y + endPt.y);
+    int steps = curveSegmentCount(data, d1 > d2 ? d1 : d2, 0.75f);
+    if (reserveOutlinePoints(data, (size_t)steps) != 0) return 1;
+
+    // B(t) = a t^3 + b t^2 + c t + p0, evaluada por diferencias hacia adelante
+    float ax = -startPt.x + 3.0f * (ctrlPt1.x - ctrlPt2.x) + endPt.x;
+    float ay = -startPt.y + 3.0f * (ctrlPt1.y - ctrlPt2.y) + endPt.y;
+    float bx = 3.0f * (startPt.x - 2.0f * ctrlPt1.x + ctrlPt2.x);
+    float by = 3.0f * (startPt.y - 2.0f * ctrlPt1.y + ctrlPt2.y);
+    float cx = 3.0f * (ctrlPt1.x - startPt.x), cy = 3.0f * (ctrlPt1.y - startPt.y);
+    float h = 1.0f / (float)steps, h2 = h * h, h3 = h2 * h;
+    Point2D p = startPt;
+    float dx = ax * h3 + bx * h2 + cx * h,   dy = ay * h3 + by * h2 + cy * h;
+    float ddx = 6.0f * ax * h3 + 2.0f * bx * h2, ddy = 6.0f * ay * h3 + 2.0f * by * h2;
+    float dddx = 6.0f * ax * h3,             dddy = 6.0f * ay * h3;
 
-    for (int i = 1; i <= data->subdivisionSteps; ++i) {
-        float t = (float)i / (float)data->subdivisionSteps;
-        Point2D pointOnCurve = evaluateQuadraticBezier(t, startPt, ctrlPt, endPt);
-        // Usa la función addPointToContour (ahora no estática)
-        if (addPointToContour(currentContour, pointOnCurve) != 0) return 1; 
+    Point2D* out = data->points + data->pointCount;
+    for (int i = 1; i < steps; ++i) {
+        p.x += dx; p.y += dy;
+        dx += ddx; dy += ddy;
+        ddx += dddx; ddy += dddy;
+        *out++ = p;
     }
+    *out = endPt;
+    data->pointCount += (size_t)steps;
+    data->contours[data->count - 1].count += (size_t)steps;
     data->currentPoint = endPt;
-    return 0; 
+    return 0;
+}
+
+int ftMoveToFunc(const FT_Vector* to, void* userData) {
+    return emitMoveTo((OutlineDataC*)userData, ftVecToPoint2D(to));
+}
+
+int ftLineToFunc(const FT_Vector* to, void* userData) {
+    OutlineDataC* data = (OutlineDataC*)userData;
+    if (data->count == 0) return 1;
+    return emitLineTo(data, ftVecToPoint2D(to));
+}
+
+int ftConicToFunc(const FT_Vector* control, const FT_Vector* to, void* userData) {
+    OutlineDataC* data = (OutlineDataC*)userData;
+    if (data->count == 0) return 1;
+    return emitConicTo(data, ftVecToPoint2D(control), ftVecToPoint2D(to));
 }
 
 int ftCubicToFunc(const FT_Vector* c1, const FT_Vector* c2, const FT_Vector* to, void* userData) {
     OutlineDataC* data = (OutlineDataC*)userData;
-    if (data->count == 0) return 1; 
+    if (data->count == 0) return 1;
+    return emitCubicTo(data, ftVecToPoint2D(c1), ftVecToPoint2D(c2), ftVecToPoint2D(to));
+}
 
-    Point2D ctrlPt1 = ftVecToPoint2D(c1);
-    Point2D ctrlPt2 = ftVecToPoint2D(c2);
-    Point2D endPt = ftVecToPoint2D(to);
-    Point2D startPt = data->currentPoint;
-    ContourC* currentContour = &data->contours[data->count - 1];
+// --- Recorrido directo de FT_Outline ---
+// Mismo orden de segmentos que FT_Outline_Decompose (ftoutln.c) con shift = 0
+// y delta = 0: un contorno que empieza fuera de curva arranca en el último
+// punto (si está en curva) o en el punto medio implícito entre ambos, y dos
+// controles cónicos seguidos tienen un punto en curva implícito en su mitad
+// (con la misma división entera que FreeType).
+int extractOutline(const FT_Outline* outline, OutlineDataC* data) {
+    TRACE_SCOPE("extractOutline");
+    if (!outline || !data) return -1;
+    if (outline->n_contours <= 0) return 0;
+
+    // Cada punto da al menos un punto de salida, más el cierre de cada contorno
+    if (reserveOutlinePoints(data, (size_t)outline->n_points + (size_t)outline->n_contours) != 0) return -1;
 
-    for (int i = 1; i <= data->subdivisionSteps; ++i) {
-        float t = (float)i / (float)data->subdivisionSteps;
-        Point2D pointOnCurve = evaluateCubicBezier(t, startPt, ctrlPt1, ctrlPt2, endPt);
-        // Usa la función addPointToContour (ahora no estática)
-        if (addPointToContour(currentContour, pointOnCurve) != 0) return 1; 
+    const FT_Vector* points = outline->points;
+    const char* tags = outline->tags;
+    int first = 0;
+    for (int n = 0; n < outline->n_contours; ++n) {
+        int last = outline->contours[n];
+        if (last < first || last >= outline->n_points) goto Invalid;
+
+        FT_Vector vStart = points[first];
+        FT_Vector vLast = points[last];
+        FT_Vector vControl;
+        int index = first;
+        int limit = last;
+        int tag = FT_CURVE_TAG(tags[first]);
+        if (tag == FT_CURVE_TAG_CUBIC) goto Invalid;
+        if (tag == FT_CURVE_TAG_CONIC) {
+            if (FT_CURVE_TAG(tags[last]) == FT_CURVE_TAG_ON) {
+                vStart = vLast;
+                limit--;
+            } else {
+                vStart.x = (vStart.x + vLast.x) / 2;
+                vStart.y = (vStart.y + vLast.y) / 2;
+            }
+            index--;
+        }
+        Point2D start = ftVecToPoint2D(&vStart);
+        if (emitMoveTo(data, start) != 0) return -1;
+
+        int closed = 0;
+        while (index < limit) {
+            index++;
+            tag = FT_CURVE_TAG(tags[index]);
+            if (tag == FT_CURVE_TAG_ON) {
+                if (emitLineTo(data, ftVecToPoint2D(&points[index])) != 0) return -1;
+                continue;
+            }
+            if (tag == FT_CURVE_TAG_CONIC) {
+                vControl = points[index];
+                for (;;) {
+                    if (index >= limit) {
+                        if (emitConicTo(data, ftVecToPoint2D(&vControl), start) != 0) return -1;
+                        closed = 1;
+                        break;
+                    }
+                    index++;
+                    FT_Vector vec = points[index];
+                    tag = FT_CURVE_TAG(tags[index]);
+                    if (tag == FT_CURVE_TAG_ON) {
+                        if (emitConicTo(data, ftVecToPoint2D(&vControl), ftVecToPoint2D(&vec)) != 0) return -1;
+                        break;
+                    }
+                    if (tag != FT_CURVE_TAG_CONIC) goto Invalid;
+                    FT_Vector vMiddle = { (vControl.x + vec.x) / 2, (vControl.y + vec.y) / 2 };
+                    if (emitConicTo(data, ftVecToPoint2D(&vControl), ftVecToPoint2D(&vMiddle)) != 0) return -1;
+                    vControl = vec;
+                }
+                if (closed) break;
+                continue;
+            }
+            // Cúbica: dos controles seguidos
+            if (index + 1 > limit || FT_CURVE_TAG(tags[index + 1]) != FT_CURVE_TAG_CUBIC) goto Invalid;
+            index += 2;
+            Point2D c1 = ftVecToPoint2D(&points[index - 2]);
+            Point2D c2 = ftVecToPoint2D(&points[index - 1]);
+            if (index <= limit) {
+                if (emitCubicTo(data, c1, c2, ftVecToPoint2D(&points[index])) != 0) return -1;
+                continue;
+            }
+            if (emitCubicTo(data, c1, c2, start) != 0) return -1;
+            closed = 1;
+            break;
+        }
+        // Cierra el contorno con una recta
+        if (!closed && emitLineTo(data, start) != 0) return -1;
+        first = last + 1;
     }
-    data->currentPoint = endPt;
-    return 0; 
-}
\ No newline at end of file
+    return 0;
+
+Invalid:
+    fprintf(stderr, "ERROR::FREETYPE_HANDLER::EXTRACT_OUTLINE: Contorno inválido.\n");
+    return -1;
+}
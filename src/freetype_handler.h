@@ -7,13 +7,28 @@
 #include "tessellation_handler.h" // Para Point2D, ContourC
 #include <stddef.h>               // Para size_t
 
-// Datos para los callbacks de FreeType
+// Aplanado de curvas: error máximo (en píxeles de la fuente) entre la curva
+// y la polilínea emitida. Con flatnessTolerance <= 0 se usan
+// subdivisionSteps segmentos fijos por curva, como antes.
+#define OUTLINE_DEFAULT_FLATNESS 0.25f
+#define OUTLINE_MAX_CURVE_SEGMENTS 128
+
+#define OUTLINE_INITIAL_POINTS 256
+
+// Datos para los callbacks de FreeType. Todos los puntos del glifo viven en
+// un único buffer contiguo y cada contorno es un rango {start, count}.
+// resetOutlineData vacía el contorno sin liberar memoria, así un mismo
+// OutlineDataC se reutiliza de glifo en glifo sin mallocs una vez crecido.
 typedef struct OutlineDataC { 
+    Point2D* points;
+    size_t pointCount;
+    size_t pointCapacity;
     ContourC* contours;
     size_t count;
     size_t capacity;
     Point2D currentPoint;
     int subdivisionSteps; 
+    float flatnessTolerance;
 } OutlineDataC;
 
 // Variables globales
@@ -31,15 +46,24 @@ const char* getFontFamilyName();
 const char* getFontStyleName();
 long getFontNumGlyphs();
 
-// Helpers para OutlineDataC y ContourC
+// Helpers para OutlineDataC (initialCapacity = contornos)
 int initOutlineData(OutlineDataC* data, size_t initialCapacity);
+void resetOutlineData(OutlineDataC* data);
 void freeOutlineData(OutlineDataC* data);
 
-// DECLARACIONES AÑADIDAS para helpers de ContourC:
-int initContour(ContourC* contour, size_t initialCapacity);
-int addPointToContour(ContourC* contour, Point2D point);
-void freeContour(ContourC* contour);
-// Fin de declaraciones añadidas
+// Abre un contorno nuevo que empieza en el siguiente punto
+int beginOutlineContour(OutlineDataC* data);
+// Añade un punto al último contorno abierto
+int addOutlinePoint(OutlineDataC* data, Point2D point);
+
+static inline const Point2D* outlineContourPoints(const OutlineDataC* data, const ContourC* contour) {
+    return data->points + contour->start;
+}
+
+// Recorre points/tags/contours de FT_Outline sin pasar por FT_Outline_Decompose.
+// Produce exactamente los mismos puntos que los callbacks de abajo. Añade al
+// contenido actual de data (llamar antes a resetOutlineData). Devuelve 0 o -1.
+int extractOutline(const FT_Outline* outline, OutlineDataC* data);
 
 // Funciones de callback (usadas por FT_Outline_Decompose)
 int ftMoveToFunc(const FT_Vector* to, void* userData);
@@ -0,0 +1,575 @@
+#include "glyph_extrude.h"
+#include "config.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define EXTRUDE_POINT_EPSILON 1e-5f
+#define EXTRUDE_MIN_MITER_DOT 0.3f // Limita el inglete en esquinas muy agudas
+#define EXTRUDE_HALF_PI 1.57079632679f
+
+// ==== Construcción de la malla ====
+
+int initGlyphExtruder(GlyphExtruder* ex) {
+    if (!ex) return -1;
+    memset(ex, 0, sizeof(*ex));
+    if (initOutlineData(&ex->clean, 8) != 0 || initOutlineData(&ex->capOutline, 8) != 0 ||
+        initTessellationContext(&ex->tess, 0) != 0) {
+        fprintf(stderr, "ERROR::GLYPH_EXTRUDE::INIT: No se pudo inicializar el extrusor.\n");
+        freeGlyphExtruder(ex);
+        return -1;
+    }
+    return 0;
+}
+
+void freeGlyphExtruder(GlyphExtruder* ex) {
+    if (!ex) return;
+    freeOutlineData(&ex->clean);
+    freeOutlineData(&ex->capOutline);
+    freeTessellationContext(&ex->tess);
+    free(ex->capMesh.vertices);
+    free(ex->capMesh.indices);
+    free(ex->miters);
+    free(ex->smoothNormals);
+    free(ex->smooth);
+    free(ex->mesh.vertices);
+    free(ex->mesh.indices);
+    memset(ex, 0, sizeof(*ex));
+}
+
+static int ensureScratch(GlyphExtruder* ex, size_t points) {
+    if (points <= ex->scratchCapacity) return 0;
+    size_t capacity = ex->scratchCapacity ? ex->scratchCapacity : 256;
+    while (capacity < points) capacity *= 2;
+    Point2D* miters = (Point2D*)realloc(ex->miters, capacity * sizeof(Point2D));
+    if (miters) ex->miters = miters;
+    Point2D* normals = (Point2D*)realloc(ex->smoothNormals, capacity * sizeof(Point2D));
+    if (normals) ex->smoothNormals = normals;
+    unsigned char* smooth = (unsigned char*)realloc(ex->smooth, capacity);
+    if (smooth) ex->smooth = smooth;
+    if (!miters || !normals || !smooth) return -1;
+    ex->scratchCapacity = capacity;
+    return 0;
+}
+
+static int ensureMeshCapacity(ExtrudedMeshBuffer* mesh, int vertices, int indices) {
+    if (vertices > mesh->vertexCapacity) {
+        GLfloat* v = (GLfloat*)realloc(mesh->vertices, (size_t)vertices * EXTRUDE_VERTEX_FLOATS * sizeof(GLfloat));
+        if (!v) return -1;
+        mesh->vertices = v;
+        mesh->vertexCapacity = vertices;
+    }
+    if (indices > mesh->indexCapacity) {
+        GLuint* i = (GLuint*)realloc(mesh->indices, (size_t)indices * sizeof(GLuint));
+        if (!i) return -1;
+        mesh->indices = i;
+        mesh->indexCapacity = indices;
+    }
+    return 0;
+}
+
+static inline void pushVertex(ExtrudedMeshBuffer* mesh, float x, float y, float z, float nx, float ny, float nz) {
+    GLfloat* v = mesh->vertices + (size_t)mesh->vertexCount * EXTRUDE_VERTEX_FLOATS;
+    v[0] = x; v[1] = y; v[2] = z;
+    v[3] = nx; v[4] = ny; v[5] = nz;
+    mesh->vertexCount++;
+}
+
+static inline void pushTriangle(ExtrudedMeshBuffer* mesh, GLuint a, GLuint b, GLuint c) {
+    GLuint* i = mesh->indices + mesh->indexCount;
+    i[0] = a; i[1] = b; i[2] = c;
+    mesh->indexCount += 3;
+}
+
+static inline int samePoint(Point2D a, Point2D b) {
+    return fabsf(a.x - b.x) < EXTRUDE_POINT_EPSILON && fabsf(a.y - b.y) < EXTRUDE_POINT_EPSILON;
+}
+
+// Normal de la arista a->b que apunta fuera del relleno
+static inline Point2D edgeNormal(Point2D a, Point2D b, int fillLeft) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len < EXTRUDE_POINT_EPSILON) return (Point2D){0.0f, 0.0f};
+    dx /= len;
+    dy /= len;
+    return fillLeft ? (Point2D){dy, -dx} : (Point2D){-dy, dx};
+}
+
+// Copia los contornos quitando puntos repetidos y el cierre duplicado.
+// Devuelve el lado del relleno: el del contorno de mayor área, que es exterior.
+static int cleanContours(GlyphExtruder* ex, const OutlineDataC* outline, int* fillLeft) {
+    resetOutlineData(&ex->clean);
+    float maxArea = 0.0f;
+    *fillLeft = 1;
+    for (size_t c = 0; c < outline->count; ++c) {
+        const ContourC* contour = &outline->contours[c];
+        const Point2D* src = outlineContourPoints(outline, contour);
+        if (beginOutlineContour(&ex->clean) != 0) return -1;
+        ContourC* dst = &ex->clean.contours[ex->clean.count - 1];
+        for (size_t i = 0; i < contour->count; ++i) {
+            if (dst->count > 0 && samePoint(src[i], ex->clean.points[ex->clean.pointCount - 1])) continue;
+            if (addOutlinePoint(&ex->clean, src[i]) != 0) return -1;
+        }
+        while (dst->count > 1 && samePoint(ex->clean.points[dst->start], ex->clean.points[ex->clean.pointCount - 1])) {
+            dst->count--;
+            ex->clean.pointCount--;
+        }
+        if (dst->count < 3) { // Degenerado: se descarta
+            ex->clean.pointCount -= dst->count;
+            ex->clean.count--;
+            continue;
+        }
+
+        const Point2D* p = outlineContourPoints(&ex->clean, dst);
+        float area = 0.0f;
+        for (size_t i = 0, j = dst->count - 1; i < dst->count; j = i++) {
+            area += p[j].x * p[i].y - p[i].x * p[j].y;
+        }
+        if (fabsf(area) > maxArea) {
+            maxArea = fabsf(area);
+            *fillLeft = area > 0.0f;
+        }
+    }
+    return 0;
+}
+
+int extrudeOutline(GlyphExtruder* ex, const OutlineDataC* outline, const ExtrudeParams* params) {
+    TRACE_SCOPE("extrudeOutline");
+    if (!ex || !outline || !params || params->depth < 0.0f) {
+        fprintf(stderr, "ERROR::GLYPH_EXTRUDE::EXTRUDE_OUTLINE: Parámetros inválidos.\n");
+        return -1;
+    }
+    ExtrudedMeshBuffer* mesh = &ex->mesh;
+    mesh->vertexCount = 0;
+    mesh->indexCount = 0;
+
+    int fillLeft;
+    if (cleanContours(ex, outline, &fillLeft) != 0 || ensureScratch(ex, ex->clean.pointCount) != 0) {
+        fprintf(stderr, "ERROR::GLYPH_EXTRUDE::EXTRUDE_OUTLINE: Sin memoria para los contornos.\n");
+        return -1;
+    }
+    if (ex->clean.count == 0) return 0;
+
+    // --- Normales e ingletes por punto ---
+    const float smoothCos = cosf(EXTRUDE_SMOOTH_ANGLE_DEG * EXTRUDE_HALF_PI / 90.0f);
+    for (size_t c = 0; c < ex->clean.count; ++c) {
+        const ContourC* contour = &ex->clean.contours[c];
+        const Point2D* p = outlineContourPoints(&ex->clean, contour);
+        size_t n = contour->count;
+        for (size_t i = 0; i < n; ++i) {
+            Point2D nIn = edgeNormal(p[(i + n - 1) % n], p[i], fillLeft);
+            Point2D nOut = edgeNormal(p[i], p[(i + 1) % n], fillLeft);
+            Point2D m = { nIn.x + nOut.x, nIn.y + nOut.y };
+            float len = sqrtf(m.x * m.x + m.y * m.y);
+            m = len > EXTRUDE_POINT_EPSILON ? (Point2D){ m.x / len, m.y / len } : nOut;
+            float miterDot = m.x * nIn.x + m.y * nIn.y;
+            if (miterDot < EXTRUDE_MIN_MITER_DOT) miterDot = EXTRUDE_MIN_MITER_DOT;
+
+            size_t g = contour->start + i;
+            ex->miters[g] = (Point2D){ m.x / miterDot, m.y / miterDot };
+            ex->smoothNormals[g] = m;
+            ex->smooth[g] = (nIn.x * nOut.x + nIn.y * nOut.y) >= smoothCos;
+        }
+    }
+
+    // --- Perfil: anillos de la pared de delante hacia atrás ---
+    float halfDepth = params->depth * 0.5f;
+    int steps = params->bevelSteps > EXTRUDE_MAX_BEVEL_STEPS ? EXTRUDE_MAX_BEVEL_STEPS : params->bevelSteps;
+    float bevel = params->bevelSize < halfDepth ? params->bevelSize : halfDepth;
+    if (steps <= 0 || bevel <= 0.0f) { steps = 0; bevel = 0.0f; }
+
+    float ringInset[2 * (EXTRUDE_MAX_BEVEL_STEPS + 1)];
+    float ringZ[2 * (EXTRUDE_MAX_BEVEL_STEPS + 1)];
+    float ringSin[2 * (EXTRUDE_MAX_BEVEL_STEPS + 1)];
+    float ringCos[2 * (EXTRUDE_MAX_BEVEL_STEPS + 1)];
+    int rings = 0;
+    if (steps == 0) {
+        ringInset[0] = ringInset[1] = 0.0f;
+        ringSin[0] = ringSin[1] = 1.0f;
+        ringCos[0] = ringCos[1] = 0.0f;
+        ringZ[0] = halfDepth;
+        ringZ[1] = -halfDepth;
+        rings = 2;
+    } else {
+        for (int k = 0; k <= steps; ++k) { // Bisel delantero: de la tapa a la pared
+            float theta = EXTRUDE_HALF_PI * (float)k / (float)steps;
+            ringInset[rings] = bevel * (1.0f - sinf(theta));
+            ringZ[rings] = halfDepth - bevel * (1.0f - cosf(theta));
+            ringSin[rings] = sinf(theta);
+            ringCos[rings] = cosf(theta);
+            rings++;
+        }
+        for (int k = steps; k >= 0; --k) { // Bisel trasero, simétrico
+            float theta = EXTRUDE_HALF_PI * (float)k / (float)steps;
+            ringInset[rings] = bevel * (1.0f - sinf(theta));
+            ringZ[rings] = -halfDepth + bevel * (1.0f - cosf(theta));
+            ringSin[rings] = sinf(theta);
+            ringCos[rings] = -cosf(theta);
+            rings++;
+        }
+    }
+
+    // --- Tapas: el contorno metido hacia dentro por el bisel ---
+    resetOutlineData(&ex->capOutline);
+    for (size_t c = 0; c < ex->clean.count; ++c) {
+        const ContourC* contour = &ex->clean.contours[c];
+        const Point2D* p = outlineContourPoints(&ex->clean, contour);
+        if (beginOutlineContour(&ex->capOutline) != 0) return -1;
+        for (size_t i = 0; i < contour->count; ++i) {
+            Point2D o = ex->miters[contour->start + i];
+            if (addOutlinePoint(&ex->capOutline, (Point2D){ p[i].x - o.x * bevel, p[i].y - o.y * bevel }) != 0) return -1;
+        }
+    }
+    int status = tessellateOutlineInto(&ex->tess, &ex->capOutline, &ex->capMesh);
+    if (status == TESS_CONTEXT_BUFFER_TOO_SMALL) {
+        TESSreal* v = (TESSreal*)realloc(ex->capMesh.vertices, (size_t)ex->capMesh.vertexCount * 2 * sizeof(TESSreal));
+        if (v) { ex->capMesh.vertices = v; ex->capMesh.vertexCapacity = ex->capMesh.vertexCount; }
+        TESSindex* i = (TESSindex*)realloc(ex->capMesh.indices, (size_t)ex->capMesh.indexCount * sizeof(TESSindex));
+        if (i) { ex->capMesh.indices = i; ex->capMesh.indexCapacity = ex->capMesh.indexCount; }
+        if (!v || !i) {
+            fprintf(stderr, "ERROR::GLYPH_EXTRUDE::EXTRUDE_OUTLINE: Realloc falló para las tapas.\n");
+            return -1;
+        }
+        status = tessellateOutlineInto(&ex->tess, &ex->capOutline, &ex->capMesh);
+    }
+    if (status != TESS_CONTEXT_OK) return -1;
+
+    int capVertices = ex->capMesh.vertexCount;
+    int wallVertices = (int)ex->clean.pointCount * 2 * rings;
+    int wallIndices = (int)ex->clean.pointCount * (rings - 1) * 6;
+    if (ensureMeshCapacity(mesh, 2 * capVertices + wallVertices, 2 * ex->capMesh.indexCount + wallIndices) != 0) {
+        fprintf(stderr, "ERROR::GLYPH_EXTRUDE::EXTRUDE_OUTLINE: Realloc falló para la malla.\n");
+        return -1;
+    }
+
+    const TESSreal* cv = ex->capMesh.vertices;
+    for (int v = 0; v < capVertices; ++v) pushVertex(mesh, cv[2 * v], cv[2 * v + 1], halfDepth, 0.0f, 0.0f, 1.0f);
+    for (int v = 0; v < capVertices; ++v) pushVertex(mesh, cv[2 * v], cv[2 * v + 1], -halfDepth, 0.0f, 0.0f, -1.0f);
+    for (int t = 0; t + 2 < ex->capMesh.indexCount; t += 3) {
+        GLuint a = (GLuint)ex->capMesh.indices[t], b = (GLuint)ex->capMesh.indices[t + 1], c = (GLuint)ex->capMesh.indices[t + 2];
+        float cross = (cv[2 * b] - cv[2 * a]) * (cv[2 * c + 1] - cv[2 * a + 1]) -
+                      (cv[2 * b + 1] - cv[2 * a + 1]) * (cv[2 * c] - cv[2 * a]);
+        if (cross == 0.0f) continue; // libtess2 deja a veces triángulos degenerados
+        if (cross < 0.0f) { GLuint tmp = b; b = c; c = tmp; }
+        pushTriangle(mesh, a, b, c); // Delantera, antihoraria vista desde +z
+        pushTriangle(mesh, a + (GLuint)capVertices, c + (GLuint)capVertices, b + (GLuint)capVertices);
+    }
+
+    // --- Paredes: por arista, una pareja de vértices por anillo. Las esquinas
+    // suaves comparten normal; las vivas usan la normal de cada arista. ---
+    for (size_t c = 0; c < ex->clean.count; ++c) {
+        const ContourC* contour = &ex->clean.contours[c];
+        const Point2D* p = outlineContourPoints(&ex->clean, contour);
+        size_t n = contour->count;
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = (i + 1) % n;
+            size_t gi = contour->start + i, gj = contour->start + j;
+            Point2D ne = edgeNormal(p[i], p[j], fillLeft);
+            Point2D nStart = ex->smooth[gi] ? ex->smoothNormals[gi] : ne;
+            Point2D nEnd = ex->smooth[gj] ? ex->smoothNormals[gj] : ne;
+            GLuint base = (GLuint)mesh->vertexCount;
+
+            for (int r = 0; r < rings; ++r) {
+                float s = ringSin[r], cz = ringCos[r];
+                float inset = ringInset[r];
+                pushVertex(mesh, p[i].x - ex->miters[gi].x * inset, p[i].y - ex->miters[gi].y * inset, ringZ[r],
+                           nStart.x * s, nStart.y * s, cz);
+                pushVertex(mesh, p[j].x - ex->miters[gj].x * inset, p[j].y - ex->miters[gj].y * inset, ringZ[r],
+                           nEnd.x * s, nEnd.y * s, cz);
+            }
+            for (int r = 0; r + 1 < rings; ++r) {
+                GLuint a0 = base + 2 * (GLuint)r, a1 = a0 + 1, b0 = a0 + 2, b1 = a0 + 3;
+                if (fillLeft) {
+                    pushTriangle(mesh, a0, b0, a1);
+                    pushTriangle(mesh, a1, b0, b1);
+                } else {
+                    pushTriangle(mesh, a0, a1, b0);
+                    pushTriangle(mesh, a1, b1, b0);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+
+// ==== Caché por (glifo, tamaño) ====
+
+#define EXTRUDE_CACHE_SIZE 256
+
+typedef struct ExtrudedGlyphNode {
+    ExtrudedGlyph glyph;
+    struct ExtrudedGlyphNode* next;
+} ExtrudedGlyphNode;
+
+static ExtrudedGlyphNode* extrudeCache[EXTRUDE_CACHE_SIZE];
+static ExtrudeParams extrudeParams = { EXTRUDE_DEFAULT_DEPTH_PX, EXTRUDE_DEFAULT_BEVEL_PX, EXTRUDE_DEFAULT_BEVEL_STEPS };
+static GlyphExtruder cacheExtruder;
+static OutlineDataC cacheOutline;
+static int cacheExtruderReady = 0;
+static size_t extrudeBuildCount = 0;
+
+// Arena compartida; en tests solo se llevan los contadores
+static GLint arenaVertexCount = 0;
+static GLint arenaIndexCount = 0;
+#ifndef UNIT_TESTING
+static GLuint arenaVAO = 0, arenaVBO = 0, arenaEBO = 0, instanceVBO = 0;
+#endif
+
+static void clearExtrudeCache(void) {
+    for (int i = 0; i < EXTRUDE_CACHE_SIZE; ++i) {
+        ExtrudedGlyphNode* node = extrudeCache[i];
+        while (node) {
+            ExtrudedGlyphNode* next = node->next;
+            free(node);
+            node = next;
+        }
+        extrudeCache[i] = NULL;
+    }
+    // Las mallas viejas se sobrescriben: la arena vuelve a empezar
+    arenaVertexCount = 0;
+    arenaIndexCount = 0;
+}
+
+void setExtrudeParams(const ExtrudeParams* params) {
+    if (!params) return;
+    if (memcmp(params, &extrudeParams, sizeof(ExtrudeParams)) == 0) return;
+    extrudeParams = *params;
+    clearExtrudeCache();
+}
+
+const ExtrudeParams* getExtrudeParams(void) {
+    return &extrudeParams;
+}
+
+size_t getExtrudedGlyphBuildCount(void) {
+    return extrudeBuildCount;
+}
+
+static int uploadExtrudedMesh(const ExtrudedMeshBuffer* mesh, ExtrudedGlyph* glyph) {
+    if (arenaVertexCount + mesh->vertexCount > EXTRUDE_ARENA_VERTICES ||
+        arenaIndexCount + mesh->indexCount > EXTRUDE_ARENA_INDICES) {
+        fprintf(stderr, "ADVERTENCIA::GLYPH_EXTRUDE::UPLOAD: Arena de mallas extruidas llena para U+%04lX.\n", glyph->codepoint);
+        return -1;
+    }
+#ifndef UNIT_TESTING
+    if (arenaVAO == 0) {
+        glGenVertexArrays(1, &arenaVAO);
+        glGenBuffers(1, &arenaVBO);
+        glGenBuffers(1, &arenaEBO);
+        glGenBuffers(1, &instanceVBO);
+        glBindVertexArray(arenaVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, arenaVBO);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)EXTRUDE_ARENA_VERTICES * EXTRUDE_VERTEX_FLOATS * sizeof(GLfloat), NULL, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, EXTRUDE_VERTEX_FLOATS * sizeof(GLfloat), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, EXTRUDE_VERTEX_FLOATS * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arenaEBO); // Queda ligado al VAO
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)EXTRUDE_ARENA_INDICES * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glVertexAttribDivisor(2, 1); // Desplazamiento del pen por instancia
+        glEnableVertexAttribArray(2);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, arenaVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)arenaVertexCount * EXTRUDE_VERTEX_FLOATS * sizeof(GLfloat),
+                    (GLsizeiptr)mesh->vertexCount * EXTRUDE_VERTEX_FLOATS * sizeof(GLfloat), mesh->vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(arenaVAO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)arenaIndexCount * sizeof(GLuint),
+                    (GLsizeiptr)mesh->indexCount * sizeof(GLuint), mesh->indices);
+    glBindVertexArray(0);
+#endif
+    glyph->baseVertex = arenaVertexCount;
+    glyph->firstIndex = (GLuint)arenaIndexCount;
+    glyph->indexCount = mesh->indexCount;
+    glyph->vertexCount = mesh->vertexCount;
+    arenaVertexCount += mesh->vertexCount;
+    arenaIndexCount += mesh->indexCount;
+    return 0;
+}
+
+static void buildExtrudedGlyph(ExtrudedGlyph* glyph) {
+    TRACE_SCOPE("buildExtrudedGlyph");
+    extrudeBuildCount++;
+    if (!ftFace) return;
+    if (!cacheExtruderReady) {
+        if (initGlyphExtruder(&cacheExtruder) != 0) return;
+        if (initOutlineData(&cacheOutline, 8) != 0) {
+            freeGlyphExtruder(&cacheExtruder);
+            return;
+        }
+        cacheExtruderReady = 1;
+    }
+
+    FT_UInt glyphIndex = FT_Get_Char_Index(ftFace, glyph->codepoint);
+    if (glyphIndex == 0) return;
+    if (FT_Set_Pixel_Sizes(ftFace, 0, (FT_UInt)glyph->pixelSize) != 0 ||
+        FT_Load_Glyph(ftFace, glyphIndex, FT_LOAD_NO_BITMAP) != 0) {
+        fprintf(stderr, "ERROR::GLYPH_EXTRUDE::BUILD: No se pudo cargar U+%04lX a %dpx.\n", glyph->codepoint, glyph->pixelSize);
+        return;
+    }
+    glyph->advanceX = (float)ftFace->glyph->advance.x / 64.0f;
+    glyph->glyphIndex = glyphIndex; // Métricas listas: la ruta 3D no necesita el SDF
+    if (ftFace->glyph->format != FT_GLYPH_FORMAT_OUTLINE || ftFace->glyph->outline.n_contours == 0) return;
+
+    resetOutlineData(&cacheOutline);
+    // Misma regla que las mallas planas: sin facetas hasta VECTOR_MESH_MAX_SCREEN_PX
+    cacheOutline.flatnessTolerance = VECTOR_MESH_TOLERANCE_PX * (float)glyph->pixelSize / VECTOR_MESH_MAX_SCREEN_PX;
+    if (extractOutline(&ftFace->glyph->outline, &cacheOutline) != 0) return;
+
+    ExtrudeParams scaled = extrudeParams; // Los parámetros están en px del tamaño de carga
+    float sizeScale = (float)glyph->pixelSize / (float)GLYPH_LOAD_PIXEL_SIZE;
+    scaled.depth *= sizeScale;
+    scaled.bevelSize *= sizeScale;
+    if (extrudeOutline(&cacheExtruder, &cacheOutline, &scaled) != 0) return;
+    if (cacheExtruder.mesh.indexCount > 0) uploadExtrudedMesh(&cacheExtruder.mesh, glyph);
+}
+
+const ExtrudedGlyph* getExtrudedGlyph(FT_ULong codepoint, int pixelSize) {
+    unsigned int bucket = (unsigned int)((codepoint * 31u + (FT_ULong)pixelSize) % EXTRUDE_CACHE_SIZE);
+    for (ExtrudedGlyphNode* node = extrudeCache[bucket]; node; node = node->next) {
+        if (node->glyph.codepoint == codepoint && node->glyph.pixelSize == pixelSize) return &node->glyph;
+    }
+
+    ExtrudedGlyphNode* node = (ExtrudedGlyphNode*)calloc(1, sizeof(ExtrudedGlyphNode));
+    if (!node) {
+        fprintf(stderr, "ERROR::GLYPH_EXTRUDE::GET: Calloc falló para U+%04lX.\n", codepoint);
+        return NULL;
+    }
+    node->glyph.codepoint = codepoint;
+    node->glyph.pixelSize = pixelSize;
+    buildExtrudedGlyph(&node->glyph); // Sin malla también se cachea: no se reintenta
+    node->next = extrudeCache[bucket];
+    extrudeCache[bucket] = node;
+    return &node->glyph;
+}
+
+void cleanupExtrudedGlyphs(void) {
+    clearExtrudeCache();
+#ifndef UNIT_TESTING
+    if (arenaVAO != 0) {
+        glDeleteVertexArrays(1, &arenaVAO);
+        glDeleteBuffers(1, &arenaVBO);
+        glDeleteBuffers(1, &arenaEBO);
+        glDeleteBuffers(1, &instanceVBO);
+        arenaVAO = arenaVBO = arenaEBO = instanceVBO = 0;
+    }
+#endif
+    if (cacheExtruderReady) {
+        freeGlyphExtruder(&cacheExtruder);
+        freeOutlineData(&cacheOutline);
+        cacheExtruderReady = 0;
+    }
+}
+
+
+// ==== Lote instanciado ====
+
+void extrudedBatchBegin(ExtrudedTextBatch* batch, int pixelSize) {
+    batch->pixelSize = pixelSize;
+    batch->instanceCount = 0;
+    batch->runCount = 0;
+}
+
+float extrudedBatchAdd(ExtrudedTextBatch* batch, FT_ULong codepoint, float penX, float penY) {
+    const ExtrudedGlyph* glyph = getExtrudedGlyph(codepoint, batch->pixelSize);
+    if (!glyph) return 0.0f;
+    if (glyph->indexCount == 0) return glyph->advanceX;
+
+    if (batch->instanceCount >= batch->instanceCapacity) {
+        int capacity = batch->instanceCapacity ? batch->instanceCapacity * 2 : 256;
+        ExtrudedInstance* instances = (ExtrudedInstance*)realloc(batch->instances, (size_t)capacity * sizeof(ExtrudedInstance));
+        GLfloat* offsets = instances ? (GLfloat*)realloc(batch->offsets, (size_t)capacity * 2 * sizeof(GLfloat)) : NULL;
+        if (instances) batch->instances = instances;
+        if (offsets) batch->offsets = offsets;
+        if (!instances || !offsets) {
+            fprintf(stderr, "ERROR::GLYPH_EXTRUDE::BATCH_ADD: Realloc falló.\n");
+            return glyph->advanceX;
+        }
+        batch->instanceCapacity = capacity;
+    }
+    batch->instances[batch->instanceCount++] = (ExtrudedInstance){ glyph, penX, penY };
+    return glyph->advanceX;
+}
+
+static int compareInstances(const void* a, const void* b) {
+    const ExtrudedInstance* ia = (const ExtrudedInstance*)a;
+    const ExtrudedInstance* ib = (const ExtrudedInstance*)b;
+    if (ia->glyph->firstIndex != ib->glyph->firstIndex) return ia->glyph->firstIndex < ib->glyph->firstIndex ? -1 : 1;
+    if (ia->x != ib->x) return ia->x < ib->x ? -1 : 1;
+    return (ia->y < ib->y) ? -1 : (ia->y > ib->y);
+}
+
+int extrudedBatchFinish(ExtrudedTextBatch* batch) {
+    batch->runCount = 0;
+    if (batch->instanceCount == 0) return 0;
+    // Agrupa por glifo (firstIndex es único por malla en la arena)
+    qsort(batch->instances, (size_t)batch->instanceCount, sizeof(ExtrudedInstance), compareInstances);
+    for (int i = 0; i < batch->instanceCount; ++i) {
+        const ExtrudedInstance* inst = &batch->instances[i];
+        batch->offsets[2 * i] = inst->x;
+        batch->offsets[2 * i + 1] = inst->y;
+        if (batch->runCount > 0 && batch->runs[batch->runCount - 1].glyph == inst->glyph) {
+            batch->runs[batch->runCount - 1].instanceCount++;
+            continue;
+        }
+        if (batch->runCount >= batch->runCapacity) {
+            int capacity = batch->runCapacity ? batch->runCapacity * 2 : 64;
+            ExtrudedRun* runs = (ExtrudedRun*)realloc(batch->runs, (size_t)capacity * sizeof(ExtrudedRun));
+            if (!runs) {
+                fprintf(stderr, "ERROR::GLYPH_EXTRUDE::BATCH_FINISH: Realloc falló.\n");
+                return -1;
+            }
+            batch->runs = runs;
+            batch->runCapacity = capacity;
+        }
+        batch->runs[batch->runCount++] = (ExtrudedRun){ inst->glyph, i, 1 };
+    }
+    return 0;
+}
+
+void freeExtrudedBatch(ExtrudedTextBatch* batch) {
+    if (!batch) return;
+    free(batch->instances);
+    free(batch->offsets);
+    free(batch->runs);
+    memset(batch, 0, sizeof(*batch));
+}
+
+void drawExtrudedBatch(const ExtrudedTextBatch* batch, GLuint program, const GLfloat view[16],
+                       float scale, const float color[3]) {
+#ifndef UNIT_TESTING
+    if (!batch || batch->runCount == 0 || program == 0 || arenaVAO == 0) return;
+    TRACE_SCOPE("drawExtrudedBatch");
+    glUseProgram(program);
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, view);
+    glUniform1f(glGetUniformLocation(program, "glyphScale"), scale);
+    glUniform3fv(glGetUniformLocation(program, "textColor"), 1, color);
+
+    glBindVertexArray(arenaVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // Huérfano + subida completa: un solo trasvase de offsets por frame
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)batch->instanceCount * 2 * sizeof(GLfloat), batch->offsets, GL_STREAM_DRAW);
+    glEnable(GL_DEPTH_TEST);
+    for (int r = 0; r < batch->runCount; ++r) {
+        const ExtrudedRun* run = &batch->runs[r];
+        // Sin baseInstance en GL 3.3: se desplaza el puntero del atributo por instancia
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat),
+                              (void*)((size_t)run->firstInstance * 2 * sizeof(GLfloat)));
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, run->glyph->indexCount, GL_UNSIGNED_INT,
+                                          (void*)((size_t)run->glyph->firstIndex * sizeof(GLuint)),
+                                          run->instanceCount, run->glyph->baseVertex);
+    }
+    glDisable(GL_DEPTH_TEST);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+#else
+    (void)batch; (void)program; (void)view; (void)scale; (void)color;
+#endif
+}
@@ -0,0 +1,115 @@
+#ifndef GLYPH_EXTRUDE_H
+#define GLYPH_EXTRUDE_H
+
+#include <GL/glew.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "tessellation_handler.h" // TessellationContext, GlyphMeshBuffer
+#include "freetype_handler.h"     // OutlineDataC
+
+// Extrusión 3D de glifos a partir de los contornos de OutlineDataC: tapa
+// delantera (z = +depth/2), tapa trasera (z = -depth/2) y paredes laterales
+// con normales, con bisel redondeado opcional. Coordenadas en px de la fuente
+// con origen en el pen, como las mallas planas de glyph_mesh.h.
+
+typedef struct {
+    float depth;      // Profundidad total
+    float bevelSize;  // Radio del bisel; 0 = aristas vivas (se limita a depth/2)
+    int bevelSteps;   // Segmentos del cuarto de círculo del bisel (0 = sin bisel)
+} ExtrudeParams;
+
+#define EXTRUDE_VERTEX_FLOATS 6 // x, y, z, nx, ny, nz
+
+typedef struct {
+    GLfloat* vertices;
+    int vertexCount;
+    int vertexCapacity;   // En vértices
+    GLuint* indices;      // 3 por triángulo, caras hacia fuera en sentido antihorario
+    int indexCount;
+    int indexCapacity;
+} ExtrudedMeshBuffer;
+
+// Estado reutilizable entre glifos (sin mallocs una vez crecido)
+typedef struct {
+    TessellationContext tess;
+    OutlineDataC clean;       // Contornos sin puntos repetidos
+    OutlineDataC capOutline;  // Contornos de las tapas (metidos hacia dentro por el bisel)
+    GlyphMeshBuffer capMesh;
+    Point2D* miters;          // Desplazamiento unitario hacia fuera por punto (inglete)
+    Point2D* smoothNormals;   // Normal de la pared en el punto si la esquina es suave
+    unsigned char* smooth;
+    size_t scratchCapacity;
+    ExtrudedMeshBuffer mesh;  // Salida de extrudeOutline
+} GlyphExtruder;
+
+int initGlyphExtruder(GlyphExtruder* ex);
+void freeGlyphExtruder(GlyphExtruder* ex);
+
+// Construye la malla en ex->mesh (válida hasta la siguiente llamada).
+// Un contorno vacío da una malla vacía. Devuelve 0 si todo fue bien.
+int extrudeOutline(GlyphExtruder* ex, const OutlineDataC* outline, const ExtrudeParams* params);
+
+
+// --- Caché por (glifo, tamaño) ---
+// Cada glifo se extruye una sola vez por tamaño y se sube a una arena
+// VBO/IBO compartida; el texto se dibuja con una instancia por carácter.
+
+typedef struct {
+    FT_ULong codepoint;
+    int pixelSize;
+    float advanceX;       // px al pixelSize
+    FT_UInt glyphIndex;   // En ftFace; 0 = no está (el renderer usa GlyphInfo)
+    GLint baseVertex;     // Primer vértice en la arena
+    GLuint firstIndex;    // Primer índice en la arena
+    GLsizei indexCount;   // 0 = sin malla (espacios, glifos bitmap, arena llena)
+    int vertexCount;
+} ExtrudedGlyph;
+
+// Cambiar los parámetros vacía la caché (los punteros ExtrudedGlyph dejan de valer)
+void setExtrudeParams(const ExtrudeParams* params);
+const ExtrudeParams* getExtrudeParams(void);
+
+// Usa la fuente principal (ftFace). Nunca devuelve NULL salvo sin memoria.
+const ExtrudedGlyph* getExtrudedGlyph(FT_ULong codepoint, int pixelSize);
+size_t getExtrudedGlyphBuildCount(void); // Extrusiones hechas desde el arranque
+void cleanupExtrudedGlyphs(void);
+
+
+// --- Lote instanciado ---
+// Se añaden caracteres con su posición de pen; extrudedBatchFinish agrupa las
+// instancias por glifo y el dibujo hace un glDrawElementsInstancedBaseVertex
+// por glifo distinto.
+
+typedef struct {
+    const ExtrudedGlyph* glyph;
+    float x, y;
+} ExtrudedInstance;
+
+typedef struct {
+    const ExtrudedGlyph* glyph;
+    int firstInstance;
+    int instanceCount;
+} ExtrudedRun;
+
+typedef struct {
+    int pixelSize;
+    ExtrudedInstance* instances;
+    int instanceCount;
+    int instanceCapacity;
+    GLfloat* offsets;     // x, y por instancia en orden de runs (tras finish)
+    ExtrudedRun* runs;
+    int runCount;
+    int runCapacity;
+} ExtrudedTextBatch;
+
+void extrudedBatchBegin(ExtrudedTextBatch* batch, int pixelSize);
+// Devuelve el avance en px (al pixelSize del lote); los glifos sin malla no generan instancia
+float extrudedBatchAdd(ExtrudedTextBatch* batch, FT_ULong codepoint, float penX, float penY);
+int extrudedBatchFinish(ExtrudedTextBatch* batch);
+void freeExtrudedBatch(ExtrudedTextBatch* batch);
+
+// view: matriz 4x4 (column-major) aplicada tras escalar px -> mundo con scale
+void drawExtrudedBatch(const ExtrudedTextBatch* batch, GLuint program, const GLfloat view[16],
+                       float scale, const float color[3]);
+
+#endif // GLYPH_EXTRUDE_H
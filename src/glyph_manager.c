@@ -1,8 +1,16 @@
 #include "glyph_manager.h"
 #include "freetype_handler.h"     // Para ftFace, ftEmojiFace
-#include "sdf_generator.h"        // Para generate_sdf_from_bitmap y free_sdf_bitmap
-// #include "tessellation_handler.h" // No es necesaria si solo haces SDF
-
+#include "sdf_generator.h"        // Para free_sdf_bitmap
+#include "sdf_backend.h"          // Generador de SDF elegido al arrancar
+#include "bc4_encoder.h"          // SDF comprimidos (TEXT3D_SDF_BC4)
+#include "kerning.h"              // Tabla de pares de ftFace
+#include "frame_timing.h"         // Para medir el coste de los misses
+#include "trace.h"                // TRACE_SCOPE (solo con TEXT3D_TRACE)
+#include "glyph_mesh.h"           // Mallas teseladas para la ruta vectorial
+#include "glyph_extrude.h"        // Caché de mallas extruidas (se limpia con la de glifos)
+#include "config.h"               // GLYPH_LOAD_PIXEL_SIZE
+
+#include <math.h>   // fabsf
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> // Para memset
@@ -19,6 +27,98 @@ static void init_glyph_info(GlyphInfo* info) {
     memset(info, 0, sizeof(GlyphInfo));
     // Inicializaciones específicas si 0 no es el valor por defecto deseado
     // info->vao = 0; // etc. ya cubierto por memset
+    info->sdfChannels = 1;
+}
+
+int sdfBc4Enabled = 0;
+
+// Sube el SDF (GL_R8, BC4 con sdfBc4Enabled, o GL_RGB8 si es MSDF; filas sin
+// relleno) a una textura propia del glifo
+static void upload_sdf_texture(const SdfGlyphImage* image, GLuint* outTextureID, FT_ULong char_code) {
+#ifndef UNIT_TESTING
+    glGenTextures(1, outTextureID);
+    printf("INFO::GLYPH_MANAGER: SDF generado OK para U+%04lX: width=%d, height=%d, textureID=%u\n",
+            char_code, image->width, image->height, *outTextureID);
+    glBindTexture(GL_TEXTURE_2D, *outTextureID);
+
+    // === ESTO ARREGLÓ EL PROBLEMA DE LAS LETRAS GARBAGE ===
+    /*
+    The problem of deformed or "sheared" letters, especially when some 
+    characters render correctly while others don't, and the issue persists 
+    across different GPUs, strongly points to a data alignment problem when 
+    providing texture data to OpenGL. Specifically, the GL_UNPACK_ALIGNMENT 
+    parameter, which defaults to 4, is the likely culprit.
+
+    GL_UNPACK_ALIGNMENT: OpenGL, by default, assumes that the starting address
+    of each row of pixel data you provide (e.g., to glTexImage2D) is aligned 
+    to a 4-byte boundary.
+    SDF Bitmap Data: In sdf_generator.c, the output SDF bitmap (sdf_bitmap_out) 
+    is a tightly packed array where each row immediately follows the previous. 
+    The width of this bitmap (sdf_w, which becomes info->sdfTextureWidth in 
+    glyph_manager.c) depends on the original FreeType bitmap width plus padding. 
+    This width is not guaranteed to be a multiple of 4.
+        unsigned char* sdf_bitmap_out = (unsigned char*)malloc(sdf_w * sdf_h);
+        Data is accessed as sdf_bitmap_out[y * sdf_w + x].
+    */
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); 
+
+    unsigned char* compressed = NULL;
+    size_t compressedSize = bc4CompressedSize(image->width, image->height);
+    if (sdfBc4Enabled && image->channels == 1) compressed = (unsigned char*)malloc(compressedSize);
+    if (compressed && bc4EncodeImage(image->data, image->width, image->height, image->width, compressed) == 0) {
+        // RGTC1: mitad de memoria que GL_R8; el MSDF (3 canales) no tiene equivalente y va sin comprimir
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RED_RGTC1, image->width, image->height, 0,
+                               (GLsizei)compressedSize, compressed);
+    } else if (image->channels == 3) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, image->width, image->height, 0, GL_RGB, GL_UNSIGNED_BYTE, image->data);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, image->width, image->height, 0, GL_RED, GL_UNSIGNED_BYTE, image->data);
+    }
+    free(compressed);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    // === OPTIONAL: Restore default alignment if other parts of your code expect it ===
+    // glPixelStorei(GL_UNPACK_ALIGNMENT, 4); 
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+#else
+    (void)image; (void)char_code;
+    *outTextureID = 0;
+#endif
+}
+
+int sdfTrimEnabled = 1;
+
+// SDF con el backend elegido al arrancar (ver sdf_backend.h) con el glifo ya
+// cargado a GLYPH_LOAD_PIXEL_SIZE. Si falla (contorno degenerado, FreeType
+// sin sdf...), se recarga el glifo y se intenta desde la cobertura del bitmap.
+static int generate_sdf_image(FT_Face face, FT_UInt glyph_index, int em_pixel_size, SdfGlyphImage* image) {
+    float sdf_spread = SDF_SPREAD_TEXELS;
+    int sdf_padding = sdfPaddingForSpread(sdf_spread);
+    int status = generateGlyphSdfAtSize(sdfBackend, face, glyph_index, em_pixel_size, sdf_padding, sdf_spread, image);
+    if (status != 0 && sdfBackend != SDF_BACKEND_COVERAGE && FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT) == 0) {
+        status = generateGlyphSdfAtSize(SDF_BACKEND_COVERAGE, face, glyph_index, em_pixel_size, sdf_padding, sdf_spread, image);
+    }
+    if (status == 0 && sdfTrimEnabled) trimSdfImage(image);
+    return status;
+}
+
+// Cara que tiene el glifo (la principal o, si no, la de emoji); 0 si ninguna
+static FT_UInt find_glyph_face(FT_ULong char_code, FT_Face* out_face) {
+    *out_face = ftFace;
+    if (char_code & GLYPH_CACHE_INDEX_FLAG) return (FT_UInt)(char_code & ~GLYPH_CACHE_INDEX_FLAG); // Glifo del shaper
+    FT_UInt glyph_index = FT_Get_Char_Index(ftFace, char_code);
+    if (glyph_index == 0 && ftEmojiFace != NULL) {
+        // printf("[GM] U+%04lX not in main font, trying emoji font.\n", char_code);
+        *out_face = ftEmojiFace;
+        glyph_index = FT_Get_Char_Index(ftEmojiFace, char_code);
+    }
+    return glyph_index;
 }
 
 static GlyphInfo generate_glyph_data_for_codepoint(FT_ULong char_code) {
@@ -32,20 +132,14 @@ static GlyphInfo generate_glyph_data_for_codepoint(FT_ULong char_code) {
         return result; // result está vacía/cero
     }
 
-    FT_UInt glyph_index = FT_Get_Char_Index(current_ft_face, char_code);
+    FT_UInt glyph_index = find_glyph_face(char_code, &current_ft_face);
 
-    if (glyph_index == 0 && ftEmojiFace != NULL) {
-        // printf("[GM] U+%04lX not in main font, trying emoji font.\n", char_code);
-        current_ft_face = ftEmojiFace;
-        glyph_index = FT_Get_Char_Index(current_ft_face, char_code);
-    }
-    
     if (glyph_index == 0) {
         // fprintf(stderr, "WARN::GLYPH_MANAGER::GENERATE_GLYPH: Glyph not found for U+%04lX. Returning empty glyph.\n", char_code);
         return result; // result.advanceX será 0.0, etc.
     }
 
-    ftError = FT_Set_Pixel_Sizes(current_ft_face, 0, 48); // 48 
+    ftError = FT_Set_Pixel_Sizes(current_ft_face, 0, GLYPH_LOAD_PIXEL_SIZE); 
     if (ftError) {
         fprintf(stderr, "ERROR::GLYPH_MANAGER::GENERATE_GLYPH: FT_Set_Pixel_Sizes falló para U+%04lX. Error: %d\n", char_code, ftError);
         return result; 
@@ -66,134 +160,26 @@ static GlyphInfo generate_glyph_data_for_codepoint(FT_ULong char_code) {
            char_code, glyph_index, current_ft_face->glyph->advance.x);
 
     result.advanceX = (float)(current_ft_face->glyph->advance.x) / 64.0f; // Convertir a píxeles
-
-    // Renderizar el glifo a un bitmap para SDF y para obtener métricas de bitmap correctas
-    // Es importante renderizar ANTES de acceder a glyph->bitmap_left/top y glyph->bitmap.
-    if (current_ft_face->glyph->format == FT_GLYPH_FORMAT_BITMAP) {
-        // El glifo ya es un bitmap (ej. emojis de color, o fuentes bitmap)
-        // No se puede (o no tiene sentido) generar SDF a partir de esto de la misma manera que de un outline.
-        // Podríamos intentar usarlo directamente o generar un pseudo-SDF.
-        // Por ahora, lo trataremos como si no pudiéramos generar SDF de él.
-         // FT_Render_Glyph(current_ft_face->glyph, FT_RENDER_MODE_NORMAL); // ¿O ya está renderizado?
-    } else if (current_ft_face->glyph->format == FT_GLYPH_FORMAT_OUTLINE) {
-        ftError = FT_Render_Glyph(current_ft_face->glyph, FT_RENDER_MODE_NORMAL); // Render to 8-bit grayscale bitmap
-        if (ftError) {
-            fprintf(stderr, "ERROR::GLYPH_MANAGER::GENERATE_GLYPH: FT_Render_Glyph failed for U+%04lX. Error: %d\n", char_code, ftError);
-            // advanceX ya está seteado. bitmap_left/top podrían no ser válidos.
-            // Devolver result como está (sin datos de textura/bitmap).
-            return result; 
-        }
+    result.glyphIndex = current_ft_face == ftFace ? glyph_index : 0; // La tabla de kerning es la de ftFace
+
+    SdfGlyphImage sdf_image;
+    if (generate_sdf_image(current_ft_face, glyph_index, 0, &sdf_image) == 0) {
+        result.bitmap_left = sdf_image.left;
+        result.bitmap_top = sdf_image.top;
+        result.sdfTextureWidth = sdf_image.width;
+        result.sdfTextureHeight = sdf_image.height;
+        result.sdfTexelSize = sdf_image.texelSize;
+        result.sdfChannels = sdf_image.channels;
+        result.sdfPadding = sdf_image.padding;
+        upload_sdf_texture(&sdf_image, &result.sdfTextureID, char_code);
+        free_sdf_bitmap(sdf_image.data);
     } else {
-         fprintf(stderr, "WARN::GLYPH_MANAGER::GENERATE_GLYPH: Glyph U+%04lX has unhandled format %d.\n", char_code, current_ft_face->glyph->format);
-         return result; // No se puede procesar para SDF
-    }
-
-    // Ahora que glyph->bitmap está poblado (si FT_Render_Glyph tuvo éxito o era un bitmap):
-    FT_Bitmap* ft_bitmap = &current_ft_face->glyph->bitmap;
-    result.bitmap_left = current_ft_face->glyph->bitmap_left;
-    result.bitmap_top  = current_ft_face->glyph->bitmap_top;
-
-    printf("  [GlyphManager DEBUG FT_Bitmap] Char U+%04lX: width=%d, rows=%d, pitch=%d, num_grays=%d, pixel_mode=%d\n",
-       char_code, ft_bitmap->width, ft_bitmap->rows, ft_bitmap->pitch, ft_bitmap->num_grays, ft_bitmap->pixel_mode);
-
-    if (ft_bitmap->buffer && ft_bitmap->width > 0 && ft_bitmap->rows > 0) {
-
-        printf("    First 5x5 pixels of FT_Bitmap for U+%04lX:\n", char_code);
-        for (int r = 0; r < 5 && r < ft_bitmap->rows; ++r) {
-            printf("      ");
-            for (int c = 0; c < 5 && c < ft_bitmap->width; ++c) {
-                printf("%03u ", (unsigned char)ft_bitmap->buffer[r * ft_bitmap->pitch + c]);
-            }
-            printf("\n");
-        }
-
-        int sdf_padding = 4;
-        float sdf_spread = 2.0f; // Definir el valor para spread 
-
-        unsigned char* sdf_data = generate_sdf_from_bitmap(
-            ft_bitmap->buffer,
-            ft_bitmap->width,
-            ft_bitmap->rows,
-            ft_bitmap->pitch,
-            sdf_padding,
-            sdf_spread,
-            &result.sdfTextureWidth,
-            &result.sdfTextureHeight
-        );
-
-        if (sdf_data) {
-            #ifndef UNIT_TESTING
-            glGenTextures(1, &result.sdfTextureID);
-            printf("INFO::GLYPH_MANAGER: SDF generado OK para U+%04lX: width=%d, height=%d, textureID=%u\n",
-                    char_code, result.sdfTextureWidth, result.sdfTextureHeight, result.sdfTextureID);
-            glBindTexture(GL_TEXTURE_2D, result.sdfTextureID);
-
-            // === ESTO ARREGLÓ EL PROBLEMA DE LAS LETRAS GARBAGE ===
-            /*
-            The problem of deformed or "sheared" letters, especially when some 
-            characters render correctly while others don't, and the issue persists 
-            across different GPUs, strongly points to a data alignment problem when 
-            providing texture data to OpenGL. Specifically, the GL_UNPACK_ALIGNMENT 
-            parameter, which defaults to 4, is the likely culprit.
-
-            GL_UNPACK_ALIGNMENT: OpenGL, by default, assumes that the starting address
-            of each row of pixel data you provide (e.g., to glTexImage2D) is aligned 
-            to a 4-byte boundary.
-            SDF Bitmap Data: In sdf_generator.c, the output SDF bitmap (sdf_bitmap_out) 
-            is a tightly packed array where each row immediately follows the previous. 
-            The width of this bitmap (sdf_w, which becomes result.sdfTextureWidth in 
-            glyph_manager.c) depends on the original FreeType bitmap width plus padding. 
-            This width is not guaranteed to be a multiple of 4.
-                unsigned char* sdf_bitmap_out = (unsigned char*)malloc(sdf_w * sdf_h);
-                Data is accessed as sdf_bitmap_out[y * sdf_w + x].
-            */
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); 
-
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, result.sdfTextureWidth, result.sdfTextureHeight, 0, GL_RED, GL_UNSIGNED_BYTE, sdf_data);
-            
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            
-            // === OPTIONAL: Restore default alignment if other parts of your code expect it ===
-            // glPixelStorei(GL_UNPACK_ALIGNMENT, 4); 
-
-            glBindTexture(GL_TEXTURE_2D, 0);
-        #else
-            result.sdfTextureID = 0; 
-        #endif
-            free_sdf_bitmap(sdf_data); // Usar la función de tu sdf_generator.h
-        } else {
-            fprintf(stderr, "WARN::GLYPH_MANAGER::GENERATE_GLYPH: SDF generation failed for U+%04lX.\n", char_code);
-            result.sdfTextureID = 0;
-            result.sdfTextureWidth = 0;
-            result.sdfTextureHeight = 0;
-        }
-    } else { 
-        // Si FT_Render_Glyph falló o el bitmap estaba vacío, no hay datos de textura.
-        // bitmap_left/top podrían haberse establecido desde el slot antes del fallo de render,
-        // pero no corresponden a un bitmap renderizado utilizable para SDF.
-        // Es mejor dejarlos como los puso FT_Load_Glyph o ponerlos a 0 si no hay bitmap.
-        // Si FT_Render_Glyph falló, ya hemos retornado.
-        // Si el bitmap es simplemente vacío (ej. para espacio ' '):
-        if (char_code != ' ') { // No imprimas warnings para el espacio
-             // fprintf(stderr, "WARN::GLYPH_MANAGER::GENERATE_GLYPH: Bitmap for U+%04lX is empty after render.\n", char_code);
-        }
+        // Sin SDF (p. ej. el espacio, cuyo bitmap está vacío): sin textura
         result.sdfTextureID = 0;
         result.sdfTextureWidth = 0;
         result.sdfTextureHeight = 0;
-        // result.bitmap_left = 0; // Opcional: resetear si no hay bitmap válido.
-        // result.bitmap_top = 0;
     }
-    
-    // VAO, VBO, EBO e indexCount no se usan para renderizado SDF puro con un quad global
-    result.vao = 0;
-    result.vbo = 0;
-    result.ebo = 0;
-    result.indexCount = 0;
-    
+
     return result;
 }
 
@@ -206,11 +192,16 @@ int initGlyphCache() {
     for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
         glyphHashTable[i] = NULL;
     }
+    // Kerning de la cara principal al tamaño de carga (el mismo que advanceX)
+    if (ftFace && buildKerningTable(ftFace, GLYPH_LOAD_PIXEL_SIZE, &fontKerningTable) == 0) {
+        printf("Kerning: %zu pares.\n", fontKerningTable.count);
+    }
     printf("Caché de glifos listo.\n");
     return 0; 
 }
 
-GlyphInfo getGlyphInfo(FT_ULong char_code) {
+// Nodo de la caché para char_code, generándolo si no estaba; NULL si malloc falla
+static GlyphCacheNode* find_or_create_node(FT_ULong char_code) {
     // Podrías querer una GlyphInfo "inválida" estática para devolver en caso de error grave.
     // static GlyphInfo invalidGlyph; // inicializada a ceros globalmente o con init_glyph_info
     // if (!ftFace && !ftEmojiFace) return invalidGlyph; // O manejar error
@@ -220,12 +211,14 @@ GlyphInfo getGlyphInfo(FT_ULong char_code) {
 
     while (node != NULL) {
         if (node->char_code == char_code) {
-            return node->glyph_info; 
+            return node;
         }
         node = node->next;
     }
 
+    FRAME_TIMING_BEGIN(missStart);
     GlyphInfo new_glyph_data = generate_glyph_data_for_codepoint(char_code);
+    FRAME_TIMING_END(FRAME_PHASE_GLYPH_MISS, missStart);
 
     // No imprimir warnings si el VAO es 0, ya que no lo estamos usando para SDF con quad global.
     // if (new_glyph_data.sdfTextureID == 0 && char_code != ' ' && char_code != '\t' && char_code != '\n' && char_code != 0xFFFD) {
@@ -235,9 +228,7 @@ GlyphInfo getGlyphInfo(FT_ULong char_code) {
     GlyphCacheNode* newNode = (GlyphCacheNode*)malloc(sizeof(GlyphCacheNode));
     if (newNode == NULL) {
         fprintf(stderr, "ERROR::GLYPH_MANAGER::GET_GLYPH_INFO: Malloc falló para GlyphCacheNode U+%04lX\n", char_code);
-        // Devolver una GlyphInfo vacía o la new_glyph_data (que podría estar parcialmente vacía si falló la gen)
-        init_glyph_info(&new_glyph_data); // Devolver una vacía segura
-        return new_glyph_data; 
+        return NULL;
     }
     newNode->char_code = char_code;
     newNode->glyph_info = new_glyph_data; // Copia la estructura
@@ -245,7 +236,142 @@ GlyphInfo getGlyphInfo(FT_ULong char_code) {
     newNode->next = glyphHashTable[hash_index];
     glyphHashTable[hash_index] = newNode;
     
-    return newNode->glyph_info; // Devuelve la info del nuevo nodo (una copia)
+    return newNode;
+}
+
+GlyphInfo getGlyphInfo(FT_ULong char_code) {
+    TRACE_SCOPE("getGlyphInfo");
+    GlyphCacheNode* node = find_or_create_node(char_code);
+    if (!node) {
+        GlyphInfo empty; // Devolver una vacía segura
+        init_glyph_info(&empty);
+        return empty;
+    }
+    return node->glyph_info; // Copia
+}
+
+int sdfLevelsEnabled = 1;
+static const int sdfLevelSizes[SDF_LEVEL_COUNT] = SDF_LEVEL_SIZES;
+
+int selectSdfLevel(float projectedEmPx) {
+    if (!sdfLevelsEnabled) return -1;
+    float wantedTexels = projectedEmPx * SDF_LEVEL_TEXELS_PER_SCREEN_PX;
+    for (int i = 0; i < SDF_LEVEL_COUNT; ++i) {
+        if ((float)sdfLevelSizes[i] >= wantedTexels) return i;
+    }
+    return SDF_LEVEL_COUNT - 1;
+}
+
+// Tesela y sube la malla del glifo (o la pre-teselada de TEXT3D_PREMESH). Solo
+// la primera vez que un dibujo elige la ruta vectorial: con el texto a tamaño
+// normal nunca se usa y no debe gastar teselado ni sitio en la arena.
+static void generate_glyph_mesh(FT_ULong char_code, GlyphInfo* info) {
+    info->meshState = 1;
+    FT_Face face;
+    FT_UInt glyph_index = find_glyph_face(char_code, &face);
+    if (glyph_index == 0 || FT_Set_Pixel_Sizes(face, 0, GLYPH_LOAD_PIXEL_SIZE) != 0 ||
+        FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT) != 0 || face->glyph->format != FT_GLYPH_FORMAT_OUTLINE) {
+        return;
+    }
+    const GlyphMeshBuffer* mesh = NULL;
+    GlyphMeshBuffer preloaded;
+    int preloadStatus = face == ftFace && !(char_code & GLYPH_CACHE_INDEX_FLAG)
+                        ? findPreloadedGlyphMesh(char_code, &preloaded) : -1;
+    if (preloadStatus == 0) {
+        uploadGlyphMesh(&preloaded, info);
+    } else if (preloadStatus < 0 && buildGlyphMeshFromSlot(face->glyph, &mesh) == 0) {
+        uploadGlyphMesh(mesh, info);
+    }
+}
+
+// Rellena el nivel `level` del glifo. Si coincide con el tamaño del SDF base,
+// lo comparte (misma textura) en lugar de generarlo otra vez.
+static void generate_sdf_level(FT_ULong char_code, GlyphInfo* info, int level) {
+    GlyphSdfLevel* out = &info->sdfLevels[level];
+    out->state = -1;
+    if (info->sdfTextureWidth <= 0) return; // Sin SDF base (espacio, glifo ausente...): tampoco niveles
+
+    int em_pixel_size = sdfLevelSizes[level];
+    if (fabsf(info->sdfTexelSize * (float)em_pixel_size - (float)GLYPH_LOAD_PIXEL_SIZE) < 1e-3f) {
+        out->textureID = info->sdfTextureID;
+        out->width = info->sdfTextureWidth;
+        out->height = info->sdfTextureHeight;
+        out->left = info->bitmap_left;
+        out->top = info->bitmap_top;
+        out->texelSize = info->sdfTexelSize;
+        out->channels = info->sdfChannels;
+        out->padding = info->sdfPadding;
+        out->state = 1;
+        return;
+    }
+
+    FT_Face face;
+    FT_UInt glyph_index = find_glyph_face(char_code, &face);
+    if (glyph_index == 0 || FT_Set_Pixel_Sizes(face, 0, GLYPH_LOAD_PIXEL_SIZE) != 0 ||
+        FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT) != 0) {
+        return;
+    }
+    SdfGlyphImage sdf_image;
+    if (generate_sdf_image(face, glyph_index, em_pixel_size, &sdf_image) != 0) return;
+    out->width = sdf_image.width;
+    out->height = sdf_image.height;
+    out->left = sdf_image.left;
+    out->top = sdf_image.top;
+    out->texelSize = sdf_image.texelSize;
+    out->channels = sdf_image.channels;
+    out->padding = sdf_image.padding;
+    upload_sdf_texture(&sdf_image, &out->textureID, char_code);
+    free_sdf_bitmap(sdf_image.data);
+    out->state = 1;
+}
+
+static GlyphInfo lookup_glyph_info(FT_ULong char_code, int level, int withMesh) {
+    GlyphCacheNode* node = find_or_create_node(char_code);
+    if (!node) {
+        GlyphInfo empty;
+        init_glyph_info(&empty);
+        return empty;
+    }
+    if (withMesh && node->glyph_info.meshState == 0) {
+        FRAME_TIMING_BEGIN(missStart);
+        generate_glyph_mesh(char_code, &node->glyph_info);
+        FRAME_TIMING_END(FRAME_PHASE_GLYPH_MISS, missStart);
+    }
+    if (level < 0 || level >= SDF_LEVEL_COUNT) return node->glyph_info;
+
+    GlyphSdfLevel* sdf_level = &node->glyph_info.sdfLevels[level];
+    if (sdf_level->state == 0) {
+        FRAME_TIMING_BEGIN(missStart);
+        generate_sdf_level(char_code, &node->glyph_info, level);
+        FRAME_TIMING_END(FRAME_PHASE_GLYPH_MISS, missStart);
+    }
+
+    GlyphInfo info = node->glyph_info;
+    if (sdf_level->state == 1) {
+        info.sdfTextureID = sdf_level->textureID;
+        info.sdfTextureWidth = sdf_level->width;
+        info.sdfTextureHeight = sdf_level->height;
+        info.bitmap_left = sdf_level->left;
+        info.bitmap_top = sdf_level->top;
+        info.sdfTexelSize = sdf_level->texelSize;
+        info.sdfChannels = sdf_level->channels;
+        info.sdfPadding = sdf_level->padding;
+    }
+    return info;
+}
+
+GlyphInfo getGlyphInfoForLevel(FT_ULong char_code, int level) {
+    TRACE_SCOPE("getGlyphInfoForLevel");
+    return lookup_glyph_info(char_code, level, 0);
+}
+
+GlyphInfo getGlyphInfoWithMesh(FT_ULong char_code, int level) {
+    TRACE_SCOPE("getGlyphInfoWithMesh");
+    return lookup_glyph_info(char_code, level, 1);
+}
+
+GlyphInfo getGlyphInfoForGlyphIndex(FT_UInt glyph_index, int level) {
+    return getGlyphInfoForLevel(GLYPH_CACHE_INDEX_KEY(glyph_index), level);
 }
 
 void cleanupGlyphCache() {
@@ -257,19 +383,23 @@ void cleanupGlyphCache() {
             node = node->next;
 
         #ifndef UNIT_TESTING
-            // VAO, VBO, EBO no se crean individualmente para SDF con quad global,
-            // así que no hay necesidad de borrarlos aquí.
-            // glDeleteVertexArrays(1, &temp->glyph_info.vao);
-            // glDeleteBuffers(1, &temp->glyph_info.vbo);
-            // glDeleteBuffers(1, &temp->glyph_info.ebo);
-            
+            // VAO/VBO/EBO pertenecen a la arena de mallas: se liberan abajo de una vez
             if (temp->glyph_info.sdfTextureID != 0) {
                 glDeleteTextures(1, &temp->glyph_info.sdfTextureID);
             }
+            for (int level = 0; level < SDF_LEVEL_COUNT; ++level) {
+                GLuint levelTexture = temp->glyph_info.sdfLevels[level].textureID;
+                if (levelTexture != 0 && levelTexture != temp->glyph_info.sdfTextureID) { // Compartida con el base
+                    glDeleteTextures(1, &levelTexture);
+                }
+            }
         #endif
             free(temp);
         }
         glyphHashTable[i] = NULL;
     }
+    freeKerningTable(&fontKerningTable);
+    cleanupGlyphMeshes();
+    cleanupExtrudedGlyphs();
     printf("Caché de glifos limpiado.\n");
 }
\ No newline at end of file
@@ -4,23 +4,50 @@
 #include <GL/glew.h> // Para GLuint, GLsizei
 #include <ft2build.h> // For FT_ULong
 #include FT_FREETYPE_H
+#include "config.h" // SDF_LEVEL_COUNT
 
 #define HASH_TABLE_SIZE 256 // Size of the hash table, can be adjusted
 
+// Un nivel de SDF del glifo (ver SDF_LEVEL_SIZES), con los mismos campos que
+// el SDF base de GlyphInfo
 typedef struct {
-    GLuint vao;         // No se usa para SDF puro si globalQuadVAO se usa para todos
-    GLuint vbo;         // No se usa para SDF puro
-    GLuint ebo;         // No se usa para SDF puro
-    GLsizei indexCount; // No se usa para SDF puro
+    GLuint textureID;
+    int width, height;      // Con padding, en texels
+    int left, top;          // bitmap_left/bitmap_top en texels del nivel
+    int padding;            // Como GlyphInfo.sdfPadding
+    float texelSize;        // GLYPH_LOAD_PIXEL_SIZE / tamaño del nivel
+    int channels;
+    int state;              // 0 = sin generar, 1 = listo, -1 = falló (se usa el SDF base)
+} GlyphSdfLevel;
+
+typedef struct {
+    // Malla vectorial (ver glyph_mesh.h): VAO/VBO/EBO de la arena compartida.
+    // Solo tras getGlyphInfoWithMesh; indexCount == 0 hasta entonces, o si el
+    // glifo no tiene contorno o la arena estaba llena.
+    GLuint vao;
+    GLuint vbo;
+    GLuint ebo;
+    GLsizei indexCount;
+    GLint meshBaseVertex;   // Primer vértice del glifo en el VBO compartido
+    GLuint meshFirstIndex;  // Primer índice del glifo en el IBO compartido
+    int meshState;          // 0 = sin teselar, 1 = intentado (con o sin malla)
 
     float advanceX;         // Avance horizontal en píxeles (unidades FT / 64.0f)
-    int bitmap_left;        // Desplazamiento X desde el origen del pen al borde izq. del bitmap (píxeles)
-    int bitmap_top;         // Desplazamiento Y desde la línea base al borde sup. del bitmap (píxeles)
+    FT_UInt glyphIndex;     // Índice en ftFace para el kerning; 0 si el glifo viene de otra cara
+    int bitmap_left;        // Desplazamiento X desde el origen del pen al borde izq. del bitmap (texels del SDF)
+    int bitmap_top;         // Desplazamiento Y desde la línea base al borde sup. del bitmap (texels del SDF)
 
     // SDF Texture data
     GLuint sdfTextureID;
-    int sdfTextureWidth;    // Ancho de la textura SDF (con padding, en píxeles)
-    int sdfTextureHeight;   // Alto de la textura SDF (con padding, en píxeles)
+    int sdfTextureWidth;    // Ancho de la textura SDF (con padding, en texels)
+    int sdfTextureHeight;   // Alto de la textura SDF (con padding, en texels)
+    float sdfTexelSize;     // Píxeles (a GLYPH_LOAD_PIXEL_SIZE) por texel: GLYPH_LOAD_PIXEL_SIZE /
+                            // tamaño de em de la textura del backend (ver sdf_backend.h)
+    int sdfChannels;        // 1 = SDF (GL_R8), 3 = MSDF (GL_RGB8, el shader toma la mediana)
+    int sdfPadding;         // Texels entre el borde izq./sup. de la textura y bitmap_left/bitmap_top
+
+    // Niveles por tamaño de pantalla; los rellena getGlyphInfoForLevel al pedirlos
+    GlyphSdfLevel sdfLevels[SDF_LEVEL_COUNT];
 } GlyphInfo;
 
 // Node for the hash table (linked list for collision resolution)
@@ -38,4 +65,25 @@ int initGlyphCache(); // Returns 0 for success, non-zero for failure
 GlyphInfo getGlyphInfo(FT_ULong char_code); // Takes Unicode codepoint
 void cleanupGlyphCache();
 
+extern int sdfBc4Enabled;    // 1 = sube los SDF de un canal como BC4/RGTC1 (TEXT3D_SDF_BC4=1)
+extern int sdfTrimEnabled;   // 1 = recorta el exterior saturado de cada SDF (TEXT3D_SDF_TRIM=0 lo desactiva)
+extern int sdfLevelsEnabled; // 0 = siempre el SDF base (TEXT3D_SDF_LEVELS=0)
+// Nivel para un em de projectedEmPx píxeles en pantalla; -1 = SDF base
+int selectSdfLevel(float projectedEmPx);
+// Como getGlyphInfo, pero con los campos SDF (sdfTextureID, tamaño,
+// bitmap_left/top, sdfTexelSize, sdfChannels) del nivel `level`, que se
+// genera la primera vez. Con level < 0 o si el nivel falla, el SDF base.
+GlyphInfo getGlyphInfoForLevel(FT_ULong char_code, int level);
+// Como getGlyphInfoForLevel, y además con la malla vectorial, que se tesela y
+// se sube la primera vez (ruta vectorial del renderer)
+GlyphInfo getGlyphInfoWithMesh(FT_ULong char_code, int level);
+
+// Los glifos que salen del shaper (ligaduras, formas contextuales del árabe...)
+// no tienen codepoint propio: van en la misma caché con la clave del índice de
+// glifo de ftFace marcada con este bit, que ningún codepoint usa
+#define GLYPH_CACHE_INDEX_FLAG 0x80000000UL
+#define GLYPH_CACHE_INDEX_KEY(glyphIndex) (GLYPH_CACHE_INDEX_FLAG | (FT_ULong)(glyphIndex))
+// Como getGlyphInfoForLevel, para el glifo glyph_index de ftFace
+GlyphInfo getGlyphInfoForGlyphIndex(FT_UInt glyph_index, int level);
+
 #endif // GLYPH_MANAGER_H
\ No newline at end of file
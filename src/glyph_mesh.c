@@ -0,0 +1,204 @@
+#include "glyph_mesh.h"
+#include "freetype_handler.h" // OutlineDataC, extractOutline
+#include "batch_tessellation.h"
+#include "mesh_optimizer.h"
+#include "config.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Estado del constructor: un contorno, un teselador y un buffer de salida
+// reutilizados de glifo en glifo (ver TessellationContext).
+static OutlineDataC meshOutline;
+static TessellationContext meshTessContext;
+static GlyphMeshBuffer meshBuffer;
+static int meshBuilderReady = 0;
+
+// Salida del post-proceso, reutilizada en cada subida
+static OptimizedMesh meshOptimized;
+
+// Mallas teseladas por adelantado (preloadGlyphMeshes) para la fuente principal
+static GlyphMeshBatch preloadedMeshes;
+
+#ifndef UNIT_TESTING
+typedef struct {
+    GLuint vao, vbo, ebo;
+    GLint vertexCount;
+    GLint indexCount;
+} GlyphMeshArena;
+
+static GlyphMeshArena meshArena = {0};
+#endif
+
+static int initMeshBuilder(void) {
+    if (meshBuilderReady) return 0;
+    if (initOutlineData(&meshOutline, 8) != 0) return -1;
+    if (initTessellationContext(&meshTessContext, 0) != 0) {
+        freeOutlineData(&meshOutline);
+        return -1;
+    }
+    meshOutline.flatnessTolerance = GLYPH_MESH_FLATNESS;
+    meshBuilderReady = 1;
+    return 0;
+}
+
+static int growMeshBuffer(int vertexCount, int indexCount) {
+    if (vertexCount > meshBuffer.vertexCapacity) {
+        TESSreal* v = (TESSreal*)realloc(meshBuffer.vertices, (size_t)vertexCount * 2 * sizeof(TESSreal));
+        if (!v) return -1;
+        meshBuffer.vertices = v;
+        meshBuffer.vertexCapacity = vertexCount;
+    }
+    if (indexCount > meshBuffer.indexCapacity) {
+        TESSindex* i = (TESSindex*)realloc(meshBuffer.indices, (size_t)indexCount * sizeof(TESSindex));
+        if (!i) return -1;
+        meshBuffer.indices = i;
+        meshBuffer.indexCapacity = indexCount;
+    }
+    return 0;
+}
+
+int buildGlyphMeshFromSlot(FT_GlyphSlot slot, const GlyphMeshBuffer** outMesh) {
+    TRACE_SCOPE("buildGlyphMeshFromSlot");
+    if (!slot || slot->format != FT_GLYPH_FORMAT_OUTLINE || slot->outline.n_contours == 0) return 1;
+    if (initMeshBuilder() != 0) {
+        fprintf(stderr, "ERROR::GLYPH_MESH::BUILD: No se pudo inicializar el constructor de mallas.\n");
+        return -1;
+    }
+
+    resetOutlineData(&meshOutline);
+    if (extractOutline(&slot->outline, &meshOutline) != 0) {
+        fprintf(stderr, "ERROR::GLYPH_MESH::BUILD: extractOutline falló.\n");
+        return -1;
+    }
+
+    int status = tessellateOutlineInto(&meshTessContext, &meshOutline, &meshBuffer);
+    if (status == TESS_CONTEXT_BUFFER_TOO_SMALL) {
+        if (growMeshBuffer(meshBuffer.vertexCount, meshBuffer.indexCount) != 0) {
+            fprintf(stderr, "ERROR::GLYPH_MESH::BUILD: Realloc falló para el buffer de malla.\n");
+            return -1;
+        }
+        status = tessellateOutlineInto(&meshTessContext, &meshOutline, &meshBuffer);
+    }
+    if (status != TESS_CONTEXT_OK) return -1;
+    if (meshBuffer.indexCount == 0) return 1;
+
+    *outMesh = &meshBuffer;
+    return 0;
+}
+
+int preloadGlyphMeshes(const char* fontPath, FT_ULong firstCodepoint, FT_ULong lastCodepoint, int threadCount) {
+    TRACE_SCOPE("preloadGlyphMeshes");
+    freeGlyphMeshBatch(&preloadedMeshes);
+    if (batchTessellateRange(fontPath, firstCodepoint, lastCodepoint, GLYPH_LOAD_PIXEL_SIZE,
+                             GLYPH_MESH_FLATNESS, threadCount, &preloadedMeshes) != 0) {
+        fprintf(stderr, "ADVERTENCIA::GLYPH_MESH::PRELOAD: No se pudieron pre-teselar U+%04lX..U+%04lX; se teselará bajo demanda.\n",
+                firstCodepoint, lastCodepoint);
+        return -1;
+    }
+    return 0;
+}
+
+int findPreloadedGlyphMesh(FT_ULong codepoint, GlyphMeshBuffer* view) {
+    const GlyphMeshEntry* entry = findBatchGlyphMesh(&preloadedMeshes, codepoint);
+    if (!entry) return -1;
+    if (entry->indexCount == 0) return 1;
+    // Vista sobre el blob: no se copia nada hasta uploadGlyphMesh
+    view->vertices = preloadedMeshes.vertices + (size_t)entry->vertexOffset * 2;
+    view->indices = preloadedMeshes.indices + entry->indexOffset;
+    view->vertexCount = view->vertexCapacity = entry->vertexCount;
+    view->indexCount = view->indexCapacity = entry->indexCount;
+    return 0;
+}
+
+int uploadGlyphMesh(const GlyphMeshBuffer* mesh, GlyphInfo* info) {
+    TRACE_SCOPE("uploadGlyphMesh");
+    static const MeshOptimizeOptions options = { 1, 1, GLYPH_MESH_QUANTIZE_SCALE };
+    int status = optimizeGlyphMesh(mesh, &options, &meshOptimized);
+    if (status == MESH_OPT_TOO_LARGE) {
+        fprintf(stderr, "ADVERTENCIA::GLYPH_MESH::UPLOAD: Malla de %d vértices fuera del formato de 16 bits; el glifo usará solo SDF.\n",
+                mesh->vertexCount);
+        return -1;
+    }
+    if (status != MESH_OPT_OK) return -1;
+    const OptimizedMesh* opt = &meshOptimized;
+    if (opt->indexCount == 0) return -1;
+
+#ifndef UNIT_TESTING
+#if VECTOR_MESH_QUANTIZE_UNITS_PER_EM > 0
+    const size_t vertexBytes = 2 * sizeof(GLshort);
+    const void* vertexData = opt->quantized;
+#else
+    const size_t vertexBytes = 2 * sizeof(GLfloat);
+    const void* vertexData = opt->positions;
+#endif
+    if (meshArena.vao == 0) {
+        glGenVertexArrays(1, &meshArena.vao);
+        glGenBuffers(1, &meshArena.vbo);
+        glGenBuffers(1, &meshArena.ebo);
+        glBindVertexArray(meshArena.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, meshArena.vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(VECTOR_MESH_ARENA_VERTICES * vertexBytes), NULL, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshArena.ebo); // Queda ligado al VAO
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(VECTOR_MESH_ARENA_INDICES * GLYPH_MESH_INDEX_BYTES), NULL, GL_STATIC_DRAW);
+#if VECTOR_MESH_QUANTIZE_UNITS_PER_EM > 0
+        // Sin normalizar: el shader recibe las unidades tal cual y transform lleva GLYPH_MESH_PX_PER_UNIT
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, (GLsizei)vertexBytes, (void*)0);
+#else
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, (GLsizei)vertexBytes, (void*)0);
+#endif
+        glEnableVertexAttribArray(0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        meshArena.vertexCount = 0;
+        meshArena.indexCount = 0;
+    }
+    if (meshArena.vertexCount + opt->vertexCount > VECTOR_MESH_ARENA_VERTICES ||
+        meshArena.indexCount + opt->indexCount > VECTOR_MESH_ARENA_INDICES) {
+        fprintf(stderr, "ADVERTENCIA::GLYPH_MESH::UPLOAD: Arena de mallas llena; el glifo usará solo SDF.\n");
+        return -1;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, meshArena.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(meshArena.vertexCount * vertexBytes),
+                    (GLsizeiptr)(opt->vertexCount * vertexBytes), vertexData);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(meshArena.vao);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)(meshArena.indexCount * GLYPH_MESH_INDEX_BYTES),
+                    (GLsizeiptr)(opt->indexCount * GLYPH_MESH_INDEX_BYTES), opt->indices);
+    glBindVertexArray(0);
+
+    info->vao = meshArena.vao;
+    info->vbo = meshArena.vbo;
+    info->ebo = meshArena.ebo;
+    info->meshBaseVertex = meshArena.vertexCount;
+    info->meshFirstIndex = (GLuint)meshArena.indexCount;
+    meshArena.vertexCount += opt->vertexCount;
+    meshArena.indexCount += opt->indexCount;
+#endif
+    // En tests no hay GL: la malla cuenta igualmente (indexCount) pero vao/vbo/ebo quedan a 0
+    info->indexCount = opt->indexCount;
+    return 0;
+}
+
+void cleanupGlyphMeshes(void) {
+#ifndef UNIT_TESTING
+    if (meshArena.vao != 0) {
+        glDeleteVertexArrays(1, &meshArena.vao);
+        glDeleteBuffers(1, &meshArena.vbo);
+        glDeleteBuffers(1, &meshArena.ebo);
+    }
+    meshArena = (GlyphMeshArena){0};
+#endif
+    if (meshBuilderReady) {
+        freeOutlineData(&meshOutline);
+        freeTessellationContext(&meshTessContext);
+        meshBuilderReady = 0;
+    }
+    free(meshBuffer.vertices);
+    free(meshBuffer.indices);
+    meshBuffer = (GlyphMeshBuffer){0};
+    freeOptimizedMesh(&meshOptimized);
+    freeGlyphMeshBatch(&preloadedMeshes);
+}
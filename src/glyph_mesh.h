@@ -0,0 +1,55 @@
+#ifndef GLYPH_MESH_H
+#define GLYPH_MESH_H
+
+#include <GL/glew.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "tessellation_handler.h" // GlyphMeshBuffer
+#include "glyph_manager.h"        // GlyphInfo
+#include "config.h"
+
+// Tolerancia de aplanado (px del tamaño de carga): la malla debe aguantar el
+// mayor tamaño de pantalla sin facetas visibles.
+#define GLYPH_MESH_FLATNESS (VECTOR_MESH_TOLERANCE_PX * (float)GLYPH_LOAD_PIXEL_SIZE / VECTOR_MESH_MAX_SCREEN_PX)
+
+// Mallas vectoriales de glifos para tamaños grandes en pantalla.
+// El contorno se tesela una vez por glifo (en unidades de píxel del tamaño
+// de carga, GLYPH_LOAD_PIXEL_SIZE) y se sube a un VBO/IBO compartido: cada
+// glifo guarda su base de vértices y su primer índice en GlyphInfo y se dibuja
+// con glDrawElementsBaseVertex.
+
+// Formato de la arena tras optimizeGlyphMesh (ver mesh_optimizer.h):
+// índices de 16 bits relativos a meshBaseVertex y posiciones int16 en
+// unidades de em/VECTOR_MESH_QUANTIZE_UNITS_PER_EM (float en px si es 0).
+#define GLYPH_MESH_GL_INDEX_TYPE GL_UNSIGNED_SHORT
+#define GLYPH_MESH_INDEX_BYTES sizeof(GLushort)
+#if VECTOR_MESH_QUANTIZE_UNITS_PER_EM > 0
+#define GLYPH_MESH_QUANTIZE_SCALE ((float)VECTOR_MESH_QUANTIZE_UNITS_PER_EM / (float)GLYPH_LOAD_PIXEL_SIZE)
+#define GLYPH_MESH_PX_PER_UNIT (1.0f / GLYPH_MESH_QUANTIZE_SCALE)
+#else
+#define GLYPH_MESH_QUANTIZE_SCALE 0.0f
+#define GLYPH_MESH_PX_PER_UNIT 1.0f
+#endif
+
+// Tesela el contorno del glyph slot (cargado, sin rasterizar). Los buffers
+// de salida los gestiona el módulo y valen hasta la siguiente llamada.
+// Devuelve 0 si hay malla, 1 si el glifo no tiene contorno, -1 si hubo error.
+int buildGlyphMeshFromSlot(FT_GlyphSlot slot, const GlyphMeshBuffer** outMesh);
+
+// Tesela por adelantado un rango de la fuente principal en varios hilos
+// (ver batch_tessellation.h). threadCount <= 0 usa todas las CPUs.
+int preloadGlyphMeshes(const char* fontPath, FT_ULong firstCodepoint, FT_ULong lastCodepoint, int threadCount);
+
+// Vista sobre la malla pre-teselada del codepoint. Devuelve 0 si hay malla,
+// 1 si el glifo no tiene contorno y -1 si no se pre-teseló.
+int findPreloadedGlyphMesh(FT_ULong codepoint, GlyphMeshBuffer* view);
+
+// Optimiza la malla (soldado, orden para la caché, 16 bits), la sube a la arena
+// GL y rellena vao/vbo/ebo/indexCount/meshBaseVertex/meshFirstIndex.
+// Devuelve -1 si la arena está llena o la malla no cabe en 16 bits (el glifo sigue teniendo SDF).
+int uploadGlyphMesh(const GlyphMeshBuffer* mesh, GlyphInfo* info);
+
+// Libera la arena GL (si existe), los buffers de teselación y las mallas pre-teseladas.
+void cleanupGlyphMeshes(void);
+
+#endif // GLYPH_MESH_H
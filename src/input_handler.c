@@ -1,6 +1,8 @@
 #include "input_handler.h"
 #include "keybindings.h"
 #include "config.h" // For APP_TEXT_BUFFER_SIZE
+#include "frame_timing.h" // Para F3/F4
+#include "trace.h"        // TRACE_SCOPE (solo con TEXT3D_TRACE)
 
 #include <stdio.h>
 #include <string.h>      // Para strlen, memmove
@@ -79,6 +81,7 @@ static size_t utf8_get_prev_char_start_offset(const char* str, size_t current_by
 
 // --- Implementaciones de los Callbacks ---
 void app_keyboard_callback(unsigned char key, int x, int y) {
+    TRACE_SCOPE("app_keyboard_callback");
     // COPIA AQUÍ LA IMPLEMENTACIÓN COMPLETA Y FUNCIONAL DE 
     // 'keyboardCallback' DE TU main.c (la última versión que te proporcioné)
     // Ejemplo de la estructura que debería tener:
@@ -233,6 +236,7 @@ void app_keyboard_callback(unsigned char key, int x, int y) {
 
 
 void app_special_keyboard_callback(int key, int x, int y) {
+    TRACE_SCOPE("app_special_keyboard_callback");
     // COPIA AQUÍ LA IMPLEMENTACIÓN COMPLETA Y FUNCIONAL DE
     // 'specialKeyboardCallback' DE TU main.c (la última versión que te proporcioné)
     // Ejemplo de la estructura que debería tener:
@@ -320,6 +324,13 @@ void app_special_keyboard_callback(int key, int x, int y) {
             // needs_redisplay_from_special = 1; // Redundant
             printf("END: new_pos=%zu, str_len=%zu\n", globalCursorBytePos, current_str_len);
             break;
+        case APP_KEY_F3:
+            frameTimingSetEnabled(!frameTimingEnabled);
+            printf("Frame timing %s.\n", frameTimingEnabled ? "activado" : "desactivado");
+            break;
+        case APP_KEY_F4:
+            frameTimingReport(stdout);
+            break;
         default:
             printf("Other (non-modifier) special key: %d\n", key);
             break;
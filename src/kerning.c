@@ -0,0 +1,178 @@
+#include "kerning.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include FT_TRUETYPE_TABLES_H // FT_Load_Sfnt_Table
+#include FT_TRUETYPE_TAGS_H   // TTAG_kern
+
+int kerningEnabled = 1;
+KerningTable fontKerningTable;
+
+static unsigned int readU16(const unsigned char* p) { return (unsigned int)p[0] << 8 | p[1]; }
+static unsigned long readU32(const unsigned char* p) { return (unsigned long)readU16(p) << 16 | readU16(p + 2); }
+
+// Subtabla de la tabla 'kern' ya validada: dónde empiezan sus pares y cómo se combinan
+typedef struct {
+    const unsigned char* pairs; // left(16) right(16) value(s16), 6 bytes por par
+    unsigned int count;
+    int override;               // 1 = reemplaza lo de subtablas anteriores, 0 = se suma
+} KernSubtable;
+
+// Recorre las subtablas de formato 0 horizontales (ni "minimum" ni
+// cross-stream) de las dos variantes de la tabla: la de Microsoft (versión
+// 0, cabeceras de 16 bits) y la de Apple (versión 1.0, de 32 bits). Llama a
+// visit para cada una y devuelve cuántas hay.
+static int forEachKernSubtable(const unsigned char* data, size_t size,
+                               void (*visit)(const KernSubtable*, void*), void* user) {
+    if (size < 4) return 0;
+    int apple = readU16(data) == 1;
+    if (apple && size < 8) return 0;
+    unsigned long tables = apple ? readU32(data + 4) : readU16(data + 2);
+    size_t headerSize = apple ? 8 : 6;
+    size_t offset = apple ? 8 : 4;
+    int visited = 0;
+    for (unsigned long t = 0; t < tables && offset + headerSize <= size; ++t) {
+        const unsigned char* header = data + offset;
+        unsigned long length = apple ? readU32(header) : readU16(header + 2);
+        unsigned int coverage = readU16(header + 4);
+        unsigned int format = apple ? coverage & 0xFF : coverage >> 8;
+        size_t next = offset + length;
+        if (format == 0) {
+            size_t body = offset + headerSize;
+            if (body + 8 > size) break;
+            // En formato 0 manda nPairs: en fuentes grandes (DejaVu) `length`,
+            // de 16 bits, se desborda
+            unsigned int pairCount = readU16(data + body);
+            size_t available = (size - body - 8) / 6;
+            if (pairCount > available) pairCount = (unsigned int)available;
+            int horizontal = apple ? (coverage & 0xE000) == 0  // Ni vertical, ni cross-stream, ni variaciones
+                                   : (coverage & 0x7) == 0x1;  // Horizontal, ni minimum ni cross-stream
+            if (horizontal) {
+                KernSubtable sub = { data + body + 8, pairCount, !apple && (coverage & 0x8) != 0 };
+                visit(&sub, user);
+                visited++;
+            }
+            next = body + 8 + (size_t)pairCount * 6;
+        }
+        if (next <= offset) break;
+        offset = next;
+    }
+    return visited;
+}
+
+static void countPairs(const KernSubtable* sub, void* user) {
+    *(size_t*)user += sub->count;
+}
+
+typedef struct {
+    KerningTable* table;
+    FT_Fixed xScale;
+    int failed;
+} KernFill;
+
+static void fillPairs(const KernSubtable* sub, void* user) {
+    KernFill* fill = (KernFill*)user;
+    for (unsigned int i = 0; i < sub->count && !fill->failed; ++i) {
+        const unsigned char* pair = sub->pairs + (size_t)i * 6;
+        FT_UInt left = readU16(pair), right = readU16(pair + 2);
+        FT_Long units = (short)readU16(pair + 4);
+        if (left == 0 || right == 0 || units == 0) continue;
+        // Como FT_Get_Kerning con FT_KERNING_UNFITTED: escalado, sin redondear al píxel
+        float pixels = (float)FT_MulFix(units, fill->xScale) / 64.0f;
+        if (!sub->override) pixels += kerningLookup(fill->table, left, right);
+        if (kerningTableSet(fill->table, left, right, pixels) != 0) fill->failed = 1;
+    }
+}
+
+static int reserveKerningTable(KerningTable* table, size_t pairs) {
+    uint32_t capacity = 16;
+    while (capacity < pairs * 2) capacity <<= 1; // Ocupación <= 1/2: sondeos cortos
+    table->keys = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    table->values = (float*)malloc(capacity * sizeof(float));
+    if (!table->keys || !table->values) {
+        fprintf(stderr, "ERROR::KERNING::RESERVE: Malloc falló (%u pares).\n", capacity);
+        freeKerningTable(table);
+        return -1;
+    }
+    table->mask = capacity - 1;
+    return 0;
+}
+
+// Duplica la capacidad y reinserta (buildKerningTable ya reserva de una vez)
+static int growKerningTable(KerningTable* table) {
+    KerningTable grown = { NULL, NULL, 0, 0, table->pixelSize };
+    if (reserveKerningTable(&grown, (size_t)table->mask + 1) != 0) return -1;
+    for (uint32_t i = 0; i <= table->mask; ++i) {
+        if (table->keys[i] != 0) kerningTableSet(&grown, table->keys[i] >> 16, table->keys[i] & 0xFFFF, table->values[i]);
+    }
+    freeKerningTable(table);
+    *table = grown;
+    return 0;
+}
+
+int kerningTableSet(KerningTable* table, FT_UInt left, FT_UInt right, float pixels) {
+    if (!table || left == 0 || right == 0 || left > 0xFFFF || right > 0xFFFF) return -1;
+    if (!table->keys && reserveKerningTable(table, 8) != 0) return -1;
+    if ((table->count + 1) * 2 > (size_t)table->mask + 1 && growKerningTable(table) != 0) return -1;
+    uint32_t key = ((uint32_t)left << 16) | (uint32_t)right;
+    uint32_t i = kerningPairHash(key) & table->mask;
+    while (table->keys[i] != 0 && table->keys[i] != key) i = (i + 1) & table->mask;
+    if (table->keys[i] == 0) {
+        table->keys[i] = key;
+        table->count++;
+    }
+    table->values[i] = pixels;
+    return 0;
+}
+
+int buildKerningTable(FT_Face face, int pixelSize, KerningTable* out) {
+    TRACE_SCOPE("buildKerningTable");
+    memset(out, 0, sizeof(*out));
+    out->pixelSize = pixelSize;
+    if (!face) return -1;
+    if (FT_Set_Pixel_Sizes(face, 0, (FT_UInt)pixelSize) != 0) {
+        fprintf(stderr, "ERROR::KERNING::BUILD: FT_Set_Pixel_Sizes(%d) falló.\n", pixelSize);
+        return -1;
+    }
+
+    FT_ULong size = 0;
+    if (!FT_HAS_KERNING(face) || FT_Load_Sfnt_Table(face, TTAG_kern, 0, NULL, &size) != 0 || size == 0) {
+        return 0; // Sin tabla 'kern' (o no es SFNT): tabla vacía
+    }
+    unsigned char* data = (unsigned char*)malloc(size);
+    if (!data || FT_Load_Sfnt_Table(face, TTAG_kern, 0, data, &size) != 0) {
+        free(data);
+        fprintf(stderr, "ADVERTENCIA::KERNING::BUILD: No se pudo leer la tabla 'kern'.\n");
+        return 0;
+    }
+
+    size_t pairs = 0;
+    forEachKernSubtable(data, size, countPairs, &pairs);
+    int status = 0;
+    if (pairs > 0) {
+        KernFill fill = { out, face->size->metrics.x_scale, 0 };
+        status = reserveKerningTable(out, pairs);
+        if (status == 0) forEachKernSubtable(data, size, fillPairs, &fill);
+        if (fill.failed) {
+            freeKerningTable(out);
+            status = -1;
+        }
+    }
+    free(data);
+    return status;
+}
+
+void freeKerningTable(KerningTable* table) {
+    if (!table) return;
+    int pixelSize = table->pixelSize;
+    free(table->keys);
+    free(table->values);
+    memset(table, 0, sizeof(*table));
+    table->pixelSize = pixelSize;
+}
+
+const KerningTable* activeKerningTable(void) {
+    return kerningEnabled && fontKerningTable.count > 0 ? &fontKerningTable : NULL;
+}
@@ -0,0 +1,54 @@
+#ifndef KERNING_H
+#define KERNING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// Tabla de kerning precalculada para una cara y un tamaño: hash de pares de
+// índices de glifo (direccionamiento abierto, sondeo lineal) con el ajuste ya
+// escalado a píxeles. Se construye una vez leyendo la tabla 'kern' de la
+// fuente, así que el bucle de layout no llama a FreeType: cada par es un
+// hash y, casi siempre, una o dos comparaciones.
+//
+// Solo la tabla 'kern' clásica (formato 0, horizontal): el kerning de GPOS
+// necesita shaping (ver HarfBuzz).
+
+typedef struct {
+    uint32_t* keys;     // (izquierdo << 16) | derecho; 0 = hueco libre
+    float* values;      // Píxeles a pixelSize (como GlyphInfo.advanceX)
+    uint32_t mask;      // Capacidad - 1 (potencia de dos)
+    size_t count;       // Pares con ajuste distinto de 0
+    int pixelSize;
+} KerningTable;
+
+extern int kerningEnabled;           // 0 = sin kerning (TEXT3D_KERNING=0)
+extern KerningTable fontKerningTable; // La de ftFace a GLYPH_LOAD_PIXEL_SIZE (ver initGlyphCache)
+
+// Tabla de `face` a pixelSize (deja la cara a ese tamaño). Una fuente sin
+// tabla 'kern' da una tabla vacía y 0. Devuelve -1 solo si falla malloc o
+// FT_Set_Pixel_Sizes.
+int buildKerningTable(FT_Face face, int pixelSize, KerningTable* out);
+void freeKerningTable(KerningTable* table);
+// Añade o reemplaza un par (la usa buildKerningTable; útil en tests)
+int kerningTableSet(KerningTable* table, FT_UInt left, FT_UInt right, float pixels);
+
+// La tabla que debe usar el layout: NULL si el kerning está desactivado o la fuente no tiene pares
+const KerningTable* activeKerningTable(void);
+
+static inline uint32_t kerningPairHash(uint32_t key) {
+    return (key * 2654435761u) >> 7; // Fibonacci; se descartan los bits bajos, que varían poco
+}
+
+// Ajuste del par en píxeles a table->pixelSize; 0 si no está
+static inline float kerningLookup(const KerningTable* table, FT_UInt left, FT_UInt right) {
+    if (!table || table->count == 0 || left == 0 || right == 0 || left > 0xFFFF || right > 0xFFFF) return 0.0f;
+    uint32_t key = ((uint32_t)left << 16) | (uint32_t)right;
+    for (uint32_t i = kerningPairHash(key) & table->mask;; i = (i + 1) & table->mask) {
+        if (table->keys[i] == key) return table->values[i];
+        if (table->keys[i] == 0) return 0.0f;
+    }
+}
+
+#endif // KERNING_H
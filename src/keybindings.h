@@ -13,6 +13,10 @@
 #define APP_KEY_END   105
 #define APP_KEY_DEL 127
 
+// Teclas de función (GLUT_KEY_F3 / GLUT_KEY_F4) para la instrumentación.
+#define APP_KEY_F3 3   // Activa/desactiva frame timing
+#define APP_KEY_F4 4   // Imprime el informe de frame timing
+
 
 // Podríamos añadir otros si los usamos explícitamente,
 // pero Shift, Ctrl, Alt son más para glutGetModifiers o ya vienen
@@ -24,6 +24,14 @@
 #include "freetype_handler.h"
 #include "input_handler.h"    // << NUEVO INCLUDE
 #include "config.h"           // For APP_TEXT_BUFFER_SIZE
+#include "render_server.h"    // Modo daemon (--server)
+#include "frame_timing.h"     // TEXT3D_FRAME_TIMING / TEXT3D_FRAME_TIMING_CSV
+#include "trace.h"            // TEXT3D_TRACE_FILE (requiere make TRACE=1)
+#include "glyph_mesh.h"       // TEXT3D_PREMESH (pre-teselado en paralelo)
+#include "glyph_extrude.h"    // TEXT3D_EXTRUDE (texto 3D)
+#include "sdf_backend.h"      // TEXT3D_SDF_BACKEND
+#include "kerning.h"          // TEXT3D_KERNING
+#include "text_shaper.h"      // TEXT3D_SHAPING
 
 // --- Variables Globales ---
 GLuint globalShaderProgramID = 0;
@@ -57,6 +65,18 @@ void idle() {
 
 void cleanup() {
     printf("Limpiando...\n");
+    if (frameTimingEnabled) {
+        frameTimingReport(stdout);
+        const char* csvPath = getenv("TEXT3D_FRAME_TIMING_CSV");
+        if (csvPath && strlen(csvPath) > 0) frameTimingExportCSV(csvPath);
+    }
+    frameTimingCleanup();
+    const char* tracePath = getenv("TEXT3D_TRACE_FILE");
+    if (tracePath && strlen(tracePath) > 0) {
+        traceStop();
+        if (traceFlush(tracePath) == 0) printf("Traza escrita en %s\n", tracePath);
+    }
+    cleanupTextShaper();
     cleanupGlyphCache();
     if (globalShaderProgramID != 0) {
         cleanupOpenGL(globalShaderProgramID);
@@ -67,7 +87,40 @@ void cleanup() {
 
 // --- Función Principal ---
 #ifndef UNIT_TESTING // Exclude main function when compiling for unit tests
+// Modo daemon: ./texto --server <ruta_socket> [ruta_fuente_principal]
+// No crea ventana ni contexto GL; solo FreeType y el caché del servidor.
+static int runRenderServer(const char* socketPath, const char* mainFontPath) {
+    if (initFreeType() != 0) {
+        fprintf(stderr, "ERROR::MAIN: Fallo al inicializar FreeType. Saliendo.\n");
+        return 1;
+    }
+    if (loadFonts(mainFontPath, NULL) != 0) {
+        fprintf(stderr, "ERROR::MAIN: Fallo al cargar la fuente '%s'. Saliendo.\n", mainFontPath);
+        cleanupFreeType();
+        return 1;
+    }
+
+    RenderServer server;
+    if (renderServerOpen(&server, socketPath) != 0) {
+        cleanupFreeType();
+        return 1;
+    }
+    printf("INFO::MAIN: Servidor de render escuchando en \"%s\"\n", socketPath);
+    int rc = renderServerRun(&server);
+    renderServerClose(&server);
+    cleanupFreeType();
+    return rc == 0 ? 0 : 1;
+}
+
 int main(int argc, char *argv[]){
+    if (argc >= 2 && strcmp(argv[1], "--server") == 0) {
+        if (argc < 3) {
+            fprintf(stderr, "Uso: %s --server <ruta_socket> [ruta_fuente_principal]\n", argv[0]);
+            return 1;
+        }
+        return runRenderServer(argv[2], (argc >= 4 && strlen(argv[3]) > 0) ? argv[3] : globalMainFontPath);
+    }
+
     // Inicializa las variables que se usarán con los valores globales predeterminados
     const char* textToRender = globalTextToRender;
     const char* mainFontPath = globalMainFontPath;
@@ -124,6 +177,7 @@ int main(int argc, char *argv[]){
     glutInit(&argc, argv);
     glutInitContextVersion(3, 3);
     glutInitContextProfile(GLUT_CORE_PROFILE);
+    glutSetOption(GLUT_MULTISAMPLE, 4); // MSAA 4x: antialiasing de la ruta vectorial
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH | GLUT_MULTISAMPLE);
     glutInitWindowSize(800, 600);
     glutInitWindowPosition(100, 100);
@@ -166,6 +220,106 @@ int main(int argc, char *argv[]){
         return 1;
     }
 
+    // Pre-teselado en paralelo de un rango de la fuente principal para la ruta
+    // vectorial, p. ej. TEXT3D_PREMESH=0x20-0x24F (sin valor útil: Latin básico + extendido).
+    const char* premeshEnv = getenv("TEXT3D_PREMESH");
+    if (premeshEnv && strcmp(premeshEnv, "0") != 0 && strlen(premeshEnv) > 0) {
+        unsigned long firstCp = 0x20, lastCp = 0x24F;
+        char* dash = NULL;
+        unsigned long parsedFirst = strtoul(premeshEnv, &dash, 0);
+        if (dash && *dash == '-') {
+            firstCp = parsedFirst;
+            lastCp = strtoul(dash + 1, NULL, 0);
+        }
+        double startMs = glutGet(GLUT_ELAPSED_TIME);
+        if (preloadGlyphMeshes(mainFontPath, (FT_ULong)firstCp, (FT_ULong)lastCp, 0) == 0) {
+            printf("INFO::MAIN: Mallas U+%04lX..U+%04lX pre-teseladas en %.0f ms.\n",
+                   firstCp, lastCp, glutGet(GLUT_ELAPSED_TIME) - startMs);
+        }
+    }
+
+    // Frame timing: también se conmuta en ejecución con F3 (F4 imprime el informe).
+    const char* frameTimingEnv = getenv("TEXT3D_FRAME_TIMING");
+    if (frameTimingEnv && strcmp(frameTimingEnv, "0") != 0 && strlen(frameTimingEnv) > 0) {
+        frameTimingSetEnabled(1);
+    }
+
+    // Generador de SDF: outline (por defecto), msdf, coverage, threshold,
+    // freetype o bsdf (ver sdf_backend.h). La caché se rellena bajo demanda,
+    // así que basta con fijarlo antes del primer frame.
+    const char* sdfBackendEnv = getenv("TEXT3D_SDF_BACKEND");
+    if (sdfBackendEnv && strlen(sdfBackendEnv) > 0) {
+        if (sdfBackendFromName(sdfBackendEnv, &sdfBackend) == 0) {
+            printf("INFO::MAIN: Backend SDF: %s\n", sdfBackendName(sdfBackend));
+        } else {
+            fprintf(stderr, "ADVERTENCIA::MAIN: TEXT3D_SDF_BACKEND='%s' desconocido; se usa '%s'.\n",
+                    sdfBackendEnv, sdfBackendName(sdfBackend));
+        }
+    }
+
+    // SDF comprimidos en BC4/RGTC1 (la mitad de memoria de textura, algo de error en el borde)
+    const char* sdfBc4Env = getenv("TEXT3D_SDF_BC4");
+    if (sdfBc4Env && strcmp(sdfBc4Env, "0") != 0 && strlen(sdfBc4Env) > 0) {
+        sdfBc4Enabled = 1;
+    }
+
+    // Recorte del exterior saturado de cada SDF (menos texels y fragmentos por quad)
+    const char* sdfTrimEnv = getenv("TEXT3D_SDF_TRIM");
+    if (sdfTrimEnv && strcmp(sdfTrimEnv, "0") == 0) {
+        sdfTrimEnabled = 0;
+    }
+
+    // Niveles de SDF por tamaño en pantalla (SDF_LEVEL_SIZES); 0 = siempre el SDF base del backend
+    const char* sdfLevelsEnv = getenv("TEXT3D_SDF_LEVELS");
+    if (sdfLevelsEnv && strcmp(sdfLevelsEnv, "0") == 0) {
+        sdfLevelsEnabled = 0;
+    }
+
+    // Kerning de la tabla 'kern' de la fuente principal; TEXT3D_KERNING=0 lo desactiva
+    const char* kerningEnv = getenv("TEXT3D_KERNING");
+    if (kerningEnv && strcmp(kerningEnv, "0") == 0) {
+        kerningEnabled = 0;
+    }
+
+    // Shaping por palabras: por defecto solo con HarfBuzz (make HARFBUZZ=1). El
+    // shaper básico no añade nada a la ruta por codepoint con kerning y deja sin
+    // usar las mallas de TEXT3D_PREMESH; TEXT3D_SHAPING=1 lo fuerza, =0 lo apaga.
+    const char* shapingEnv = getenv("TEXT3D_SHAPING");
+    if (shapingEnv && strcmp(shapingEnv, "0") == 0) {
+        textShapingEnabled = 0;
+    } else if (!textShaperHasHarfBuzz() && !(shapingEnv && strcmp(shapingEnv, "1") == 0)) {
+        textShapingEnabled = 0;
+    } else if (initTextShaper(ftFace, GLYPH_LOAD_PIXEL_SIZE) == 0) {
+        printf("INFO::MAIN: Shaping %s con caché de palabras.\n", textShaperHasHarfBuzz() ? "HarfBuzz" : "básico (sin HarfBuzz)");
+    }
+
+    // Umbral de la ruta vectorial (mallas) en px de em en pantalla; 0 = siempre mallas.
+    const char* vectorMinEnv = getenv("TEXT3D_VECTOR_MIN_PX");
+    if (vectorMinEnv && strlen(vectorMinEnv) > 0) {
+        vectorGlyphMinScreenPx = (float)atof(vectorMinEnv);
+    }
+
+    // Texto extruido 3D: TEXT3D_EXTRUDE=1 o profundidad:bisel:pasos (px de la fuente), p. ej. 12:1.5:3
+    const char* extrudeEnv = getenv("TEXT3D_EXTRUDE");
+    if (extrudeEnv && strcmp(extrudeEnv, "0") != 0 && strlen(extrudeEnv) > 0) {
+        ExtrudeParams params = *getExtrudeParams();
+        if (strchr(extrudeEnv, ':')) {
+            sscanf(extrudeEnv, "%f:%f:%d", &params.depth, &params.bevelSize, &params.bevelSteps);
+        }
+        setExtrudeParams(&params);
+        extrudedTextEnabled = 1;
+    }
+
+    // Trazas Chrome trace_event desde el arranque, para ver las esperas en frío.
+    const char* traceEnv = getenv("TEXT3D_TRACE_FILE");
+    if (traceEnv && strlen(traceEnv) > 0) {
+#ifdef TEXT3D_TRACE
+        traceStart();
+#else
+        fprintf(stderr, "ADVERTENCIA::MAIN: TEXT3D_TRACE_FILE definido pero el binario no se compiló con TRACE=1.\n");
+#endif
+    }
+
     // --- Registrar Callbacks y Bucle Principal ---
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
@@ -0,0 +1,332 @@
+#include "mesh_optimizer.h"
+#include "trace.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constantes del artículo de Forsyth
+#define FORSYTH_CACHE_DECAY_POWER 1.5f
+#define FORSYTH_LAST_TRI_SCORE 0.75f
+#define FORSYTH_VALENCE_BOOST_SCALE 2.0f
+#define FORSYTH_VALENCE_BOOST_POWER 0.5f
+#define FORSYTH_VALENCE_TABLE 32
+
+static int growArray(void** array, size_t count, size_t elementSize) {
+    void* grown = realloc(*array, count * elementSize);
+    if (!grown) return -1;
+    *array = grown;
+    return 0;
+}
+
+static int growScratch(OptimizedMesh* m, size_t vertices, size_t indices) {
+    if (vertices > m->vertexScratch) {
+        size_t n = m->vertexScratch ? m->vertexScratch : 256;
+        while (n < vertices) n *= 2;
+        if (growArray((void**)&m->positions, 2 * n, sizeof(float)) != 0 ||
+            growArray((void**)&m->quantized, 2 * n, sizeof(int16_t)) != 0 ||
+            growArray((void**)&m->remap, n, sizeof(uint32_t)) != 0 ||
+            growArray((void**)&m->sources, n, sizeof(uint32_t)) != 0 ||
+            growArray((void**)&m->adjacencyOffset, n + 1, sizeof(int)) != 0 ||
+            growArray((void**)&m->liveTriangles, n, sizeof(int)) != 0 ||
+            growArray((void**)&m->cachePosition, n, sizeof(int)) != 0 ||
+            growArray((void**)&m->vertexScore, n, sizeof(float)) != 0) return -1;
+        m->vertexScratch = n;
+    }
+    if (indices > m->indexScratch) {
+        size_t n = m->indexScratch ? m->indexScratch : 768;
+        while (n < indices) n *= 2;
+        if (growArray((void**)&m->indices, n, sizeof(uint16_t)) != 0 ||
+            growArray((void**)&m->triangles, n, sizeof(uint32_t)) != 0 ||
+            growArray((void**)&m->adjacency, n, sizeof(int)) != 0 ||
+            growArray((void**)&m->order, n / 3 + 1, sizeof(uint32_t)) != 0 ||
+            growArray((void**)&m->triangleScore, n / 3 + 1, sizeof(float)) != 0 ||
+            growArray((void**)&m->emitted, n / 3 + 1, 1) != 0) return -1;
+        m->indexScratch = n;
+    }
+    size_t cells = 64;
+    while (cells < 2 * vertices) cells *= 2;
+    if (cells > m->hashScratch) {
+        if (growArray((void**)&m->hashTable, cells, sizeof(int)) != 0) return -1;
+        m->hashScratch = cells;
+    }
+    return 0;
+}
+
+void freeOptimizedMesh(OptimizedMesh* m) {
+    if (!m) return;
+    free(m->positions);
+    free(m->quantized);
+    free(m->indices);
+    free(m->remap);
+    free(m->sources);
+    free(m->triangles);
+    free(m->order);
+    free(m->hashTable);
+    free(m->adjacencyOffset);
+    free(m->adjacency);
+    free(m->liveTriangles);
+    free(m->cachePosition);
+    free(m->vertexScore);
+    free(m->triangleScore);
+    free(m->emitted);
+    memset(m, 0, sizeof(*m));
+}
+
+// Clave de soldado: los bits de la posición (cuantizada o float)
+static inline void weldKey(const TESSreal* v, float quantizeScale, uint32_t* kx, uint32_t* ky) {
+    if (quantizeScale > 0.0f) {
+        *kx = (uint32_t)(int32_t)lrintf(v[0] * quantizeScale);
+        *ky = (uint32_t)(int32_t)lrintf(v[1] * quantizeScale);
+    } else {
+        float x = v[0] + 0.0f, y = v[1] + 0.0f; // -0 y +0 son el mismo punto
+        memcpy(kx, &x, sizeof(float));
+        memcpy(ky, &y, sizeof(float));
+    }
+}
+
+static inline uint32_t hashKey(uint32_t kx, uint32_t ky) {
+    uint32_t h = kx * 0x9E3779B1u ^ (ky + 0x7F4A7C15u) * 0x85EBCA77u;
+    return h ^ (h >> 15);
+}
+
+// Rellena remap (entrada -> soldado) y sources (soldado -> primer vértice de entrada)
+static int weldVertices(const GlyphMeshBuffer* mesh, float quantizeScale, OptimizedMesh* m) {
+    size_t mask = 64;
+    while (mask < 2 * (size_t)mesh->vertexCount) mask *= 2;
+    mask -= 1;
+    for (size_t c = 0; c <= mask; ++c) m->hashTable[c] = -1;
+
+    int unique = 0;
+    for (int v = 0; v < mesh->vertexCount; ++v) {
+        uint32_t kx, ky;
+        weldKey(mesh->vertices + 2 * v, quantizeScale, &kx, &ky);
+        size_t cell = hashKey(kx, ky) & mask;
+        for (;;) {
+            int slot = m->hashTable[cell];
+            if (slot < 0) {
+                m->hashTable[cell] = v;
+                m->sources[unique] = (uint32_t)v;
+                m->remap[v] = (uint32_t)unique++;
+                break;
+            }
+            uint32_t ox, oy;
+            weldKey(mesh->vertices + 2 * slot, quantizeScale, &ox, &oy);
+            if (ox == kx && oy == ky) {
+                m->remap[v] = m->remap[slot];
+                break;
+            }
+            cell = (cell + 1) & mask;
+        }
+    }
+    return unique;
+}
+
+static inline float forsythVertexScore(const float* cacheScores, const float* valenceScores, int cachePos, int live) {
+    if (live == 0) return -1.0f; // Ya no se va a usar
+    float score = cachePos >= 0 ? cacheScores[cachePos] : 0.0f;
+    score += live < FORSYTH_VALENCE_TABLE ? valenceScores[live]
+                                          : FORSYTH_VALENCE_BOOST_SCALE * powf((float)live, -FORSYTH_VALENCE_BOOST_POWER);
+    return score;
+}
+
+// Orden de triángulos de Forsyth sobre m->triangles (triangleCount triángulos, vertexCount vértices)
+static void forsythOrder(OptimizedMesh* m, int vertexCount, int triangleCount) {
+    float cacheScores[MESH_OPT_CACHE_SIZE];
+    float valenceScores[FORSYTH_VALENCE_TABLE];
+    for (int i = 0; i < MESH_OPT_CACHE_SIZE; ++i) {
+        // Los tres vértices del último triángulo puntúan igual: así no se
+        // favorece recorrer tiras en una sola dirección
+        cacheScores[i] = i < 3 ? FORSYTH_LAST_TRI_SCORE
+                               : powf(1.0f - (float)(i - 3) / (float)(MESH_OPT_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+    }
+    valenceScores[0] = 0.0f;
+    for (int i = 1; i < FORSYTH_VALENCE_TABLE; ++i) {
+        valenceScores[i] = FORSYTH_VALENCE_BOOST_SCALE * powf((float)i, -FORSYTH_VALENCE_BOOST_POWER);
+    }
+
+    // Triángulos de cada vértice (listas contiguas)
+    int* live = m->liveTriangles;
+    int* offset = m->adjacencyOffset;
+    memset(live, 0, (size_t)vertexCount * sizeof(int));
+    for (int i = 0; i < triangleCount * 3; ++i) live[m->triangles[i]]++;
+    offset[0] = 0;
+    for (int v = 0; v < vertexCount; ++v) offset[v + 1] = offset[v] + live[v];
+    int* cursor = m->cachePosition; // Prestado hasta que empiece la simulación
+    memcpy(cursor, offset, (size_t)vertexCount * sizeof(int));
+    for (int t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) m->adjacency[cursor[m->triangles[3 * t + k]]++] = t;
+    }
+
+    for (int v = 0; v < vertexCount; ++v) {
+        m->cachePosition[v] = -1;
+        m->vertexScore[v] = forsythVertexScore(cacheScores, valenceScores, -1, live[v]);
+    }
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (int t = 0; t < triangleCount; ++t) {
+        const uint32_t* tri = m->triangles + 3 * t;
+        m->triangleScore[t] = m->vertexScore[tri[0]] + m->vertexScore[tri[1]] + m->vertexScore[tri[2]];
+        m->emitted[t] = 0;
+        if (m->triangleScore[t] > bestScore) {
+            bestScore = m->triangleScore[t];
+            bestTriangle = t;
+        }
+    }
+
+    int cache[MESH_OPT_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    int scan = 0;
+    for (int emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle < 0) {
+            // Nada en caché tiene triángulos pendientes: el siguiente sin emitir
+            while (m->emitted[scan]) scan++;
+            bestTriangle = scan;
+        }
+        const uint32_t* tri = m->triangles + 3 * bestTriangle;
+        m->order[emittedCount] = (uint32_t)bestTriangle;
+        m->emitted[bestTriangle] = 1;
+
+        // Quita el triángulo de las listas de sus vértices
+        for (int k = 0; k < 3; ++k) {
+            int v = (int)tri[k];
+            int* list = m->adjacency + offset[v];
+            for (int j = 0; j < live[v]; ++j) {
+                if (list[j] == bestTriangle) {
+                    list[j] = list[live[v] - 1];
+                    break;
+                }
+            }
+            live[v]--;
+        }
+
+        // LRU: los vértices del triángulo pasan al frente
+        int next[MESH_OPT_CACHE_SIZE + 3];
+        int nextCount = 0;
+        for (int k = 0; k < 3; ++k) next[nextCount++] = (int)tri[k];
+        for (int i = 0; i < cacheCount; ++i) {
+            int v = cache[i];
+            if (v != (int)tri[0] && v != (int)tri[1] && v != (int)tri[2]) next[nextCount++] = v;
+        }
+        for (int i = 0; i < nextCount; ++i) {
+            int v = next[i];
+            m->cachePosition[v] = i < MESH_OPT_CACHE_SIZE ? i : -1;
+            m->vertexScore[v] = forsythVertexScore(cacheScores, valenceScores, m->cachePosition[v], live[v]);
+        }
+
+        // Solo cambian las puntuaciones de triángulos que tocan la caché
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (int i = 0; i < nextCount; ++i) {
+            int v = next[i];
+            const int* list = m->adjacency + offset[v];
+            for (int j = 0; j < live[v]; ++j) {
+                int t = list[j];
+                const uint32_t* other = m->triangles + 3 * t;
+                float score = m->vertexScore[other[0]] + m->vertexScore[other[1]] + m->vertexScore[other[2]];
+                m->triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        cacheCount = nextCount < MESH_OPT_CACHE_SIZE ? nextCount : MESH_OPT_CACHE_SIZE;
+        memcpy(cache, next, (size_t)cacheCount * sizeof(int));
+    }
+}
+
+int optimizeGlyphMesh(const GlyphMeshBuffer* mesh, const MeshOptimizeOptions* options, OptimizedMesh* out) {
+    TRACE_SCOPE("optimizeGlyphMesh");
+    if (!mesh || !options || !out || mesh->indexCount % 3 != 0) {
+        fprintf(stderr, "ERROR::MESH_OPTIMIZER::OPTIMIZE: Parámetros inválidos.\n");
+        return MESH_OPT_ERROR;
+    }
+    out->vertexCount = 0;
+    out->indexCount = 0;
+    out->quantizeScale = options->quantizeScale > 0.0f ? options->quantizeScale : 0.0f;
+    if (mesh->indexCount == 0 || mesh->vertexCount == 0) return MESH_OPT_OK;
+
+    if (growScratch(out, (size_t)mesh->vertexCount, (size_t)mesh->indexCount) != 0) {
+        fprintf(stderr, "ERROR::MESH_OPTIMIZER::OPTIMIZE: Sin memoria para %d vértices.\n", mesh->vertexCount);
+        return MESH_OPT_ERROR;
+    }
+
+    // 1. Soldado
+    int unique;
+    if (options->weld) {
+        unique = weldVertices(mesh, out->quantizeScale, out);
+    } else {
+        unique = mesh->vertexCount;
+        for (int v = 0; v < unique; ++v) out->remap[v] = out->sources[v] = (uint32_t)v;
+    }
+
+    // 2. Triángulos soldados, sin los que han quedado degenerados
+    int triangleCount = 0;
+    for (int i = 0; i < mesh->indexCount; i += 3) {
+        uint32_t a = out->remap[mesh->indices[i]];
+        uint32_t b = out->remap[mesh->indices[i + 1]];
+        uint32_t c = out->remap[mesh->indices[i + 2]];
+        if (a == b || b == c || a == c) continue;
+        uint32_t* tri = out->triangles + 3 * triangleCount++;
+        tri[0] = a;
+        tri[1] = b;
+        tri[2] = c;
+    }
+    if (triangleCount == 0) return MESH_OPT_OK;
+
+    // 3. Orden de triángulos
+    if (options->optimizeCache) {
+        forsythOrder(out, unique, triangleCount);
+    } else {
+        for (int t = 0; t < triangleCount; ++t) out->order[t] = (uint32_t)t;
+    }
+
+    // 4. Vértices en orden de primer uso; los no referenciados desaparecen
+    int* newIndex = out->liveTriangles;
+    for (int v = 0; v < unique; ++v) newIndex[v] = -1;
+    int vertexCount = 0;
+    for (int t = 0; t < triangleCount; ++t) {
+        const uint32_t* tri = out->triangles + 3 * out->order[t];
+        uint16_t* dst = out->indices + 3 * t;
+        for (int k = 0; k < 3; ++k) {
+            uint32_t w = tri[k];
+            if (newIndex[w] < 0) {
+                if (vertexCount > UINT16_MAX) return MESH_OPT_TOO_LARGE;
+                const TESSreal* src = mesh->vertices + 2 * out->sources[w];
+                if (out->quantizeScale > 0.0f) {
+                    long qx = lrintf(src[0] * out->quantizeScale);
+                    long qy = lrintf(src[1] * out->quantizeScale);
+                    if (qx < INT16_MIN || qx > INT16_MAX || qy < INT16_MIN || qy > INT16_MAX) return MESH_OPT_TOO_LARGE;
+                    out->quantized[2 * vertexCount] = (int16_t)qx;
+                    out->quantized[2 * vertexCount + 1] = (int16_t)qy;
+                } else {
+                    out->positions[2 * vertexCount] = src[0];
+                    out->positions[2 * vertexCount + 1] = src[1];
+                }
+                newIndex[w] = vertexCount++;
+            }
+            dst[k] = (uint16_t)newIndex[w];
+        }
+    }
+    out->vertexCount = vertexCount;
+    out->indexCount = triangleCount * 3;
+    return MESH_OPT_OK;
+}
+
+float meshAverageCacheMissRatio(const uint16_t* indices, int indexCount, int vertexCount, int cacheSize) {
+    if (!indices || indexCount < 3 || vertexCount <= 0 || cacheSize <= 0) return 0.0f;
+    // FIFO: un vértice está en caché si entró hace menos de cacheSize fallos
+    int* insertedAt = (int*)malloc((size_t)vertexCount * sizeof(int));
+    if (!insertedAt) return 0.0f;
+    for (int v = 0; v < vertexCount; ++v) insertedAt[v] = -cacheSize - 1;
+    int misses = 0;
+    for (int i = 0; i < indexCount; ++i) {
+        int v = indices[i];
+        if (misses - insertedAt[v] > cacheSize) insertedAt[v] = misses++;
+    }
+    free(insertedAt);
+    return (float)misses / (float)(indexCount / 3);
+}
@@ -0,0 +1,61 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <stdint.h>
+#include "tessellation_handler.h" // GlyphMeshBuffer
+
+// Post-proceso de mallas teseladas antes de subirlas a la GPU:
+//  1. Soldado de vértices con la misma posición (tras cuantizar, si se pide)
+//     y descarte de los triángulos que quedan degenerados.
+//  2. Reordenado de triángulos para la caché post-transformación (Forsyth,
+//     "Linear-Speed Vertex Cache Optimisation").
+//  3. Reordenado de vértices por primer uso (la caché de lectura del VBO).
+//  4. Índices de 16 bits y, opcionalmente, posiciones int16.
+
+#define MESH_OPT_OK 0
+#define MESH_OPT_ERROR -1
+#define MESH_OPT_TOO_LARGE -2 // Más de 65536 vértices o posiciones fuera de int16
+
+#define MESH_OPT_CACHE_SIZE 32 // Caché LRU que modela el algoritmo de Forsyth
+
+typedef struct {
+    int weld;               // Fusiona vértices iguales
+    int optimizeCache;      // Reordena triángulos y vértices
+    float quantizeScale;    // > 0: posiciones int16 = round(x * quantizeScale); 0 = float
+} MeshOptimizeOptions;
+
+// Salida y memoria de trabajo; se reutiliza de malla en malla
+typedef struct {
+    float* positions;       // x, y (si quantizeScale == 0)
+    int16_t* quantized;     // x, y cuantizadas (si quantizeScale > 0)
+    uint16_t* indices;      // 3 por triángulo, relativos al primer vértice de la malla
+    int vertexCount;
+    int indexCount;
+    float quantizeScale;
+
+    // Trabajo interno
+    uint32_t* remap;        // Vértice de entrada -> vértice soldado
+    uint32_t* sources;      // Vértice soldado -> primer vértice de entrada
+    uint32_t* triangles;    // Índices soldados (32 bits)
+    uint32_t* order;        // Orden de salida de los triángulos
+    int* hashTable;
+    int* adjacencyOffset;
+    int* adjacency;
+    int* liveTriangles;
+    int* cachePosition;
+    float* vertexScore;
+    float* triangleScore;
+    unsigned char* emitted;
+    size_t vertexScratch;   // Capacidades (en vértices / índices / celdas de hash)
+    size_t indexScratch;
+    size_t hashScratch;
+} OptimizedMesh;
+
+int optimizeGlyphMesh(const GlyphMeshBuffer* mesh, const MeshOptimizeOptions* options, OptimizedMesh* out);
+void freeOptimizedMesh(OptimizedMesh* out);
+
+// Fallos de caché por triángulo con una caché FIFO de cacheSize vértices
+// (0.5 es el mínimo teórico en mallas grandes, 3 el peor caso)
+float meshAverageCacheMissRatio(const uint16_t* indices, int indexCount, int vertexCount, int cacheSize);
+
+#endif // MESH_OPTIMIZER_H
@@ -6,6 +6,8 @@
 // Define global VAO and VBO
 GLuint globalQuadVAO = 0;
 GLuint globalQuadVBO = 0;
+GLuint globalMeshProgramID = 0;
+GLuint globalExtrudeProgramID = 0;
 
 // Helper function to read shader files
 static char* readFileToString(const char* filepath) {
@@ -57,6 +59,19 @@ GLuint initOpenGL() {
         return 0;
     }
 
+    // Programa de la ruta vectorial (mallas de glifos grandes). Es opcional:
+    // sin él todo se dibuja con SDF.
+    globalMeshProgramID = createShaderProgram("./shaders/mesh_vertex.glsl", "./shaders/mesh_fragment.glsl");
+    if (globalMeshProgramID == 0) {
+        fprintf(stderr, "ADVERTENCIA::OPENGL_SETUP: Sin programa de mallas; los glifos grandes usarán SDF.\n");
+    }
+
+    // Texto extruido (TEXT3D_EXTRUDE); también opcional.
+    globalExtrudeProgramID = createShaderProgram("./shaders/extrude_vertex.glsl", "./shaders/extrude_fragment.glsl");
+    if (globalExtrudeProgramID == 0) {
+        fprintf(stderr, "ADVERTENCIA::OPENGL_SETUP: Sin programa de extrusión; el texto se dibujará plano.\n");
+    }
+
     // Quad vertices: posX, posY, texX, texY
     float quadVertices[] = {
         // Vértice      Posición      Coordenadas de Textura (V invertida)
@@ -166,6 +181,14 @@ void cleanupOpenGL(GLuint programID) {
     if (programID != 0) {
         glDeleteProgram(programID);
     }
+    if (globalMeshProgramID != 0) {
+        glDeleteProgram(globalMeshProgramID);
+        globalMeshProgramID = 0;
+    }
+    if (globalExtrudeProgramID != 0) {
+        glDeleteProgram(globalExtrudeProgramID);
+        globalExtrudeProgramID = 0;
+    }
     if (globalQuadVAO != 0) {
         glDeleteVertexArrays(1, &globalQuadVAO);
     }
@@ -5,6 +5,8 @@
 
 extern GLuint globalQuadVAO;
 extern GLuint globalQuadVBO;
+extern GLuint globalMeshProgramID; // Ruta vectorial; 0 si sus shaders no compilaron
+extern GLuint globalExtrudeProgramID; // Texto extruido 3D; 0 si sus shaders no compilaron
 
 GLuint initOpenGL(); // Return type changed to GLuint
 GLuint createShaderProgram(const char* vertexPath, const char* fragmentPath);
@@ -0,0 +1,689 @@
+#include "outline_sdf.h"
+#include "trace.h"  // TRACE_SCOPE (solo con TEXT3D_TRACE)
+
+#include <float.h>  // Para FLT_MAX
+#include <math.h>   // Para floorf, ceilf, sqrtf, fabsf
+#include <stdio.h>
+#include <stdlib.h>
+
+// Canales del MSDF (bit 0 = R, 1 = G, 2 = B). El SDF de un canal usa WHITE.
+#define MSDF_RED 1
+#define MSDF_GREEN 2
+#define MSDF_BLUE 4
+#define MSDF_YELLOW 3
+#define MSDF_MAGENTA 5
+#define MSDF_CYAN 6
+#define MSDF_WHITE 7
+
+#define SEGMENT_EDGE_START 1 // Primer tramo de una arista: antes de él vale la pseudo-distancia
+#define SEGMENT_EDGE_END 2   // Último tramo de una arista
+
+// Segmento de la poligonal. Se recoge en unidades del contorno y se pasa a
+// texels de la textura (y hacia abajo, centros de texel en i + 0.5, j + 0.5)
+typedef struct {
+    float ax, ay;
+    float dx, dy;      // b - a
+    float invLength2;  // 1 / |b - a|^2
+    unsigned char color;
+    unsigned char flags;
+    short contour;
+} SdfSegment;
+
+// Corte de un segmento con la fila de centros de una fila de texels
+typedef struct {
+    float x;
+    int winding;       // +1 si el segmento baja, -1 si sube
+} SdfCrossing;
+
+// Segmentos, caja y estructuras de aceleración de un glifo
+typedef struct {
+    SdfSegment* segments;
+    int segmentCount;
+    int segmentCapacity;
+    int contourCount;
+
+    int left, top;          // bitmap_left / bitmap_top en texels
+    int width, height;      // Con padding
+    int cellsX, cellsY;
+    int* cellStart;         // CSR: segmentos a menos de `spread` de cada celda
+    int* cellSegments;
+    int* rowStart;          // CSR: cortes de cada fila de centros
+    SdfCrossing* crossings;
+} SdfGrid;
+
+// Mismo mapeo que normalize_distance en sdf_generator.c
+static unsigned char distanceToByte(float distance, float spread) {
+    float n = distance / spread;
+    if (n < -1.0f) n = -1.0f;
+    if (n > 1.0f) n = 1.0f;
+    return (unsigned char)((n * 0.5f + 0.5f) * 255.0f);
+}
+
+static int clampInt(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void freeGrid(SdfGrid* grid) {
+    free(grid->segments);
+    free(grid->cellStart);
+    free(grid->cellSegments);
+    free(grid->rowStart);
+    free(grid->crossings);
+}
+
+// Añade el segmento a -> b (unidades del contorno) al contorno actual
+static int addSegment(SdfGrid* grid, Point2D a, Point2D b, unsigned char flags) {
+    if (a.x == b.x && a.y == b.y) return 0;
+    if (grid->segmentCount == grid->segmentCapacity) {
+        int newCapacity = grid->segmentCapacity ? grid->segmentCapacity * 2 : 256;
+        SdfSegment* newSegments = (SdfSegment*)realloc(grid->segments, (size_t)newCapacity * sizeof(SdfSegment));
+        if (!newSegments) return -1;
+        grid->segments = newSegments;
+        grid->segmentCapacity = newCapacity;
+    }
+    SdfSegment* s = &grid->segments[grid->segmentCount++];
+    s->ax = a.x;
+    s->ay = a.y;
+    s->dx = b.x - a.x;
+    s->dy = b.y - a.y;
+    s->color = MSDF_WHITE;
+    s->flags = flags;
+    s->contour = (short)(grid->contourCount - 1);
+    return 0;
+}
+
+// Caja redondeada como la de FT_Render_Glyph y paso de los segmentos a texels
+static int placeSegments(SdfGrid* grid, float scale, int padding) {
+    if (grid->segmentCount == 0) return -1;
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int i = 0; i < grid->segmentCount; ++i) {
+        const SdfSegment* s = &grid->segments[i];
+        float x1 = s->ax + s->dx, y1 = s->ay + s->dy;
+        if (s->ax < minX) minX = s->ax;
+        if (s->ax > maxX) maxX = s->ax;
+        if (s->ay < minY) minY = s->ay;
+        if (s->ay > maxY) maxY = s->ay;
+        if (x1 < minX) minX = x1;
+        if (x1 > maxX) maxX = x1;
+        if (y1 < minY) minY = y1;
+        if (y1 > maxY) maxY = y1;
+    }
+    int left = (int)floorf(minX * scale), right = (int)ceilf(maxX * scale);
+    int bottom = (int)floorf(minY * scale), top = (int)ceilf(maxY * scale);
+    if (right <= left || top <= bottom) return -1;
+
+    grid->left = left;
+    grid->top = top;
+    grid->width = right - left + 2 * padding;
+    grid->height = top - bottom + 2 * padding;
+    float originX = (float)(left - padding), originY = (float)(top + padding);
+    for (int i = 0; i < grid->segmentCount; ++i) {
+        SdfSegment* s = &grid->segments[i];
+        s->ax = s->ax * scale - originX;
+        s->ay = originY - s->ay * scale;
+        s->dx *= scale;
+        s->dy = -s->dy * scale;
+        s->invLength2 = 1.0f / (s->dx * s->dx + s->dy * s->dy);
+    }
+    return 0;
+}
+
+// Celdas que toca la caja del segmento ampliada en `spread`: fuera de ellas
+// el segmento no puede ser el más cercano de ningún texel sin saturar
+static void segmentCells(const SdfSegment* s, float spread, int cellsX, int cellsY,
+                         int* cx0, int* cy0, int* cx1, int* cy1) {
+    float minX = s->dx < 0.0f ? s->ax + s->dx : s->ax, maxX = s->dx < 0.0f ? s->ax : s->ax + s->dx;
+    float minY = s->dy < 0.0f ? s->ay + s->dy : s->ay, maxY = s->dy < 0.0f ? s->ay : s->ay + s->dy;
+    *cx0 = clampInt((int)floorf((minX - spread) / OUTLINE_SDF_CELL_SIZE), 0, cellsX - 1);
+    *cx1 = clampInt((int)floorf((maxX + spread) / OUTLINE_SDF_CELL_SIZE), 0, cellsX - 1);
+    *cy0 = clampInt((int)floorf((minY - spread) / OUTLINE_SDF_CELL_SIZE), 0, cellsY - 1);
+    *cy1 = clampInt((int)floorf((maxY + spread) / OUTLINE_SDF_CELL_SIZE), 0, cellsY - 1);
+}
+
+// Filas cuyo centro (j + 0.5) cae en [min(y), max(y)) del segmento. El
+// intervalo semiabierto evita contar dos veces el vértice entre dos segmentos.
+static int segmentRows(const SdfSegment* s, int height, int* j0, int* j1) {
+    if (s->dy == 0.0f) return 0;
+    float lo = s->dy < 0.0f ? s->ay + s->dy : s->ay;
+    float hi = s->dy < 0.0f ? s->ay : s->ay + s->dy;
+    *j0 = clampInt((int)ceilf(lo - 0.5f), 0, height);
+    *j1 = clampInt((int)ceilf(hi - 0.5f), 0, height); // Exclusivo
+    return *j1 > *j0;
+}
+
+// Rejilla de celdas y cortes por fila, ambos en formato CSR (contar y rellenar)
+static int buildGrid(SdfGrid* grid, float spread) {
+    int cellsX = (grid->width + OUTLINE_SDF_CELL_SIZE - 1) / OUTLINE_SDF_CELL_SIZE;
+    int cellsY = (grid->height + OUTLINE_SDF_CELL_SIZE - 1) / OUTLINE_SDF_CELL_SIZE;
+    int cellCount = cellsX * cellsY, height = grid->height;
+    grid->cellsX = cellsX;
+    grid->cellsY = cellsY;
+    grid->cellStart = (int*)calloc((size_t)cellCount + 1, sizeof(int));
+    grid->rowStart = (int*)calloc((size_t)height + 1, sizeof(int));
+    if (!grid->cellStart || !grid->rowStart) return -1;
+
+    int cx0, cy0, cx1, cy1, j0, j1;
+    for (int i = 0; i < grid->segmentCount; ++i) {
+        segmentCells(&grid->segments[i], spread, cellsX, cellsY, &cx0, &cy0, &cx1, &cy1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) grid->cellStart[cy * cellsX + cx + 1]++;
+        if (segmentRows(&grid->segments[i], height, &j0, &j1))
+            for (int j = j0; j < j1; ++j) grid->rowStart[j + 1]++;
+    }
+    for (int c = 0; c < cellCount; ++c) grid->cellStart[c + 1] += grid->cellStart[c];
+    for (int j = 0; j < height; ++j) grid->rowStart[j + 1] += grid->rowStart[j];
+
+    grid->cellSegments = (int*)malloc(((size_t)grid->cellStart[cellCount] + 1) * sizeof(int));
+    grid->crossings = (SdfCrossing*)malloc(((size_t)grid->rowStart[height] + 1) * sizeof(SdfCrossing));
+    if (!grid->cellSegments || !grid->crossings) return -1;
+
+    for (int i = 0; i < grid->segmentCount; ++i) {
+        const SdfSegment* s = &grid->segments[i];
+        segmentCells(s, spread, cellsX, cellsY, &cx0, &cy0, &cx1, &cy1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) grid->cellSegments[grid->cellStart[cy * cellsX + cx]++] = i;
+        if (segmentRows(s, height, &j0, &j1)) {
+            for (int j = j0; j < j1; ++j) {
+                float t = ((float)j + 0.5f - s->ay) / s->dy;
+                SdfCrossing* x = &grid->crossings[grid->rowStart[j]++];
+                x->x = s->ax + t * s->dx;
+                x->winding = s->dy > 0.0f ? 1 : -1;
+            }
+        }
+    }
+    // El relleno dejó cada inicio en el final de su tramo: se desplazan una posición
+    for (int c = cellCount; c > 0; --c) grid->cellStart[c] = grid->cellStart[c - 1];
+    grid->cellStart[0] = 0;
+    for (int j = height; j > 0; --j) grid->rowStart[j] = grid->rowStart[j - 1];
+    grid->rowStart[0] = 0;
+    return 0;
+}
+
+// Signo por barrido de filas con la regla no nula (la de TrueType/CFF):
+// inside[j * width + i] = 1 si el centro del texel es interior
+static void fillInsideMask(const SdfGrid* grid, unsigned char* inside) {
+    for (int j = 0; j < grid->height; ++j) {
+        SdfCrossing* row = grid->crossings + grid->rowStart[j];
+        int n = grid->rowStart[j + 1] - grid->rowStart[j];
+        for (int a = 1; a < n; ++a) { // Pocas intersecciones por fila: inserción
+            SdfCrossing key = row[a];
+            int b = a - 1;
+            while (b >= 0 && row[b].x > key.x) { row[b + 1] = row[b]; --b; }
+            row[b + 1] = key;
+        }
+        int winding = 0, k = 0;
+        for (int i = 0; i < grid->width; ++i) {
+            float centerX = (float)i + 0.5f;
+            while (k < n && row[k].x < centerX) winding += row[k++].winding;
+            inside[j * grid->width + i] = winding != 0;
+        }
+    }
+}
+
+unsigned char* generateSdfFromOutline(const OutlineDataC* outline, float scale, int padding, float spread,
+                                      int* outLeft, int* outTop, int* outWidth, int* outHeight) {
+    TRACE_SCOPE("generateSdfFromOutline");
+    if (outLeft) *outLeft = 0;
+    if (outTop) *outTop = 0;
+    if (outWidth) *outWidth = 0;
+    if (outHeight) *outHeight = 0;
+    if (!outline || outline->pointCount == 0 || scale <= 0.0f || padding < 0 || spread <= 0.0f) return NULL;
+
+    // 1. Segmentos de cada contorno (cerrado: el último punto vuelve al primero)
+    SdfGrid grid = {0};
+    unsigned char* sdf = NULL;
+    for (size_t c = 0; c < outline->count; ++c) {
+        const ContourC* contour = &outline->contours[c];
+        if (contour->count < 2) continue;
+        const Point2D* pts = outline->points + contour->start;
+        grid.contourCount++;
+        for (size_t k = 0; k < contour->count; ++k) {
+            if (addSegment(&grid, pts[k], pts[(k + 1) % contour->count], 0) != 0) goto OutOfMemory;
+        }
+    }
+    if (placeSegments(&grid, scale, padding) != 0) {
+        freeGrid(&grid);
+        return NULL;
+    }
+
+    // 2. Rejilla y signo. La máscara de interior se guarda en la propia salida.
+    int width = grid.width, height = grid.height;
+    sdf = (unsigned char*)malloc((size_t)width * height);
+    if (!sdf || buildGrid(&grid, spread) != 0) goto OutOfMemory;
+    fillInsideMask(&grid, sdf);
+
+    // 3. Distancia al segmento más cercano entre los de la celda del texel.
+    //    Más allá de `spread` el valor satura, así que es el punto de partida.
+    float spread2 = spread * spread;
+    for (int cy = 0; cy < grid.cellsY; ++cy) {
+        for (int cx = 0; cx < grid.cellsX; ++cx) {
+            int cell = cy * grid.cellsX + cx;
+            const int* list = grid.cellSegments + grid.cellStart[cell];
+            int listCount = grid.cellStart[cell + 1] - grid.cellStart[cell];
+            int jEnd = (cy + 1) * OUTLINE_SDF_CELL_SIZE < height ? (cy + 1) * OUTLINE_SDF_CELL_SIZE : height;
+            int iEnd = (cx + 1) * OUTLINE_SDF_CELL_SIZE < width ? (cx + 1) * OUTLINE_SDF_CELL_SIZE : width;
+            for (int j = cy * OUTLINE_SDF_CELL_SIZE; j < jEnd; ++j) {
+                float py = (float)j + 0.5f;
+                for (int i = cx * OUTLINE_SDF_CELL_SIZE; i < iEnd; ++i) {
+                    float px = (float)i + 0.5f;
+                    float best = spread2;
+                    for (int k = 0; k < listCount; ++k) {
+                        const SdfSegment* s = &grid.segments[list[k]];
+                        float wx = px - s->ax, wy = py - s->ay;
+                        float t = (wx * s->dx + wy * s->dy) * s->invLength2;
+                        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+                        float ex = wx - t * s->dx, ey = wy - t * s->dy;
+                        float d2 = ex * ex + ey * ey;
+                        if (d2 < best) best = d2;
+                    }
+                    float distance = sqrtf(best);
+                    unsigned char* texel = &sdf[j * width + i];
+                    *texel = distanceToByte(*texel ? -distance : distance, spread);
+                }
+            }
+        }
+    }
+
+    if (outLeft) *outLeft = grid.left;
+    if (outTop) *outTop = grid.top;
+    if (outWidth) *outWidth = width;
+    if (outHeight) *outHeight = height;
+    freeGrid(&grid);
+    return sdf;
+
+OutOfMemory:
+    fprintf(stderr, "ERROR::OUTLINE_SDF::GENERATE: Malloc falló (%d segmentos).\n", grid.segmentCount);
+    freeGrid(&grid);
+    free(sdf);
+    return NULL;
+}
+
+// --- MSDF ---
+// Chlumský, "Shape Decomposition for Multi-channel Distance Fields": las
+// aristas (tramos entre esquinas) se colorean para que en cada esquina se
+// encuentren colores distintos, cada canal es la pseudo-distancia a la arista
+// más cercana de su color y la mediana de los tres reconstruye el contorno
+// sin redondear las esquinas.
+
+typedef struct {
+    SdfGrid* grid;
+    Point2D current;
+    Point2D firstDirection;  // Tangente de salida de la primera arista del contorno
+    Point2D lastDirection;   // Tangente de llegada de la última arista emitida
+    int contourFirstEdge;    // Índice (en `edges`) de la primera arista del contorno
+    float tolerance;         // Aplanado, en unidades del contorno
+    // Aristas: primer segmento y si empiezan en esquina
+    int* edgeFirstSegment;
+    unsigned char* edgeCorner;
+    int edgeCount, edgeCapacity;
+    int failed;
+} MsdfBuilder;
+
+static Point2D msdfPoint(const FT_Vector* v) {
+    return (Point2D){ (float)v->x / 64.0f, (float)v->y / 64.0f };
+}
+
+static Point2D directionOr(Point2D a, Point2D b, Point2D fallback) {
+    Point2D d = { b.x - a.x, b.y - a.y };
+    return (d.x == 0.0f && d.y == 0.0f) ? fallback : d;
+}
+
+// Esquina si la tangente gira más de OUTLINE_MSDF_CORNER_ANGLE (o da la vuelta)
+static int isCorner(Point2D a, Point2D b) {
+    float la = sqrtf(a.x * a.x + a.y * a.y), lb = sqrtf(b.x * b.x + b.y * b.y);
+    if (la == 0.0f || lb == 0.0f) return 0;
+    float dot = (a.x * b.x + a.y * b.y) / (la * lb);
+    float cross = (a.x * b.y - a.y * b.x) / (la * lb);
+    return dot <= 0.0f || fabsf(cross) > sinf(OUTLINE_MSDF_CORNER_ANGLE);
+}
+
+static void closeMsdfContour(MsdfBuilder* b) {
+    if (b->edgeCount > b->contourFirstEdge) {
+        b->edgeCorner[b->contourFirstEdge] = (unsigned char)isCorner(b->lastDirection, b->firstDirection);
+    }
+}
+
+static int beginMsdfEdge(MsdfBuilder* b, Point2D startDirection) {
+    if (b->edgeCount == b->edgeCapacity) {
+        int newCapacity = b->edgeCapacity ? b->edgeCapacity * 2 : 64;
+        int* newFirst = (int*)realloc(b->edgeFirstSegment, (size_t)newCapacity * sizeof(int));
+        if (!newFirst) return -1;
+        b->edgeFirstSegment = newFirst;
+        unsigned char* newCorner = (unsigned char*)realloc(b->edgeCorner, (size_t)newCapacity);
+        if (!newCorner) return -1;
+        b->edgeCorner = newCorner;
+        b->edgeCapacity = newCapacity;
+    }
+    int first = b->edgeCount == b->contourFirstEdge;
+    b->edgeFirstSegment[b->edgeCount] = b->grid->segmentCount;
+    b->edgeCorner[b->edgeCount] = first ? 0 : (unsigned char)isCorner(b->lastDirection, startDirection);
+    if (first) b->firstDirection = startDirection;
+    b->edgeCount++;
+    return 0;
+}
+
+// Emite la arista ya aplanada (puntos p[0..n]) y marca sus extremos
+static int emitMsdfEdge(MsdfBuilder* b, const Point2D* p, int n, Point2D startDirection, Point2D endDirection) {
+    int firstSegment = b->grid->segmentCount;
+    if (beginMsdfEdge(b, startDirection) != 0) return -1;
+    for (int i = 0; i < n; ++i) {
+        if (addSegment(b->grid, p[i], p[i + 1], 0) != 0) return -1;
+    }
+    if (b->grid->segmentCount == firstSegment) { // Arista degenerada: se descarta
+        b->edgeCount--;
+        return 0;
+    }
+    b->grid->segments[firstSegment].flags |= SEGMENT_EDGE_START;
+    b->grid->segments[b->grid->segmentCount - 1].flags |= SEGMENT_EDGE_END;
+    b->lastDirection = endDirection;
+    b->current = p[n];
+    return 0;
+}
+
+static int curveSteps(float deviation, float factor, float tolerance) {
+    float n = ceilf(sqrtf(factor * deviation / tolerance));
+    if (n < 1.0f) return 1;
+    if (n > (float)OUTLINE_MAX_CURVE_SEGMENTS) return OUTLINE_MAX_CURVE_SEGMENTS;
+    return (int)n;
+}
+
+static int msdfMoveTo(const FT_Vector* to, void* user) {
+    MsdfBuilder* b = (MsdfBuilder*)user;
+    b->grid->contourCount++;
+    b->contourFirstEdge = b->edgeCount;
+    b->current = msdfPoint(to);
+    return 0;
+}
+
+static int msdfLineTo(const FT_Vector* to, void* user) {
+    MsdfBuilder* b = (MsdfBuilder*)user;
+    Point2D p[2] = { b->current, msdfPoint(to) };
+    Point2D d = directionOr(p[0], p[1], (Point2D){0.0f, 0.0f});
+    if (d.x == 0.0f && d.y == 0.0f) return 0;
+    if (emitMsdfEdge(b, p, 1, d, d) != 0) b->failed = 1;
+    return b->failed;
+}
+
+static int msdfConicTo(const FT_Vector* control, const FT_Vector* to, void* user) {
+    MsdfBuilder* b = (MsdfBuilder*)user;
+    Point2D p0 = b->current, p1 = msdfPoint(control), p2 = msdfPoint(to);
+    float ax = p0.x - 2.0f * p1.x + p2.x, ay = p0.y - 2.0f * p1.y + p2.y;
+    int n = curveSteps(sqrtf(ax * ax + ay * ay), 0.25f, b->tolerance);
+    Point2D p[OUTLINE_MAX_CURVE_SEGMENTS + 1];
+    for (int i = 0; i <= n; ++i) {
+        float t = (float)i / n, u = 1.0f - t;
+        p[i].x = u * u * p0.x + 2.0f * u * t * p1.x + t * t * p2.x;
+        p[i].y = u * u * p0.y + 2.0f * u * t * p1.y + t * t * p2.y;
+    }
+    p[n] = p2;
+    Point2D startDir = directionOr(p0, p1, directionOr(p0, p2, (Point2D){0.0f, 0.0f}));
+    Point2D endDir = directionOr(p1, p2, directionOr(p0, p2, (Point2D){0.0f, 0.0f}));
+    if (emitMsdfEdge(b, p, n, startDir, endDir) != 0) b->failed = 1;
+    return b->failed;
+}
+
+static int msdfCubicTo(const FT_Vector* c1, const FT_Vector* c2, const FT_Vector* to, void* user) {
+    MsdfBuilder* b = (MsdfBuilder*)user;
+    Point2D p0 = b->current, p1 = msdfPoint(c1), p2 = msdfPoint(c2), p3 = msdfPoint(to);
+    float d1x = p0.x - 2.0f * p1.x + p2.x, d1y = p0.y - 2.0f * p1.y + p2.y;
+    float d2x = p1.x - 2.0f * p2.x + p3.x, d2y = p1.y - 2.0f * p2.y + p3.y;
+    float d1 = sqrtf(d1x * d1x + d1y * d1y), d2 = sqrtf(d2x * d2x + d2y * d2y);
+    int n = curveSteps(d1 > d2 ? d1 : d2, 0.75f, b->tolerance);
+    Point2D p[OUTLINE_MAX_CURVE_SEGMENTS + 1];
+    for (int i = 0; i <= n; ++i) {
+        float t = (float)i / n, u = 1.0f - t;
+        float w0 = u * u * u, w1 = 3.0f * u * u * t, w2 = 3.0f * u * t * t, w3 = t * t * t;
+        p[i].x = w0 * p0.x + w1 * p1.x + w2 * p2.x + w3 * p3.x;
+        p[i].y = w0 * p0.y + w1 * p1.y + w2 * p2.y + w3 * p3.y;
+    }
+    p[n] = p3;
+    Point2D zero = {0.0f, 0.0f};
+    Point2D startDir = directionOr(p0, p1, directionOr(p0, p2, directionOr(p0, p3, zero)));
+    Point2D endDir = directionOr(p2, p3, directionOr(p1, p3, directionOr(p0, p3, zero)));
+    if (emitMsdfEdge(b, p, n, startDir, endDir) != 0) b->failed = 1;
+    return b->failed;
+}
+
+// Cambia al siguiente color de dos canales (edgeColoringSimple de msdfgen, semilla 0)
+static unsigned char switchColor(unsigned char color, unsigned char banned) {
+    unsigned char combined = color & banned;
+    if (combined == MSDF_RED || combined == MSDF_GREEN || combined == MSDF_BLUE) return combined ^ MSDF_WHITE;
+    if (color == 0 || color == MSDF_WHITE) return MSDF_CYAN;
+    int shifted = color << 1;
+    return (unsigned char)((shifted | shifted >> 3) & MSDF_WHITE);
+}
+
+// -1, 0 o 1 según el tercio de [0, n) en el que cae position
+static int symmetricalTrichotomy(int position, int n) {
+    return (int)(3 + 2.875 * position / (n - 1) - 1.4375 + 0.5) - 3;
+}
+
+static void colorMsdfContour(MsdfBuilder* b, int firstEdge, int lastEdge, int segmentEnd) {
+    SdfSegment* segments = b->grid->segments;
+    int edgeCount = lastEdge - firstEdge;
+    int corners[64], cornerCount = 0;
+    for (int e = firstEdge; e < lastEdge && cornerCount < 64; ++e) {
+        if (b->edgeCorner[e]) corners[cornerCount++] = e - firstEdge;
+    }
+#define EDGE_SEGMENTS(e, body) \
+    for (int s = b->edgeFirstSegment[firstEdge + (e)]; \
+         s < ((firstEdge + (e) + 1 < lastEdge) ? b->edgeFirstSegment[firstEdge + (e) + 1] : segmentEnd); ++s) body
+
+    if (cornerCount == 0) return; // Contorno suave: todo blanco
+    if (cornerCount == 1) {
+        // "Lágrima": tres colores repartidos a lo largo del contorno desde la esquina
+        unsigned char colors[3];
+        colors[0] = switchColor(MSDF_WHITE, 0);
+        colors[1] = MSDF_WHITE;
+        colors[2] = switchColor(colors[0], 0);
+        int firstSegment = b->edgeFirstSegment[firstEdge + corners[0]];
+        int contourStart = b->edgeFirstSegment[firstEdge];
+        int m = segmentEnd - contourStart;
+        if (m < 3) return;
+        for (int i = 0; i < m; ++i) {
+            int s = contourStart + (firstSegment - contourStart + i) % m;
+            segments[s].color = colors[1 + symmetricalTrichotomy(i, m)];
+        }
+        return;
+    }
+    int start = corners[0], spline = 0;
+    unsigned char color = switchColor(MSDF_WHITE, 0);
+    unsigned char initialColor = color;
+    for (int i = 0; i < edgeCount; ++i) {
+        int e = (start + i) % edgeCount;
+        if (spline + 1 < cornerCount && corners[spline + 1] == e) {
+            ++spline;
+            color = switchColor(color, spline == cornerCount - 1 ? initialColor : 0);
+        }
+        EDGE_SEGMENTS(e, { segments[s].color = color; });
+    }
+#undef EDGE_SEGMENTS
+}
+
+// Número de vueltas de todos los segmentos alrededor de (x, y)
+static int windingAt(const SdfGrid* grid, float x, float y) {
+    int winding = 0;
+    for (int i = 0; i < grid->segmentCount; ++i) {
+        const SdfSegment* s = &grid->segments[i];
+        float y0 = s->ay, y1 = s->ay + s->dy;
+        if ((y0 <= y) == (y1 <= y)) continue;
+        float cx = s->ax + (y - y0) / s->dy * s->dx;
+        if (cx > x) winding += s->dy > 0.0f ? 1 : -1;
+    }
+    return winding;
+}
+
+unsigned char* generateMsdfFromOutline(const FT_Outline* outline, float scale, int padding, float spread,
+                                       int* outLeft, int* outTop, int* outWidth, int* outHeight) {
+    TRACE_SCOPE("generateMsdfFromOutline");
+    if (outLeft) *outLeft = 0;
+    if (outTop) *outTop = 0;
+    if (outWidth) *outWidth = 0;
+    if (outHeight) *outHeight = 0;
+    if (!outline || outline->n_contours <= 0 || scale <= 0.0f || padding < 0 || spread <= 0.0f) return NULL;
+
+    // 1. Aristas aplanadas (cada una con su primer y último segmento marcados)
+    SdfGrid grid = {0};
+    MsdfBuilder builder = { .grid = &grid, .tolerance = OUTLINE_SDF_FLATNESS_TEXELS / scale };
+    unsigned char* msdf = NULL;
+    unsigned char* inside = NULL;
+    signed char* interiorSide = NULL;
+    static const FT_Outline_Funcs funcs = { msdfMoveTo, msdfLineTo, msdfConicTo, msdfCubicTo, 0, 0 };
+    int* contourFirstEdge = (int*)malloc(((size_t)outline->n_contours + 1) * sizeof(int));
+    if (!contourFirstEdge) goto OutOfMemory;
+
+    // Se descompone contorno a contorno para saber dónde empieza cada uno
+    FT_Outline single = *outline;
+    int firstPoint = 0, contours = 0;
+    for (int c = 0; c < outline->n_contours; ++c) {
+        int last = outline->contours[c];
+        short lastInContour = (short)(last - firstPoint);
+        single.n_points = (short)(last - firstPoint + 1);
+        single.n_contours = 1;
+        single.points = outline->points + firstPoint;
+        single.tags = outline->tags + firstPoint;
+        single.contours = &lastInContour;
+        firstPoint = last + 1;
+        contourFirstEdge[contours] = builder.edgeCount;
+        int segmentsBefore = grid.segmentCount;
+        if (FT_Outline_Decompose(&single, &funcs, &builder) != 0 || builder.failed) {
+            if (builder.failed) goto OutOfMemory;
+            continue;
+        }
+        closeMsdfContour(&builder);
+        if (grid.segmentCount > segmentsBefore) contours++;
+        else builder.edgeCount = contourFirstEdge[contours];
+    }
+    contourFirstEdge[contours] = builder.edgeCount;
+
+    // 2. Coloreado de aristas por contorno
+    for (int c = 0; c < contours; ++c) {
+        int segmentEnd = c + 1 < contours ? builder.edgeFirstSegment[contourFirstEdge[c + 1]] : grid.segmentCount;
+        colorMsdfContour(&builder, contourFirstEdge[c], contourFirstEdge[c + 1], segmentEnd);
+    }
+    // Los índices de contorno de los segmentos saltan los contornos vacíos: se renumeran
+    for (int c = 0; c < contours; ++c) {
+        int segmentEnd = c + 1 < contours ? builder.edgeFirstSegment[contourFirstEdge[c + 1]] : grid.segmentCount;
+        for (int s = builder.edgeFirstSegment[contourFirstEdge[c]]; s < segmentEnd; ++s) grid.segments[s].contour = (short)c;
+    }
+    grid.contourCount = contours;
+
+    if (placeSegments(&grid, scale, padding) != 0) {
+        free(contourFirstEdge);
+        free(builder.edgeFirstSegment);
+        free(builder.edgeCorner);
+        freeGrid(&grid);
+        return NULL;
+    }
+
+    // 3. Lado interior de cada contorno: se mira el número de vueltas justo a la
+    //    izquierda del punto medio de su segmento más largo
+    int width = grid.width, height = grid.height;
+    interiorSide = (signed char*)malloc((size_t)contours);
+    msdf = (unsigned char*)malloc((size_t)width * height * 3);
+    inside = (unsigned char*)malloc((size_t)width * height);
+    if (!interiorSide || !msdf || !inside || buildGrid(&grid, spread) != 0) goto OutOfMemory;
+    for (int c = 0; c < contours; ++c) {
+        int longest = -1;
+        float longestLength2 = 0.0f;
+        for (int s = 0; s < grid.segmentCount; ++s) {
+            const SdfSegment* seg = &grid.segments[s];
+            float length2 = seg->dx * seg->dx + seg->dy * seg->dy;
+            if (seg->contour == c && length2 > longestLength2) { longest = s; longestLength2 = length2; }
+        }
+        const SdfSegment* seg = &grid.segments[longest];
+        float length = sqrtf(longestLength2), eps = 1e-3f;
+        // Desplazamiento (-dy, dx): el lado con cross > 0 que se usa abajo
+        float x = seg->ax + 0.5f * seg->dx - eps * seg->dy / length;
+        float y = seg->ay + 0.5f * seg->dy + eps * seg->dx / length;
+        interiorSide[c] = windingAt(&grid, x, y) != 0 ? 1 : -1;
+    }
+    fillInsideMask(&grid, inside);
+
+    // 4. Por canal: segmento más cercano de ese color (empates: el más
+    //    perpendicular) y su pseudo-distancia con signo
+    float spread2 = spread * spread;
+    for (int cy = 0; cy < grid.cellsY; ++cy) {
+        for (int cx = 0; cx < grid.cellsX; ++cx) {
+            int cell = cy * grid.cellsX + cx;
+            const int* list = grid.cellSegments + grid.cellStart[cell];
+            int listCount = grid.cellStart[cell + 1] - grid.cellStart[cell];
+            int jEnd = (cy + 1) * OUTLINE_SDF_CELL_SIZE < height ? (cy + 1) * OUTLINE_SDF_CELL_SIZE : height;
+            int iEnd = (cx + 1) * OUTLINE_SDF_CELL_SIZE < width ? (cx + 1) * OUTLINE_SDF_CELL_SIZE : width;
+            for (int j = cy * OUTLINE_SDF_CELL_SIZE; j < jEnd; ++j) {
+                float py = (float)j + 0.5f;
+                for (int i = cx * OUTLINE_SDF_CELL_SIZE; i < iEnd; ++i) {
+                    float px = (float)i + 0.5f;
+                    float bestD2[3] = { spread2, spread2, spread2 };
+                    float bestDot[3] = { 2.0f, 2.0f, 2.0f };
+                    int bestSegment[3] = { -1, -1, -1 };
+                    float bestT[3] = { 0.0f, 0.0f, 0.0f };
+                    for (int k = 0; k < listCount; ++k) {
+                        const SdfSegment* s = &grid.segments[list[k]];
+                        float wx = px - s->ax, wy = py - s->ay;
+                        float t = (wx * s->dx + wy * s->dy) * s->invLength2;
+                        float tc = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+                        float ex = wx - tc * s->dx, ey = wy - tc * s->dy;
+                        float d2 = ex * ex + ey * ey;
+                        if (d2 > spread2) continue;
+                        // Fuera del segmento: coseno entre su dirección y el vector al extremo
+                        float dot = 0.0f;
+                        if (t != tc && d2 > 0.0f) dot = fabsf((ex * s->dx + ey * s->dy) * sqrtf(s->invLength2 / d2));
+                        for (int ch = 0; ch < 3; ++ch) {
+                            if (!(s->color & (1 << ch))) continue;
+                            float diff = d2 - bestD2[ch];
+                            if (diff < -1e-6f || (diff <= 1e-6f && dot < bestDot[ch])) {
+                                bestD2[ch] = d2;
+                                bestDot[ch] = dot;
+                                bestSegment[ch] = list[k];
+                                bestT[ch] = t;
+                            }
+                        }
+                    }
+                    int texel = j * width + i;
+                    for (int ch = 0; ch < 3; ++ch) {
+                        if (bestSegment[ch] < 0) { // Ninguna arista de ese color cerca: satura
+                            msdf[3 * texel + ch] = inside[texel] ? 0 : 255;
+                            continue;
+                        }
+                        const SdfSegment* s = &grid.segments[bestSegment[ch]];
+                        float wx = px - s->ax, wy = py - s->ay;
+                        float cross = s->dx * wy - s->dy * wx;
+                        float distance = sqrtf(bestD2[ch]);
+                        float t = bestT[ch];
+                        // Pseudo-distancia: más allá de los extremos de la arista se prolonga su recta
+                        if ((t < 0.0f && (s->flags & SEGMENT_EDGE_START)) || (t > 1.0f && (s->flags & SEGMENT_EDGE_END))) {
+                            float perpendicular = fabsf(cross) * sqrtf(s->invLength2);
+                            if (perpendicular < distance) distance = perpendicular;
+                        }
+                                        int onInteriorSide = (cross > 0.0f) == (interiorSide[s->contour] > 0);
+                        msdf[3 * texel + ch] = distanceToByte(onInteriorSide ? -distance : distance, spread);
+                    }
+                }
+            }
+        }
+    }
+
+    if (outLeft) *outLeft = grid.left;
+    if (outTop) *outTop = grid.top;
+    if (outWidth) *outWidth = width;
+    if (outHeight) *outHeight = height;
+    free(interiorSide);
+    free(inside);
+    free(contourFirstEdge);
+    free(builder.edgeFirstSegment);
+    free(builder.edgeCorner);
+    freeGrid(&grid);
+    return msdf;
+
+OutOfMemory:
+    fprintf(stderr, "ERROR::OUTLINE_SDF::GENERATE_MSDF: Malloc falló (%d segmentos).\n", grid.segmentCount);
+    free(interiorSide);
+    free(inside);
+    free(msdf);
+    free(contourFirstEdge);
+    free(builder.edgeFirstSegment);
+    free(builder.edgeCorner);
+    freeGrid(&grid);
+    return NULL;
+}
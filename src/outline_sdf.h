@@ -0,0 +1,38 @@
+#ifndef OUTLINE_SDF_H
+#define OUTLINE_SDF_H
+
+#include "freetype_handler.h" // OutlineDataC
+
+// SDF calculado directamente de los segmentos del contorno, sin pasar por
+// FT_Render_Glyph ni por el umbral a 128. Mismo contrato de salida que
+// generate_sdf_from_bitmap: un byte por texel, filas de arriba abajo sin
+// relleno, `padding` texels alrededor de la caja del glifo y distancias en
+// [-spread, spread] texels mapeadas a [0, 255] con el exterior > 128.
+//
+// `scale` convierte unidades del contorno (px a GLYPH_LOAD_PIXEL_SIZE) en
+// texels. La caja del glifo se redondea como la de FT_Render_Glyph (mínimo
+// hacia abajo, máximo hacia arriba); outLeft/outTop equivalen a
+// bitmap_left/bitmap_top, en texels. Devuelve NULL (y dimensiones a 0) si el
+// contorno está vacío. El búfer se libera con free_sdf_bitmap (o free).
+//
+// La distancia es la exacta a la poligonal del contorno: las curvas deben
+// llegar aplanadas con una tolerancia muy por debajo de un texel.
+#define OUTLINE_SDF_FLATNESS_TEXELS 0.05f
+#define OUTLINE_SDF_CELL_SIZE 4 // Lado (texels) de las celdas de la rejilla de segmentos
+
+#define OUTLINE_MSDF_CORNER_ANGLE 3.0f // Radianes (umbral de msdfgen): esquina si |sin(giro)| > sin(3.0) o gira > 90°
+
+unsigned char* generateSdfFromOutline(const OutlineDataC* outline, float scale, int padding, float spread,
+                                      int* outLeft, int* outTop, int* outWidth, int* outHeight);
+
+// SDF multicanal: mismo contrato (caja, padding, spread, polaridad) pero con
+// tres bytes por texel (RGB). Las aristas entre esquinas se colorean como en
+// msdfgen (edgeColoringSimple) y cada canal guarda la pseudo-distancia a la
+// arista más cercana de su color; la mediana de los tres canales reconstruye
+// el contorno con las esquinas vivas. Lee el FT_Outline en lugar de
+// OutlineDataC porque necesita saber dónde empieza y acaba cada curva. No
+// aplica corrección de errores (clashes) entre canales.
+unsigned char* generateMsdfFromOutline(const FT_Outline* outline, float scale, int padding, float spread,
+                                       int* outLeft, int* outTop, int* outWidth, int* outHeight);
+
+#endif // OUTLINE_SDF_H
@@ -0,0 +1,538 @@
+#define _GNU_SOURCE // memfd_create, SCM_RIGHTS, clock_gettime
+#include "render_server.h"
+#include "freetype_handler.h" // Para ftFace, ftEmojiFace
+#include "utf8_decode.h"      // utf8DecodeBuffer
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// --- Utilidades de E/S ---
+// Lee sin bloquear lo que falte de la petición en curso del cliente.
+// Devuelve 1 si la petición está completa en client->buf, 0 si faltan
+// bytes (se reintenta en el próximo poll), -1 si hay que cerrar la conexión.
+static int readPending(RenderClient* client) {
+    for (;;) {
+        size_t need = sizeof(RenderRequestHeader);
+        if (client->received >= need) {
+            RenderRequestHeader header;
+            memcpy(&header, client->buf, sizeof(header));
+            if (header.textLength > RENDER_SERVER_MAX_TEXT) {
+                fprintf(stderr, "ERROR::RENDER_SERVER::READ_PENDING: Texto demasiado largo (%u bytes).\n", header.textLength);
+                return -1; // No podemos resincronizar el flujo: cerrar la conexión
+            }
+            need += header.textLength;
+            if (client->received == need) return 1;
+        }
+        ssize_t n = read(client->fd, client->buf + client->received, need - client->received);
+        if (n == 0) return -1; // EOF: el cliente cerró
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return -1;
+        }
+        client->received += (size_t)n;
+    }
+}
+
+static int writeFull(int fd, const void* buf, size_t len) {
+    const unsigned char* p = (const unsigned char*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Envía la respuesta y, si pixelFd >= 0, adjunta el descriptor con SCM_RIGHTS.
+static int sendResponse(int fd, const RenderResponse* response, int pixelFd) {
+    struct iovec iov = { (void*)response, sizeof(*response) };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    if (pixelFd >= 0) {
+        memset(&control, 0, sizeof(control));
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &pixelFd, sizeof(int));
+    }
+
+    ssize_t n;
+    do {
+        n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    return (n == (ssize_t)sizeof(*response)) ? 0 : -1;
+}
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// --- Caché de bitmaps de cobertura ---
+static void freeGlyphCache(RenderServer* server) {
+    for (int i = 0; i < RENDER_SERVER_CACHE_SIZE; ++i) {
+        RenderCacheNode* node = server->cache[i];
+        while (node) {
+            RenderCacheNode* next = node->next;
+            free(node->coverage);
+            free(node);
+            node = next;
+        }
+        server->cache[i] = NULL;
+    }
+    server->cacheEntries = 0;
+}
+
+// countStats = 0 en la pasada de composición, para no contar dos veces cada glifo.
+static RenderCacheNode* lookupGlyph(RenderServer* server, FT_ULong char_code, uint32_t pixelSize, int countStats) {
+    unsigned int hash_index = (unsigned int)((char_code * 31u + pixelSize) % RENDER_SERVER_CACHE_SIZE);
+    for (RenderCacheNode* node = server->cache[hash_index]; node != NULL; node = node->next) {
+        if (node->char_code == char_code && node->pixelSize == pixelSize) {
+            if (countStats) server->cacheHits++;
+            return node;
+        }
+    }
+    if (countStats) server->cacheMisses++;
+
+    // Tope de memoria: como el caché de formas, se vacía entero al llenarse.
+    // Es seguro a mitad de layout porque cada nodo se usa antes de la
+    // siguiente búsqueda.
+    if (server->cacheEntries >= RENDER_SERVER_CACHE_MAX_ENTRIES) freeGlyphCache(server);
+
+    RenderCacheNode* node = (RenderCacheNode*)calloc(1, sizeof(RenderCacheNode));
+    if (!node) {
+        fprintf(stderr, "ERROR::RENDER_SERVER::LOOKUP_GLYPH: Malloc falló para U+%04lX\n", char_code);
+        return NULL;
+    }
+    node->char_code = char_code;
+    node->pixelSize = pixelSize;
+
+    FT_Face face = ftFace;
+    FT_UInt glyph_index = face ? FT_Get_Char_Index(face, char_code) : 0;
+    if (glyph_index == 0 && ftEmojiFace != NULL) {
+        face = ftEmojiFace;
+        glyph_index = FT_Get_Char_Index(face, char_code);
+    }
+
+    // Un glifo inexistente o que no se pueda rasterizar se cachea vacío para
+    // no volver a pagar FreeType en cada petición.
+    if (glyph_index != 0 &&
+        FT_Set_Pixel_Sizes(face, 0, pixelSize) == 0 &&
+        FT_Load_Glyph(face, glyph_index, FT_LOAD_RENDER) == 0) {
+        FT_GlyphSlot slot = face->glyph;
+        node->advanceX = (int)((slot->advance.x + 32) >> 6);
+        node->bitmap_left = slot->bitmap_left;
+        node->bitmap_top = slot->bitmap_top;
+        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_GRAY &&
+            slot->bitmap.buffer && slot->bitmap.width > 0 && slot->bitmap.rows > 0) {
+            node->width = (int)slot->bitmap.width;
+            node->rows = (int)slot->bitmap.rows;
+            node->coverage = (unsigned char*)malloc((size_t)node->width * node->rows);
+            if (node->coverage) {
+                for (int r = 0; r < node->rows; ++r) {
+                    memcpy(node->coverage + (size_t)r * node->width,
+                           slot->bitmap.buffer + (ptrdiff_t)r * slot->bitmap.pitch,
+                           (size_t)node->width);
+                }
+            } else {
+                node->width = node->rows = 0;
+            }
+        }
+    }
+
+    node->next = server->cache[hash_index];
+    server->cache[hash_index] = node;
+    server->cacheEntries++;
+    return node;
+}
+
+// --- Layout y composición ---
+// Una pasada de medida y otra de composición. Los saltos de línea '\n' bajan
+// una línea; no hay ajuste automático (el llamador decide dónde partir).
+typedef struct {
+    int width, height;
+    int originX;         // Desplazamiento para glifos con bitmap_left negativo
+    int ascender, lineHeight;
+    int glyphCount;
+} ServerLayout;
+
+#define SERVER_DECODE_CHUNK_BYTES 256 // Bytes del texto que se decodifican de una vez
+
+static int layoutText(RenderServer* server, const char* text, uint32_t pixelSize,
+                      ServerLayout* out, unsigned char* pixels, int stride) {
+    if (!ftFace || FT_Set_Pixel_Sizes(ftFace, 0, pixelSize) != 0) return -1;
+    int ascender = (int)((ftFace->size->metrics.ascender + 63) >> 6);
+    int descender = (int)(-(ftFace->size->metrics.descender) >> 6);
+    int lineHeight = (int)((ftFace->size->metrics.height + 63) >> 6);
+    if (lineHeight <= 0) lineHeight = ascender + descender;
+
+    int penX = 0, line = 0, minX = 0, maxX = 0, glyphs = 0;
+    uint32_t codepoints[SERVER_DECODE_CHUNK_BYTES];
+    size_t textLength = strlen(text), done = 0;
+    while (done < textLength) {
+        size_t chunkLength = utf8ChunkLength(text + done, textLength - done, SERVER_DECODE_CHUNK_BYTES);
+        size_t chunkUsed = 0;
+        size_t count = utf8DecodeBuffer(text + done, chunkLength, codepoints, NULL, &chunkUsed);
+        for (size_t k = 0; k < count; ++k) {
+            FT_ULong cp = codepoints[k];
+            if (cp == '\n') {
+                penX = 0;
+                line++;
+                continue;
+            }
+            RenderCacheNode* g = lookupGlyph(server, cp, pixelSize, pixels == NULL);
+            if (!g) return -1;
+            glyphs++;
+
+            if (g->coverage) {
+                int x0 = penX + g->bitmap_left;
+                if (x0 < minX) minX = x0;
+                if (x0 + g->width > maxX) maxX = x0 + g->width;
+                if (pixels) {
+                    int dstX = out->originX + x0;
+                    int dstY = line * lineHeight + ascender - g->bitmap_top;
+                    for (int r = 0; r < g->rows; ++r) {
+                        int y = dstY + r;
+                        if (y < 0 || y >= out->height) continue;
+                        unsigned char* row = pixels + (size_t)y * stride;
+                        const unsigned char* src = g->coverage + (size_t)r * g->width;
+                        for (int c = 0; c < g->width; ++c) {
+                            int x = dstX + c;
+                            if (x < 0 || x >= out->width) continue;
+                            if (src[c] > row[x]) row[x] = src[c]; // Unión de coberturas
+                        }
+                    }
+                }
+            }
+            penX += g->advanceX;
+            if (penX > maxX) maxX = penX;
+        }
+        done += chunkUsed;
+        if (chunkUsed < chunkLength) break; // U+0000 sobrelargo: fin del texto
+    }
+
+    if (!pixels) {
+        out->originX = -minX;
+        out->width = maxX - minX;
+        out->height = (line + 1) * lineHeight;
+        out->ascender = ascender;
+        out->lineHeight = lineHeight;
+        out->glyphCount = glyphs;
+    }
+    return 0;
+}
+
+// Crea el memfd con el texto ya compuesto. Devuelve el fd o -1.
+static int renderToMemfd(RenderServer* server, const char* text, uint32_t pixelSize,
+                         const ServerLayout* layout, int stride) {
+    size_t size = (size_t)stride * (size_t)layout->height;
+    int fd = memfd_create("texto-render", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        perror("ERROR::RENDER_SERVER::MEMFD_CREATE");
+        return -1;
+    }
+    // El cliente solo puede leer: sellamos el tamaño y la escritura.
+    const int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+    if (size == 0) {
+        fcntl(fd, F_ADD_SEALS, seals);
+        return fd;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        perror("ERROR::RENDER_SERVER::FTRUNCATE");
+        close(fd);
+        return -1;
+    }
+    unsigned char* pixels = (unsigned char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (pixels == MAP_FAILED) {
+        perror("ERROR::RENDER_SERVER::MMAP");
+        close(fd);
+        return -1;
+    }
+    // ftruncate ya deja el contenido a cero.
+    ServerLayout composed = *layout;
+    layoutText(server, text, pixelSize, &composed, pixels, stride);
+    munmap(pixels, size);
+    fcntl(fd, F_ADD_SEALS, seals);
+    return fd;
+}
+
+static int compareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void fillStats(const RenderServer* server, RenderResponse* response) {
+    size_t n = server->requestCount < RENDER_SERVER_LATENCY_SAMPLES
+             ? (size_t)server->requestCount : RENDER_SERVER_LATENCY_SAMPLES;
+    response->requestCount = server->requestCount;
+    response->cacheHits = server->cacheHits;
+    response->cacheMisses = server->cacheMisses;
+    if (n == 0) return;
+
+    uint64_t sorted[RENDER_SERVER_LATENCY_SAMPLES];
+    memcpy(sorted, server->latencyNs, n * sizeof(uint64_t));
+    qsort(sorted, n, sizeof(uint64_t), compareU64);
+    response->p50LatencyNs = sorted[(n - 1) * 50 / 100];
+    response->p99LatencyNs = sorted[(n - 1) * 99 / 100];
+}
+
+// Atiende la petición ya completa en client->buf y deja el búfer listo para
+// la siguiente. Devuelve 0 para seguir con el cliente, -1 para cerrarlo.
+static int handleRequest(RenderServer* server, RenderClient* client) {
+    uint64_t start = nowNs();
+    RenderRequestHeader header;
+    memcpy(&header, client->buf, sizeof(header));
+    char text[RENDER_SERVER_MAX_TEXT + 1];
+    memcpy(text, client->buf + sizeof(header), header.textLength); // readPending ya acotó textLength
+    text[header.textLength] = '\0';
+    client->received = 0;
+
+    RenderResponse response;
+    memset(&response, 0, sizeof(response));
+    int pixelFd = -1;
+
+    uint32_t pixelSize = header.pixelSize ? header.pixelSize : RENDER_SERVER_DEFAULT_PIXEL_SIZE;
+
+    switch (header.type) {
+        case RENDER_REQ_RENDER:
+        case RENDER_REQ_MEASURE: {
+            // Un tamaño enorme reservaría bitmaps y memfds a placer del cliente.
+            if (pixelSize < RENDER_SERVER_MIN_PIXEL_SIZE || pixelSize > RENDER_SERVER_MAX_PIXEL_SIZE) {
+                fprintf(stderr, "ADVERTENCIA::RENDER_SERVER::HANDLE_REQUEST: pixelSize %u fuera de [%d, %d].\n",
+                        pixelSize, RENDER_SERVER_MIN_PIXEL_SIZE, RENDER_SERVER_MAX_PIXEL_SIZE);
+                response.status = -4;
+                break;
+            }
+            ServerLayout layout;
+            memset(&layout, 0, sizeof(layout));
+            if (layoutText(server, text, pixelSize, &layout, NULL, 0) != 0) {
+                response.status = -2;
+                break;
+            }
+            int stride = (layout.width + 3) & ~3;
+            response.width = (uint32_t)layout.width;
+            response.height = (uint32_t)layout.height;
+            response.baseline = layout.ascender;
+            response.glyphCount = (uint32_t)layout.glyphCount;
+            if (header.type == RENDER_REQ_RENDER) {
+                response.stride = (uint32_t)stride;
+                pixelFd = renderToMemfd(server, text, pixelSize, &layout, stride);
+                if (pixelFd < 0) response.status = -3;
+            }
+            break;
+        }
+        case RENDER_REQ_STATS:
+            fillStats(server, &response);
+            break;
+        case RENDER_REQ_SHUTDOWN:
+            server->running = 0;
+            break;
+        default:
+            fprintf(stderr, "ADVERTENCIA::RENDER_SERVER::HANDLE_REQUEST: Tipo de petición desconocido %u.\n", header.type);
+            response.status = -1;
+            break;
+    }
+
+    // La respuesta cabe de sobra en el búfer del socket; si aun así no se puede
+    // enviar sin bloquear, el cliente no está leyendo y se le desconecta.
+    int rc = sendResponse(client->fd, &response, pixelFd);
+    if (pixelFd >= 0) close(pixelFd); // El cliente tiene su propia copia del descriptor
+
+    // STATS no cuenta para no sesgar los percentiles que está midiendo.
+    if (header.type == RENDER_REQ_RENDER || header.type == RENDER_REQ_MEASURE) {
+        server->latencyNs[server->requestCount % RENDER_SERVER_LATENCY_SAMPLES] = nowNs() - start;
+        server->requestCount++;
+    }
+    return rc == 0 ? 0 : -1;
+}
+
+// --- API del servidor ---
+int renderServerOpen(RenderServer* server, const char* socketPath) {
+    if (!server || !socketPath) return -1;
+    memset(server, 0, sizeof(*server));
+    server->listenFd = -1;
+    for (int i = 0; i < RENDER_SERVER_MAX_CLIENTS; ++i) server->clients[i].fd = -1;
+
+    if (strlen(socketPath) >= sizeof(server->socketPath)) {
+        fprintf(stderr, "ERROR::RENDER_SERVER::OPEN: Ruta de socket demasiado larga: %s\n", socketPath);
+        return -1;
+    }
+    strcpy(server->socketPath, socketPath);
+
+    server->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (server->listenFd < 0) {
+        perror("ERROR::RENDER_SERVER::OPEN: socket");
+        return -1;
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath); // Socket huérfano de una ejecución anterior
+
+    if (bind(server->listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(server->listenFd, RENDER_SERVER_MAX_CLIENTS) != 0) {
+        perror("ERROR::RENDER_SERVER::OPEN: bind/listen");
+        close(server->listenFd);
+        server->listenFd = -1;
+        return -1;
+    }
+    server->running = 1;
+    return 0;
+}
+
+int renderServerRun(RenderServer* server) {
+    if (!server || server->listenFd < 0) return -1;
+
+    while (server->running) {
+        struct pollfd fds[RENDER_SERVER_MAX_CLIENTS + 1];
+        int slots[RENDER_SERVER_MAX_CLIENTS + 1];
+        nfds_t nfds = 0;
+        fds[nfds].fd = server->listenFd;
+        fds[nfds].events = POLLIN;
+        slots[nfds++] = -1;
+        for (int i = 0; i < RENDER_SERVER_MAX_CLIENTS; ++i) {
+            if (server->clients[i].fd >= 0) {
+                fds[nfds].fd = server->clients[i].fd;
+                fds[nfds].events = POLLIN;
+                slots[nfds++] = i;
+            }
+        }
+
+        if (poll(fds, nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("ERROR::RENDER_SERVER::RUN: poll");
+            return -1;
+        }
+
+        for (nfds_t k = 1; k < nfds && server->running; ++k) {
+            if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            // Como mucho una petición por cliente y vuelta de poll, para que uno
+            // que encadena peticiones no acapare el servidor.
+            RenderClient* client = &server->clients[slots[k]];
+            int rc = readPending(client);
+            if (rc > 0) rc = handleRequest(server, client);
+            if (rc < 0) {
+                close(client->fd);
+                client->fd = -1;
+            }
+        }
+
+        if (server->running && (fds[0].revents & POLLIN)) {
+            int clientFd = accept4(server->listenFd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (clientFd < 0) continue;
+            int slot = -1;
+            for (int i = 0; i < RENDER_SERVER_MAX_CLIENTS; ++i) {
+                if (server->clients[i].fd < 0) { slot = i; break; }
+            }
+            if (slot < 0) {
+                fprintf(stderr, "ADVERTENCIA::RENDER_SERVER::RUN: Demasiados clientes, rechazando conexión.\n");
+                close(clientFd);
+            } else {
+                server->clients[slot].fd = clientFd;
+                server->clients[slot].received = 0;
+            }
+        }
+    }
+    return 0;
+}
+
+void renderServerClose(RenderServer* server) {
+    if (!server) return;
+    for (int i = 0; i < RENDER_SERVER_MAX_CLIENTS; ++i) {
+        if (server->clients[i].fd >= 0) {
+            close(server->clients[i].fd);
+            server->clients[i].fd = -1;
+        }
+    }
+    if (server->listenFd >= 0) {
+        close(server->listenFd);
+        server->listenFd = -1;
+        unlink(server->socketPath);
+    }
+    freeGlyphCache(server);
+}
+
+// --- API del cliente ---
+int renderClientConnect(const char* socketPath) {
+    if (!socketPath) return -1;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, socketPath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int renderClientRequest(int fd, RenderRequestType type, uint32_t pixelSize,
+                        const char* text, RenderResponse* response, int* outPixelFd) {
+    if (outPixelFd) *outPixelFd = -1;
+    if (fd < 0 || !response) return -1;
+
+    size_t len = text ? strlen(text) : 0;
+    if (len > RENDER_SERVER_MAX_TEXT) return -1;
+    RenderRequestHeader header = { (uint32_t)type, pixelSize, (uint32_t)len };
+    if (writeFull(fd, &header, sizeof(header)) != 0) return -1;
+    if (len > 0 && writeFull(fd, text, len) != 0) return -1;
+
+    struct iovec iov = { response, sizeof(*response) };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t n;
+    do {
+        n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC | MSG_WAITALL);
+    } while (n < 0 && errno == EINTR);
+    if (n != (ssize_t)sizeof(*response)) return -1;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            int received;
+            memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+            if (outPixelFd) *outPixelFd = received;
+            else close(received);
+        }
+    }
+    return response->status;
+}
@@ -0,0 +1,101 @@
+#ifndef RENDER_SERVER_H
+#define RENDER_SERVER_H
+
+#include <stddef.h> // Para size_t
+#include <stdint.h> // Para uint32_t, uint64_t
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// Modo daemon: `texto --server <socket> [fuente]` escucha en un socket Unix y
+// atiende peticiones de render/measure sin lanzar un proceso por petición.
+// Los píxeles nunca viajan por el socket: se escriben en un memfd cuyo
+// descriptor se pasa al cliente con SCM_RIGHTS.
+
+#define RENDER_SERVER_MAX_TEXT 4096          // Bytes UTF-8 máximos por petición
+#define RENDER_SERVER_MAX_CLIENTS 16         // Conexiones simultáneas
+#define RENDER_SERVER_LATENCY_SAMPLES 1024   // Ventana para p50/p99
+#define RENDER_SERVER_DEFAULT_PIXEL_SIZE 48
+#define RENDER_SERVER_MIN_PIXEL_SIZE 4       // Fuera de [MIN, MAX] la petición se rechaza
+#define RENDER_SERVER_MAX_PIXEL_SIZE 512
+#define RENDER_SERVER_CACHE_SIZE 256         // Buckets del caché de bitmaps
+#define RENDER_SERVER_CACHE_MAX_ENTRIES 4096 // Al llegar, se vacía entero
+
+typedef enum {
+    RENDER_REQ_RENDER   = 1, // Rasteriza el texto; píxeles en un memfd
+    RENDER_REQ_MEASURE  = 2, // Solo métricas de layout, sin píxeles
+    RENDER_REQ_STATS    = 3, // Percentiles de latencia y estado del caché
+    RENDER_REQ_SHUTDOWN = 4  // Termina renderServerRun()
+} RenderRequestType;
+
+// Cabecera de petición; le siguen textLength bytes de UTF-8 (sin '\0').
+typedef struct {
+    uint32_t type;       // RenderRequestType
+    uint32_t pixelSize;  // 0 = RENDER_SERVER_DEFAULT_PIXEL_SIZE; si no, en [MIN, MAX]_PIXEL_SIZE
+    uint32_t textLength;
+} RenderRequestHeader;
+
+typedef struct {
+    int32_t status;        // 0 = OK, negativo = error (-4 = pixelSize fuera de rango)
+    uint32_t width;        // Dimensiones del buffer de cobertura (RENDER/MEASURE)
+    uint32_t height;
+    uint32_t stride;       // Bytes por fila del memfd (RENDER)
+    int32_t baseline;      // Línea base de la primera línea, en px desde arriba
+    uint32_t glyphCount;
+    // Solo STATS
+    uint64_t requestCount;
+    uint64_t p50LatencyNs;
+    uint64_t p99LatencyNs;
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+} RenderResponse;
+
+// Bitmap de cobertura cacheado por (codepoint, tamaño). El caché vive lo
+// mismo que el servidor, así que sigue caliente entre peticiones.
+typedef struct RenderCacheNode {
+    FT_ULong char_code;
+    uint32_t pixelSize;
+    int advanceX;           // Píxeles enteros (26.6 redondeado)
+    int bitmap_left;
+    int bitmap_top;
+    int width;
+    int rows;
+    unsigned char* coverage; // width * rows, sin padding de pitch
+    struct RenderCacheNode* next;
+} RenderCacheNode;
+
+// Conexión aceptada. Los sockets son no bloqueantes: la petición en curso se
+// acumula en buf y solo se atiende cuando ha llegado entera, así un cliente
+// que se detiene a medias no bloquea a los demás.
+typedef struct {
+    int fd;                 // -1 = hueco libre
+    size_t received;        // Bytes de la petición en curso ya leídos
+    unsigned char buf[sizeof(RenderRequestHeader) + RENDER_SERVER_MAX_TEXT];
+} RenderClient;
+
+typedef struct {
+    int listenFd;
+    RenderClient clients[RENDER_SERVER_MAX_CLIENTS];
+    char socketPath[108];   // sizeof(sockaddr_un.sun_path)
+    int running;
+
+    RenderCacheNode* cache[RENDER_SERVER_CACHE_SIZE];
+    uint32_t cacheEntries;  // Nodos vivos; tope RENDER_SERVER_CACHE_MAX_ENTRIES
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+
+    uint64_t latencyNs[RENDER_SERVER_LATENCY_SAMPLES]; // Anillo
+    uint64_t requestCount;
+} RenderServer;
+
+// Servidor. Requiere initFreeType() y loadFonts() previos (usa ftFace).
+int renderServerOpen(RenderServer* server, const char* socketPath);
+int renderServerRun(RenderServer* server); // Bloquea hasta RENDER_REQ_SHUTDOWN
+void renderServerClose(RenderServer* server);
+
+// Cliente. Para RENDER, *outPixelFd recibe el memfd (el llamador lo mmapea
+// con response->stride * response->height bytes y lo cierra).
+int renderClientConnect(const char* socketPath);
+int renderClientRequest(int fd, RenderRequestType type, uint32_t pixelSize,
+                        const char* text, RenderResponse* response, int* outPixelFd);
+
+#endif // RENDER_SERVER_H
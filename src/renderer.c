@@ -5,6 +5,13 @@
 #include "glyph_manager.h" // For actual getGlyphInfo and GlyphInfo struct
 #include "utils.h"         // Para utf8_to_codepoint
 #include "text_layout.h"   // For TextLayoutInfo and calculateTextLayout signature
+#include "frame_timing.h"  // Medición por fases (desactivada por defecto)
+#include "trace.h"         // TRACE_SCOPE (solo con TEXT3D_TRACE)
+#include "config.h"        // GLYPH_LOAD_PIXEL_SIZE, VECTOR_GLYPH_MIN_SCREEN_PX
+#include "glyph_extrude.h" // Ruta 3D instanciada
+#include "glyph_mesh.h"    // Formato de la arena de mallas (GLYPH_MESH_*)
+#include "text_shaper.h"   // shapeText, textShapingEnabled
+#include "utf8_decode.h"   // utf8DecodeBuffer para el layout
 #include <stdio.h> 
 #include <GL/freeglut.h>
 #include <string.h> 
@@ -18,6 +25,7 @@ MinimalGlyphInfo getGlyphMetrics_wrapper(FT_ULong codepoint) {
     MinimalGlyphInfo min_info = {0};
     min_info.advanceX = real_info.advanceX; 
     min_info.codepoint = codepoint; 
+    min_info.glyphIndex = real_info.glyphIndex;
     return min_info;
 #else
     MinimalGlyphInfo dummy_info = {0};
@@ -32,6 +40,20 @@ TextLayoutInfo calculateTextLayout(
     float startX, float startY, float scale,
     float maxLineWidth, float lineHeight,
     GetGlyphMetricsFunc get_glyph_metrics) {
+    return calculateTextLayoutKerned(text, cursorBytePos, startX, startY, scale, maxLineWidth, lineHeight,
+                                     get_glyph_metrics, activeKerningTable());
+}
+
+// Bytes de texto que el layout decodifica de una vez
+#define LAYOUT_DECODE_CHUNK_BYTES 256
+
+TextLayoutInfo calculateTextLayoutKerned(
+    const char* text, size_t cursorBytePos,
+    float startX, float startY, float scale,
+    float maxLineWidth, float lineHeight,
+    GetGlyphMetricsFunc get_glyph_metrics,
+    const KerningTable* kerning) {
+    TRACE_SCOPE("calculateTextLayout");
 
     TextLayoutInfo layout_info = {0};
     layout_info.cursor_pos.x = startX;
@@ -39,37 +61,121 @@ TextLayoutInfo calculateTextLayout(
 
     if (!text) return layout_info;
 
-    const char* s_iter = text;
+    // Decodificación por trozos a arrays de la pila (utf8DecodeBuffer), no un
+    // utf8_to_codepoint por carácter
+    uint32_t codepoints[LAYOUT_DECODE_CHUNK_BYTES], offsets[LAYOUT_DECODE_CHUNK_BYTES];
+    size_t textLength = strlen(text);
     size_t current_byte_iter_offset = 0;
     float simulatedCurrentX = startX;
     float simulatedCurrentY = startY; 
+    unsigned int previousGlyphIndex = 0; // 0 al empezar una línea: sin kerning
+
+    while (current_byte_iter_offset < textLength) {
+        const char* chunk = text + current_byte_iter_offset;
+        size_t chunkLength = utf8ChunkLength(chunk, textLength - current_byte_iter_offset, LAYOUT_DECODE_CHUNK_BYTES);
+        size_t chunkUsed = 0;
+        size_t count = utf8DecodeBuffer(chunk, chunkLength, codepoints, offsets, &chunkUsed);
+
+        for (size_t k = 0; k < count; ++k) {
+            FT_ULong codepoint_for_check = codepoints[k];
+            MinimalGlyphInfo glyph_info_minimal = get_glyph_metrics(codepoint_for_check);
+            float kern = kerningLookup(kerning, previousGlyphIndex, glyph_info_minimal.glyphIndex) * scale;
+
+            if (simulatedCurrentX > startX && (simulatedCurrentX + kern + (glyph_info_minimal.advanceX * scale)) > (startX + maxLineWidth)) {
+                simulatedCurrentX = startX;
+                simulatedCurrentY -= lineHeight; 
+                kern = 0.0f;
+            }
+            simulatedCurrentX += kern;
+            previousGlyphIndex = glyph_info_minimal.glyphIndex;
+
+            if (current_byte_iter_offset + offsets[k] == cursorBytePos) {
+                layout_info.cursor_pos.x = simulatedCurrentX;
+                layout_info.cursor_pos.y = simulatedCurrentY; 
+                layout_info.codepoint_under_cursor = codepoint_for_check;
+                layout_info.glyph_info_under_cursor = glyph_info_minimal; 
+                layout_info.cursor_is_over_char = 1;
+                layout_info.cursor_cluster_byte = cursorBytePos;
+            }
+            simulatedCurrentX += glyph_info_minimal.advanceX * scale;
+        }
+        current_byte_iter_offset += chunkUsed;
+        if (chunkUsed < chunkLength) break; // Un U+0000 sobrelargo acaba el texto, como antes
+    }
 
-    while (*s_iter != '\0') {
-        const char* temp_s_ptr = s_iter;
-        FT_ULong codepoint_for_check = utf8_to_codepoint(&temp_s_ptr);
-        if (codepoint_for_check == 0) break;
-        size_t char_byte_length = temp_s_ptr - s_iter;
+    if (!layout_info.cursor_is_over_char && cursorBytePos == current_byte_iter_offset) {
+        layout_info.cursor_pos.x = simulatedCurrentX;
+        layout_info.cursor_pos.y = simulatedCurrentY;
+    }
+    return layout_info;
+}
 
-        MinimalGlyphInfo glyph_info_minimal = get_glyph_metrics(codepoint_for_check);
+// Cluster que contiene el byte `bytePos`: el mayor inicio de cluster <= bytePos
+static int findCursorCluster(const ShapedText* shaped, size_t bytePos, size_t* clusterStart) {
+    int found = 0;
+    for (int i = 0; i < shaped->count; ++i) {
+        size_t cluster = shaped->glyphs[i].cluster;
+        if (cluster <= bytePos && (!found || cluster > *clusterStart)) {
+            *clusterStart = cluster;
+            found = 1;
+        }
+    }
+    return found;
+}
 
-        if (simulatedCurrentX > startX && (simulatedCurrentX + (glyph_info_minimal.advanceX * scale)) > (startX + maxLineWidth)) {
+TextLayoutInfo calculateTextLayoutShaped(
+    const char* text, size_t cursorBytePos,
+    float startX, float startY, float scale,
+    float maxLineWidth, float lineHeight,
+    const ShapedText* shaped,
+    GetGlyphMetricsFunc get_glyph_metrics) {
+    TRACE_SCOPE("calculateTextLayoutShaped");
+
+    TextLayoutInfo layout_info = {0};
+    layout_info.cursor_pos.x = startX;
+    layout_info.cursor_pos.y = startY;
+
+    if (!text || !shaped) return layout_info;
+
+    size_t textLength = strlen(text);
+    size_t cursorCluster = 0;
+    int cursorInText = cursorBytePos < textLength && findCursorCluster(shaped, cursorBytePos, &cursorCluster);
+    float simulatedCurrentX = startX;
+    float simulatedCurrentY = startY;
+    int glyphsOnLine = 0;
+
+    for (int i = 0; i < shaped->count; ++i) {
+        const ShapedGlyph* glyph = &shaped->glyphs[i];
+        int clusterStart = i == 0 || glyph->cluster != shaped->glyphs[i - 1].cluster;
+        MinimalGlyphInfo metrics = {0};
+        float advance = glyph->advanceX;
+        if (glyph->glyphIndex == 0) {
+            metrics = get_glyph_metrics(glyph->codepoint);
+            advance = (float)metrics.advanceX;
+        }
+
+        if (clusterStart && glyphsOnLine > 0 && (simulatedCurrentX + advance * scale) > (startX + maxLineWidth)) {
             simulatedCurrentX = startX;
-            simulatedCurrentY -= lineHeight; 
+            simulatedCurrentY -= lineHeight;
+            glyphsOnLine = 0;
         }
 
-        if (current_byte_iter_offset == cursorBytePos) {
+        if (cursorInText && clusterStart && glyph->cluster == cursorCluster && !layout_info.cursor_is_over_char) {
+            metrics.advanceX = (long)advance;
+            metrics.codepoint = glyph->codepoint;
+            metrics.glyphIndex = glyph->glyphIndex;
             layout_info.cursor_pos.x = simulatedCurrentX;
-            layout_info.cursor_pos.y = simulatedCurrentY; 
-            layout_info.codepoint_under_cursor = codepoint_for_check;
-            layout_info.glyph_info_under_cursor = glyph_info_minimal; 
+            layout_info.cursor_pos.y = simulatedCurrentY;
+            layout_info.codepoint_under_cursor = glyph->codepoint;
+            layout_info.glyph_info_under_cursor = metrics;
             layout_info.cursor_is_over_char = 1;
+            layout_info.cursor_cluster_byte = cursorCluster;
         }
-        simulatedCurrentX += glyph_info_minimal.advanceX * scale;
-        s_iter += char_byte_length;
-        current_byte_iter_offset += char_byte_length;
+        simulatedCurrentX += advance * scale;
+        glyphsOnLine++;
     }
 
-    if (!layout_info.cursor_is_over_char && cursorBytePos == current_byte_iter_offset) {
+    if (!layout_info.cursor_is_over_char && cursorBytePos == textLength) {
         layout_info.cursor_pos.x = simulatedCurrentX;
         layout_info.cursor_pos.y = simulatedCurrentY;
     }
@@ -77,8 +183,118 @@ TextLayoutInfo calculateTextLayout(
 }
 
 
+float vectorGlyphMinScreenPx = VECTOR_GLYPH_MIN_SCREEN_PX;
+int extrudedTextEnabled = 0;
+
+// Inclinación de la escena 3D para que se vean las paredes (radianes)
+#define EXTRUDE_VIEW_TILT_X 0.35f
+#define EXTRUDE_VIEW_TILT_Y -0.25f
+
+#ifndef UNIT_TESTING
+// Dibuja la malla del glifo con el programa de mallas ya activo. Los vértices
+// están en píxeles de la fuente con origen en el pen, así que basta con escalar y trasladar.
+static void drawGlyphMesh(const GlyphInfo* info, float penX, float penY, float scale, GLint meshTransformLoc) {
+    float unitScale = scale * GLYPH_MESH_PX_PER_UNIT; // Los vértices pueden venir cuantizados
+    GLfloat transformMatrix[16] = {
+        unitScale, 0.0f,      0.0f, 0.0f,
+        0.0f,      unitScale, 0.0f, 0.0f,
+        0.0f,      0.0f,      1.0f, 0.0f,
+        penX,      penY,      0.0f, 1.0f
+    };
+    glUniformMatrix4fv(meshTransformLoc, 1, GL_FALSE, transformMatrix);
+    glBindVertexArray(info->vao);
+    glDrawElementsBaseVertex(GL_TRIANGLES, info->indexCount, GLYPH_MESH_GL_INDEX_TYPE,
+                             (void*)((size_t)info->meshFirstIndex * GLYPH_MESH_INDEX_BYTES), info->meshBaseVertex);
+}
+
+// Rotación Y * X en column-major para la vista del texto extruido
+static void buildExtrudeView(GLfloat view[16]) {
+    float cx = cosf(EXTRUDE_VIEW_TILT_X), sx = sinf(EXTRUDE_VIEW_TILT_X);
+    float cy = cosf(EXTRUDE_VIEW_TILT_Y), sy = sinf(EXTRUDE_VIEW_TILT_Y);
+    GLfloat m[16] = {
+        cy,      0.0f, -sy,      0.0f,
+        sy * sx, cx,   cy * sx,  0.0f,
+        sy * cx, -sx,  cy * cx,  0.0f,
+        0.0f,    0.0f, 0.0f,     1.0f
+    };
+    memcpy(view, m, sizeof(m));
+}
+
+// Conmuta el uniform msdfMode del shader SDF solo cuando cambia (con el programa SDF activo)
+static void setMsdfMode(GLint msdfModeLoc, int* current, int msdf) {
+    if (msdfModeLoc == -1 || *current == msdf) return;
+    glUniform1i(msdfModeLoc, msdf);
+    *current = msdf;
+}
+
+// Lo que necesita drawTextGlyph del estado de renderText
+typedef struct {
+    GLuint shaderProgramID;
+    bool useMeshPath;
+    GLint meshTransformLoc;
+    GLint transformLoc;
+    GLint msdfModeLoc;
+    int* currentMsdfMode;
+    float scale;
+} GlyphDrawState;
+
+// Ruta 3D: las métricas de la malla extruida, sin generar el SDF del glifo.
+// Los que no están en ftFace (emoji) siguen por GlyphInfo.
+static MinimalGlyphInfo getExtrudedMetrics_wrapper(FT_ULong codepoint) {
+    const ExtrudedGlyph* extruded = getExtrudedGlyph(codepoint, GLYPH_LOAD_PIXEL_SIZE);
+    if (extruded && extruded->glyphIndex != 0) {
+        MinimalGlyphInfo min_info = {0};
+        min_info.advanceX = extruded->advanceX;
+        min_info.codepoint = codepoint;
+        min_info.glyphIndex = extruded->glyphIndex;
+        return min_info;
+    }
+    return getGlyphMetrics_wrapper(codepoint);
+}
+
+// GlyphInfo de un glifo a dibujar: con malla solo si la ruta vectorial la va a usar
+static GlyphInfo glyphInfoForDraw(FT_ULong cacheKey, int sdfLevel, bool useMeshPath) {
+    return useMeshPath ? getGlyphInfoWithMesh(cacheKey, sdfLevel) : getGlyphInfoForLevel(cacheKey, sdfLevel);
+}
+
+// Un glifo del texto principal con el pen en (penX, penY): su malla en la
+// ruta vectorial o, si no, su quad SDF
+static void drawTextGlyph(const GlyphDrawState* state, const GlyphInfo* info, float penX, float penY) {
+    float scale = state->scale;
+    if (state->useMeshPath && info->indexCount > 0) {
+        drawGlyphMesh(info, penX, penY, scale, state->meshTransformLoc);
+    } else if (info->sdfTextureID != 0 && info->sdfTextureWidth > 0 && info->sdfTextureHeight > 0) {
+        if (state->useMeshPath) { // Glifo sin malla (p.ej. bitmap): vuelve al SDF solo para él
+            glUseProgram(state->shaderProgramID);
+            glBindVertexArray(globalQuadVAO);
+        }
+        glBindTexture(GL_TEXTURE_2D, info->sdfTextureID);
+        setMsdfMode(state->msdfModeLoc, state->currentMsdfMode, info->sdfChannels == 3);
+
+        float quad_world_width = (float)info->sdfTextureWidth * info->sdfTexelSize * scale;
+        float quad_world_height = (float)info->sdfTextureHeight * info->sdfTexelSize * scale;
+
+        float actualPosX = penX + ((float)(info->bitmap_left - info->sdfPadding)) * info->sdfTexelSize * scale;
+        float actualPosY = penY + ((float)(info->bitmap_top + info->sdfPadding)) * info->sdfTexelSize * scale - quad_world_height;
+
+        GLfloat transformMatrix[16] = {
+            quad_world_width, 0.0f,            0.0f, 0.0f,
+            0.0f,             quad_world_height, 0.0f, 0.0f,
+            0.0f,             0.0f,            1.0f, 0.0f,
+            actualPosX,       actualPosY,      0.0f, 1.0f
+        };
+        glUniformMatrix4fv(state->transformLoc, 1, GL_FALSE, transformMatrix);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        if (state->useMeshPath) glUseProgram(globalMeshProgramID);
+    }
+}
+#endif
+
 void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos) {
 #ifndef UNIT_TESTING
+    TRACE_SCOPE("renderText");
+    frameTimingBeginFrame();
+    frameTimingGpuBegin();
     checkOpenGLError("renderText Start");
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     checkOpenGLError("After glClear");
@@ -90,7 +306,9 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     if (!text) {
         fprintf(stderr, "ERROR::RENDERER: El parámetro de texto es NULL.\n");
         glBindVertexArray(0); 
+        frameTimingGpuEnd();
         glutSwapBuffers(); 
+        frameTimingEndFrame();
         return;
     }
 
@@ -100,11 +318,23 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     const float maxLineWidth = 1.96f;
     const float lineHeight = 0.18f; 
     float scale = 0.003f; 
-    const int sdf_padding = 4; 
 
-    TextLayoutInfo layout = calculateTextLayout(text, cursorBytePos, startX, startY, scale, maxLineWidth, lineHeight, getGlyphMetrics_wrapper);
+    // --- Shaping: glifos de la fuente en vez de un glifo por codepoint. La ruta
+    // 3D se queda con los codepoints, que es la clave de sus mallas extruidas ---
+    bool useExtrudePath = extrudedTextEnabled && globalExtrudeProgramID != 0;
+    static ShapedText shaped; // Se reutiliza entre frames; la caché de palabras evita volver a dar forma
+    bool useShaping = textShapingEnabled && textShaperReady() && !useExtrudePath &&
+                      shapeText(text, strlen(text), &shaped) == 0;
+
+    FRAME_TIMING_BEGIN(layoutStart);
+    TextLayoutInfo layout = useShaping
+        ? calculateTextLayoutShaped(text, cursorBytePos, startX, startY, scale, maxLineWidth, lineHeight, &shaped, getGlyphMetrics_wrapper)
+        : calculateTextLayout(text, cursorBytePos, startX, startY, scale, maxLineWidth, lineHeight,
+                              useExtrudePath ? getExtrudedMetrics_wrapper : getGlyphMetrics_wrapper);
+    FRAME_TIMING_END(FRAME_PHASE_LAYOUT, layoutStart);
     
     // --- Uniforms Base ---
+    FRAME_TIMING_BEGIN(uniformsStart);
     GLint transformLoc = glGetUniformLocation(shaderProgramID, "transform");
     GLint colorLoc = glGetUniformLocation(shaderProgramID, "textColor"); // Renombrado de textColor a baseTextColor para claridad
     GLint sdfTextureSamplerLoc = glGetUniformLocation(shaderProgramID, "sdfTexture"); // Nombre común para el sampler
@@ -124,6 +354,7 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     GLint shadowColorLoc = glGetUniformLocation(shaderProgramID, "shadowColor");
     GLint shadowOffsetScreenLoc = glGetUniformLocation(shaderProgramID, "shadowOffsetScreen"); // O shadowOffsetUVLoc
     GLint shadowSoftnessSDFLoc = glGetUniformLocation(shaderProgramID, "shadowSoftnessSDF");
+    GLint msdfModeLoc = glGetUniformLocation(shaderProgramID, "msdfMode"); // Mediana de RGB (GlyphInfo.sdfChannels == 3)
     // === FIN: NUEVOS UNIFORMS PARA EL SHADER SDF "MÁS PRO" ===
 
     if (transformLoc == -1 || colorLoc == -1 || sdfTextureSamplerLoc == -1) {
@@ -135,6 +366,8 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     
     glUniform1i(sdfTextureSamplerLoc, 0); 
     glActiveTexture(GL_TEXTURE0);  
+    int currentMsdfMode = 0; // Solo se cambia el uniform cuando cambia el tipo de textura
+    if (msdfModeLoc != -1) glUniform1i(msdfModeLoc, 0);
 
     // === INICIO: Establecer valores para los nuevos uniforms SDF ===
     glUniform1f(sdfEdgeValueLoc, 0.5f); // Correcto para tu sdf_generator
@@ -166,53 +399,113 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     float mainTextColor[3] = {0.8f, 0.9f, 0.2f}; 
     glUniform3fv(colorLoc, 1, mainTextColor); // colorLoc ahora es el textColor base
 
-    const char* s_iter = text;
+    // --- Ruta vectorial: con ems grandes en pantalla el SDF de 48px se emborrona ---
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    float projectedEmPx = (float)GLYPH_LOAD_PIXEL_SIZE * scale * (float)viewport[3] * 0.5f;
+    bool useMeshPath = globalMeshProgramID != 0 && projectedEmPx >= vectorGlyphMinScreenPx;
+    // Nivel de SDF para este tamaño: texturas pequeñas para texto pequeño
+    int sdfLevel = selectSdfLevel(projectedEmPx);
+    GLint meshTransformLoc = -1;
+    GLint meshColorLoc = -1;
+    if (useMeshPath) {
+        glUseProgram(globalMeshProgramID);
+        meshTransformLoc = glGetUniformLocation(globalMeshProgramID, "transform");
+        meshColorLoc = glGetUniformLocation(globalMeshProgramID, "textColor");
+        glUniform3fv(meshColorLoc, 1, mainTextColor);
+    }
+
+    // --- Ruta 3D: una malla por glifo distinto, una instancia por carácter ---
+    static ExtrudedTextBatch extrudeBatch;
+    if (useExtrudePath) extrudedBatchBegin(&extrudeBatch, GLYPH_LOAD_PIXEL_SIZE);
+    FRAME_TIMING_END(FRAME_PHASE_UNIFORMS, uniformsStart);
+
+    FRAME_TIMING_BEGIN(drawStart);
+    GlyphDrawState drawState = { shaderProgramID, useMeshPath, meshTransformLoc, transformLoc, msdfModeLoc, &currentMsdfMode, scale };
     float currentX = startX; 
     float currentY = startY; 
     size_t current_byte_render_offset = 0; 
 
     int char_count_on_line = 0;
-    while (*s_iter != '\0') {
-        const char* char_start_ptr_for_offset = s_iter; 
-        FT_ULong current_codepoint = utf8_to_codepoint(&s_iter);
-        size_t char_byte_length = s_iter - char_start_ptr_for_offset; 
+    const KerningTable* kerning = activeKerningTable(); // Como calculateTextLayout: el cursor cae en el mismo sitio
+    FT_UInt previousGlyphIndex = 0;
+    // Por trozos, como calculateTextLayoutKerned
+    uint32_t drawCodepoints[LAYOUT_DECODE_CHUNK_BYTES], drawOffsets[LAYOUT_DECODE_CHUNK_BYTES];
+    size_t textLength = useShaping ? 0 : strlen(text); // Con shaping, el bucle de glifos de más abajo
+    while (current_byte_render_offset < textLength) {
+        const char* chunk = text + current_byte_render_offset;
+        size_t chunkLength = utf8ChunkLength(chunk, textLength - current_byte_render_offset, LAYOUT_DECODE_CHUNK_BYTES);
+        size_t chunkUsed = 0;
+        size_t count = utf8DecodeBuffer(chunk, chunkLength, drawCodepoints, drawOffsets, &chunkUsed);
+
+        for (size_t k = 0; k < count; ++k) {
+            FT_ULong current_codepoint = drawCodepoints[k];
+            // Ruta 3D: avance e índice salen de la malla extruida; el SDF (o la
+            // malla plana) solo se pide si el glifo acaba dibujándose plano
+            const ExtrudedGlyph* extruded = useExtrudePath ? getExtrudedGlyph(current_codepoint, GLYPH_LOAD_PIXEL_SIZE) : NULL;
+            bool extrudedMetrics = extruded && extruded->glyphIndex != 0;
+            GlyphInfo loop_glyph_info;
+            if (!extrudedMetrics) loop_glyph_info = glyphInfoForDraw(current_codepoint, sdfLevel, useMeshPath);
+            float advanceX = extrudedMetrics ? extruded->advanceX : loop_glyph_info.advanceX;
+            FT_UInt glyphIndex = extrudedMetrics ? extruded->glyphIndex : loop_glyph_info.glyphIndex;
+            float kern = char_count_on_line > 0 ? kerningLookup(kerning, previousGlyphIndex, glyphIndex) * scale : 0.0f;
+
+            if (char_count_on_line > 0 && (currentX + kern + (advanceX * scale)) > (startX + maxLineWidth) ) {
+                currentX = startX;
+                currentY -= lineHeight; 
+                char_count_on_line = 0;
+                kern = 0.0f;
+            }
+            currentX += kern;
+            previousGlyphIndex = glyphIndex;
+
+            if (!(layout.cursor_is_over_char && current_byte_render_offset + drawOffsets[k] == cursorBytePos)) {
+                if (extruded && extruded->indexCount > 0) {
+                    extrudedBatchAdd(&extrudeBatch, current_codepoint, currentX, currentY);
+                } else {
+                    if (extrudedMetrics) loop_glyph_info = glyphInfoForDraw(current_codepoint, sdfLevel, useMeshPath);
+                    drawTextGlyph(&drawState, &loop_glyph_info, currentX, currentY);
+                }
+            }
 
-        if (current_codepoint == 0) break;
+            currentX += advanceX * scale;
+            char_count_on_line++;
+        }
+        current_byte_render_offset += chunkUsed;
+        if (chunkUsed < chunkLength) break; // U+0000 sobrelargo: fin del texto
+    }
 
-        GlyphInfo loop_glyph_info = getGlyphInfo(current_codepoint);
-        
-        if (char_count_on_line > 0 && (currentX + (loop_glyph_info.advanceX * scale)) > (startX + maxLineWidth) ) {
+    // Mismos saltos de línea que calculateTextLayoutShaped
+    for (int i = 0; useShaping && i < shaped.count; ++i) {
+        const ShapedGlyph* glyph = &shaped.glyphs[i];
+        int clusterStart = i == 0 || glyph->cluster != shaped.glyphs[i - 1].cluster;
+        FT_ULong glyphKey = glyph->glyphIndex != 0 ? GLYPH_CACHE_INDEX_KEY(glyph->glyphIndex) : glyph->codepoint;
+        GlyphInfo shaped_glyph_info = glyphInfoForDraw(glyphKey, sdfLevel, useMeshPath);
+        float advance = glyph->glyphIndex != 0 ? glyph->advanceX : shaped_glyph_info.advanceX;
+
+        if (clusterStart && char_count_on_line > 0 && (currentX + advance * scale) > (startX + maxLineWidth)) {
             currentX = startX;
-            currentY -= lineHeight; 
+            currentY -= lineHeight;
             char_count_on_line = 0;
         }
-
-        if (!(layout.cursor_is_over_char && current_byte_render_offset == cursorBytePos)) {
-            if (loop_glyph_info.sdfTextureID != 0 && loop_glyph_info.sdfTextureWidth > 0 && loop_glyph_info.sdfTextureHeight > 0) {
-                glBindTexture(GL_TEXTURE_2D, loop_glyph_info.sdfTextureID);
-
-                float quad_world_width = (float)loop_glyph_info.sdfTextureWidth * scale;
-                float quad_world_height = (float)loop_glyph_info.sdfTextureHeight * scale;
-
-                float actualPosX = currentX + ((float)loop_glyph_info.bitmap_left - sdf_padding) * scale;
-                float actualPosY = currentY + ((float)loop_glyph_info.bitmap_top + sdf_padding) * scale - quad_world_height;
-                
-                GLfloat transformMatrix[16] = {
-                    quad_world_width, 0.0f,            0.0f, 0.0f,
-                    0.0f,             quad_world_height, 0.0f, 0.0f,
-                    0.0f,             0.0f,            1.0f, 0.0f,
-                    actualPosX,       actualPosY,      0.0f, 1.0f
-                };
-                glUniformMatrix4fv(transformLoc, 1, GL_FALSE, transformMatrix);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
+        if (!(layout.cursor_is_over_char && glyph->cluster == layout.cursor_cluster_byte)) {
+            drawTextGlyph(&drawState, &shaped_glyph_info, currentX + glyph->offsetX * scale, currentY + glyph->offsetY * scale);
         }
-        
-        currentX += loop_glyph_info.advanceX * scale;
+        currentX += advance * scale;
         char_count_on_line++;
-        current_byte_render_offset += char_byte_length; 
     }
     
+    if (useExtrudePath && extrudedBatchFinish(&extrudeBatch) == 0) {
+        GLfloat extrudeView[16];
+        buildExtrudeView(extrudeView);
+        drawExtrudedBatch(&extrudeBatch, globalExtrudeProgramID, extrudeView, scale, mainTextColor);
+    }
+
+    if (useMeshPath || useExtrudePath) { // El bloque del cursor siempre es SDF
+        glUseProgram(shaderProgramID);
+        glBindVertexArray(globalQuadVAO);
+    }
+
     // --- Renderizado del Cursor y Carácter Sobre el Cursor ---
     float cursorBackgroundColor[3] = {0.85f, 0.85f, 0.85f}; 
     float textOnCursorColor[3] = {0.1f, 0.1f, 0.1f};   
@@ -220,7 +513,7 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     float cursorPenX = layout.cursor_pos.x;
     float cursorPenY = layout.cursor_pos.y;
 
-    GlyphInfo block_glyph_info = getGlyphInfo(0x2588); 
+    GlyphInfo block_glyph_info = getGlyphInfoForLevel(0x2588, sdfLevel);
 
     if (block_glyph_info.sdfTextureID != 0 && block_glyph_info.sdfTextureWidth > 0 && block_glyph_info.sdfTextureHeight > 0) {
         // Para el fondo del cursor, podrías querer desactivar temporalmente efectos como el contorno o sombra,
@@ -232,11 +525,11 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
         // if (enableShadowLoc != -1) glUniform1i(enableShadowLoc, false);
 
 
-        float quad_w_cursor_bg = (float)block_glyph_info.sdfTextureWidth * scale;
-        float quad_h_cursor_bg = (float)block_glyph_info.sdfTextureHeight * scale;
+        float quad_w_cursor_bg = (float)block_glyph_info.sdfTextureWidth * block_glyph_info.sdfTexelSize * scale;
+        float quad_h_cursor_bg = (float)block_glyph_info.sdfTextureHeight * block_glyph_info.sdfTexelSize * scale;
         
-        float actualPosX_cursor_bg = cursorPenX + ((float)block_glyph_info.bitmap_left - sdf_padding) * scale;
-        float actualPosY_cursor_bg = cursorPenY + ((float)block_glyph_info.bitmap_top + sdf_padding) * scale - quad_h_cursor_bg;
+        float actualPosX_cursor_bg = cursorPenX + ((float)(block_glyph_info.bitmap_left - block_glyph_info.sdfPadding)) * block_glyph_info.sdfTexelSize * scale;
+        float actualPosY_cursor_bg = cursorPenY + ((float)(block_glyph_info.bitmap_top + block_glyph_info.sdfPadding)) * block_glyph_info.sdfTexelSize * scale - quad_h_cursor_bg;
 
         GLfloat cursorBgTransformMatrix[16] = {
             quad_w_cursor_bg, 0.0f,               0.0f, 0.0f,
@@ -247,6 +540,7 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, cursorBgTransformMatrix);
         
         glBindTexture(GL_TEXTURE_2D, block_glyph_info.sdfTextureID);
+        setMsdfMode(msdfModeLoc, &currentMsdfMode, block_glyph_info.sdfChannels == 3);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Restaurar configuración de efectos si la cambiaste para el bloque del cursor
@@ -255,16 +549,23 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
     }
 
     if (layout.cursor_is_over_char) {
-        GlyphInfo char_on_cursor_info = getGlyphInfo(layout.codepoint_under_cursor);
-
-        if (char_on_cursor_info.sdfTextureID != 0 && char_on_cursor_info.sdfTextureWidth > 0 && char_on_cursor_info.sdfTextureHeight > 0) {
+        FT_ULong cursorGlyphKey = useShaping && layout.glyph_info_under_cursor.glyphIndex != 0
+            ? GLYPH_CACHE_INDEX_KEY(layout.glyph_info_under_cursor.glyphIndex)
+            : layout.codepoint_under_cursor;
+        GlyphInfo char_on_cursor_info = glyphInfoForDraw(cursorGlyphKey, sdfLevel, useMeshPath);
+
+        if (useMeshPath && char_on_cursor_info.indexCount > 0) {
+            glUseProgram(globalMeshProgramID);
+            glUniform3fv(meshColorLoc, 1, textOnCursorColor);
+            drawGlyphMesh(&char_on_cursor_info, cursorPenX, cursorPenY, scale, meshTransformLoc);
+        } else if (char_on_cursor_info.sdfTextureID != 0 && char_on_cursor_info.sdfTextureWidth > 0 && char_on_cursor_info.sdfTextureHeight > 0) {
             glUniform3fv(colorLoc, 1, textOnCursorColor); // colorLoc es el "textColor" base del shader
 
-            float quad_w_char_on_cursor = (float)char_on_cursor_info.sdfTextureWidth * scale;
-            float quad_h_char_on_cursor = (float)char_on_cursor_info.sdfTextureHeight * scale;
+            float quad_w_char_on_cursor = (float)char_on_cursor_info.sdfTextureWidth * char_on_cursor_info.sdfTexelSize * scale;
+            float quad_h_char_on_cursor = (float)char_on_cursor_info.sdfTextureHeight * char_on_cursor_info.sdfTexelSize * scale;
             
-            float actualPosX_char_on_cursor = cursorPenX + ((float)char_on_cursor_info.bitmap_left - sdf_padding) * scale;
-            float actualPosY_char_on_cursor = cursorPenY + ((float)char_on_cursor_info.bitmap_top + sdf_padding) * scale - quad_h_char_on_cursor;
+            float actualPosX_char_on_cursor = cursorPenX + ((float)(char_on_cursor_info.bitmap_left - char_on_cursor_info.sdfPadding)) * char_on_cursor_info.sdfTexelSize * scale;
+            float actualPosY_char_on_cursor = cursorPenY + ((float)(char_on_cursor_info.bitmap_top + char_on_cursor_info.sdfPadding)) * char_on_cursor_info.sdfTexelSize * scale - quad_h_char_on_cursor;
 
             GLfloat charOnCursorTransformMatrix[16] = {
                 quad_w_char_on_cursor, 0.0f,                     0.0f, 0.0f,
@@ -275,15 +576,21 @@ void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos)
             glUniformMatrix4fv(transformLoc, 1, GL_FALSE, charOnCursorTransformMatrix);
 
             glBindTexture(GL_TEXTURE_2D, char_on_cursor_info.sdfTextureID);
+            setMsdfMode(msdfModeLoc, &currentMsdfMode, char_on_cursor_info.sdfChannels == 3);
             glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         }
     }
 
     glBindTexture(GL_TEXTURE_2D, 0); 
     glBindVertexArray(0);            
+    FRAME_TIMING_END(FRAME_PHASE_DRAW, drawStart);
+    frameTimingGpuEnd();
     checkOpenGLError("Before glutSwapBuffers");
+    FRAME_TIMING_BEGIN(swapStart);
     glutSwapBuffers();
+    FRAME_TIMING_END(FRAME_PHASE_SWAP, swapStart);
     checkOpenGLError("After glutSwapBuffers");
+    frameTimingEndFrame();
 #else
     (void)shaderProgramID; (void)text; (void)cursorBytePos;
 #endif
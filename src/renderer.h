@@ -4,6 +4,12 @@
 #include <GL/glew.h> // For GLuint
 #include <stddef.h>  // For size_t
 
+// Tamaño de em en pantalla (px) a partir del cual se usan mallas en vez de SDF
+extern float vectorGlyphMinScreenPx;
+
+// Texto principal como mallas extruidas 3D (TEXT3D_EXTRUDE); 0 = plano
+extern int extrudedTextEnabled;
+
 // Modificado para aceptar la posición del cursor
 void renderText(GLuint shaderProgramID, const char* text, size_t cursorBytePos);
 
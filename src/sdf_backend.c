@@ -0,0 +1,281 @@
+#include "sdf_backend.h"
+#include "sdf_generator.h"   // generate_sdf_from_bitmap / generate_sdf_from_coverage
+#include "outline_sdf.h"     // generateSdfFromOutline / generateMsdfFromOutline
+#include "freetype_handler.h" // extractOutline
+#include "config.h"          // Tamaños de cada backend
+#include "trace.h"           // TRACE_SCOPE (solo con TEXT3D_TRACE)
+#include FT_MODULE_H         // FT_Property_Set (spread de sdf/bsdf)
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SdfBackend sdfBackend = SDF_BACKEND_OUTLINE;
+
+static const char* const backendNames[SDF_BACKEND_COUNT] = {
+    "outline", "msdf", "coverage", "threshold", "freetype", "bsdf"
+};
+
+int sdfPaddingForSpread(float spread) {
+    return (int)ceilf(spread + 0.5f);
+}
+
+static int rowSaturated(const SdfGlyphImage* image, int y) {
+    const unsigned char* row = image->data + (size_t)y * image->width * image->channels;
+    for (int i = 0; i < image->width * image->channels; ++i) {
+        if (row[i] != 255) return 0;
+    }
+    return 1;
+}
+
+static int columnSaturated(const SdfGlyphImage* image, int x) {
+    for (int y = 0; y < image->height; ++y) {
+        const unsigned char* texel = image->data + ((size_t)y * image->width + x) * image->channels;
+        for (int ch = 0; ch < image->channels; ++ch) {
+            if (texel[ch] != 255) return 0;
+        }
+    }
+    return 1;
+}
+
+int trimSdfImage(SdfGlyphImage* image) {
+    if (!image->data || image->width <= 2 || image->height <= 2) return 0;
+    int top = 0, bottom = 0, left = 0, right = 0;
+    while (top < image->height && rowSaturated(image, top)) top++;
+    if (top == image->height) return 0; // Todo exterior: nada que recortar con sentido
+    while (rowSaturated(image, image->height - 1 - bottom)) bottom++;
+    while (columnSaturated(image, left)) left++;
+    while (columnSaturated(image, image->width - 1 - right)) right++;
+    // Se deja una fila/columna saturada por lado
+    top = top > 1 ? top - 1 : 0;
+    bottom = bottom > 1 ? bottom - 1 : 0;
+    left = left > 1 ? left - 1 : 0;
+    right = right > 1 ? right - 1 : 0;
+    if (top + bottom + left + right == 0) return 0;
+
+    int w = image->width - left - right, h = image->height - top - bottom;
+    size_t rowBytes = (size_t)w * image->channels;
+    for (int y = 0; y < h; ++y) { // Destino siempre por detrás del origen: se compacta en el sitio
+        memmove(image->data + y * rowBytes,
+                image->data + ((size_t)(y + top) * image->width + left) * image->channels, rowBytes);
+    }
+    int removed = image->width * image->height - w * h;
+    image->width = w;
+    image->height = h;
+    image->left += left;
+    image->top -= top;
+    return removed;
+}
+
+const char* sdfBackendName(SdfBackend backend) {
+    return (backend >= 0 && backend < SDF_BACKEND_COUNT) ? backendNames[backend] : "?";
+}
+
+int sdfBackendFromName(const char* name, SdfBackend* outBackend) {
+    if (!name) return -1;
+    for (int i = 0; i < SDF_BACKEND_COUNT; ++i) {
+        if (strcmp(name, backendNames[i]) == 0) {
+            *outBackend = (SdfBackend)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Recarga el glifo sin hinting a otro tamaño: a tamaños pequeños el hinting
+// deformaría el glifo una vez escalado a GLYPH_LOAD_PIXEL_SIZE
+static int reloadGlyph(FT_Face face, FT_UInt glyphIndex, int pixelSize) {
+    FT_Error error = FT_Set_Pixel_Sizes(face, 0, pixelSize);
+    if (!error) error = FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_HINTING);
+    if (error) {
+        fprintf(stderr, "ERROR::SDF_BACKEND::RELOAD: No se pudo cargar el glifo %u a %dpx. Error: %d\n",
+                glyphIndex, pixelSize, error);
+        return -1;
+    }
+    return 0;
+}
+
+// SDF del bitmap del slot (ya renderizado o glifo bitmap): EDT antialiasado
+// si hay cobertura de 8 bits y se pide, umbral a 128 en otro caso
+static int bitmapSdf(FT_GlyphSlot slot, int coverage, int padding, float spread, float texelSize, SdfGlyphImage* out) {
+    const FT_Bitmap* bm = &slot->bitmap;
+    if (!bm->buffer || bm->width == 0 || bm->rows == 0) return -1;
+    if (coverage && bm->pixel_mode == FT_PIXEL_MODE_GRAY) {
+        out->data = generate_sdf_from_coverage(bm->buffer, (int)bm->width, (int)bm->rows, bm->pitch,
+                                               padding, spread, &out->width, &out->height);
+    } else {
+        out->data = generate_sdf_from_bitmap(bm->buffer, (int)bm->width, (int)bm->rows, bm->pitch,
+                                             padding, spread, &out->width, &out->height);
+    }
+    out->left = slot->bitmap_left;
+    out->top = slot->bitmap_top;
+    out->texelSize = texelSize;
+    return out->data ? 0 : -1;
+}
+
+static int outlineSdf(FT_GlyphSlot slot, int emPixelSize, int padding, float spread, SdfGlyphImage* out) {
+    static OutlineDataC outline; // Se reutiliza entre glifos (la caché no es multihilo)
+    static int outlineReady = 0;
+    if (!outlineReady) {
+        if (initOutlineData(&outline, 8) != 0) return -1;
+        outlineReady = 1;
+    }
+    float scale = (float)emPixelSize / (float)GLYPH_LOAD_PIXEL_SIZE;
+    resetOutlineData(&outline);
+    outline.flatnessTolerance = OUTLINE_SDF_FLATNESS_TEXELS / scale;
+    if (extractOutline(&slot->outline, &outline) != 0) return -1;
+    out->data = generateSdfFromOutline(&outline, scale, padding, spread, &out->left, &out->top, &out->width, &out->height);
+    out->texelSize = 1.0f / scale;
+    return out->data ? 0 : -1;
+}
+
+static int msdfSdf(FT_GlyphSlot slot, int emPixelSize, int padding, float spread, SdfGlyphImage* out) {
+    float scale = (float)emPixelSize / (float)GLYPH_LOAD_PIXEL_SIZE;
+    out->data = generateMsdfFromOutline(&slot->outline, scale, padding, spread, &out->left, &out->top,
+                                        &out->width, &out->height);
+    out->texelSize = 1.0f / scale;
+    out->channels = 3;
+    return out->data ? 0 : -1;
+}
+
+// --- FreeType: el spread es entero (2..32) y sale como padding; la
+// polaridad es la contraria (interior > 128, 128 + d / spread * 128) ---
+
+// Se fija en cada llamada: cuesta poco frente al render y una caché por
+// puntero de FT_Library fallaría si se crea otra en la misma dirección
+static int setFreeTypeSpread(FT_Library library, int spread) {
+    FT_Error error = FT_Property_Set(library, "sdf", "spread", &spread);
+    if (!error) error = FT_Property_Set(library, "bsdf", "spread", &spread);
+    if (error) {
+        fprintf(stderr, "ERROR::SDF_BACKEND::FREETYPE: No se pudo fijar spread=%d (FreeType sin módulos sdf/bsdf?). Error: %d\n",
+                spread, error);
+        return -1;
+    }
+    return 0;
+}
+
+// Pasa el SDF de FreeType (padding = ftSpread) al contrato común
+static int convertFreeTypeSdf(FT_GlyphSlot slot, int ftSpread, int padding, float spread, float texelSize,
+                              SdfGlyphImage* out) {
+    const FT_Bitmap* bm = &slot->bitmap;
+    if (!bm->buffer || (int)bm->width <= 2 * ftSpread || (int)bm->rows <= 2 * ftSpread) return -1;
+    unsigned char lut[256];
+    for (int v = 0; v < 256; ++v) {
+        float n = -((float)v - 128.0f) / 128.0f * (float)ftSpread / spread;
+        n = n < -1.0f ? -1.0f : (n > 1.0f ? 1.0f : n);
+        lut[v] = (unsigned char)((n * 0.5f + 0.5f) * 255.0f); // Como normalize_distance
+    }
+
+    int glyphW = (int)bm->width - 2 * ftSpread, glyphH = (int)bm->rows - 2 * ftSpread;
+    int w = glyphW + 2 * padding, h = glyphH + 2 * padding;
+    unsigned char* data = (unsigned char*)malloc((size_t)w * h);
+    if (!data) {
+        fprintf(stderr, "ERROR::SDF_BACKEND::FREETYPE: Malloc falló (%dx%d).\n", w, h);
+        return -1;
+    }
+    int shift = ftSpread - padding; // Texel (x, y) de la salida = (x + shift, y + shift) de FreeType
+    for (int y = 0; y < h; ++y) {
+        int sy = y + shift;
+        for (int x = 0; x < w; ++x) {
+            int sx = x + shift;
+            int inside = sx >= 0 && sy >= 0 && sx < (int)bm->width && sy < (int)bm->rows;
+            data[y * w + x] = inside ? lut[bm->buffer[sy * bm->pitch + sx]] : 255; // Fuera: exterior saturado
+        }
+    }
+    out->data = data;
+    out->width = w;
+    out->height = h;
+    out->left = slot->bitmap_left + ftSpread;
+    out->top = slot->bitmap_top - ftSpread;
+    out->texelSize = texelSize;
+    return 0;
+}
+
+static int freeTypeSdf(FT_Face face, FT_UInt glyphIndex, int fromBitmap, int emPixelSize, int padding, float spread,
+                       SdfGlyphImage* out) {
+    int ftSpread = (int)ceilf(spread);
+    if (ftSpread < 2) ftSpread = 2;
+    if (setFreeTypeSpread(face->glyph->library, ftSpread) != 0) return -1;
+    if (reloadGlyph(face, glyphIndex, emPixelSize) != 0) return -1;
+    FT_Error error = 0;
+    if (fromBitmap) error = FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL); // bsdf parte del bitmap
+    if (!error) error = FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF);
+    if (error) {
+        fprintf(stderr, "ERROR::SDF_BACKEND::FREETYPE: FT_Render_Glyph (%s) falló para el glifo %u. Error: %d\n",
+                fromBitmap ? "bsdf" : "sdf", glyphIndex, error);
+        return -1;
+    }
+    return convertFreeTypeSdf(face->glyph, ftSpread, padding, spread,
+                              (float)GLYPH_LOAD_PIXEL_SIZE / (float)emPixelSize, out);
+}
+
+// Tamaño de em propio de cada backend (el de generateGlyphSdf)
+static int defaultEmPixelSize(SdfBackend backend) {
+    switch (backend) {
+    case SDF_BACKEND_OUTLINE:   return SDF_OUTLINE_PIXEL_SIZE;
+    case SDF_BACKEND_MSDF:      return MSDF_PIXEL_SIZE;
+    case SDF_BACKEND_COVERAGE:  return SDF_COVERAGE_PIXEL_SIZE;
+    case SDF_BACKEND_FREETYPE:
+    case SDF_BACKEND_BSDF:      return SDF_FREETYPE_PIXEL_SIZE;
+    default:                    return GLYPH_LOAD_PIXEL_SIZE;
+    }
+}
+
+int generateGlyphSdf(SdfBackend backend, FT_Face face, FT_UInt glyphIndex, int padding, float spread,
+                     SdfGlyphImage* out) {
+    return generateGlyphSdfAtSize(backend, face, glyphIndex, 0, padding, spread, out);
+}
+
+int generateGlyphSdfAtSize(SdfBackend backend, FT_Face face, FT_UInt glyphIndex, int emPixelSize, int padding,
+                           float spread, SdfGlyphImage* out) {
+    TRACE_SCOPE("generateGlyphSdf");
+    memset(out, 0, sizeof(*out));
+    out->padding = padding;
+    out->channels = 1;
+    out->texelSize = 1.0f;
+    if (!face || !face->glyph) return -1;
+    FT_GlyphSlot slot = face->glyph;
+
+    int status = -1;
+    if (slot->format != FT_GLYPH_FORMAT_OUTLINE) {
+        // Glifo bitmap (p. ej. fuentes sin contorno): no hay otro tamaño que cargar
+        return bitmapSdf(slot, 1, padding, spread, 1.0f, out);
+    }
+    if (slot->outline.n_points == 0) return -1; // Espacios y similares: no hay nada que rasterizar
+    if (emPixelSize <= 0) emPixelSize = defaultEmPixelSize(backend);
+    switch (backend) {
+    case SDF_BACKEND_OUTLINE:
+        status = outlineSdf(slot, emPixelSize, padding, spread, out);
+        break;
+    case SDF_BACKEND_MSDF:
+        status = msdfSdf(slot, emPixelSize, padding, spread, out);
+        break;
+    case SDF_BACKEND_COVERAGE:
+    case SDF_BACKEND_THRESHOLD: {
+        // El umbral a GLYPH_LOAD_PIXEL_SIZE usa el slot tal cual (con hinting)
+        int coverage = backend == SDF_BACKEND_COVERAGE;
+        if ((emPixelSize == GLYPH_LOAD_PIXEL_SIZE && !coverage) || reloadGlyph(face, glyphIndex, emPixelSize) == 0) {
+            if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) == 0) {
+                status = bitmapSdf(face->glyph, coverage, padding, spread,
+                                   (float)GLYPH_LOAD_PIXEL_SIZE / (float)emPixelSize, out);
+            }
+        }
+        break;
+    }
+    case SDF_BACKEND_FREETYPE:
+    case SDF_BACKEND_BSDF:
+        status = freeTypeSdf(face, glyphIndex, backend == SDF_BACKEND_BSDF, emPixelSize, padding, spread, out);
+        break;
+    default:
+        fprintf(stderr, "ERROR::SDF_BACKEND::GENERATE: Backend desconocido %d.\n", (int)backend);
+        break;
+    }
+    FT_Set_Pixel_Sizes(face, 0, GLYPH_LOAD_PIXEL_SIZE);
+    if (status != 0) {
+        free(out->data);
+        out->data = NULL;
+        out->width = out->height = 0;
+    }
+    return status;
+}
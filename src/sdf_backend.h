@@ -0,0 +1,68 @@
+#ifndef SDF_BACKEND_H
+#define SDF_BACKEND_H
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// Generadores de SDF intercambiables para la caché de glifos. Todos cumplen
+// el mismo contrato de salida (el de generate_sdf_from_bitmap):
+//   - filas de arriba abajo sin relleno, `channels` bytes por texel;
+//   - `padding` texels alrededor de la caja del glifo (sdfPaddingForSpread
+//     basta para que el borde de la textura quede saturado);
+//   - distancias en [-spread, spread] texels mapeadas a [0, 255] con el
+//     exterior > 128 (el shader invierte con 1.0 - muestra);
+//   - left/top equivalen a bitmap_left/bitmap_top en texels, y texelSize son
+//     los píxeles (a GLYPH_LOAD_PIXEL_SIZE) que mide un texel.
+// FreeType (sdf/bsdf) usa la polaridad contraria y su propio padding (=
+// spread): se convierte aquí.
+typedef enum {
+    SDF_BACKEND_OUTLINE,   // outline_sdf.c a SDF_OUTLINE_PIXEL_SIZE (por defecto)
+    SDF_BACKEND_MSDF,      // MSDF RGB8 de outline_sdf.c a MSDF_PIXEL_SIZE
+    SDF_BACKEND_COVERAGE,  // sdf_generator.c, EDT antialiasado a SDF_COVERAGE_PIXEL_SIZE
+    SDF_BACKEND_THRESHOLD, // sdf_generator.c, umbral a 128 a GLYPH_LOAD_PIXEL_SIZE
+    SDF_BACKEND_FREETYPE,  // FT_RENDER_MODE_SDF desde el contorno (rasterizador "sdf")
+    SDF_BACKEND_BSDF,      // FT_RENDER_MODE_SDF sobre el bitmap antialiasado ("bsdf")
+    SDF_BACKEND_COUNT
+} SdfBackend;
+
+typedef struct {
+    unsigned char* data;   // Se libera con free_sdf_bitmap
+    int width, height;     // Con padding, en texels
+    int left, top;
+    int padding;           // La columna 0 está en left - padding y la fila 0 en top + padding
+    int channels;          // 1 o 3 (MSDF)
+    float texelSize;
+} SdfGlyphImage;
+
+extern SdfBackend sdfBackend; // Backend de la caché de glifos; se fija al arrancar (TEXT3D_SDF_BACKEND)
+
+// Padding mínimo para un spread: el centro del texel del borde queda a
+// spread o más de la caja, así que sale saturado y CLAMP_TO_EDGE no arrastra
+// nada fuera del quad
+int sdfPaddingForSpread(float spread);
+
+// Recorta las filas y columnas exteriores saturadas (255 en todos los canales)
+// de los cuatro lados, dejando una en cada uno para que el filtrado bilineal
+// del borde del quad siga viendo exterior. Ajusta left/top para que la
+// textura no se mueva. Devuelve los texels quitados.
+int trimSdfImage(SdfGlyphImage* image);
+
+const char* sdfBackendName(SdfBackend backend);
+// Devuelve 0 y el backend si `name` es uno de los de sdfBackendName, -1 si no
+int sdfBackendFromName(const char* name, SdfBackend* outBackend);
+
+// SDF del glifo glyphIndex de `face`. El slot debe tener ese glifo cargado a
+// GLYPH_LOAD_PIXEL_SIZE (como lo deja generate_glyph_data_for_codepoint);
+// los backends que rasterizan a otro tamaño lo recargan, así que a la vuelta
+// el slot puede haber cambiado. La cara queda siempre a GLYPH_LOAD_PIXEL_SIZE.
+// Los glifos sin contorno (bitmaps) usan su bitmap con el EDT de
+// sdf_generator.c sea cual sea el backend. Devuelve 0 si hay SDF, -1 si no.
+int generateGlyphSdf(SdfBackend backend, FT_Face face, FT_UInt glyphIndex, int padding, float spread,
+                     SdfGlyphImage* out);
+// Igual, pero con el tamaño de em de la textura fijado a emPixelSize texels
+// (niveles de SDF_LEVEL_SIZES) en lugar del propio del backend; 0 = el propio.
+// texelSize queda en GLYPH_LOAD_PIXEL_SIZE / emPixelSize.
+int generateGlyphSdfAtSize(SdfBackend backend, FT_Face face, FT_UInt glyphIndex, int emPixelSize, int padding,
+                           float spread, SdfGlyphImage* out);
+
+#endif // SDF_BACKEND_H
@@ -3,8 +3,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include "trace.h" // TRACE_SCOPE (solo con TEXT3D_TRACE)
+
+int tessellationFastPathEnabled = 1;
 
 TessellationResult generateGlyphTessellation(OutlineDataC* outlineData) {
+    TRACE_SCOPE("generateGlyphTessellation");
     TESStesselator* tess = NULL;
     // Inicializa allocationFailed a 0. Se pondrá a 1 si hay errores de alocación para result.vertices/elements.
     TessellationResult result = { NULL, NULL, 0, 0, 0 }; 
@@ -15,6 +19,29 @@ TessellationResult generateGlyphTessellation(OutlineDataC* outlineData) {
         return result;
     }
 
+    if (tessellationFastPathEnabled) {
+        EarClipScratch scratch = {0};
+        int fast = earClipOutline(outlineData, &scratch);
+        if (fast == EAR_CLIP_OK) {
+            // La salida del recorte pasa al llamador tal cual
+            if (scratch.indexCount > 0) {
+                result.vertices = scratch.vertices;
+                result.elements = scratch.indices;
+                result.vertexCount = scratch.vertexCount;
+                result.elementCount = scratch.indexCount / 3;
+                scratch.vertices = NULL;
+                scratch.indices = NULL;
+            }
+            freeEarClipScratch(&scratch);
+            return result;
+        }
+        freeEarClipScratch(&scratch);
+        if (fast == EAR_CLIP_ERROR) {
+            result.allocationFailed = 1;
+            return result;
+        }
+    }
+
     tess = tessNewTess(NULL);
     if (!tess) { 
         fprintf(stderr, "ERROR::TESSELLATION_HANDLER: tessNewTess falló (posiblemente memoria insuficiente).\n");
@@ -22,10 +49,12 @@ TessellationResult generateGlyphTessellation(OutlineDataC* outlineData) {
         return result;
     }
 
+    // Los contornos son rangos del buffer de puntos: se pasan sin copiar
     int contoursAdded = 0;
     for (size_t i = 0; i < outlineData->count; ++i) {
-         if (outlineData->contours[i].points && outlineData->contours[i].count >= 3) {
-             tessAddContour(tess, 2, outlineData->contours[i].points, sizeof(Point2D), (int)outlineData->contours[i].count);
+         const ContourC* contour = &outlineData->contours[i];
+         if (contour->count >= 3) {
+             tessAddContour(tess, 2, outlineContourPoints(outlineData, contour), sizeof(Point2D), (int)contour->count);
              contoursAdded++;
          }
      }
@@ -92,4 +121,191 @@ TessellationResult generateGlyphTessellation(OutlineDataC* outlineData) {
 
     tessDeleteTess(tess);
     return result;
-}
\ No newline at end of file
+}
+
+// --- Arena para TESSalloc ---
+struct TessArenaChunk {
+    struct TessArenaChunk* next;
+    size_t capacity;
+    unsigned char data[];
+};
+
+// Cada bloque lleva delante su tamaño (para memrealloc); 16 bytes mantiene la alineación
+#define TESS_ARENA_HEADER 16
+#define TESS_ARENA_ALIGN(n) (((n) + 15) & ~(size_t)15)
+
+static void* tessArenaAlloc(void* userData, unsigned int size) {
+    TessArena* arena = (TessArena*)userData;
+    size_t blockSize = TESS_ARENA_HEADER + TESS_ARENA_ALIGN((size_t)size);
+
+    if (!arena->current || arena->offset + blockSize > arena->current->capacity) {
+        // Siguiente bloque ya reservado (tras un reset) o uno nuevo
+        TessArenaChunk* next = arena->current ? arena->current->next : arena->first;
+        while (next && next->capacity < blockSize) next = next->next;
+        if (!next) {
+            size_t capacity = blockSize > arena->chunkSize ? blockSize : arena->chunkSize;
+            next = (TessArenaChunk*)malloc(sizeof(TessArenaChunk) + capacity);
+            if (!next) {
+                fprintf(stderr, "ERROR::TESSELLATION_HANDLER::ARENA_ALLOC: Malloc falló (%zu bytes).\n", capacity);
+                return NULL;
+            }
+            next->capacity = capacity;
+            if (arena->current) {
+                next->next = arena->current->next;
+                arena->current->next = next;
+            } else {
+                next->next = arena->first;
+                arena->first = next;
+            }
+            arena->backingAllocations++;
+        }
+        arena->current = next;
+        arena->offset = 0;
+    }
+
+    unsigned char* block = arena->current->data + arena->offset;
+    *(size_t*)block = (size_t)size;
+    arena->offset += blockSize;
+    arena->requests++;
+    return block + TESS_ARENA_HEADER;
+}
+
+static void* tessArenaRealloc(void* userData, void* ptr, unsigned int size) {
+    TessArena* arena = (TessArena*)userData;
+    if (!ptr) return tessArenaAlloc(userData, size);
+    unsigned char* block = (unsigned char*)ptr - TESS_ARENA_HEADER;
+    size_t oldSize = *(size_t*)block;
+    if ((size_t)size <= oldSize) return ptr;
+
+    // Si es el último bloque del chunk actual, crece en su sitio
+    size_t oldBlock = TESS_ARENA_HEADER + TESS_ARENA_ALIGN(oldSize);
+    size_t newBlock = TESS_ARENA_HEADER + TESS_ARENA_ALIGN((size_t)size);
+    if (arena->current && block + oldBlock == arena->current->data + arena->offset &&
+        arena->offset - oldBlock + newBlock <= arena->current->capacity) {
+        arena->offset += newBlock - oldBlock;
+        *(size_t*)block = (size_t)size;
+        arena->requests++;
+        return ptr;
+    }
+    void* fresh = tessArenaAlloc(userData, size);
+    if (fresh) memcpy(fresh, ptr, oldSize);
+    return fresh;
+}
+
+static void tessArenaFree(void* userData, void* ptr) {
+    (void)userData; (void)ptr; // Se recupera todo de golpe al rebobinar
+}
+
+static void tessArenaRewind(TessArena* arena) {
+    arena->current = arena->markChunk;
+    arena->offset = arena->markOffset;
+}
+
+static int createContextTesselator(TessellationContext* ctx) {
+    ctx->arena.current = NULL;
+    ctx->arena.offset = 0;
+    ctx->tess = tessNewTess(&ctx->alloc);
+    if (!ctx->tess) {
+        fprintf(stderr, "ERROR::TESSELLATION_HANDLER::CREATE_CONTEXT_TESSELATOR: tessNewTess falló.\n");
+        return -1;
+    }
+    ctx->arena.markChunk = ctx->arena.current;
+    ctx->arena.markOffset = ctx->arena.offset;
+    return 0;
+}
+
+int initTessellationContext(TessellationContext* ctx, size_t arenaChunkSize) {
+    if (!ctx) return -1;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->arena.chunkSize = arenaChunkSize ? arenaChunkSize : TESS_ARENA_DEFAULT_CHUNK;
+
+    ctx->alloc.memalloc = tessArenaAlloc;
+    ctx->alloc.memrealloc = tessArenaRealloc;
+    ctx->alloc.memfree = tessArenaFree;
+    ctx->alloc.userData = &ctx->arena;
+    // Un glifo típico tiene decenas o cientos de vértices: cubos pequeños
+    ctx->alloc.meshEdgeBucketSize = 256;
+    ctx->alloc.meshVertexBucketSize = 256;
+    ctx->alloc.meshFaceBucketSize = 128;
+    ctx->alloc.dictNodeBucketSize = 256;
+    ctx->alloc.regionBucketSize = 128;
+    ctx->alloc.extraVertices = 64;
+
+    if (createContextTesselator(ctx) != 0) {
+        freeTessellationContext(ctx);
+        return -1;
+    }
+    return 0;
+}
+
+void freeTessellationContext(TessellationContext* ctx) {
+    if (!ctx) return;
+    // tessDeleteTess solo llamaría a tessArenaFree: basta con soltar los bloques
+    ctx->tess = NULL;
+    TessArenaChunk* chunk = ctx->arena.first;
+    while (chunk) {
+        TessArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    memset(&ctx->arena, 0, sizeof(ctx->arena));
+    freeEarClipScratch(&ctx->fastPath);
+}
+
+int tessellateOutlineInto(TessellationContext* ctx, const OutlineDataC* outlineData, GlyphMeshBuffer* mesh) {
+    TRACE_SCOPE("tessellateOutlineInto");
+    if (!ctx || !ctx->tess || !outlineData || !mesh) {
+        fprintf(stderr, "ERROR::TESSELLATION_HANDLER::TESSELLATE_OUTLINE_INTO: Parámetros inválidos.\n");
+        return TESS_CONTEXT_ERROR;
+    }
+    mesh->vertexCount = 0;
+    mesh->indexCount = 0;
+
+    if (tessellationFastPathEnabled) {
+        EarClipScratch* fast = &ctx->fastPath;
+        int status = earClipOutline(outlineData, fast);
+        if (status == EAR_CLIP_ERROR) return TESS_CONTEXT_ERROR;
+        if (status == EAR_CLIP_OK) {
+            if (fast->indexCount == 0) return TESS_CONTEXT_OK;
+            mesh->vertexCount = fast->vertexCount;
+            mesh->indexCount = fast->indexCount;
+            if (fast->vertexCount > mesh->vertexCapacity || fast->indexCount > mesh->indexCapacity) {
+                return TESS_CONTEXT_BUFFER_TOO_SMALL;
+            }
+            memcpy(mesh->vertices, fast->vertices, (size_t)fast->vertexCount * 2 * sizeof(TESSreal));
+            memcpy(mesh->indices, fast->indices, (size_t)fast->indexCount * sizeof(TESSindex));
+            return TESS_CONTEXT_OK;
+        }
+    }
+
+    // Todo lo del glifo anterior (malla, cola de prioridad, salida) queda descartado
+    tessArenaRewind(&ctx->arena);
+
+    int contoursAdded = 0;
+    for (size_t i = 0; i < outlineData->count; ++i) {
+        const ContourC* contour = &outlineData->contours[i];
+        if (contour->count >= 3) {
+            tessAddContour(ctx->tess, 2, outlineContourPoints(outlineData, contour), sizeof(Point2D), (int)contour->count);
+            contoursAdded++;
+        }
+    }
+    if (contoursAdded == 0) return TESS_CONTEXT_OK;
+
+    if (!tessTesselate(ctx->tess, TESS_WINDING_ODD, TESS_POLYGONS, 3, 2, NULL)) {
+        // Tras un fallo libtess2 puede conservar la malla a medias: se empieza de cero
+        fprintf(stderr, "ERROR::TESSELLATION_HANDLER::TESSELLATE_OUTLINE_INTO: tessTesselate falló (%d contornos).\n", contoursAdded);
+        if (createContextTesselator(ctx) != 0) ctx->tess = NULL;
+        return TESS_CONTEXT_ERROR;
+    }
+
+    int numVertices = tessGetVertexCount(ctx->tess);
+    int numIndices = tessGetElementCount(ctx->tess) * 3;
+    mesh->vertexCount = numVertices;
+    mesh->indexCount = numIndices;
+    if (numVertices > mesh->vertexCapacity || numIndices > mesh->indexCapacity) {
+        return TESS_CONTEXT_BUFFER_TOO_SMALL;
+    }
+    memcpy(mesh->vertices, tessGetVertices(ctx->tess), (size_t)numVertices * 2 * sizeof(TESSreal));
+    memcpy(mesh->indices, tessGetElements(ctx->tess), (size_t)numIndices * sizeof(TESSindex));
+    return TESS_CONTEXT_OK;
+}
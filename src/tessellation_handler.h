@@ -2,6 +2,7 @@
 #define TESSELLATION_HANDLER_H
 
 #include "tesselator.h"   // Para TESSreal, TESSindex
+#include "ear_clipping.h" // Camino rápido para contornos simples
 #include <stddef.h>       // Para size_t
 // Forward declare OutlineDataC if freetype_handler.h isn't included,
 // or include freetype_handler.h if it's safe from circular dependencies.
@@ -15,10 +16,10 @@ typedef struct {
     float x, y;
 } Point2D;
 
+// Un contorno es un rango dentro del buffer de puntos único de OutlineDataC
 typedef struct {
-    Point2D* points;
+    size_t start;   // Índice del primer punto en OutlineDataC.points
     size_t count;
-    size_t capacity;
 } ContourC;
 
 // Estructura para devolver los resultados de la teselación
@@ -36,5 +37,56 @@ typedef struct {
 // MODIFIED: Takes OutlineDataC* now
 TessellationResult generateGlyphTessellation(struct OutlineDataC* outlineData);
 
+// 1 (por defecto) = probar el recorte de orejas antes que libtess2.
+// Solo se cambia para comparar ambos caminos (tests, bench).
+extern int tessellationFastPathEnabled;
+
+
+// --- Teselación reutilizable (sin mallocs por glifo) ---
+// Un solo TESStesselator vive en una arena de bloques. La arena se rebobina
+// hasta justo después del tesselator antes de cada glifo, así que en régimen
+// estacionario libtess2 no pide memoria al sistema. El resultado se copia a
+// un GlyphMeshBuffer que aporta el llamador.
+
+#define TESS_ARENA_DEFAULT_CHUNK (64 * 1024)
+
+typedef struct TessArenaChunk TessArenaChunk;
+
+typedef struct {
+    TessArenaChunk* first;
+    TessArenaChunk* current;      // NULL = aún no se usó ningún bloque
+    size_t offset;                // Bytes usados en current
+    TessArenaChunk* markChunk;    // Posición tras crear el tesselator
+    size_t markOffset;
+    size_t chunkSize;
+    size_t backingAllocations;    // mallocs reales de bloques (para tests/bench)
+    size_t requests;              // Peticiones de libtess2 servidas
+} TessArena;
+
+typedef struct {
+    TESStesselator* tess;
+    TESSalloc alloc;
+    TessArena arena;
+    EarClipScratch fastPath;
+} TessellationContext;
+
+// Buffers del llamador; vertexCount/indexCount se rellenan al teselar
+typedef struct {
+    TESSreal* vertices;    // x, y por vértice
+    int vertexCapacity;    // En vértices
+    TESSindex* indices;    // 3 por triángulo
+    int indexCapacity;
+    int vertexCount;
+    int indexCount;
+} GlyphMeshBuffer;
+
+#define TESS_CONTEXT_OK 0
+#define TESS_CONTEXT_ERROR -1
+#define TESS_CONTEXT_BUFFER_TOO_SMALL -2 // vertexCount/indexCount dicen cuánto hace falta
+
+int initTessellationContext(TessellationContext* ctx, size_t arenaChunkSize); // 0 = chunk por defecto
+void freeTessellationContext(TessellationContext* ctx);
+int tessellateOutlineInto(TessellationContext* ctx, const struct OutlineDataC* outlineData, GlyphMeshBuffer* mesh);
+
 
 #endif // TESSELLATION_HANDLER_H
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <stddef.h> // For size_t
 #include <ft2build.h>
 #include FT_FREETYPE_H // Include the main FreeType header for FT_ULong and other types
+#include "kerning.h"   // KerningTable, kerningLookup
+#include "text_shaper.h" // ShapedText
 // #include "glyph_manager.h" // Avoid direct dependency on full glyph_manager for easier testing
 
 // Forward declaration if GlyphInfo is complex and comes from glyph_manager.h
@@ -20,6 +22,7 @@ typedef struct {
     long advanceX; // Key for layout
     int indexCount;
     FT_ULong codepoint; // For debugging, or if the GetGlyphMetricsFunc provides it
+    unsigned int glyphIndex; // For kerning (GlyphInfo.glyphIndex); 0 = no kerning
 } MinimalGlyphInfo;
 
 
@@ -40,6 +43,8 @@ typedef struct {
     FT_ULong codepoint_under_cursor; // Codepoint under the cursor
     MinimalGlyphInfo glyph_info_under_cursor; // Glyph info for char under cursor
     int cursor_is_over_char;    // Flag: 1 if cursor is over a char, 0 if at EOL
+    size_t cursor_cluster_byte; // Byte where the glyph under the cursor starts (cursorBytePos
+                                // unless shaping merged it into a ligature or a mark cluster)
 
     // For debugging or more detailed tests, one could add:
     // Position char_positions[MAX_TEXT_LENGTH]; // Or dynamic
@@ -48,6 +53,7 @@ typedef struct {
     // int total_lines;
 } TextLayoutInfo;
 
+// Uses activeKerningTable() (the font's pairs unless TEXT3D_KERNING=0)
 TextLayoutInfo calculateTextLayout(
     const char* text,
     size_t cursorBytePos,
@@ -59,4 +65,36 @@ TextLayoutInfo calculateTextLayout(
     GetGlyphMetricsFunc get_glyph_metrics // Function to get glyph advance width
 );
 
+// Same, with an explicit pair table (NULL = advances only). The kerning of the
+// pair (previous, current) moves the pen before the current glyph, on the same
+// line only; renderText applies it the same way, so the cursor stays in place.
+TextLayoutInfo calculateTextLayoutKerned(
+    const char* text,
+    size_t cursorBytePos,
+    float startX,
+    float startY,
+    float scale,
+    float maxLineWidth,
+    float lineHeight,
+    GetGlyphMetricsFunc get_glyph_metrics,
+    const KerningTable* kerning
+);
+
+// Same rules over the glyphs of shapeText(text): their advances and the pair
+// adjustments come from the shaper. Lines only wrap at the start of a
+// cluster, so a ligature or a base with its marks is never split. A cursor
+// inside a cluster lands on the cluster's first glyph. Glyphs missing from
+// the shaper's face (glyphIndex 0, e.g. emoji) take get_glyph_metrics' advance.
+TextLayoutInfo calculateTextLayoutShaped(
+    const char* text,
+    size_t cursorBytePos,
+    float startX,
+    float startY,
+    float scale,
+    float maxLineWidth,
+    float lineHeight,
+    const ShapedText* shaped,
+    GetGlyphMetricsFunc get_glyph_metrics
+);
+
 #endif // TEXT_LAYOUT_H
@@ -0,0 +1,288 @@
+#include "text_shaper.h"
+#include "kerning.h" // Kerning del shaper sin HarfBuzz
+#include "utils.h"   // utf8_to_codepoint (HarfBuzz: el carácter de cada cluster)
+#include "utf8_decode.h" // utf8DecodeBuffer
+#include "trace.h"
+
+#include FT_ADVANCES_H // FT_Get_Advance
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef TEXT3D_HARFBUZZ
+#include <hb.h>
+#include <hb-ft.h>
+#endif
+
+int textShapingEnabled = 1;
+int shapeCacheEnabled = 1;
+
+// Una palabra ya formada; los clusters de `glyphs` son relativos a su inicio
+typedef struct ShapeCacheEntry {
+    uint32_t hash;
+    FT_Face face;
+    int pixelSize;
+    size_t length;
+    char* bytes;
+    ShapedGlyph* glyphs;
+    int glyphCount;
+    struct ShapeCacheEntry* next;
+} ShapeCacheEntry;
+
+static ShapeCacheEntry* shapeCache[SHAPE_CACHE_BUCKETS];
+static ShapeCacheStats shapeStats;
+static FT_Face shaperFace;
+static int shaperPixelSize;
+#ifdef TEXT3D_HARFBUZZ
+static hb_font_t* hbFont;
+static hb_buffer_t* hbBuffer;
+#endif
+
+int textShaperHasHarfBuzz(void) {
+#ifdef TEXT3D_HARFBUZZ
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int initTextShaper(FT_Face face, int pixelSize) {
+    cleanupTextShaper();
+    if (!face || pixelSize <= 0) return -1;
+    if (FT_Set_Pixel_Sizes(face, 0, (FT_UInt)pixelSize) != 0) {
+        fprintf(stderr, "ERROR::TEXT_SHAPER::INIT: FT_Set_Pixel_Sizes(%d) falló.\n", pixelSize);
+        return -1;
+    }
+#ifdef TEXT3D_HARFBUZZ
+    hbFont = hb_ft_font_create_referenced(face);
+    hbBuffer = hb_buffer_create();
+    if (!hbFont || !hb_buffer_allocation_successful(hbBuffer)) {
+        fprintf(stderr, "ERROR::TEXT_SHAPER::INIT: No se pudo crear la fuente o el buffer de HarfBuzz.\n");
+        cleanupTextShaper();
+        return -1;
+    }
+    // Avances con hinting, como los de GlyphInfo.advanceX
+    hb_ft_font_set_load_flags(hbFont, FT_LOAD_DEFAULT);
+#endif
+    shaperFace = face;
+    shaperPixelSize = pixelSize;
+    return 0;
+}
+
+void cleanupTextShaper(void) {
+    clearShapeCache();
+#ifdef TEXT3D_HARFBUZZ
+    if (hbBuffer) hb_buffer_destroy(hbBuffer);
+    if (hbFont) hb_font_destroy(hbFont);
+    hbBuffer = NULL;
+    hbFont = NULL;
+#endif
+    shaperFace = NULL;
+    shaperPixelSize = 0;
+}
+
+int textShaperReady(void) {
+    return shaperFace != NULL;
+}
+
+// La caché de glifos y los niveles de SDF cambian el tamaño de la cara: se
+// restablece antes de dar forma
+static int ensureShaperSize(void) {
+    if (shaperFace->size && shaperFace->size->metrics.x_ppem == (FT_UShort)shaperPixelSize &&
+        shaperFace->size->metrics.y_ppem == (FT_UShort)shaperPixelSize) {
+        return 0;
+    }
+    if (FT_Set_Pixel_Sizes(shaperFace, 0, (FT_UInt)shaperPixelSize) != 0) return -1;
+#ifdef TEXT3D_HARFBUZZ
+    hb_ft_font_changed(hbFont);
+#endif
+    return 0;
+}
+
+static int reserveShapedGlyphs(ShapedText* text, int extra) {
+    if (text->count + extra <= text->capacity) return 0;
+    int capacity = text->capacity > 0 ? text->capacity : 64;
+    while (capacity < text->count + extra) capacity *= 2;
+    ShapedGlyph* glyphs = (ShapedGlyph*)realloc(text->glyphs, (size_t)capacity * sizeof(ShapedGlyph));
+    if (!glyphs) {
+        fprintf(stderr, "ERROR::TEXT_SHAPER::RESERVE: Realloc falló (%d glifos).\n", capacity);
+        return -1;
+    }
+    text->glyphs = glyphs;
+    text->capacity = capacity;
+    return 0;
+}
+
+#ifdef TEXT3D_HARFBUZZ
+static int shapeWordRaw(const char* word, size_t length, ShapedText* out) {
+    hb_buffer_clear_contents(hbBuffer);
+    hb_buffer_add_utf8(hbBuffer, word, (int)length, 0, (int)length);
+    hb_buffer_guess_segment_properties(hbBuffer); // Escritura, dirección e idioma de la palabra
+    hb_shape(hbFont, hbBuffer, NULL, 0);
+
+    unsigned int count = 0;
+    const hb_glyph_info_t* info = hb_buffer_get_glyph_infos(hbBuffer, &count);
+    const hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(hbBuffer, &count);
+    if (reserveShapedGlyphs(out, (int)count) != 0) return -1;
+    for (unsigned int i = 0; i < count; ++i) {
+        ShapedGlyph* g = &out->glyphs[out->count++];
+        const char* c = word + info[i].cluster;
+        g->glyphIndex = info[i].codepoint; // Tras hb_shape, `codepoint` es el índice de glifo
+        g->codepoint = utf8_to_codepoint(&c);
+        g->cluster = info[i].cluster;
+        g->advanceX = (float)pos[i].x_advance / 64.0f; // hb-ft escala a 26.6
+        g->offsetX = (float)pos[i].x_offset / 64.0f;
+        g->offsetY = (float)pos[i].y_offset / 64.0f;
+    }
+    return 0;
+}
+#else
+#define SHAPER_DECODE_CHUNK_BYTES 256 // Bytes de la palabra que se decodifican de una vez
+
+// Sin HarfBuzz: un glifo por codepoint, con el kerning de la tabla 'kern'
+static int shapeWordRaw(const char* word, size_t length, ShapedText* out) {
+    const KerningTable* kerning = activeKerningTable();
+    if (kerning && kerning->pixelSize != shaperPixelSize) kerning = NULL;
+    uint32_t codepoints[SHAPER_DECODE_CHUNK_BYTES], offsets[SHAPER_DECODE_CHUNK_BYTES];
+    int first = out->count;
+    size_t done = 0;
+    while (done < length) {
+        size_t chunkLength = utf8ChunkLength(word + done, length - done, SHAPER_DECODE_CHUNK_BYTES);
+        size_t chunkUsed = 0;
+        size_t count = utf8DecodeBuffer(word + done, chunkLength, codepoints, offsets, &chunkUsed);
+        if (reserveShapedGlyphs(out, (int)count) != 0) return -1;
+        for (size_t k = 0; k < count; ++k) {
+            ShapedGlyph* g = &out->glyphs[out->count];
+            memset(g, 0, sizeof(*g));
+            g->codepoint = codepoints[k];
+            g->cluster = (uint32_t)(done + offsets[k]);
+            g->glyphIndex = FT_Get_Char_Index(shaperFace, g->codepoint);
+            FT_Fixed advance;
+            if (g->glyphIndex != 0 && FT_Get_Advance(shaperFace, g->glyphIndex, FT_LOAD_DEFAULT, &advance) == 0) {
+                g->advanceX = (float)advance / 65536.0f; // 16.16 en píxeles
+            }
+            if (out->count > first) {
+                ShapedGlyph* previous = &out->glyphs[out->count - 1];
+                previous->advanceX += kerningLookup(kerning, previous->glyphIndex, g->glyphIndex);
+            }
+            out->count++;
+        }
+        done += chunkUsed;
+        if (chunkUsed < chunkLength) break; // U+0000 sobrelargo
+    }
+    return 0;
+}
+#endif
+
+static uint32_t hashWord(FT_Face face, int pixelSize, const char* bytes, size_t length) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    uintptr_t faceBits = (uintptr_t)face;
+    for (size_t i = 0; i < sizeof(faceBits); ++i) hash = (hash ^ (uint32_t)((faceBits >> (8 * i)) & 0xFF)) * 16777619u;
+    hash = (hash ^ (uint32_t)pixelSize) * 16777619u;
+    for (size_t i = 0; i < length; ++i) hash = (hash ^ (unsigned char)bytes[i]) * 16777619u;
+    return hash;
+}
+
+static int storeWord(uint32_t hash, const char* word, size_t length, const ShapedGlyph* glyphs, int count) {
+    if (shapeStats.words >= SHAPE_CACHE_MAX_WORDS) clearShapeCache();
+    ShapeCacheEntry* entry = (ShapeCacheEntry*)malloc(sizeof(ShapeCacheEntry));
+    char* bytes = (char*)malloc(length);
+    ShapedGlyph* copy = (ShapedGlyph*)malloc((size_t)(count > 0 ? count : 1) * sizeof(ShapedGlyph));
+    if (!entry || !bytes || !copy) {
+        free(entry);
+        free(bytes);
+        free(copy);
+        return -1; // Sin caché para esta palabra; el resultado ya está en out
+    }
+    memcpy(bytes, word, length);
+    memcpy(copy, glyphs, (size_t)count * sizeof(ShapedGlyph));
+    entry->hash = hash;
+    entry->face = shaperFace;
+    entry->pixelSize = shaperPixelSize;
+    entry->length = length;
+    entry->bytes = bytes;
+    entry->glyphs = copy;
+    entry->glyphCount = count;
+    entry->next = shapeCache[hash % SHAPE_CACHE_BUCKETS];
+    shapeCache[hash % SHAPE_CACHE_BUCKETS] = entry;
+    shapeStats.words++;
+    return 0;
+}
+
+// Añade a out los glifos de la palabra (clusters relativos a `word`)
+static int shapeWord(const char* word, size_t length, ShapedText* out) {
+    if (!shapeCacheEnabled || length > SHAPE_CACHE_MAX_WORD_BYTES) {
+        shapeStats.misses++;
+        return shapeWordRaw(word, length, out);
+    }
+    uint32_t hash = hashWord(shaperFace, shaperPixelSize, word, length);
+    for (ShapeCacheEntry* e = shapeCache[hash % SHAPE_CACHE_BUCKETS]; e; e = e->next) {
+        if (e->hash == hash && e->length == length && e->face == shaperFace && e->pixelSize == shaperPixelSize &&
+            memcmp(e->bytes, word, length) == 0) {
+            if (reserveShapedGlyphs(out, e->glyphCount) != 0) return -1;
+            memcpy(out->glyphs + out->count, e->glyphs, (size_t)e->glyphCount * sizeof(ShapedGlyph));
+            out->count += e->glyphCount;
+            shapeStats.hits++;
+            return 0;
+        }
+    }
+    shapeStats.misses++;
+    int first = out->count;
+    if (shapeWordRaw(word, length, out) != 0) return -1;
+    storeWord(hash, word, length, out->glyphs + first, out->count - first);
+    return 0;
+}
+
+static int isWordBreak(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+int shapeText(const char* text, size_t length, ShapedText* out) {
+    TRACE_SCOPE("shapeText");
+    if (!out) return -1;
+    out->count = 0;
+    if (!text || !shaperFace) return -1;
+    if (ensureShaperSize() != 0) return -1;
+
+    size_t i = 0;
+    while (i < length) {
+        size_t start = i;
+        if (isWordBreak(text[i])) {
+            i++; // Cada espacio por separado: se queda en caché tras el primero
+        } else {
+            while (i < length && !isWordBreak(text[i])) i++;
+        }
+        int first = out->count;
+        if (shapeWord(text + start, i - start, out) != 0) return -1;
+        for (int g = first; g < out->count; ++g) out->glyphs[g].cluster += (uint32_t)start;
+    }
+    return 0;
+}
+
+void freeShapedText(ShapedText* text) {
+    if (!text) return;
+    free(text->glyphs);
+    text->glyphs = NULL;
+    text->count = 0;
+    text->capacity = 0;
+}
+
+ShapeCacheStats getShapeCacheStats(void) {
+    return shapeStats;
+}
+
+void clearShapeCache(void) {
+    for (int i = 0; i < SHAPE_CACHE_BUCKETS; ++i) {
+        ShapeCacheEntry* entry = shapeCache[i];
+        while (entry) {
+            ShapeCacheEntry* next = entry->next;
+            free(entry->bytes);
+            free(entry->glyphs);
+            free(entry);
+            entry = next;
+        }
+        shapeCache[i] = NULL;
+    }
+    shapeStats.words = 0;
+}
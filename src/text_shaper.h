@@ -0,0 +1,65 @@
+#ifndef TEXT_SHAPER_H
+#define TEXT_SHAPER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// Shaping del texto por palabras: codepoints -> glifos de ftFace con avance y
+// desplazamiento. Compilado con make HARFBUZZ=1 usa hb_shape (ligaduras,
+// marcas combinantes, árabe, devanagari...); sin HarfBuzz, un glifo por
+// codepoint con el cmap, el avance de FreeType y la tabla de kerning.
+//
+// Dar forma cuesta mucho más que el layout, así que el texto se parte en
+// palabras (los espacios, una a una) y cada palabra se guarda en una caché
+// con clave (cara, tamaño, bytes): en un documento las palabras repetidas
+// solo pasan por el shaper la primera vez.
+//
+// Sin bidi: las palabras se colocan en orden lógico, de izquierda a derecha
+// (HarfBuzz sí ordena visualmente los glifos dentro de cada palabra).
+
+typedef struct {
+    FT_UInt glyphIndex;     // En la cara del shaper; 0 = no está (usar codepoint con getGlyphInfo)
+    FT_ULong codepoint;     // Primer codepoint del cluster
+    uint32_t cluster;       // Byte del texto donde empieza el cluster
+    float advanceX;         // Píxeles al tamaño del shaper (como GlyphInfo.advanceX)
+    float offsetX, offsetY; // Desplazamiento del glifo respecto al pen (marcas)
+} ShapedGlyph;
+
+typedef struct {
+    ShapedGlyph* glyphs;
+    int count;
+    int capacity;
+} ShapedText;
+
+typedef struct {
+    long hits;
+    long misses;
+    int words;              // Palabras guardadas ahora mismo
+} ShapeCacheStats;
+
+#define SHAPE_CACHE_BUCKETS 1024
+#define SHAPE_CACHE_MAX_WORDS 8192 // Al llegar, se vacía entera (un documento cabe de sobra)
+#define SHAPE_CACHE_MAX_WORD_BYTES 64 // Palabras más largas se forman sin caché
+
+extern int textShapingEnabled; // 1 = el renderer coloca glifos del shaper (main.c: solo con HarfBuzz salvo TEXT3D_SHAPING=1)
+extern int shapeCacheEnabled;  // 0 = cada palabra pasa por el shaper (para medir la caché)
+
+// 1 si se compiló con HarfBuzz
+int textShaperHasHarfBuzz(void);
+
+// Prepara el shaper para `face` a pixelSize. Devuelve 0 si todo fue bien.
+int initTextShaper(FT_Face face, int pixelSize);
+void cleanupTextShaper(void);
+int textShaperReady(void);
+
+// Da forma a text[0, length) y deja los glifos en out (reutiliza su memoria;
+// out->count se pone a 0 antes). Los clusters son bytes de `text`.
+int shapeText(const char* text, size_t length, ShapedText* out);
+void freeShapedText(ShapedText* text);
+
+ShapeCacheStats getShapeCacheStats(void);
+void clearShapeCache(void);
+
+#endif // TEXT_SHAPER_H
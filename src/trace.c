@@ -0,0 +1,168 @@
+#ifdef TEXT3D_TRACE
+#define _GNU_SOURCE // syscall(SYS_gettid), clock_gettime
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+// Un anillo por hilo. Solo su hilo escribe (writeIndex con release) y
+// traceFlush lee con acquire, así que grabar no toma ningún lock. Si el
+// anillo se llena se sobrescriben los eventos más antiguos.
+//
+// Los pools de hilos (teselado y SDF por lotes) lanzan hilos nuevos en cada
+// llamada: cuando un hilo termina, su anillo queda libre y lo reutiliza el
+// siguiente hilo que grabe. Así hay tantos anillos como hilos vivos a la vez,
+// no uno por hilo creado. Los eventos del hilo anterior se conservan hasta
+// que el anillo da la vuelta; por eso cada evento lleva su tid.
+typedef struct {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durNs;
+    int tid;
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    TraceEvent events[TRACE_RING_CAPACITY];
+    uint64_t writeIndex;
+    uint64_t baseIndex;     // Eventos anteriores a este índice se descartaron con traceReset
+    int tid;                // Hilo dueño actual
+    int inUse;              // 0 = su hilo terminó y otro puede reclamarlo
+    struct TraceBuffer* next;
+} TraceBuffer;
+
+int traceEnabled = 0;
+
+static TraceBuffer* traceBuffers = NULL;      // Lista de solo inserción (CAS)
+static __thread TraceBuffer* threadBuffer = NULL;
+static uint64_t traceEpochNs = 0;             // ts = 0 en el primer traceStart
+static pthread_key_t threadBufferKey;         // Su destructor libera el anillo al terminar el hilo
+static pthread_once_t threadBufferKeyOnce = PTHREAD_ONCE_INIT;
+
+uint64_t traceNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void releaseThreadBuffer(void* buffer) {
+    __atomic_store_n(&((TraceBuffer*)buffer)->inUse, 0, __ATOMIC_RELEASE);
+}
+
+static void createThreadBufferKey(void) {
+    pthread_key_create(&threadBufferKey, releaseThreadBuffer);
+}
+
+// Reclama el anillo de un hilo terminado o, si no hay ninguno, crea otro.
+static TraceBuffer* acquireThreadBuffer(void) {
+    pthread_once(&threadBufferKeyOnce, createThreadBufferKey);
+    int tid = (int)syscall(SYS_gettid);
+
+    TraceBuffer* buffer = NULL;
+    for (TraceBuffer* b = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE); b; b = b->next) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&b->inUse, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            buffer = b;
+            break;
+        }
+    }
+
+    if (!buffer) {
+        buffer = (TraceBuffer*)calloc(1, sizeof(TraceBuffer));
+        if (!buffer) {
+            fprintf(stderr, "ERROR::TRACE::ACQUIRE_THREAD_BUFFER: Malloc falló, se pierden eventos de este hilo.\n");
+            return NULL;
+        }
+        buffer->inUse = 1;
+        TraceBuffer* head = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE);
+        do {
+            buffer->next = head;
+        } while (!__atomic_compare_exchange_n(&traceBuffers, &head, buffer, 0,
+                                              __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    }
+    buffer->tid = tid;
+    pthread_setspecific(threadBufferKey, buffer);
+    threadBuffer = buffer;
+    return buffer;
+}
+
+void traceRecordZone(const char* name, uint64_t startNs, uint64_t endNs) {
+    TraceBuffer* buffer = threadBuffer ? threadBuffer : acquireThreadBuffer();
+    if (!buffer) return;
+    uint64_t w = buffer->writeIndex; // Solo este hilo lo modifica
+    TraceEvent* ev = &buffer->events[w & (TRACE_RING_CAPACITY - 1)];
+    ev->name = name;
+    ev->startNs = startNs;
+    ev->durNs = endNs - startNs;
+    ev->tid = buffer->tid;
+    __atomic_store_n(&buffer->writeIndex, w + 1, __ATOMIC_RELEASE);
+}
+
+int traceStart(void) {
+    if (traceEpochNs == 0) traceEpochNs = traceNow();
+    __atomic_store_n(&traceEnabled, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+void traceStop(void) {
+    __atomic_store_n(&traceEnabled, 0, __ATOMIC_RELAXED);
+}
+
+static void bufferRange(TraceBuffer* b, uint64_t* first, uint64_t* end) {
+    *end = __atomic_load_n(&b->writeIndex, __ATOMIC_ACQUIRE);
+    uint64_t oldest = (*end > TRACE_RING_CAPACITY) ? *end - TRACE_RING_CAPACITY : 0;
+    *first = (b->baseIndex > oldest) ? b->baseIndex : oldest;
+}
+
+long traceEventCount(void) {
+    long total = 0;
+    for (TraceBuffer* b = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE); b; b = b->next) {
+        uint64_t first, end;
+        bufferRange(b, &first, &end);
+        total += (long)(end - first);
+    }
+    return total;
+}
+
+long traceBufferCount(void) {
+    long count = 0;
+    for (TraceBuffer* b = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE); b; b = b->next) count++;
+    return count;
+}
+
+void traceReset(void) {
+    for (TraceBuffer* b = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE); b; b = b->next) {
+        b->baseIndex = __atomic_load_n(&b->writeIndex, __ATOMIC_ACQUIRE);
+    }
+}
+
+int traceFlush(const char* path) {
+    FILE* f = path ? fopen(path, "w") : NULL;
+    if (!f) {
+        fprintf(stderr, "ERROR::TRACE::FLUSH: No se pudo abrir '%s'.\n", path ? path : "(null)");
+        return -1;
+    }
+    int pid = (int)getpid();
+    int first_event = 1;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (TraceBuffer* b = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE); b; b = b->next) {
+        uint64_t first, end;
+        bufferRange(b, &first, &end);
+        for (uint64_t i = first; i < end; ++i) {
+            const TraceEvent* ev = &b->events[i & (TRACE_RING_CAPACITY - 1)];
+            double tsUs = (ev->startNs >= traceEpochNs) ? (double)(ev->startNs - traceEpochNs) / 1000.0 : 0.0;
+            fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"text3d\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                    first_event ? "" : ",", ev->name, tsUs, (double)ev->durNs / 1000.0, pid, ev->tid);
+            first_event = 0;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    return 0;
+}
+
+#endif // TEXT3D_TRACE
@@ -0,0 +1,69 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Zonas de traza con formato Chrome trace_event (se abren en Perfetto o
+// chrome://tracing). Se compilan solo con -DTEXT3D_TRACE (make TRACE=1):
+//  - Sin TEXT3D_TRACE las macros no generan código.
+//  - Compiladas pero sin traceStart(), cada zona cuesta dos ramas bien
+//    predichas sobre una sola lectura de traceEnabled: la de la entrada y la
+//    de la salida, que mira lo que decidió la entrada (no vuelve a leerlo).
+//
+// Uso:  void f(void) { TRACE_SCOPE("f"); ... }  // Se cierra al salir del bloque
+
+#define TRACE_RING_CAPACITY 65536 // Eventos por hilo (potencia de 2)
+
+#ifdef TEXT3D_TRACE
+
+#include <stdint.h>
+
+typedef struct {
+    const char* name; // Literal de cadena: no se copia
+    int active;       // traceEnabled al entrar
+    uint64_t startNs;
+} TraceZone;
+
+extern int traceEnabled;
+
+uint64_t traceNow(void);
+void traceRecordZone(const char* name, uint64_t startNs, uint64_t endNs);
+
+static inline TraceZone traceZoneBegin(const char* name) {
+    TraceZone zone = { name, 0, 0 };
+    if (__builtin_expect(traceEnabled, 0)) {
+        zone.active = 1;
+        zone.startNs = traceNow();
+    }
+    return zone;
+}
+
+static inline void traceZoneEnd(TraceZone* zone) {
+    if (__builtin_expect(zone->active, 0)) traceRecordZone(zone->name, zone->startNs, traceNow());
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(zoneName) \
+    TraceZone TRACE_CONCAT(traceZone_, __LINE__) __attribute__((cleanup(traceZoneEnd))) = \
+        traceZoneBegin(zoneName)
+
+int traceStart(void);                 // Empieza a grabar
+void traceStop(void);                 // Deja de grabar (los buffers se conservan)
+int traceFlush(const char* path);     // Vuelca todos los hilos a JSON
+long traceEventCount(void);           // Eventos retenidos (todos los hilos)
+long traceBufferCount(void);          // Anillos reservados (uno por hilo vivo a la vez)
+void traceReset(void);                // Vacía los buffers
+
+#else // !TEXT3D_TRACE
+
+#define TRACE_SCOPE(zoneName) do { } while (0)
+
+static inline int traceStart(void) { return 0; }
+static inline void traceStop(void) { }
+static inline int traceFlush(const char* path) { (void)path; return -1; } // Nada que escribir
+static inline long traceEventCount(void) { return 0; }
+static inline long traceBufferCount(void) { return 0; }
+static inline void traceReset(void) { }
+
+#endif // TEXT3D_TRACE
+
+#endif // TRACE_H
@@ -0,0 +1,192 @@
+#include "utf8_decode.h"
+#include "trace.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+int utf8SimdEnabled = 1;
+
+// Un carácter, con las mismas reglas que utf8_to_codepoint; s[k] con
+// k >= remaining cuenta como 0. Devuelve los bytes consumidos.
+static size_t decodeOne(const unsigned char* s, size_t remaining, uint32_t* codepoint) {
+    unsigned char c1 = s[0];
+    size_t need;
+    uint32_t cp;
+    if (c1 < 0x80) {
+        *codepoint = c1;
+        return 1;
+    } else if ((c1 & 0xE0) == 0xC0) {
+        need = 1;
+        cp = c1 & 0x1F;
+    } else if ((c1 & 0xF0) == 0xE0) {
+        need = 2;
+        cp = c1 & 0x0F;
+    } else if ((c1 & 0xF8) == 0xF0) {
+        need = 3;
+        cp = c1 & 0x07;
+    } else {
+        *codepoint = 0xFFFD;
+        return 1;
+    }
+    for (size_t k = 1; k <= need; ++k) {
+        unsigned char b = k < remaining ? s[k] : 0;
+        if ((b & 0xC0) != 0x80) {
+            *codepoint = 0xFFFD; // Secuencia cortada: se avanza un byte, como utf8_to_codepoint
+            return 1;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    *codepoint = cp;
+    return need + 1;
+}
+
+#ifdef __SSE2__
+// Bytes de v con (b & mask) == value, como vector y como máscara de bits
+static inline __m128i classBytes(__m128i v, int mask, int value) {
+    return _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)mask)), _mm_set1_epi8((char)value));
+}
+
+static inline uint32_t classMask(__m128i v, int mask, int value) {
+    return (uint32_t)_mm_movemask_epi8(classBytes(v, mask, value));
+}
+
+// Codepoints de 1 a 3 bytes que empezarían en cada uno de los 8 bytes de b0
+// (ya a 16 bits, con los dos siguientes en b1 y b2); is2/is3 marcan los
+// inicios de 2 y 3 bytes
+static inline __m128i candidates16(__m128i b0, __m128i b1, __m128i b2, __m128i is2, __m128i is3) {
+    __m128i low6 = _mm_set1_epi16(0x3F);
+    __m128i c2 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1F)), 6), _mm_and_si128(b1, low6));
+    __m128i c3 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x0F)), 12),
+                              _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b1, low6), 6), _mm_and_si128(b2, low6)));
+    __m128i c1 = _mm_andnot_si128(_mm_or_si128(is2, is3), b0);
+    return _mm_or_si128(c1, _mm_or_si128(_mm_and_si128(is2, c2), _mm_and_si128(is3, c3)));
+}
+
+// Recorre text de 16 en 16 bytes mientras haya 32 por delante (lo que mira un
+// bloque y sus continuaciones). Devuelve dónde se quedó; el resto, incluido
+// cualquier codepoint 0, lo hace el bucle escalar.
+static size_t decodeSse2(const unsigned char* s, size_t length, uint32_t* codepoints, uint32_t* byteOffsets,
+                         size_t* count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i step4 = _mm_set1_epi32(4);
+    size_t i = 0, n = *count;
+    while (i + 32 <= length) {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(s + i));
+        uint32_t high0 = (uint32_t)_mm_movemask_epi8(v0);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, zero)) != 0) break; // Fin del texto
+
+        if (high0 == 0) { // 16 bytes ASCII
+            __m128i lo = _mm_unpacklo_epi8(v0, zero), hi = _mm_unpackhi_epi8(v0, zero);
+            _mm_storeu_si128((__m128i*)(codepoints + n), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(codepoints + n + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(codepoints + n + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i*)(codepoints + n + 12), _mm_unpackhi_epi16(hi, zero));
+            if (byteOffsets) {
+                __m128i offset = _mm_add_epi32(_mm_set1_epi32((int)i), _mm_setr_epi32(0, 1, 2, 3));
+                for (int k = 0; k < 16; k += 4, offset = _mm_add_epi32(offset, step4)) {
+                    _mm_storeu_si128((__m128i*)(byteOffsets + n + k), offset);
+                }
+            }
+            n += 16;
+            i += 16;
+            continue;
+        }
+
+        // Inicios en los 16 bytes del bloque; de los siguientes solo importa
+        // si son continuaciones (las de una secuencia que empieza al final)
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(s + i + 16));
+        uint32_t cont = classMask(v0, 0xC0, 0x80) | classMask(v1, 0xC0, 0x80) << 16;
+        uint32_t lead2 = classMask(v0, 0xE0, 0xC0);
+        uint32_t lead3 = classMask(v0, 0xF0, 0xE0);
+        uint32_t lead4 = classMask(v0, 0xF8, 0xF0);
+        uint32_t bad = high0 & ~(cont | lead2 | lead3 | lead4);
+        uint32_t multi = lead2 | lead3 | lead4;
+        uint32_t leads = (~high0 & 0xFFFF) | multi;
+        uint32_t expected = multi << 1 | (lead3 | lead4) << 2 | lead4 << 3;
+
+        uint32_t span = 0;
+        if (leads != 0) {
+            int last = 31 - __builtin_clz(leads);
+            int end = last + 1 + (int)((multi >> last) & 1) + (int)(((lead3 | lead4) >> last) & 1) + (int)((lead4 >> last) & 1);
+            span = (1u << end) - 1;
+        }
+        // Válido si cada byte del tramo es un inicio o justo la continuación
+        // que espera su inicio: así el decodificador escalar haría lo mismo
+        if (span == 0 || (bad & span) != 0 || (cont & span) != expected) {
+            size_t stop = i + 16;
+            while (i < stop) {
+                size_t used = decodeOne(s + i, length - i, &codepoints[n]);
+                if (codepoints[n] == 0) goto done; // C0 80 y similares también acaban el texto
+                if (byteOffsets) byteOffsets[n] = (uint32_t)i;
+                n++;
+                i += used;
+            }
+            continue;
+        }
+
+        __m128i v0b = _mm_loadu_si128((const __m128i*)(s + i + 1));
+        __m128i v0c = _mm_loadu_si128((const __m128i*)(s + i + 2));
+        __m128i is2 = classBytes(v0, 0xE0, 0xC0);
+        __m128i is3 = classBytes(v0, 0xF0, 0xE0);
+        __m128i lo = candidates16(_mm_unpacklo_epi8(v0, zero), _mm_unpacklo_epi8(v0b, zero), _mm_unpacklo_epi8(v0c, zero),
+                                  _mm_unpacklo_epi8(is2, is2), _mm_unpacklo_epi8(is3, is3));
+        __m128i hi = candidates16(_mm_unpackhi_epi8(v0, zero), _mm_unpackhi_epi8(v0b, zero), _mm_unpackhi_epi8(v0c, zero),
+                                  _mm_unpackhi_epi8(is2, is2), _mm_unpackhi_epi8(is3, is3));
+        uint32_t zeroLeads = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(lo, zero), _mm_cmpeq_epi16(hi, zero))) & leads;
+        if (zeroLeads != 0) break; // Forma sobrelarga de U+0000: el bucle escalar para ahí
+        uint16_t candidates[16];
+        _mm_storeu_si128((__m128i*)candidates, lo);
+        _mm_storeu_si128((__m128i*)(candidates + 8), hi);
+        uint32_t m = leads;
+        while (m) {
+            int p = __builtin_ctz(m);
+            m &= m - 1;
+            if ((lead4 >> p) & 1) { // 4 bytes (emoji...): no cabe en 16 bits
+                decodeOne(s + i + p, length - i - p, &codepoints[n]);
+                if (codepoints[n] == 0) {
+                    i += (size_t)p;
+                    goto done;
+                }
+            } else {
+                codepoints[n] = candidates[p];
+            }
+            if (byteOffsets) byteOffsets[n] = (uint32_t)(i + p);
+            n++;
+        }
+        i += (size_t)(32 - __builtin_clz(span)); // Tras la última secuencia que empieza en el bloque
+    }
+done:
+    *count = n;
+    return i;
+}
+#endif
+
+size_t utf8DecodeBuffer(const char* text, size_t length, uint32_t* codepoints, uint32_t* byteOffsets,
+                        size_t* bytesUsed) {
+    TRACE_SCOPE("utf8DecodeBuffer");
+    if (bytesUsed) *bytesUsed = 0;
+    if (!text || !codepoints) return 0;
+    const unsigned char* s = (const unsigned char*)text;
+    size_t i = 0, n = 0;
+#ifdef __SSE2__
+    if (utf8SimdEnabled) i = decodeSse2(s, length, codepoints, byteOffsets, &n);
+#endif
+    while (i < length) {
+        size_t used = decodeOne(s + i, length - i, &codepoints[n]);
+        if (codepoints[n] == 0) break;
+        if (byteOffsets) byteOffsets[n] = (uint32_t)i;
+        n++;
+        i += used;
+    }
+    if (bytesUsed) *bytesUsed = i;
+    return n;
+}
+
+size_t utf8ChunkLength(const char* text, size_t length, size_t maxBytes) {
+    if (length <= maxBytes) return length;
+    size_t end = maxBytes;
+    // Un byte de continuación en el corte podría ser de una secuencia anterior
+    while (end > 0 && ((unsigned char)text[end] & 0xC0) == 0x80) end--;
+    return end > 0 ? end : maxBytes; // Todo continuaciones: ninguna secuencia las reclama
+}
@@ -0,0 +1,38 @@
+#ifndef UTF8_DECODE_H
+#define UTF8_DECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Decodificación de UTF-8 por bloques: todo un buffer a un array de
+// codepoints, en lugar de un utf8_to_codepoint por carácter. Con SSE2
+// (x86-64) va de 16 en 16 bytes:
+//   - ASCII: los 16 bytes se ensanchan a 32 bits sin mirar uno a uno;
+//   - multibyte: las clases de cada byte (ASCII, inicio de 2/3/4 bytes,
+//     continuación) salen de máscaras de 16 bits, se valida el bloque entero
+//     comparando las continuaciones esperadas con las que hay, y los
+//     codepoints de 1 a 3 bytes se calculan en registros para todas las
+//     posiciones; solo queda copiar los de las posiciones de inicio.
+// Un bloque con algo inválido se decodifica byte a byte, así que el
+// reemplazo es exactamente el de utf8_to_codepoint: U+FFFD y un byte de
+// avance (sin rechazar formas sobrelargas ni sustitutos, como él).
+
+extern int utf8SimdEnabled; // 0 = ruta escalar (las dos dan el mismo resultado)
+
+// Decodifica text[0, length) en codepoints y, si byteOffsets no es NULL,
+// guarda el byte donde empieza cada uno. Para en el primer codepoint 0 (un
+// byte 0 o su forma sobrelarga, C0 80...), como el bucle
+// while ((cp = utf8_to_codepoint(&s)) != 0); los bytes a partir de
+// length cuentan como 0. Cada array necesita sitio para length valores
+// (length < 4 GiB). Devuelve cuántos codepoints escribió y, si bytesUsed no
+// es NULL, hasta qué byte llegó (< length si paró en un 0).
+size_t utf8DecodeBuffer(const char* text, size_t length, uint32_t* codepoints, uint32_t* byteOffsets,
+                        size_t* bytesUsed);
+
+// Longitud (<= maxBytes, > 0 si length > 0) de un trozo inicial de text que
+// se decodifica igual por separado que dentro del texto entero: no corta
+// justo antes de un byte de continuación. Para decodificar por trozos con
+// arrays de tamaño fijo; maxBytes >= 4.
+size_t utf8ChunkLength(const char* text, size_t length, size_t maxBytes);
+
+#endif // UTF8_DECODE_H
@@ -0,0 +1,113 @@
+#include "minunit.h"
+#include "batch_tessellation.h"
+#include "tessellation_handler.h"
+#include "freetype_handler.h" // OutlineDataC y callbacks de FT_Outline_Decompose
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include FT_OUTLINE_H
+
+static const char* batchTestFontPath = "tests/fonts/test_font.ttf";
+#define BATCH_TEST_PIXEL_SIZE 48
+#define BATCH_TEST_FLATNESS 0.05f
+
+MU_TEST(test_invalid_arguments) {
+    GlyphMeshBatch batch;
+    mu_assert_int_eq(-1, batchTessellateRange(NULL, 0x20, 0x7E, BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 2, &batch));
+    mu_assert_int_eq(-1, batchTessellateRange(batchTestFontPath, 0x7E, 0x20, BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 2, &batch));
+    mu_assert_int_eq(-1, batchTessellateRange("tests/fonts/non_existent_font.ttf", 0x20, 0x7E,
+                                              BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 2, &batch));
+    mu_check(batch.vertices == NULL && batch.entries == NULL);
+}
+
+MU_TEST(test_offset_table_is_packed_in_codepoint_order) {
+    GlyphMeshBatch batch;
+    mu_assert_int_eq(0, batchTessellateRange(batchTestFontPath, 0x20, 0x7E, BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 3, &batch));
+    mu_assert_int_eq(0x7E - 0x20 + 1, (int)batch.entryCount);
+
+    int vertexCursor = 0, indexCursor = 0;
+    for (size_t g = 0; g < batch.entryCount; ++g) {
+        const GlyphMeshEntry* entry = &batch.entries[g];
+        mu_check(entry->codepoint == 0x20 + g);
+        mu_assert_int_eq(vertexCursor, entry->vertexOffset);
+        mu_assert_int_eq(indexCursor, entry->indexOffset);
+        mu_assert_int_eq(0, entry->indexCount % 3);
+        for (int i = 0; i < entry->indexCount; ++i) {
+            int local = batch.indices[entry->indexOffset + i];
+            mu_check(local >= 0 && local < entry->vertexCount);
+        }
+        vertexCursor += entry->vertexCount;
+        indexCursor += entry->indexCount;
+    }
+    mu_assert_int_eq(vertexCursor, batch.vertexCount);
+    mu_assert_int_eq(indexCursor, batch.indexCount);
+
+    const GlyphMeshEntry* space = findBatchGlyphMesh(&batch, ' ');
+    const GlyphMeshEntry* letterA = findBatchGlyphMesh(&batch, 'A');
+    mu_check(space != NULL && space->indexCount == 0 && space->advanceX > 0.0f);
+    mu_check(letterA != NULL && letterA->indexCount > 0);
+    mu_check(findBatchGlyphMesh(&batch, 0x7F) == NULL);
+    freeGlyphMeshBatch(&batch);
+}
+
+MU_TEST(test_thread_count_does_not_change_output) {
+    GlyphMeshBatch single, parallel;
+    mu_assert_int_eq(0, batchTessellateRange(batchTestFontPath, 0x20, 0x17F, BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 1, &single));
+    mu_assert_int_eq(0, batchTessellateRange(batchTestFontPath, 0x20, 0x17F, BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 4, &parallel));
+
+    mu_assert_int_eq(single.vertexCount, parallel.vertexCount);
+    mu_assert_int_eq(single.indexCount, parallel.indexCount);
+    mu_check(memcmp(single.entries, parallel.entries, single.entryCount * sizeof(GlyphMeshEntry)) == 0);
+    mu_check(memcmp(single.vertices, parallel.vertices, (size_t)single.vertexCount * 2 * sizeof(TESSreal)) == 0);
+    mu_check(memcmp(single.indices, parallel.indices, (size_t)single.indexCount * sizeof(TESSindex)) == 0);
+    freeGlyphMeshBatch(&single);
+    freeGlyphMeshBatch(&parallel);
+}
+
+MU_TEST(test_matches_single_glyph_tessellation) {
+    GlyphMeshBatch batch;
+    mu_assert_int_eq(0, batchTessellateRange(batchTestFontPath, 'g', 'g', BATCH_TEST_PIXEL_SIZE, BATCH_TEST_FLATNESS, 2, &batch));
+
+    // Misma ruta en el hilo del test: FT_Outline_Decompose + generateGlyphTessellation
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, batchTestFontPath, 0, &face));
+    FT_Set_Pixel_Sizes(face, 0, BATCH_TEST_PIXEL_SIZE);
+    mu_assert_int_eq(0, FT_Load_Glyph(face, FT_Get_Char_Index(face, 'g'), FT_LOAD_NO_BITMAP));
+
+    OutlineDataC outline;
+    initOutlineData(&outline, 8);
+    outline.flatnessTolerance = BATCH_TEST_FLATNESS;
+    FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    mu_assert_int_eq(0, FT_Outline_Decompose(&face->glyph->outline, &funcs, &outline));
+    TessellationResult expected = generateGlyphTessellation(&outline);
+
+    const GlyphMeshEntry* entry = findBatchGlyphMesh(&batch, 'g');
+    mu_assert_int_eq(expected.vertexCount, entry->vertexCount);
+    mu_assert_int_eq(expected.elementCount * 3, entry->indexCount);
+    mu_check(memcmp(expected.vertices, batch.vertices, (size_t)entry->vertexCount * 2 * sizeof(TESSreal)) == 0);
+    mu_check(memcmp(expected.elements, batch.indices, (size_t)entry->indexCount * sizeof(TESSindex)) == 0);
+
+    free(expected.vertices);
+    free(expected.elements);
+    freeOutlineData(&outline);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+    freeGlyphMeshBatch(&batch);
+}
+
+MU_TEST_SUITE(batch_tessellation_tests) {
+    MU_RUN_TEST(test_invalid_arguments);
+    MU_RUN_TEST(test_offset_table_is_packed_in_codepoint_order);
+    MU_RUN_TEST(test_thread_count_does_not_change_output);
+    MU_RUN_TEST(test_matches_single_glyph_tessellation);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(batch_tessellation_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,193 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime con -std=c99
+#include "minunit.h"
+#include "bc4_encoder.h"
+#include "sdf_generator.h"
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char* bc4TestFontPath = "tests/fonts/test_font.ttf";
+
+static unsigned int lcgState = 12345u;
+static unsigned char next_byte(void) {
+    lcgState = lcgState * 1103515245u + 12345u;
+    return (unsigned char)(lcgState >> 16);
+}
+
+static int block_max_error(const unsigned char block[16]) {
+    unsigned char encoded[BC4_BLOCK_BYTES], decoded[16];
+    bc4EncodeBlock(block, encoded);
+    bc4DecodeBlock(encoded, decoded);
+    int worst = 0;
+    for (int i = 0; i < 16; ++i) {
+        int d = abs((int)block[i] - (int)decoded[i]);
+        worst = d > worst ? d : worst;
+    }
+    return worst;
+}
+
+MU_TEST(test_block_cases) {
+    unsigned char block[16];
+    memset(block, 255, sizeof(block)); // Exterior saturado
+    mu_assert_int_eq(0, block_max_error(block));
+    for (int i = 0; i < 16; ++i) block[i] = (i & 1) ? 0 : 255; // Solo extremos
+    mu_assert_int_eq(0, block_max_error(block));
+    for (int i = 0; i < 16; ++i) block[i] = (unsigned char)(100 + 7 * (i % 2)); // Dos valores
+    mu_assert_int_eq(0, block_max_error(block));
+    // Rampa completa: 8 niveles para 0..255, error máximo ~ 255 / 14
+    for (int i = 0; i < 16; ++i) block[i] = (unsigned char)(i * 17);
+    mu_check(block_max_error(block) <= 19);
+    // Rampa corta junto a texels saturados: el modo de 6 valores deja 255 exacto
+    for (int i = 0; i < 16; ++i) block[i] = i < 8 ? (unsigned char)(140 + 2 * i) : 255;
+    mu_check(block_max_error(block) <= 2);
+
+    mu_assert_int_eq(8, (int)bc4CompressedSize(4, 4));
+    mu_assert_int_eq(4 * 8, (int)bc4CompressedSize(5, 7));
+    mu_assert_int_eq(0, (int)bc4CompressedSize(0, 7));
+}
+
+MU_TEST(test_simd_matches_scalar) {
+    unsigned char block[16], simd[BC4_BLOCK_BYTES], scalar[BC4_BLOCK_BYTES];
+    int differences = 0;
+    for (int n = 0; n < 20000; ++n) {
+        int base = next_byte(), range = next_byte() % 64 + 1;
+        for (int i = 0; i < 16; ++i) {
+            int v = base + next_byte() % range;
+            block[i] = (n % 3 == 0 && next_byte() < 64) ? 255 : (unsigned char)(v > 255 ? 255 : v);
+        }
+        bc4SimdEnabled = 1;
+        bc4EncodeBlock(block, simd);
+        bc4SimdEnabled = 0;
+        bc4EncodeBlock(block, scalar);
+        differences += memcmp(simd, scalar, BC4_BLOCK_BYTES) != 0;
+    }
+    bc4SimdEnabled = 1;
+    mu_assert_int_eq(0, differences);
+}
+
+MU_TEST(test_image_edges_and_stride) {
+    // 5x7 con stride 8: los bloques del borde repiten el último texel
+    unsigned char src[7 * 8];
+    for (int y = 0; y < 7; ++y) {
+        for (int x = 0; x < 8; ++x) src[y * 8 + x] = x < 5 ? (unsigned char)(120 + 3 * x + 2 * y) : 0;
+    }
+    unsigned char encoded[4 * BC4_BLOCK_BYTES], decoded[5 * 7];
+    mu_assert_int_eq(0, bc4EncodeImage(src, 5, 7, 8, encoded));
+    mu_assert_int_eq(0, bc4DecodeImage(encoded, 5, 7, decoded));
+    int worst = 0;
+    for (int y = 0; y < 7; ++y) {
+        for (int x = 0; x < 5; ++x) {
+            int d = abs((int)src[y * 8 + x] - (int)decoded[y * 5 + x]);
+            worst = d > worst ? d : worst;
+        }
+    }
+    mu_check(worst <= 2); // La columna de relleno (0) no ha entrado en ningún bloque
+    mu_assert_int_eq(-1, bc4EncodeImage(src, 5, 7, 4, encoded));
+    mu_assert_int_eq(-1, bc4EncodeImage(NULL, 5, 7, 8, encoded));
+}
+
+// Error de los SDF reales del generador (EDT antialiasado a 24px), en
+// niveles de 8 bits y en distancia (spread 2 => 255 niveles = 4 texels)
+MU_TEST(test_glyph_sdf_error) {
+    FT_Library library;
+    FT_Face face;
+    if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, bc4TestFontPath, 0, &face) != 0) {
+        mu_fail("No se pudo abrir la fuente de prueba.");
+        return;
+    }
+    FT_Set_Pixel_Sizes(face, 0, 24);
+    double sumAbs = 0.0, sumEdge = 0.0;
+    long texels = 0, edgeTexels = 0;
+    int worst = 0;
+    for (const char* c = "AaBgQRe@&%8sw"; *c; ++c) {
+        mu_assert_int_eq(0, FT_Load_Char(face, (FT_ULong)*c, FT_LOAD_RENDER | FT_LOAD_NO_HINTING));
+        const FT_Bitmap* bm = &face->glyph->bitmap;
+        int w, h;
+        unsigned char* sdf = generate_sdf_from_coverage(bm->buffer, (int)bm->width, (int)bm->rows, bm->pitch, 3, 2.0f, &w, &h);
+        mu_check(sdf != NULL);
+        unsigned char* encoded = (unsigned char*)malloc(bc4CompressedSize(w, h));
+        unsigned char* decoded = (unsigned char*)malloc((size_t)w * h);
+        mu_assert_int_eq(0, bc4EncodeImage(sdf, w, h, w, encoded));
+        mu_assert_int_eq(0, bc4DecodeImage(encoded, w, h, decoded));
+        for (int i = 0; i < w * h; ++i) {
+            int d = abs((int)sdf[i] - (int)decoded[i]);
+            sumAbs += d;
+            worst = d > worst ? d : worst;
+            if (sdf[i] > 96 && sdf[i] < 160) { // Cerca del borde (|d| < 0.5 texels), lo que se ve
+                sumEdge += d;
+                edgeTexels++;
+            }
+        }
+        texels += (long)w * h;
+        free(encoded);
+        free(decoded);
+        free_sdf_bitmap(sdf);
+    }
+    double meanAbs = sumAbs / texels, meanEdge = sumEdge / edgeTexels;
+    printf("  BC4 sobre SDF: error medio %.3f niveles (%.4f texels), junto al borde %.3f, máximo %d\n",
+           meanAbs, meanAbs / 255.0 * 4.0, meanEdge, worst);
+    // Con spread 2 un bloque de 4x4 abarca casi toda la rampa: ~1/40 de texel
+    // de error medio, ~1/14 junto al borde
+    mu_check(meanAbs < 3.0);
+    mu_check(meanEdge < 5.5);
+    mu_check(worst <= 24);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+static double seconds_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Rendimiento en CPU sobre un campo de distancias de 1024x1024 (varios
+// círculos, como un atlas de SDF). Solo informa: la cifra de referencia está en
+// `make bench` (bc4_encode_*).
+MU_TEST(test_encoder_throughput) {
+    const int size = 1024;
+    unsigned char* field = (unsigned char*)malloc((size_t)size * size);
+    unsigned char* encoded = (unsigned char*)malloc(bc4CompressedSize(size, size));
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float cx = (float)(x % 64) - 31.5f, cy = (float)(y % 64) - 31.5f;
+            float d = (sqrtf(cx * cx + cy * cy) - 20.0f) / 8.0f;
+            d = d < -1.0f ? -1.0f : (d > 1.0f ? 1.0f : d);
+            field[y * size + x] = (unsigned char)((d * 0.5f + 0.5f) * 255.0f);
+        }
+    }
+    double rates[2];
+    unsigned char checksum[2] = { 0, 0 };
+    for (int simd = 1; simd >= 0; --simd) {
+        bc4SimdEnabled = simd;
+        double start = seconds_now();
+        mu_assert_int_eq(0, bc4EncodeImage(field, size, size, size, encoded));
+        rates[simd] = (double)size * size / (seconds_now() - start) / 1e6;
+        for (size_t i = 0; i < bc4CompressedSize(size, size); ++i) checksum[simd] ^= encoded[i];
+    }
+    bc4SimdEnabled = 1;
+    printf("  BC4 1024x1024: SSE2 %.1f Mtexel/s, escalar %.1f Mtexel/s\n", rates[1], rates[0]);
+    mu_assert_int_eq(checksum[0], checksum[1]);
+    free(field);
+    free(encoded);
+}
+
+MU_TEST_SUITE(bc4_encoder_tests) {
+    MU_RUN_TEST(test_block_cases);
+    MU_RUN_TEST(test_simd_matches_scalar);
+    MU_RUN_TEST(test_image_edges_and_stride);
+    MU_RUN_TEST(test_glyph_sdf_error);
+    MU_RUN_TEST(test_encoder_throughput);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(bc4_encoder_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
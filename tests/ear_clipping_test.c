@@ -0,0 +1,193 @@
+#include "minunit.h"
+#include "ear_clipping.h"
+#include "tessellation_handler.h"
+#include "freetype_handler.h" // OutlineDataC y callbacks de FT_Outline_Decompose
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include FT_OUTLINE_H
+
+static const char* earTestFontPath = "tests/fonts/test_font.ttf";
+#define EAR_TEST_PIXEL_SIZE 48
+#define EAR_TEST_FLATNESS 0.05f
+
+static void add_contour(OutlineDataC* outline, const Point2D* points, int count) {
+    beginOutlineContour(outline);
+    for (int i = 0; i < count; ++i) addOutlinePoint(outline, points[i]);
+}
+
+// Área con signo de los triángulos (> 0 si son antihorarios)
+static double signed_mesh_area(const TESSreal* v, const TESSindex* idx, int indexCount, double* minTriangleArea) {
+    double total = 0.0;
+    if (minTriangleArea) *minTriangleArea = 1e300;
+    for (int t = 0; t < indexCount; t += 3) {
+        const TESSreal* a = v + 2 * idx[t];
+        const TESSreal* b = v + 2 * idx[t + 1];
+        const TESSreal* c = v + 2 * idx[t + 2];
+        double area = 0.5 * (((double)b[0] - a[0]) * ((double)c[1] - a[1]) - ((double)b[1] - a[1]) * ((double)c[0] - a[0]));
+        if (minTriangleArea && area < *minTriangleArea) *minTriangleArea = area;
+        total += area;
+    }
+    return total;
+}
+
+static double absolute_mesh_area(const TESSreal* v, const TESSindex* idx, int indexCount) {
+    double total = 0.0;
+    for (int t = 0; t < indexCount; t += 3) {
+        const TESSreal* a = v + 2 * idx[t];
+        const TESSreal* b = v + 2 * idx[t + 1];
+        const TESSreal* c = v + 2 * idx[t + 2];
+        total += 0.5 * fabs(((double)b[0] - a[0]) * ((double)c[1] - a[1]) - ((double)b[1] - a[1]) * ((double)c[0] - a[0]));
+    }
+    return total;
+}
+
+MU_TEST(test_square_and_orientation) {
+    // Cuadrado horario: la salida se reorienta igualmente a antihoraria
+    Point2D square[] = {{0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0}};
+    OutlineDataC outline;
+    initOutlineData(&outline, 1);
+    add_contour(&outline, square, 5);
+
+    EarClipScratch scratch = {0};
+    mu_assert_int_eq(EAR_CLIP_OK, earClipOutline(&outline, &scratch));
+    mu_assert_int_eq(4, scratch.vertexCount); // Sin el punto de cierre repetido
+    mu_assert_int_eq(6, scratch.indexCount);
+    double minArea;
+    mu_check(fabs(signed_mesh_area(scratch.vertices, scratch.indices, scratch.indexCount, &minArea) - 100.0) < 1e-9);
+    mu_check(minArea > 0.0);
+
+    freeEarClipScratch(&scratch);
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_holes_and_islands) {
+    // Cuadrado con agujero y una isla dentro del agujero (como una "O" con punto)
+    Point2D outer[] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    Point2D hole[] = {{1, 1}, {9, 1}, {9, 9}, {1, 9}};
+    Point2D island[] = {{3, 3}, {7, 3}, {7, 7}, {3, 7}};
+    OutlineDataC outline;
+    initOutlineData(&outline, 3);
+    add_contour(&outline, outer, 4);
+    add_contour(&outline, hole, 4);
+
+    EarClipScratch scratch = {0};
+    mu_assert_int_eq(EAR_CLIP_OK, earClipOutline(&outline, &scratch));
+    mu_assert_int_eq(8 * 3, scratch.indexCount); // 8 vértices + 2 del puente
+    mu_check(fabs(signed_mesh_area(scratch.vertices, scratch.indices, scratch.indexCount, NULL) - 36.0) < 1e-9);
+
+    add_contour(&outline, island, 4);
+    mu_assert_int_eq(EAR_CLIP_OK, earClipOutline(&outline, &scratch));
+    mu_check(fabs(signed_mesh_area(scratch.vertices, scratch.indices, scratch.indexCount, NULL) - 52.0) < 1e-9);
+
+    freeEarClipScratch(&scratch);
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_non_simple_outlines_fall_back) {
+    EarClipScratch scratch = {0};
+    OutlineDataC outline;
+    initOutlineData(&outline, 2);
+
+    // Pajarita: el contorno se corta a sí mismo
+    Point2D bowtie[] = {{0, 0}, {10, 10}, {10, 0}, {0, 10}};
+    add_contour(&outline, bowtie, 4);
+    mu_assert_int_eq(EAR_CLIP_FALLBACK, earClipOutline(&outline, &scratch));
+
+    // Dos cuadrados solapados (contornos distintos que se cortan)
+    Point2D a[] = {{0, 0}, {6, 0}, {6, 6}, {0, 6}};
+    Point2D b[] = {{3, 3}, {9, 3}, {9, 9}, {3, 9}};
+    resetOutlineData(&outline);
+    add_contour(&outline, a, 4);
+    add_contour(&outline, b, 4);
+    mu_assert_int_eq(EAR_CLIP_FALLBACK, earClipOutline(&outline, &scratch));
+
+    // Agujero que toca el exterior en un vértice
+    Point2D outer[] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    Point2D touching[] = {{0, 5}, {5, 2}, {5, 8}};
+    resetOutlineData(&outline);
+    add_contour(&outline, outer, 4);
+    add_contour(&outline, touching, 3);
+    mu_assert_int_eq(EAR_CLIP_FALLBACK, earClipOutline(&outline, &scratch));
+
+    // generateGlyphTessellation resuelve el caso con libtess2
+    TessellationResult result = generateGlyphTessellation(&outline);
+    mu_check(result.elementCount > 0);
+    mu_check(fabs(absolute_mesh_area(result.vertices, result.elements, result.elementCount * 3) - 85.0) < 1e-6);
+    free(result.vertices);
+    free(result.elements);
+
+    freeEarClipScratch(&scratch);
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_all_font_glyphs_match_libtess2_area) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, earTestFontPath, 0, &face));
+    FT_Set_Pixel_Sizes(face, 0, EAR_TEST_PIXEL_SIZE);
+
+    OutlineDataC outline;
+    initOutlineData(&outline, 8);
+    FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    EarClipScratch scratch = {0};
+
+    int glyphs = 0, fastPathHits = 0, mismatches = 0, flipped = 0, badIndices = 0;
+    for (FT_Long g = 0; g < face->num_glyphs; ++g) {
+        if (FT_Load_Glyph(face, (FT_UInt)g, FT_LOAD_NO_BITMAP) != 0) continue;
+        if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE) continue;
+        resetOutlineData(&outline);
+        outline.flatnessTolerance = EAR_TEST_FLATNESS;
+        if (FT_Outline_Decompose(&face->glyph->outline, &funcs, &outline) != 0) continue;
+        glyphs++;
+
+        int status = earClipOutline(&outline, &scratch);
+        if (status == EAR_CLIP_ERROR) mismatches++;
+        if (status != EAR_CLIP_OK) continue;
+        fastPathHits++;
+
+        tessellationFastPathEnabled = 0;
+        TessellationResult reference = generateGlyphTessellation(&outline);
+        tessellationFastPathEnabled = 1;
+
+        double minArea = 0.0;
+        double fast = scratch.indexCount ? signed_mesh_area(scratch.vertices, scratch.indices, scratch.indexCount, &minArea) : 0.0;
+        double slow = absolute_mesh_area(reference.vertices, reference.elements, reference.elementCount * 3);
+        if (fabs(fast - slow) > 1e-3 * (slow > 1.0 ? slow : 1.0)) {
+            printf("\nGlifo %ld: área %.4f (recorte) frente a %.4f (libtess2)", (long)g, fast, slow);
+            mismatches++;
+        }
+        if (minArea < 0.0) flipped++;
+        for (int i = 0; i < scratch.indexCount; ++i) badIndices += scratch.indices[i] >= scratch.vertexCount;
+        free(reference.vertices);
+        free(reference.elements);
+    }
+    printf("\n%d de %d glifos por el camino rápido\n", fastPathHits, glyphs);
+
+    mu_check(glyphs > 0);
+    mu_assert_int_eq(0, mismatches);
+    mu_assert_int_eq(0, flipped);
+    mu_assert_int_eq(0, badIndices);
+    mu_check(fastPathHits * 2 > glyphs); // La mayoría de glifos son simples
+
+    freeEarClipScratch(&scratch);
+    freeOutlineData(&outline);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST_SUITE(ear_clipping_tests) {
+    MU_RUN_TEST(test_square_and_orientation);
+    MU_RUN_TEST(test_holes_and_islands);
+    MU_RUN_TEST(test_non_simple_outlines_fall_back);
+    MU_RUN_TEST(test_all_font_glyphs_match_libtess2_area);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(ear_clipping_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,117 @@
+#include "minunit.h"
+#include "frame_timing.h"
+#include <stdio.h>
+#include <string.h>
+
+// Simula un frame con tiempos conocidos por fase (sin reloj ni GL).
+static void fake_frame(uint64_t layoutNs, uint64_t missNs, uint64_t drawNs) {
+    frameTimingBeginFrame();
+    frameTimingAdd(FRAME_PHASE_LAYOUT, layoutNs);
+    if (missNs) frameTimingAdd(FRAME_PHASE_GLYPH_MISS, missNs);
+    frameTimingAdd(FRAME_PHASE_DRAW, drawNs);
+    frameTimingEndFrame();
+}
+
+static void reset_state(void) {
+    frameTimingSetEnabled(0);
+    frameTimingReset();
+}
+
+MU_TEST(test_disabled_records_nothing) {
+    reset_state();
+    FRAME_TIMING_BEGIN(start);
+    mu_check(start == 0); // Desactivado: ni siquiera se lee el reloj
+    FRAME_TIMING_END(FRAME_PHASE_LAYOUT, start);
+    fake_frame(1000, 0, 2000);
+    mu_assert_int_eq(0, frameTimingGetStats(FRAME_PHASE_LAYOUT).samples);
+    mu_assert_int_eq(0, frameTimingGetStats(FRAME_PHASE_TOTAL).samples);
+}
+
+MU_TEST(test_min_avg_p99_per_phase) {
+    reset_state();
+    frameTimingSetEnabled(1);
+    for (int i = 1; i <= 100; ++i) {
+        fake_frame((uint64_t)i * 1000, 0, 500);
+    }
+    FramePhaseStats layout = frameTimingGetStats(FRAME_PHASE_LAYOUT);
+    mu_assert_int_eq(100, layout.samples);
+    mu_check(layout.minNs == 1000);
+    mu_check(layout.maxNs == 100000);
+    mu_check(layout.avgNs == 50500);
+    mu_check(layout.p99Ns == 99000);
+
+    FramePhaseStats draw = frameTimingGetStats(FRAME_PHASE_DRAW);
+    mu_check(draw.minNs == 500 && draw.p99Ns == 500);
+    mu_assert_int_eq(100, frameTimingGetStats(FRAME_PHASE_TOTAL).samples);
+}
+
+MU_TEST(test_glyph_miss_only_sampled_when_it_happens) {
+    reset_state();
+    frameTimingSetEnabled(1);
+    fake_frame(100, 0, 100);
+    fake_frame(100, 7000, 100);
+    fake_frame(100, 0, 100);
+    FramePhaseStats miss = frameTimingGetStats(FRAME_PHASE_GLYPH_MISS);
+    mu_assert_int_eq(1, miss.samples);
+    mu_check(miss.minNs == 7000);
+}
+
+MU_TEST(test_window_keeps_latest_frames) {
+    reset_state();
+    frameTimingSetEnabled(1);
+    for (int i = 0; i < FRAME_TIMING_WINDOW; ++i) fake_frame(1, 0, 1);
+    for (int i = 0; i < FRAME_TIMING_WINDOW; ++i) fake_frame(50, 0, 1);
+    FramePhaseStats layout = frameTimingGetStats(FRAME_PHASE_LAYOUT);
+    mu_assert_int_eq(FRAME_TIMING_WINDOW, layout.samples);
+    mu_check(layout.minNs == 50); // Los frames antiguos ya salieron de la ventana
+}
+
+MU_TEST(test_toggle_mid_frame_discards_partial_frame) {
+    reset_state();
+    frameTimingSetEnabled(1);
+    frameTimingBeginFrame();
+    frameTimingAdd(FRAME_PHASE_LAYOUT, 123);
+    frameTimingSetEnabled(0);
+    frameTimingSetEnabled(1);
+    frameTimingEndFrame();
+    mu_assert_int_eq(0, frameTimingGetStats(FRAME_PHASE_LAYOUT).samples);
+}
+
+MU_TEST(test_export_csv) {
+    reset_state();
+    frameTimingSetEnabled(1);
+    fake_frame(2000, 0, 3000);
+    const char* path = "build/frame_timing_test.csv";
+    mu_assert_int_eq(0, frameTimingExportCSV(path));
+
+    FILE* f = fopen(path, "r");
+    mu_check(f != NULL);
+    if (!f) return;
+    char line[256];
+    int lines = 0, found_layout = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lines++;
+        if (strncmp(line, "layout,2000,2000,2000,2000,1", 28) == 0) found_layout = 1;
+    }
+    fclose(f);
+    remove(path);
+    mu_assert_int_eq(1 + FRAME_PHASE_COUNT, lines);
+    mu_check(found_layout);
+}
+
+MU_TEST_SUITE(frame_timing_suite) {
+    MU_RUN_TEST(test_disabled_records_nothing);
+    MU_RUN_TEST(test_min_avg_p99_per_phase);
+    MU_RUN_TEST(test_glyph_miss_only_sampled_when_it_happens);
+    MU_RUN_TEST(test_window_keeps_latest_frames);
+    MU_RUN_TEST(test_toggle_mid_frame_discards_partial_frame);
+    MU_RUN_TEST(test_export_csv);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(frame_timing_suite);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
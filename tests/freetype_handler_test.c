@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h> 
 #include <string.h> 
+#include <math.h>
 
 // Variables externas de freetype_handler.c
 // freetype_handler.h ya las declara como extern
@@ -116,6 +117,190 @@ MU_TEST(test_loadFonts_without_init) {
     mu_check(loadFonts(validFontPath, NULL) == -3);
 }
 
+// --- Aplanado adaptativo de curvas ---
+static FT_Vector ftVec(float x, float y) { // Píxeles -> 26.6
+    FT_Vector v = { (FT_Pos)(x * 64.0f), (FT_Pos)(y * 64.0f) };
+    return v;
+}
+
+static float distanceToSegment(Point2D p, Point2D a, Point2D b) {
+    float vx = b.x - a.x, vy = b.y - a.y;
+    float len2 = vx * vx + vy * vy;
+    float t = len2 > 0.0f ? ((p.x - a.x) * vx + (p.y - a.y) * vy) / len2 : 0.0f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    float dx = a.x + t * vx - p.x, dy = a.y + t * vy - p.y;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+// Distancia máxima entre la curva muestreada densamente y la polilínea emitida.
+static float maxDeviationFromPolyline(const OutlineDataC* outline, Point2D (*eval)(float, const Point2D*), const Point2D* ctrl) {
+    const ContourC* contour = &outline->contours[outline->count - 1];
+    const Point2D* pts = outlineContourPoints(outline, contour);
+    float worst = 0.0f;
+    for (int i = 0; i <= 2000; ++i) {
+        Point2D p = eval((float)i / 2000.0f, ctrl);
+        float best = 1e30f;
+        for (size_t k = 0; k + 1 < contour->count; ++k) {
+            float d = distanceToSegment(p, pts[k], pts[k + 1]);
+            if (d < best) best = d;
+        }
+        if (best > worst) worst = best;
+    }
+    return worst;
+}
+
+static Point2D evalQuad(float t, const Point2D* c) {
+    float u = 1.0f - t;
+    return (Point2D){ u * u * c[0].x + 2 * u * t * c[1].x + t * t * c[2].x,
+                      u * u * c[0].y + 2 * u * t * c[1].y + t * t * c[2].y };
+}
+
+static Point2D evalCubic(float t, const Point2D* c) {
+    float u = 1.0f - t;
+    return (Point2D){ u * u * u * c[0].x + 3 * u * u * t * c[1].x + 3 * u * t * t * c[2].x + t * t * t * c[3].x,
+                      u * u * u * c[0].y + 3 * u * u * t * c[1].y + 3 * u * t * t * c[2].y + t * t * t * c[3].y };
+}
+
+static size_t flattenConic(OutlineDataC* outline, const Point2D* c) {
+    FT_Vector p0 = ftVec(c[0].x, c[0].y), p1 = ftVec(c[1].x, c[1].y), p2 = ftVec(c[2].x, c[2].y);
+    ftMoveToFunc(&p0, outline);
+    ftConicToFunc(&p1, &p2, outline);
+    return outline->contours[outline->count - 1].count;
+}
+
+MU_TEST(test_conic_flattening_respects_tolerance) {
+    Point2D ctrl[3] = { {0.0f, 0.0f}, {250.0f, 400.0f}, {500.0f, 0.0f} };
+    OutlineDataC outline;
+    mu_assert_int_eq(0, initOutlineData(&outline, 1));
+    outline.flatnessTolerance = 0.25f;
+    size_t points = flattenConic(&outline, ctrl);
+    float deviation = maxDeviationFromPolyline(&outline, evalQuad, ctrl);
+    mu_check(deviation <= 0.25f * 1.01f);
+    mu_check(points > 11); // Una curva de 500px necesita más que los 10 pasos fijos
+    Point2D last = outline.points[points - 1];
+    mu_check(last.x == 500.0f && last.y == 0.0f); // Extremo exacto
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_cubic_flattening_respects_tolerance) {
+    Point2D ctrl[4] = { {0.0f, 0.0f}, {50.0f, 300.0f}, {400.0f, -200.0f}, {450.0f, 100.0f} };
+    FT_Vector p0 = ftVec(ctrl[0].x, ctrl[0].y), c1 = ftVec(ctrl[1].x, ctrl[1].y);
+    FT_Vector c2 = ftVec(ctrl[2].x, ctrl[2].y), p3 = ftVec(ctrl[3].x, ctrl[3].y);
+    OutlineDataC outline;
+    mu_assert_int_eq(0, initOutlineData(&outline, 1));
+    outline.flatnessTolerance = 0.1f;
+    ftMoveToFunc(&p0, &outline);
+    ftCubicToFunc(&c1, &c2, &p3, &outline);
+    float deviation = maxDeviationFromPolyline(&outline, evalCubic, ctrl);
+    mu_check(deviation <= 0.1f * 1.01f);
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_small_curve_emits_few_points) {
+    Point2D ctrl[3] = { {0.0f, 0.0f}, {1.0f, 1.0f}, {2.0f, 0.0f} };
+    OutlineDataC outline;
+    mu_assert_int_eq(0, initOutlineData(&outline, 1));
+    size_t points = flattenConic(&outline, ctrl); // Tolerancia por defecto
+    mu_check(points <= 3); // moveTo + 1 o 2 segmentos, frente a 11 con pasos fijos
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_zero_tolerance_uses_fixed_steps) {
+    Point2D ctrl[3] = { {0.0f, 0.0f}, {250.0f, 400.0f}, {500.0f, 0.0f} };
+    OutlineDataC outline;
+    mu_assert_int_eq(0, initOutlineData(&outline, 1));
+    outline.flatnessTolerance = 0.0f;
+    mu_assert_int_eq(1 + outline.subdivisionSteps, (int)flattenConic(&outline, ctrl));
+    freeOutlineData(&outline);
+}
+
+// --- extractOutline frente a FT_Outline_Decompose ---
+static int outlinesIdentical(const OutlineDataC* a, const OutlineDataC* b) {
+    if (a->count != b->count || a->pointCount != b->pointCount) return 0;
+    if (memcmp(a->contours, b->contours, a->count * sizeof(ContourC)) != 0) return 0;
+    return memcmp(a->points, b->points, a->pointCount * sizeof(Point2D)) == 0;
+}
+
+static int decomposeBoth(const FT_Outline* ftOutline, OutlineDataC* viaCallbacks, OutlineDataC* direct) {
+    static const FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    resetOutlineData(viaCallbacks);
+    resetOutlineData(direct);
+    int a = FT_Outline_Decompose((FT_Outline*)ftOutline, &funcs, viaCallbacks);
+    int b = extractOutline(ftOutline, direct);
+    if ((a != 0) != (b != 0)) return 0;
+    return a != 0 || outlinesIdentical(viaCallbacks, direct);
+}
+
+MU_TEST(test_extract_outline_matches_decompose_on_font) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, validFontPath, 0, &face));
+    OutlineDataC viaCallbacks, direct;
+    initOutlineData(&viaCallbacks, 4);
+    initOutlineData(&direct, 4);
+
+    // Dos tamaños (redondeo distinto de los puntos medios) y los dos modos de aplanado
+    static const int sizes[] = { 17, 48 };
+    static const float tolerances[] = { OUTLINE_DEFAULT_FLATNESS, 0.0f };
+    int compared = 0, mismatches = 0;
+    for (int s = 0; s < 2; ++s) {
+        FT_Set_Pixel_Sizes(face, 0, sizes[s]);
+        viaCallbacks.flatnessTolerance = direct.flatnessTolerance = tolerances[s];
+        for (FT_Long g = 0; g < face->num_glyphs; ++g) {
+            if (FT_Load_Glyph(face, (FT_UInt)g, FT_LOAD_NO_BITMAP) != 0) continue;
+            if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE) continue;
+            compared++;
+            if (!decomposeBoth(&face->glyph->outline, &viaCallbacks, &direct)) mismatches++;
+        }
+    }
+    mu_check(compared > 1000);
+    mu_assert_int_eq(0, mismatches);
+
+    freeOutlineData(&viaCallbacks);
+    freeOutlineData(&direct);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST(test_extract_outline_implied_points_and_cubics) {
+    // Contorno 0: todo cónico con coordenadas impares (puntos medios truncados, también negativos)
+    // Contorno 1: empieza fuera de curva y acaba en curva
+    // Contorno 2: cúbicas, la última cierra sobre el inicio
+    FT_Vector points[] = {
+        {-65, -3}, {201, -131}, {333, 97}, {-7, 255},
+        {64, 640}, {640, 640}, {640, 64},
+        {0, 0}, {100, 300}, {400, 300}, {500, 0}, {400, -300}, {100, -300},
+    };
+    char tags[] = {
+        FT_CURVE_TAG_CONIC, FT_CURVE_TAG_CONIC, FT_CURVE_TAG_CONIC, FT_CURVE_TAG_CONIC,
+        FT_CURVE_TAG_CONIC, FT_CURVE_TAG_ON, FT_CURVE_TAG_ON,
+        FT_CURVE_TAG_ON, FT_CURVE_TAG_CUBIC, FT_CURVE_TAG_CUBIC, FT_CURVE_TAG_ON, FT_CURVE_TAG_CUBIC, FT_CURVE_TAG_CUBIC,
+    };
+    short contours[] = { 3, 6, 12 };
+    FT_Outline ftOutline = {0};
+    ftOutline.n_contours = 3;
+    ftOutline.n_points = 13;
+    ftOutline.points = points;
+    ftOutline.tags = tags;
+    ftOutline.contours = contours;
+
+    OutlineDataC viaCallbacks, direct;
+    initOutlineData(&viaCallbacks, 1);
+    initOutlineData(&direct, 1);
+    mu_check(decomposeBoth(&ftOutline, &viaCallbacks, &direct));
+    mu_assert_int_eq(3, (int)direct.count);
+
+    // Un contorno que empieza con un control cúbico no es válido para ninguno de los dos
+    tags[7] = FT_CURVE_TAG_CUBIC;
+    resetOutlineData(&direct);
+    mu_assert_int_eq(-1, extractOutline(&ftOutline, &direct));
+    mu_check(decomposeBoth(&ftOutline, &viaCallbacks, &direct));
+
+    freeOutlineData(&viaCallbacks);
+    freeOutlineData(&direct);
+}
 
 MU_TEST_SUITE(freetype_handler_suite) {
     MU_RUN_TEST(test_initFreeType_success);
@@ -126,6 +311,12 @@ MU_TEST_SUITE(freetype_handler_suite) {
     MU_RUN_TEST(test_cleanupFreeType_multiple_times);
     MU_RUN_TEST(test_font_properties_after_loadFonts);
     MU_RUN_TEST(test_loadFonts_without_init);
+    MU_RUN_TEST(test_conic_flattening_respects_tolerance);
+    MU_RUN_TEST(test_cubic_flattening_respects_tolerance);
+    MU_RUN_TEST(test_small_curve_emits_few_points);
+    MU_RUN_TEST(test_zero_tolerance_uses_fixed_steps);
+    MU_RUN_TEST(test_extract_outline_matches_decompose_on_font);
+    MU_RUN_TEST(test_extract_outline_implied_points_and_cubics);
 }
 
 int main(int argc, char *argv[]) {
@@ -0,0 +1,227 @@
+#include "minunit.h"
+#include "glyph_extrude.h"
+#include "freetype_handler.h"
+#include "config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* extrudeTestFontPath = "tests/fonts/test_font.ttf";
+static GlyphExtruder extruder;
+
+static void addRect(OutlineDataC* outline, float x0, float y0, float x1, float y1, int clockwise) {
+    Point2D ccw[4] = { {x0, y0}, {x1, y0}, {x1, y1}, {x0, y1} };
+    beginOutlineContour(outline);
+    for (int i = 0; i < 4; ++i) addOutlinePoint(outline, clockwise ? ccw[3 - i] : ccw[i]);
+    addOutlinePoint(outline, clockwise ? ccw[3] : ccw[0]); // Cierre repetido, como FreeType
+}
+
+// Volumen por el teorema de la divergencia: solo sale positivo y exacto si la
+// superficie es cerrada y todas las caras miran hacia fuera.
+static double meshVolume(const ExtrudedMeshBuffer* mesh) {
+    double volume = 0.0;
+    for (int t = 0; t < mesh->indexCount; t += 3) {
+        const GLfloat* a = mesh->vertices + mesh->indices[t] * EXTRUDE_VERTEX_FLOATS;
+        const GLfloat* b = mesh->vertices + mesh->indices[t + 1] * EXTRUDE_VERTEX_FLOATS;
+        const GLfloat* c = mesh->vertices + mesh->indices[t + 2] * EXTRUDE_VERTEX_FLOATS;
+        volume += a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0]) + a[2] * (b[0] * c[1] - b[1] * c[0]);
+    }
+    return volume / 6.0;
+}
+
+// Cada triángulo debe mirar hacia donde apuntan las normales de sus vértices
+static int facesAgreeWithNormals(const ExtrudedMeshBuffer* mesh) {
+    for (int t = 0; t < mesh->indexCount; t += 3) {
+        const GLfloat* a = mesh->vertices + mesh->indices[t] * EXTRUDE_VERTEX_FLOATS;
+        const GLfloat* b = mesh->vertices + mesh->indices[t + 1] * EXTRUDE_VERTEX_FLOATS;
+        const GLfloat* c = mesh->vertices + mesh->indices[t + 2] * EXTRUDE_VERTEX_FLOATS;
+        float ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+        float vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+        float fx = uy * vz - uz * vy, fy = uz * vx - ux * vz, fz = ux * vy - uy * vx;
+        float nx = a[3] + b[3] + c[3], ny = a[4] + b[4] + c[4], nz = a[5] + b[5] + c[5];
+        if (fx * nx + fy * ny + fz * nz <= 0.0f) return 0;
+    }
+    return 1;
+}
+
+static void extrudeSetup(void) {
+    initGlyphExtruder(&extruder);
+}
+
+static void extrudeTeardown(void) {
+    freeGlyphExtruder(&extruder);
+}
+
+MU_TEST(test_box_without_bevel) {
+    ExtrudeParams params = { 4.0f, 0.0f, 0 };
+    for (int clockwise = 0; clockwise <= 1; ++clockwise) {
+        OutlineDataC outline;
+        initOutlineData(&outline, 1);
+        addRect(&outline, 0.0f, 0.0f, 10.0f, 10.0f, clockwise);
+        mu_assert_int_eq(0, extrudeOutline(&extruder, &outline, &params));
+
+        // 2 + 2 triángulos de tapas y 4 paredes de 2 triángulos
+        mu_assert_int_eq(12 * 3, extruder.mesh.indexCount);
+        mu_assert_int_eq(4 + 4 + 4 * 4, extruder.mesh.vertexCount);
+        mu_check(fabs(meshVolume(&extruder.mesh) - 400.0) < 1e-3);
+        mu_check(facesAgreeWithNormals(&extruder.mesh));
+
+        // Paredes: normal horizontal y hacia fuera del centro
+        for (int v = 8; v < extruder.mesh.vertexCount; ++v) {
+            const GLfloat* p = extruder.mesh.vertices + v * EXTRUDE_VERTEX_FLOATS;
+            mu_check(fabsf(p[2]) == 2.0f && p[5] == 0.0f);
+            mu_check((p[0] - 5.0f) * p[3] + (p[1] - 5.0f) * p[4] > 0.0f);
+        }
+        freeOutlineData(&outline);
+    }
+}
+
+MU_TEST(test_hole_faces_inward) {
+    ExtrudeParams params = { 2.0f, 0.0f, 0 };
+    OutlineDataC outline;
+    initOutlineData(&outline, 2);
+    addRect(&outline, 0.0f, 0.0f, 10.0f, 10.0f, 1);  // Exterior horario (TrueType)
+    addRect(&outline, 3.0f, 3.0f, 7.0f, 7.0f, 0);    // Agujero antihorario
+    mu_assert_int_eq(0, extrudeOutline(&extruder, &outline, &params));
+    mu_check(fabs(meshVolume(&extruder.mesh) - (100.0 - 16.0) * 2.0) < 1e-3);
+    mu_check(facesAgreeWithNormals(&extruder.mesh));
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_bevel_stays_inside_and_closed) {
+    ExtrudeParams params = { 4.0f, 1.0f, 3 };
+    OutlineDataC outline;
+    initOutlineData(&outline, 1);
+    addRect(&outline, 0.0f, 0.0f, 10.0f, 10.0f, 0);
+    mu_assert_int_eq(0, extrudeOutline(&extruder, &outline, &params));
+    mu_check(facesAgreeWithNormals(&extruder.mesh));
+
+    // El bisel recorta volumen respecto a la caja, pero poco
+    double volume = meshVolume(&extruder.mesh);
+    mu_check(volume > 360.0 && volume < 400.0);
+
+    for (int v = 0; v < extruder.mesh.vertexCount; ++v) {
+        const GLfloat* p = extruder.mesh.vertices + v * EXTRUDE_VERTEX_FLOATS;
+        mu_check(p[0] >= -1e-4f && p[0] <= 10.0001f && p[1] >= -1e-4f && p[1] <= 10.0001f);
+        mu_check(fabsf(p[2]) <= 2.0001f);
+        mu_check(fabsf(sqrtf(p[3] * p[3] + p[4] * p[4] + p[5] * p[5]) - 1.0f) < 1e-4f);
+        if (p[5] == 1.0f && p[2] == 2.0f) { // Tapa delantera: metida por el bisel
+            mu_check(p[0] >= 0.999f && p[0] <= 9.001f);
+        }
+    }
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_degenerate_contours_give_empty_mesh) {
+    ExtrudeParams params = { 4.0f, 0.0f, 0 };
+    OutlineDataC outline;
+    initOutlineData(&outline, 1);
+    beginOutlineContour(&outline);
+    addOutlinePoint(&outline, (Point2D){1.0f, 1.0f});
+    addOutlinePoint(&outline, (Point2D){1.0f, 1.0f});
+    addOutlinePoint(&outline, (Point2D){2.0f, 2.0f});
+    mu_assert_int_eq(0, extrudeOutline(&extruder, &outline, &params));
+    mu_assert_int_eq(0, extruder.mesh.indexCount);
+    mu_assert_int_eq(-1, extrudeOutline(&extruder, NULL, &params));
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_font_glyph_is_closed) {
+    mu_assert_int_eq(0, FT_Set_Pixel_Sizes(ftFace, 0, GLYPH_LOAD_PIXEL_SIZE));
+    mu_assert_int_eq(0, FT_Load_Glyph(ftFace, FT_Get_Char_Index(ftFace, 'B'), FT_LOAD_NO_BITMAP));
+    OutlineDataC outline;
+    initOutlineData(&outline, 4);
+    FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    mu_assert_int_eq(0, FT_Outline_Decompose(&ftFace->glyph->outline, &funcs, &outline));
+
+    // Sin bisel: volumen = área de la tapa * profundidad
+    ExtrudeParams params = { 6.0f, 0.0f, 0 };
+    mu_assert_int_eq(0, extrudeOutline(&extruder, &outline, &params));
+    mu_check(facesAgreeWithNormals(&extruder.mesh));
+    double capArea = 0.0;
+    for (int t = 0; t < extruder.capMesh.indexCount; t += 3) {
+        const TESSreal* v = extruder.capMesh.vertices;
+        int a = extruder.capMesh.indices[t], b = extruder.capMesh.indices[t + 1], c = extruder.capMesh.indices[t + 2];
+        capArea += fabs((v[2 * b] - v[2 * a]) * (v[2 * c + 1] - v[2 * a + 1]) - (v[2 * b + 1] - v[2 * a + 1]) * (v[2 * c] - v[2 * a])) * 0.5;
+    }
+    mu_check(capArea > 100.0);
+    mu_check(fabs(meshVolume(&extruder.mesh) - capArea * 6.0) < capArea * 6.0 * 1e-4);
+
+    const ExtrudedGlyph* glyph = getExtrudedGlyph('B', GLYPH_LOAD_PIXEL_SIZE);
+    mu_check(glyph != NULL && glyph->indexCount > 0 && glyph->advanceX > 0.0f);
+    mu_assert_int_eq((int)FT_Get_Char_Index(ftFace, 'B'), (int)glyph->glyphIndex); // El renderer no necesita el SDF
+    const ExtrudedGlyph* missing = getExtrudedGlyph(0x915, GLYPH_LOAD_PIXEL_SIZE); // No está en la fuente de test
+    mu_check(missing != NULL && missing->glyphIndex == 0 && missing->indexCount == 0);
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_cache_builds_once_per_unique_glyph) {
+    const char* paragraph = "hello world hello world hello";
+    size_t buildsBefore = getExtrudedGlyphBuildCount();
+    ExtrudedTextBatch batch = {0};
+    extrudedBatchBegin(&batch, GLYPH_LOAD_PIXEL_SIZE);
+    float penX = 0.0f;
+    for (const char* c = paragraph; *c; ++c) penX += extrudedBatchAdd(&batch, (FT_ULong)*c, penX, 0.0f);
+    mu_assert_int_eq(0, extrudedBatchFinish(&batch));
+
+    // h e l o ' ' w r d: 8 glifos distintos, el espacio sin malla
+    mu_assert_int_eq(8, (int)(getExtrudedGlyphBuildCount() - buildsBefore));
+    mu_assert_int_eq(7, batch.runCount);
+    mu_assert_int_eq((int)strlen(paragraph) - 4, batch.instanceCount);
+    int instances = 0;
+    for (int r = 0; r < batch.runCount; ++r) {
+        mu_assert_int_eq(instances, batch.runs[r].firstInstance);
+        instances += batch.runs[r].instanceCount;
+        if (r > 0) mu_check(batch.runs[r].glyph != batch.runs[r - 1].glyph);
+    }
+    mu_assert_int_eq(batch.instanceCount, instances);
+    mu_check(penX > 0.0f);
+
+    // Un segundo frame no vuelve a extruir nada
+    extrudedBatchBegin(&batch, GLYPH_LOAD_PIXEL_SIZE);
+    for (const char* c = paragraph; *c; ++c) extrudedBatchAdd(&batch, (FT_ULong)*c, 0.0f, 0.0f);
+    mu_assert_int_eq(8, (int)(getExtrudedGlyphBuildCount() - buildsBefore));
+
+    // Otro tamaño es otra entrada de la caché
+    getExtrudedGlyph('h', GLYPH_LOAD_PIXEL_SIZE * 2);
+    mu_assert_int_eq(9, (int)(getExtrudedGlyphBuildCount() - buildsBefore));
+    freeExtrudedBatch(&batch);
+}
+
+MU_TEST(test_params_change_invalidates_cache) {
+    getExtrudedGlyph('x', GLYPH_LOAD_PIXEL_SIZE);
+    size_t builds = getExtrudedGlyphBuildCount();
+    getExtrudedGlyph('x', GLYPH_LOAD_PIXEL_SIZE);
+    mu_assert_int_eq((int)builds, (int)getExtrudedGlyphBuildCount());
+
+    ExtrudeParams deeper = *getExtrudeParams();
+    deeper.depth *= 2.0f;
+    setExtrudeParams(&deeper);
+    getExtrudedGlyph('x', GLYPH_LOAD_PIXEL_SIZE);
+    mu_assert_int_eq((int)builds + 1, (int)getExtrudedGlyphBuildCount());
+}
+
+MU_TEST_SUITE(glyph_extrude_tests) {
+    MU_SUITE_CONFIGURE(&extrudeSetup, &extrudeTeardown);
+    MU_RUN_TEST(test_box_without_bevel);
+    MU_RUN_TEST(test_hole_faces_inward);
+    MU_RUN_TEST(test_bevel_stays_inside_and_closed);
+    MU_RUN_TEST(test_degenerate_contours_give_empty_mesh);
+    MU_RUN_TEST(test_font_glyph_is_closed);
+    MU_RUN_TEST(test_cache_builds_once_per_unique_glyph);
+    MU_RUN_TEST(test_params_change_invalidates_cache);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    if (initFreeType() != 0 || loadFonts(extrudeTestFontPath, NULL) != 0) {
+        fprintf(stderr, "ERROR: No se pudo cargar '%s' para los tests de extrusión.\n", extrudeTestFontPath);
+        return 1;
+    }
+    MU_RUN_SUITE(glyph_extrude_tests);
+    MU_REPORT();
+    cleanupExtrudedGlyphs();
+    cleanupFreeType();
+    return MU_EXIT_CODE;
+}
@@ -1,6 +1,9 @@
 #include "minunit.h"
 #include "glyph_manager.h" 
+#include "kerning.h"
 #include "freetype_handler.h" 
+#include "config.h"       // Tamaños de carga y de las texturas SDF
+#include "sdf_backend.h"  // sdfBackend
 #include <stdio.h>
 #include <stdlib.h> 
 #include <math.h>   
@@ -67,7 +70,9 @@ MU_TEST(test_get_glyph_info_basic_ascii) {
     initGlyphCache();
 
     FT_ULong char_A = 'A'; 
-    GlyphInfo gi_A = getGlyphInfo(char_A);
+    // La malla no se tesela con el SDF: solo cuando la pide la ruta vectorial
+    mu_assert_int_eq(0, getGlyphInfo(char_A).indexCount);
+    GlyphInfo gi_A = getGlyphInfoWithMesh(char_A, -1);
 
 #ifdef UNIT_TESTING
     mu_assert_int_eq(0, gi_A.vao); // En testing, VAO será 0
@@ -81,6 +86,17 @@ MU_TEST(test_get_glyph_info_basic_ascii) {
     // Estas comprobaciones deberían ser válidas en ambos casos si la fuente y el glifo son válidos
     mu_check(gi_A.indexCount > 0); 
     mu_check(gi_A.advanceX > 0.0f); 
+    // Índice de glifo de la cara principal y tabla de kerning construida en initGlyphCache
+    mu_assert_int_eq((int)FT_Get_Char_Index(ftFace, char_A), (int)gi_A.glyphIndex);
+    mu_check(fontKerningTable.count > 0);
+    mu_check(kerningLookup(activeKerningTable(), gi_A.glyphIndex, getGlyphInfo('V').glyphIndex) < 0.0f);
+    // Por índice de glifo (glifos del shaper): entrada propia, mismas métricas
+    GlyphInfo gi_A_index = getGlyphInfoWithMesh(GLYPH_CACHE_INDEX_KEY(gi_A.glyphIndex), -1);
+    mu_check(fabsf(gi_A_index.advanceX - gi_A.advanceX) < 1e-6f);
+    mu_assert_int_eq((int)gi_A.glyphIndex, (int)gi_A_index.glyphIndex);
+    mu_assert_int_eq(gi_A.indexCount, gi_A_index.indexCount);
+    mu_assert_int_eq(gi_A.sdfTextureWidth, gi_A_index.sdfTextureWidth);
+    mu_assert_int_eq(gi_A.indexCount, getGlyphInfoForGlyphIndex(gi_A.glyphIndex, -1).indexCount); // Misma entrada
 
     // SDF specific checks for 'A' (outline glyph)
     #ifdef UNIT_TESTING
@@ -100,6 +116,33 @@ MU_TEST(test_get_glyph_info_basic_ascii) {
     // Example: if FT bitmap was 30x48, padding 4 => 38x56
     mu_check(gi_A.sdfTextureWidth > 0); 
     mu_check(gi_A.sdfTextureHeight > 0);
+    // 'A' tiene contorno: su SDF sale de outline_sdf a SDF_OUTLINE_PIXEL_SIZE
+    mu_check(fabs(gi_A.sdfTexelSize - (float)GLYPH_LOAD_PIXEL_SIZE / SDF_OUTLINE_PIXEL_SIZE) < 1e-6);
+    mu_assert_int_eq(1, gi_A.sdfChannels);
+    mu_assert_int_eq(sdfPaddingForSpread(SDF_SPREAD_TEXELS), gi_A.sdfPadding);
+
+    // Backend msdf: textura RGB8 a MSDF_PIXEL_SIZE
+    sdfBackend = SDF_BACKEND_MSDF;
+    GlyphInfo gi_B = getGlyphInfo((FT_ULong)'B');
+    sdfBackend = SDF_BACKEND_OUTLINE;
+    mu_assert_int_eq(3, gi_B.sdfChannels);
+    mu_check(fabs(gi_B.sdfTexelSize - (float)GLYPH_LOAD_PIXEL_SIZE / MSDF_PIXEL_SIZE) < 1e-6);
+
+    // Backend coverage: bitmap a SDF_COVERAGE_PIXEL_SIZE con el EDT antialiasado
+    sdfBackend = SDF_BACKEND_COVERAGE;
+    GlyphInfo gi_C = getGlyphInfo((FT_ULong)'C');
+    sdfBackend = SDF_BACKEND_OUTLINE;
+    mu_check(gi_C.sdfTextureWidth > 0);
+    mu_check(fabs(gi_C.sdfTexelSize - (float)GLYPH_LOAD_PIXEL_SIZE / SDF_COVERAGE_PIXEL_SIZE) < 1e-6);
+    mu_check(fabs(gi_C.advanceX - getGlyphInfo((FT_ULong)'C').advanceX) < 1e-6);
+
+    // Backend freetype: SDF de FreeType a SDF_FREETYPE_PIXEL_SIZE
+    sdfBackend = SDF_BACKEND_FREETYPE;
+    GlyphInfo gi_D = getGlyphInfo((FT_ULong)'D');
+    sdfBackend = SDF_BACKEND_OUTLINE;
+    mu_check(gi_D.sdfTextureWidth > 0);
+    mu_assert_int_eq(1, gi_D.sdfChannels);
+    mu_check(fabs(gi_D.sdfTexelSize - (float)GLYPH_LOAD_PIXEL_SIZE / SDF_FREETYPE_PIXEL_SIZE) < 1e-6);
 
     GlyphInfo gi_A_cached = getGlyphInfo(char_A);
 #ifdef UNIT_TESTING
@@ -125,7 +168,7 @@ MU_TEST(test_get_glyph_info_space) {
     initGlyphCache();
 
     FT_ULong char_space = ' '; 
-    GlyphInfo gi_space = getGlyphInfo(char_space);
+    GlyphInfo gi_space = getGlyphInfoWithMesh(char_space, -1);
 
     mu_assert_int_eq(0, gi_space.vao); // El espacio no tiene VAO
     mu_assert_int_eq(0, gi_space.indexCount); // El espacio no tiene índices
@@ -148,7 +191,7 @@ MU_TEST(test_get_glyph_info_unicode_and_fallback) {
     initGlyphCache();
 
     FT_ULong char_euro = 0x20AC; 
-    GlyphInfo gi_euro = getGlyphInfo(char_euro);
+    GlyphInfo gi_euro = getGlyphInfoWithMesh(char_euro, -1);
 
 #ifdef UNIT_TESTING
     mu_assert_int_eq(0, gi_euro.vao);
@@ -170,11 +213,64 @@ MU_TEST(test_get_glyph_info_unicode_and_fallback) {
 }
 
 
+MU_TEST(test_sdf_levels_are_lazy_and_selected_by_size) {
+    if (setup_freetype_for_glyph_tests() != 0) {
+        mu_fail("Fallo en la configuración de FreeType para test_sdf_levels_are_lazy_and_selected_by_size.");
+        return;
+    }
+    initGlyphCache();
+
+    static const int sizes[SDF_LEVEL_COUNT] = SDF_LEVEL_SIZES;
+    mu_assert_int_eq(0, selectSdfLevel(8.0f));
+    mu_assert_int_eq(0, selectSdfLevel((float)sizes[0] / SDF_LEVEL_TEXELS_PER_SCREEN_PX));
+    mu_assert_int_eq(1, selectSdfLevel((float)sizes[0] / SDF_LEVEL_TEXELS_PER_SCREEN_PX + 1.0f));
+    mu_assert_int_eq(SDF_LEVEL_COUNT - 1, selectSdfLevel(10000.0f));
+    sdfLevelsEnabled = 0;
+    mu_assert_int_eq(-1, selectSdfLevel(8.0f));
+    sdfLevelsEnabled = 1;
+
+    // Ningún nivel se genera con getGlyphInfo
+    GlyphInfo base = getGlyphInfo((FT_ULong)'g');
+    for (int i = 0; i < SDF_LEVEL_COUNT; ++i) mu_assert_int_eq(0, base.sdfLevels[i].state);
+
+    int previousWidth = 0;
+    for (int i = 0; i < SDF_LEVEL_COUNT; ++i) {
+        GlyphInfo level = getGlyphInfoForLevel((FT_ULong)'g', i);
+        mu_assert_int_eq(1, level.sdfLevels[i].state);
+        mu_check(fabs(level.sdfTexelSize - (float)GLYPH_LOAD_PIXEL_SIZE / sizes[i]) < 1e-6);
+        mu_check(level.sdfTextureWidth > previousWidth); // Más texels cuanto mayor el nivel
+        previousWidth = level.sdfTextureWidth;
+        // La caja del glifo en píxeles de carga apenas cambia entre niveles
+        float leftPx = (float)level.bitmap_left * level.sdfTexelSize;
+        mu_check(fabs(leftPx - (float)base.bitmap_left * base.sdfTexelSize) <= level.sdfTexelSize + base.sdfTexelSize);
+        mu_check(fabs(level.advanceX - base.advanceX) < 1e-6);
+        if (sizes[i] == SDF_OUTLINE_PIXEL_SIZE) { // Mismo tamaño que el base: se comparte
+            mu_assert_int_eq(base.sdfTextureWidth, level.sdfTextureWidth);
+            mu_assert_int_eq(base.sdfTextureHeight, level.sdfTextureHeight);
+        }
+    }
+    // Pedido otra vez, sale de la caché sin cambiar
+    GlyphInfo again = getGlyphInfoForLevel((FT_ULong)'g', 0);
+    mu_assert_int_eq(1, again.sdfLevels[0].state);
+    mu_check(fabs(again.sdfTexelSize - (float)GLYPH_LOAD_PIXEL_SIZE / sizes[0]) < 1e-6);
+
+    // Nivel -1 y glifos sin SDF: los campos del base
+    GlyphInfo baseAgain = getGlyphInfoForLevel((FT_ULong)'g', -1);
+    mu_assert_int_eq(base.sdfTextureWidth, baseAgain.sdfTextureWidth);
+    GlyphInfo space = getGlyphInfoForLevel((FT_ULong)' ', 0);
+    mu_assert_int_eq(0, space.sdfTextureWidth);
+    mu_assert_int_eq(-1, space.sdfLevels[0].state);
+
+    cleanupGlyphCache();
+    teardown_freetype_for_glyph_tests();
+}
+
 MU_TEST_SUITE(glyph_manager_suite) {
     MU_RUN_TEST(test_init_and_cleanup_glyph_cache);
     MU_RUN_TEST(test_get_glyph_info_basic_ascii);
     MU_RUN_TEST(test_get_glyph_info_space);
     MU_RUN_TEST(test_get_glyph_info_unicode_and_fallback);
+    MU_RUN_TEST(test_sdf_levels_are_lazy_and_selected_by_size);
 }
 
 int main(int argc, char *argv[]) {
@@ -0,0 +1,95 @@
+#include "minunit.h"
+#include "kerning.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* kerningTestFontPath = "tests/fonts/test_font.ttf";
+
+MU_TEST(test_table_set_and_lookup) {
+    KerningTable table;
+    memset(&table, 0, sizeof(table));
+    mu_check(kerningLookup(&table, 1, 2) == 0.0f); // Vacía
+    mu_check(kerningLookup(NULL, 1, 2) == 0.0f);
+
+    // Más pares que la reserva inicial: la tabla crece y no pierde ninguno
+    for (FT_UInt left = 1; left <= 40; ++left) {
+        for (FT_UInt right = 1; right <= 40; ++right) {
+            mu_assert_int_eq(0, kerningTableSet(&table, left, right, (float)left - (float)right * 0.5f));
+        }
+    }
+    mu_assert_int_eq(1600, (int)table.count);
+    int wrong = 0;
+    for (FT_UInt left = 1; left <= 40; ++left) {
+        for (FT_UInt right = 1; right <= 40; ++right) wrong += kerningLookup(&table, left, right) != (float)left - (float)right * 0.5f;
+    }
+    mu_assert_int_eq(0, wrong);
+    mu_check(kerningLookup(&table, 41, 1) == 0.0f);
+    mu_check(kerningLookup(&table, 0, 1) == 0.0f); // Índice 0: glifo de otra cara, sin kerning
+
+    mu_assert_int_eq(0, kerningTableSet(&table, 3, 4, -2.5f)); // Reemplaza
+    mu_assert_int_eq(1600, (int)table.count);
+    mu_check(kerningLookup(&table, 3, 4) == -2.5f);
+    mu_assert_int_eq(-1, kerningTableSet(&table, 0x10000, 1, 1.0f));
+
+    freeKerningTable(&table);
+    mu_check(kerningLookup(&table, 3, 4) == 0.0f);
+}
+
+// La tabla leída de 'kern' da lo mismo que FT_Get_Kerning (sin ajustar al
+// píxel) en todos los pares de ASCII imprimible
+MU_TEST(test_build_matches_ft_get_kerning) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, kerningTestFontPath, 0, &face));
+
+    KerningTable table;
+    mu_assert_int_eq(0, buildKerningTable(face, 48, &table));
+    mu_assert_int_eq(48, table.pixelSize);
+    mu_check(table.count > 100);
+
+    int mismatches = 0, kernedPairs = 0;
+    for (FT_ULong l = 0x20; l < 0x7F; ++l) {
+        FT_UInt left = FT_Get_Char_Index(face, l);
+        for (FT_ULong r = 0x20; r < 0x7F; ++r) {
+            FT_UInt right = FT_Get_Char_Index(face, r);
+            FT_Vector kerning;
+            mu_assert_int_eq(0, FT_Get_Kerning(face, left, right, FT_KERNING_UNFITTED, &kerning));
+            float expected = (float)kerning.x / 64.0f;
+            float actual = kerningLookup(&table, left, right);
+            mismatches += fabsf(expected - actual) > 1e-4f;
+            kernedPairs += actual != 0.0f;
+        }
+    }
+    printf("  Kerning a 48px: %zu pares en la tabla, %d entre ASCII imprimible\n", table.count, kernedPairs);
+    mu_assert_int_eq(0, mismatches);
+    mu_check(kernedPairs > 0);
+    mu_check(kerningLookup(&table, FT_Get_Char_Index(face, 'A'), FT_Get_Char_Index(face, 'V')) < -1.0f);
+
+    // El ajuste escala con el tamaño
+    KerningTable half;
+    mu_assert_int_eq(0, buildKerningTable(face, 24, &half));
+    float av48 = kerningLookup(&table, FT_Get_Char_Index(face, 'A'), FT_Get_Char_Index(face, 'V'));
+    float av24 = kerningLookup(&half, FT_Get_Char_Index(face, 'A'), FT_Get_Char_Index(face, 'V'));
+    mu_check(fabsf(av48 - 2.0f * av24) < 0.05f);
+
+    freeKerningTable(&table);
+    freeKerningTable(&half);
+    mu_assert_int_eq(-1, buildKerningTable(NULL, 48, &table));
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST_SUITE(kerning_tests) {
+    MU_RUN_TEST(test_table_set_and_lookup);
+    MU_RUN_TEST(test_build_matches_ft_get_kerning);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(kerning_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
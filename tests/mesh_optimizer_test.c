@@ -0,0 +1,202 @@
+#include "minunit.h"
+#include "mesh_optimizer.h"
+#include "tessellation_handler.h"
+#include "freetype_handler.h" // OutlineDataC y callbacks de FT_Outline_Decompose
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include FT_OUTLINE_H
+
+static const char* meshOptTestFontPath = "tests/fonts/test_font.ttf";
+#define MESH_OPT_TEST_PIXEL_SIZE 48
+#define MESH_OPT_TEST_FLATNESS 0.05f
+#define MESH_OPT_TEST_QUANTIZE (4096.0f / MESH_OPT_TEST_PIXEL_SIZE)
+#define GRID_SIZE 24
+
+static double optimized_area(const OptimizedMesh* m) {
+    double total = 0.0;
+    for (int t = 0; t < m->indexCount; t += 3) {
+        double p[3][2];
+        for (int k = 0; k < 3; ++k) {
+            int v = m->indices[t + k];
+            if (m->quantizeScale > 0.0f) {
+                p[k][0] = m->quantized[2 * v] / (double)m->quantizeScale;
+                p[k][1] = m->quantized[2 * v + 1] / (double)m->quantizeScale;
+            } else {
+                p[k][0] = m->positions[2 * v];
+                p[k][1] = m->positions[2 * v + 1];
+            }
+        }
+        total += 0.5 * fabs((p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]));
+    }
+    return total;
+}
+
+static double buffer_area(const GlyphMeshBuffer* m) {
+    double total = 0.0;
+    for (int t = 0; t < m->indexCount; t += 3) {
+        const TESSreal* a = m->vertices + 2 * m->indices[t];
+        const TESSreal* b = m->vertices + 2 * m->indices[t + 1];
+        const TESSreal* c = m->vertices + 2 * m->indices[t + 2];
+        total += 0.5 * fabs(((double)b[0] - a[0]) * ((double)c[1] - a[1]) - ((double)b[1] - a[1]) * ((double)c[0] - a[0]));
+    }
+    return total;
+}
+
+MU_TEST(test_weld_and_degenerates) {
+    // Dos triángulos con la arista compartida duplicada, y uno que se
+    // vuelve degenerado al cuantizar (dos vértices a 1e-4 px)
+    TESSreal vertices[] = { 0, 0,  1, 0,  1, 1,    0, 0,  1, 1,  0, 1,    2, 2,  2.0001f, 2,  3, 3 };
+    TESSindex indices[] = { 0, 1, 2,  3, 4, 5,  6, 7, 8 };
+    GlyphMeshBuffer mesh = { vertices, 9, indices, 9, 9, 9 };
+    OptimizedMesh out = {0};
+
+    MeshOptimizeOptions floatWeld = { 1, 1, 0.0f };
+    mu_assert_int_eq(MESH_OPT_OK, optimizeGlyphMesh(&mesh, &floatWeld, &out));
+    mu_assert_int_eq(7, out.vertexCount); // 9 - 2 repetidos
+    mu_assert_int_eq(9, out.indexCount);
+
+    MeshOptimizeOptions quantized = { 1, 1, 100.0f };
+    mu_assert_int_eq(MESH_OPT_OK, optimizeGlyphMesh(&mesh, &quantized, &out));
+    mu_assert_int_eq(4, out.vertexCount); // El triángulo degenerado y sus vértices desaparecen
+    mu_assert_int_eq(6, out.indexCount);
+    mu_check(fabs(optimized_area(&out) - 1.0) < 1e-6);
+
+    MeshOptimizeOptions none = { 0, 0, 0.0f };
+    mu_assert_int_eq(MESH_OPT_OK, optimizeGlyphMesh(&mesh, &none, &out));
+    mu_assert_int_eq(9, out.vertexCount);
+    for (int i = 0; i < 9; ++i) mu_assert_int_eq(i, out.indices[i]); // Sin reordenar: primer uso = orden original
+
+    // Fuera del rango de int16
+    TESSreal far[] = { 0, 0,  400, 0,  0, 1 };
+    TESSindex tri[] = { 0, 1, 2 };
+    GlyphMeshBuffer farMesh = { far, 3, tri, 3, 3, 3 };
+    MeshOptimizeOptions tooFine = { 1, 1, 100.0f };
+    mu_assert_int_eq(MESH_OPT_TOO_LARGE, optimizeGlyphMesh(&farMesh, &tooFine, &out));
+
+    freeOptimizedMesh(&out);
+}
+
+MU_TEST(test_cache_order_beats_shuffled_grid) {
+    // Rejilla con los triángulos barajados: el peor caso típico para la caché
+    static TESSreal vertices[(GRID_SIZE + 1) * (GRID_SIZE + 1) * 2];
+    static TESSindex indices[GRID_SIZE * GRID_SIZE * 6];
+    for (int y = 0; y <= GRID_SIZE; ++y) {
+        for (int x = 0; x <= GRID_SIZE; ++x) {
+            vertices[2 * (y * (GRID_SIZE + 1) + x)] = (TESSreal)x;
+            vertices[2 * (y * (GRID_SIZE + 1) + x) + 1] = (TESSreal)y;
+        }
+    }
+    int n = 0;
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            int v = y * (GRID_SIZE + 1) + x;
+            TESSindex quad[6] = { v, v + 1, v + GRID_SIZE + 2, v, v + GRID_SIZE + 2, v + GRID_SIZE + 1 };
+            memcpy(indices + n, quad, sizeof(quad));
+            n += 6;
+        }
+    }
+    unsigned int seed = 12345u;
+    for (int t = n / 3 - 1; t > 0; --t) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)((seed >> 8) % (unsigned int)(t + 1));
+        for (int k = 0; k < 3; ++k) {
+            TESSindex tmp = indices[3 * t + k];
+            indices[3 * t + k] = indices[3 * j + k];
+            indices[3 * j + k] = tmp;
+        }
+    }
+    GlyphMeshBuffer mesh = { vertices, (GRID_SIZE + 1) * (GRID_SIZE + 1), indices, n,
+                             (GRID_SIZE + 1) * (GRID_SIZE + 1), n };
+
+    OptimizedMesh out = {0};
+    MeshOptimizeOptions keepOrder = { 1, 0, 0.0f };
+    mu_assert_int_eq(MESH_OPT_OK, optimizeGlyphMesh(&mesh, &keepOrder, &out));
+    float before = meshAverageCacheMissRatio(out.indices, out.indexCount, out.vertexCount, 16);
+    MeshOptimizeOptions reorder = { 1, 1, 0.0f };
+    mu_assert_int_eq(MESH_OPT_OK, optimizeGlyphMesh(&mesh, &reorder, &out));
+    float after = meshAverageCacheMissRatio(out.indices, out.indexCount, out.vertexCount, 16);
+    printf("\nACMR rejilla barajada: %.3f -> %.3f\n", before, after);
+    mu_check(before > 1.5f);
+    mu_check(after < 0.9f);
+    mu_check(fabs(optimized_area(&out) - GRID_SIZE * GRID_SIZE) < 1e-6);
+
+    freeOptimizedMesh(&out);
+}
+
+MU_TEST(test_font_glyphs_keep_geometry_and_halve_size) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, meshOptTestFontPath, 0, &face));
+    FT_Set_Pixel_Sizes(face, 0, MESH_OPT_TEST_PIXEL_SIZE);
+
+    OutlineDataC outline;
+    initOutlineData(&outline, 8);
+    FT_Outline_Funcs funcs = { ftMoveToFunc, ftLineToFunc, ftConicToFunc, ftCubicToFunc, 0, 0 };
+    OptimizedMesh out = {0};
+    MeshOptimizeOptions options = { 1, 1, MESH_OPT_TEST_QUANTIZE };
+
+    int meshes = 0, areaMismatches = 0, worseCache = 0, badIndices = 0;
+    size_t bytesBefore = 0, bytesAfter = 0;
+    for (FT_ULong c = 0x21; c < 0x250; ++c) {
+        FT_UInt glyphIndex = FT_Get_Char_Index(face, c);
+        if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_BITMAP) != 0) continue;
+        if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE) continue;
+        resetOutlineData(&outline);
+        outline.flatnessTolerance = MESH_OPT_TEST_FLATNESS;
+        if (FT_Outline_Decompose(&face->glyph->outline, &funcs, &outline) != 0) continue;
+        TessellationResult result = generateGlyphTessellation(&outline);
+        if (result.elementCount == 0) continue;
+        GlyphMeshBuffer mesh = { result.vertices, result.vertexCount, result.elements, result.elementCount * 3,
+                                 result.vertexCount, result.elementCount * 3 };
+        meshes++;
+
+        mu_assert_int_eq(MESH_OPT_OK, optimizeGlyphMesh(&mesh, &options, &out));
+        double expected = buffer_area(&mesh);
+        // El redondeo a 1/85 px mueve cada vértice como mucho media unidad
+        if (fabs(optimized_area(&out) - expected) > 0.01 * expected + 0.05) areaMismatches++;
+        for (int i = 0; i < out.indexCount; ++i) badIndices += out.indices[i] >= out.vertexCount;
+
+        // Comparación con el mismo formato de índices pero en el orden del teselador
+        static uint16_t original[3 * 8192];
+        if (mesh.indexCount <= 3 * 8192) {
+            for (int i = 0; i < mesh.indexCount; ++i) original[i] = (uint16_t)mesh.indices[i];
+            float acmrBefore = meshAverageCacheMissRatio(original, mesh.indexCount, mesh.vertexCount, 16);
+            float acmrAfter = meshAverageCacheMissRatio(out.indices, out.indexCount, out.vertexCount, 16);
+            if (acmrAfter > acmrBefore + 0.05f) worseCache++;
+        }
+
+        bytesBefore += (size_t)mesh.vertexCount * 2 * sizeof(TESSreal) + (size_t)mesh.indexCount * sizeof(TESSindex);
+        bytesAfter += (size_t)out.vertexCount * 2 * sizeof(int16_t) + (size_t)out.indexCount * sizeof(uint16_t);
+        free(result.vertices);
+        free(result.elements);
+    }
+    printf("\n%d mallas: %zu -> %zu bytes\n", meshes, bytesBefore, bytesAfter);
+
+    mu_check(meshes > 100);
+    mu_assert_int_eq(0, areaMismatches);
+    mu_assert_int_eq(0, badIndices);
+    mu_assert_int_eq(0, worseCache);
+    mu_check(bytesAfter * 2 <= bytesBefore);
+
+    freeOptimizedMesh(&out);
+    freeOutlineData(&outline);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST_SUITE(mesh_optimizer_tests) {
+    MU_RUN_TEST(test_weld_and_degenerates);
+    MU_RUN_TEST(test_cache_order_beats_shuffled_grid);
+    MU_RUN_TEST(test_font_glyphs_keep_geometry_and_halve_size);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(mesh_optimizer_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
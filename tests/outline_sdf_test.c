@@ -0,0 +1,493 @@
+#include "minunit.h"
+#include "outline_sdf.h"
+#include "sdf_generator.h"
+#include "freetype_handler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* sdfTestFontPath = "tests/fonts/test_font.ttf";
+#define SDF_TEST_PADDING 4
+#define SDF_TEST_SPREAD 2.0f
+#define SDF_TEST_OUTLINE_PX 48   // Tamaño del contorno (como GLYPH_LOAD_PIXEL_SIZE)
+#define SDF_TEST_REFERENCE_PX 192 // Cobertura de FreeType contra la que se compara
+
+static void add_square(OutlineDataC* outline, float x0, float y0, float x1, float y1, int clockwise) {
+    Point2D ccw[] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+    beginOutlineContour(outline);
+    for (int i = 0; i < 4; ++i) addOutlinePoint(outline, ccw[clockwise ? 3 - i : i]);
+}
+
+// Mediana de los tres canales, como el shader en modo MSDF
+static float median3(float r, float g, float b) {
+    return fmaxf(fminf(r, g), fminf(fmaxf(r, g), b));
+}
+
+MU_TEST(test_square_contract) {
+    OutlineDataC outline;
+    initOutlineData(&outline, 2);
+    add_square(&outline, 0, 0, 10, 10, 0);
+
+    int left, top, w, h;
+    unsigned char* sdf = generateSdfFromOutline(&outline, 1.0f, SDF_TEST_PADDING, SDF_TEST_SPREAD, &left, &top, &w, &h);
+    mu_check(sdf != NULL);
+    mu_assert_int_eq(0, left);
+    mu_assert_int_eq(10, top);
+    mu_assert_int_eq(18, w);
+    mu_assert_int_eq(18, h);
+    mu_assert_int_eq(0, sdf[9 * w + 9]);     // Centro: saturado por dentro
+    mu_assert_int_eq(255, sdf[0]);           // Esquina del padding: saturado por fuera
+    mu_assert_int_eq(95, sdf[4 * w + 4]);    // Texel interior a 0.5 del borde
+    mu_assert_int_eq(159, sdf[8 * w + 3]);   // Texel exterior a 0.5 del borde
+    mu_assert_int_eq(159, sdf[13 * w + 14]); // Simétrico, lado derecho
+
+    // La orientación del contorno no cambia nada
+    resetOutlineData(&outline);
+    add_square(&outline, 0, 0, 10, 10, 1);
+    unsigned char* flipped = generateSdfFromOutline(&outline, 1.0f, SDF_TEST_PADDING, SDF_TEST_SPREAD, NULL, NULL, NULL, NULL);
+    int differences = 0;
+    for (int i = 0; i < w * h; ++i) differences += sdf[i] != flipped[i];
+    mu_assert_int_eq(0, differences);
+    free_sdf_bitmap(flipped);
+
+    // Con agujero (sentido contrario): el centro pasa a ser exterior
+    add_square(&outline, 3, 3, 7, 7, 0);
+    unsigned char* holed = generateSdfFromOutline(&outline, 1.0f, SDF_TEST_PADDING, SDF_TEST_SPREAD, NULL, NULL, NULL, NULL);
+    mu_check(holed[9 * w + 9] > 128);
+    mu_check(holed[5 * w + 5] < 128);
+    free_sdf_bitmap(holed);
+
+    // Contorno vacío
+    resetOutlineData(&outline);
+    mu_check(generateSdfFromOutline(&outline, 1.0f, SDF_TEST_PADDING, SDF_TEST_SPREAD, &left, &top, &w, &h) == NULL);
+    mu_assert_int_eq(0, w);
+
+    free_sdf_bitmap(sdf);
+    freeOutlineData(&outline);
+}
+
+MU_TEST(test_msdf_square_keeps_corners) {
+    // El mismo cuadrado de 10x10, como FT_Outline en 26.6
+    FT_Vector points[] = {{0, 0}, {640, 0}, {640, 640}, {0, 640}};
+    char tags[] = { FT_CURVE_TAG_ON, FT_CURVE_TAG_ON, FT_CURVE_TAG_ON, FT_CURVE_TAG_ON };
+    short ends[] = { 3 };
+    FT_Outline square = { 1, 4, points, tags, ends, 0 };
+
+    int left, top, w, h;
+    unsigned char* msdf = generateMsdfFromOutline(&square, 1.0f, SDF_TEST_PADDING, SDF_TEST_SPREAD, &left, &top, &w, &h);
+    mu_check(msdf != NULL);
+    mu_assert_int_eq(0, left);
+    mu_assert_int_eq(10, top);
+    mu_assert_int_eq(18, w);
+    mu_assert_int_eq(18, h);
+
+#define MEDIAN_AT(i, j) ((int)median3(msdf[3 * ((j) * w + (i))], msdf[3 * ((j) * w + (i)) + 1], msdf[3 * ((j) * w + (i)) + 2]))
+    mu_assert_int_eq(0, MEDIAN_AT(9, 9));
+    mu_assert_int_eq(255, MEDIAN_AT(0, 0));
+    mu_assert_int_eq(95, MEDIAN_AT(4, 4));
+    mu_assert_int_eq(159, MEDIAN_AT(8, 3));
+    mu_assert_int_eq(159, MEDIAN_AT(14, 13));
+    // Texel en la diagonal fuera de la esquina: el SDF da la distancia al
+    // vértice (0.71 texels) y la esquina sale redondeada; la mediana del MSDF
+    // da 0.5, la de una esquina viva
+    mu_assert_int_eq(159, MEDIAN_AT(3, 3));
+    mu_assert_int_eq(159, MEDIAN_AT(14, 14));
+#undef MEDIAN_AT
+
+    // Las cuatro esquinas separan aristas de colores distintos: ningún canal es uniforme
+    int channelsUsed = 0;
+    for (int ch = 0; ch < 3; ++ch) {
+        int differs = 0;
+        for (int i = 0; i < w * h; ++i) differs += msdf[3 * i + ch] != msdf[3 * (9 * w + 9) + ch] && msdf[3 * i + ch] < 128;
+        channelsUsed += differs > 0;
+    }
+    mu_assert_int_eq(3, channelsUsed);
+
+    free_sdf_bitmap(msdf);
+}
+
+// --- Calidad: se reconstruye el glifo a SDF_TEST_REFERENCE_PX desde el SDF
+// (bilineal, rampa de 1 px en el borde) y se compara con la cobertura
+// antialiasada de FreeType a ese tamaño ---
+
+typedef struct {
+    unsigned char* data;
+    int width, height;
+    int left, top;          // bitmap_left/bitmap_top en texels
+    float texelsPerRefPx;
+    int channels;           // 1 = SDF, 3 = MSDF (se reconstruye con la mediana, como el shader)
+} SdfSample;
+
+typedef struct {
+    unsigned char* coverage;
+    int width, rows, pitch, left, top;
+} Reference;
+
+static float sample_bilinear(const SdfSample* s, float tx, float ty) {
+    float x = tx - 0.5f, y = ty - 0.5f;
+    int x0 = (int)floorf(x), y0 = (int)floorf(y);
+    float fx = x - x0, fy = y - y0;
+    float filtered[3];
+    for (int ch = 0; ch < s->channels; ++ch) {
+        float v[2][2];
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                int xi = x0 + dx, yi = y0 + dy;
+                xi = xi < 0 ? 0 : (xi >= s->width ? s->width - 1 : xi);
+                yi = yi < 0 ? 0 : (yi >= s->height ? s->height - 1 : yi);
+                v[dy][dx] = s->data[(yi * s->width + xi) * s->channels + ch];
+            }
+        }
+        filtered[ch] = (v[0][0] * (1 - fx) + v[0][1] * fx) * (1 - fy) + (v[1][0] * (1 - fx) + v[1][1] * fx) * fy;
+    }
+    return s->channels == 3 ? median3(filtered[0], filtered[1], filtered[2]) : filtered[0];
+}
+
+// Error absoluto medio de cobertura sobre la caja de la referencia
+static double reconstruction_error(const SdfSample* s, const Reference* ref) {
+    double total = 0.0;
+    for (int v = 0; v < ref->rows; ++v) {
+        for (int u = 0; u < ref->width; ++u) {
+            float refX = (float)ref->left + u + 0.5f, refY = (float)ref->top - v - 0.5f;
+            float tx = refX * s->texelsPerRefPx - (float)(s->left - SDF_TEST_PADDING);
+            float ty = (float)(s->top + SDF_TEST_PADDING) - refY * s->texelsPerRefPx;
+            float distance = (sample_bilinear(s, tx, ty) / 255.0f * 2.0f - 1.0f) * SDF_TEST_SPREAD / s->texelsPerRefPx;
+            float alpha = 0.5f - distance;
+            alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+            total += fabsf(alpha - ref->coverage[v * ref->pitch + u] / 255.0f);
+        }
+    }
+    return total / ((double)ref->width * ref->rows);
+}
+
+static int load_unhinted(FT_Face face, FT_ULong c, int px) {
+    FT_Set_Pixel_Sizes(face, 0, px);
+    if (FT_Load_Char(face, c, FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP) != 0) return -1;
+    return face->glyph->format == FT_GLYPH_FORMAT_OUTLINE ? 0 : -1;
+}
+
+static int bitmap_sdf(FT_Face face, FT_ULong c, int px, SdfSample* out) {
+    if (load_unhinted(face, c, px) != 0 || FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) return -1;
+    const FT_Bitmap* bm = &face->glyph->bitmap;
+    out->data = generate_sdf_from_bitmap(bm->buffer, (int)bm->width, (int)bm->rows, bm->pitch,
+                                         SDF_TEST_PADDING, SDF_TEST_SPREAD, &out->width, &out->height);
+    out->left = face->glyph->bitmap_left;
+    out->top = face->glyph->bitmap_top;
+    out->texelsPerRefPx = (float)px / SDF_TEST_REFERENCE_PX;
+    out->channels = 1;
+    return out->data ? 0 : -1;
+}
+
+// Mismo bitmap que bitmap_sdf, pero con el EDT antialiasado sobre la cobertura
+static int coverage_sdf(FT_Face face, FT_ULong c, int px, SdfSample* out) {
+    if (load_unhinted(face, c, px) != 0 || FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) return -1;
+    const FT_Bitmap* bm = &face->glyph->bitmap;
+    out->data = generate_sdf_from_coverage(bm->buffer, (int)bm->width, (int)bm->rows, bm->pitch,
+                                           SDF_TEST_PADDING, SDF_TEST_SPREAD, &out->width, &out->height);
+    out->left = face->glyph->bitmap_left;
+    out->top = face->glyph->bitmap_top;
+    out->texelsPerRefPx = (float)px / SDF_TEST_REFERENCE_PX;
+    out->channels = 1;
+    return out->data ? 0 : -1;
+}
+
+static int outline_sdf(FT_Face face, FT_ULong c, int px, OutlineDataC* outline, SdfSample* out) {
+    if (load_unhinted(face, c, SDF_TEST_OUTLINE_PX) != 0) return -1;
+    float scale = (float)px / SDF_TEST_OUTLINE_PX;
+    resetOutlineData(outline);
+    outline->flatnessTolerance = OUTLINE_SDF_FLATNESS_TEXELS / scale;
+    if (extractOutline(&face->glyph->outline, outline) != 0) return -1;
+    out->data = generateSdfFromOutline(outline, scale, SDF_TEST_PADDING, SDF_TEST_SPREAD,
+                                       &out->left, &out->top, &out->width, &out->height);
+    out->texelsPerRefPx = (float)px / SDF_TEST_REFERENCE_PX;
+    out->channels = 1;
+    return out->data ? 0 : -1;
+}
+
+static int outline_msdf(FT_Face face, FT_ULong c, int px, SdfSample* out) {
+    if (load_unhinted(face, c, SDF_TEST_OUTLINE_PX) != 0) return -1;
+    float scale = (float)px / SDF_TEST_OUTLINE_PX;
+    out->data = generateMsdfFromOutline(&face->glyph->outline, scale, SDF_TEST_PADDING, SDF_TEST_SPREAD,
+                                        &out->left, &out->top, &out->width, &out->height);
+    out->texelsPerRefPx = (float)px / SDF_TEST_REFERENCE_PX;
+    out->channels = 3;
+    return out->data ? 0 : -1;
+}
+
+MU_TEST(test_font_glyph_matches_bitmap_contract) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, sdfTestFontPath, 0, &face));
+
+    // 'H' solo tiene rectas: la caja coincide exactamente con la del bitmap
+    OutlineDataC outline;
+    initOutlineData(&outline, 4);
+    SdfSample fromBitmap, fromOutline;
+    mu_assert_int_eq(0, bitmap_sdf(face, 'H', SDF_TEST_OUTLINE_PX, &fromBitmap));
+    mu_assert_int_eq(0, outline_sdf(face, 'H', SDF_TEST_OUTLINE_PX, &outline, &fromOutline));
+    mu_assert_int_eq(fromBitmap.width, fromOutline.width);
+    mu_assert_int_eq(fromBitmap.height, fromOutline.height);
+    mu_assert_int_eq(fromBitmap.left, fromOutline.left);
+    mu_assert_int_eq(fromBitmap.top, fromOutline.top);
+
+    int signMismatches = 0;
+    for (int i = 0; i < fromBitmap.width * fromBitmap.height; ++i) {
+        signMismatches += (fromBitmap.data[i] > 128) != (fromOutline.data[i] > 128);
+    }
+    mu_check(signMismatches * 50 < fromBitmap.width * fromBitmap.height); // Solo texels de borde
+
+    free_sdf_bitmap(fromBitmap.data);
+    free_sdf_bitmap(fromOutline.data);
+    freeOutlineData(&outline);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST(test_outline_sdf_at_24px_matches_bitmap_sdf_at_48px) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, sdfTestFontPath, 0, &face));
+
+    static const char* charset = "AaBgQRe@&%8sw";
+    static const int sizes[] = { 16, 24, 32, 48 };
+    enum { SIZE_COUNT = sizeof(sizes) / sizeof(sizes[0]) };
+    double bitmapError[SIZE_COUNT] = {0}, outlineError[SIZE_COUNT] = {0};
+    OutlineDataC outline;
+    initOutlineData(&outline, 4);
+    int failures = 0;
+
+    for (const char* c = charset; *c; ++c) {
+        if (load_unhinted(face, (FT_ULong)*c, SDF_TEST_REFERENCE_PX) != 0 ||
+            FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) { failures++; continue; }
+        const FT_Bitmap* bm = &face->glyph->bitmap;
+        Reference ref = { (unsigned char*)malloc((size_t)bm->pitch * bm->rows), (int)bm->width, (int)bm->rows,
+                          bm->pitch, face->glyph->bitmap_left, face->glyph->bitmap_top };
+        for (size_t i = 0; i < (size_t)bm->pitch * bm->rows; ++i) ref.coverage[i] = bm->buffer[i];
+
+        for (int s = 0; s < SIZE_COUNT; ++s) {
+            SdfSample sample;
+            if (bitmap_sdf(face, (FT_ULong)*c, sizes[s], &sample) == 0) {
+                bitmapError[s] += reconstruction_error(&sample, &ref);
+                free_sdf_bitmap(sample.data);
+            } else failures++;
+            if (outline_sdf(face, (FT_ULong)*c, sizes[s], &outline, &sample) == 0) {
+                outlineError[s] += reconstruction_error(&sample, &ref);
+                free_sdf_bitmap(sample.data);
+            } else failures++;
+        }
+        free(ref.coverage);
+    }
+
+    double glyphs = (double)strlen(charset);
+    printf("\nError medio de cobertura a %dpx (bitmap / contorno):", SDF_TEST_REFERENCE_PX);
+    for (int s = 0; s < SIZE_COUNT; ++s) printf(" %dpx %.4f/%.4f", sizes[s], bitmapError[s] / glyphs, outlineError[s] / glyphs);
+    printf("\n");
+
+    mu_assert_int_eq(0, failures);
+    mu_check(outlineError[1] <= bitmapError[3]); // 24px desde el contorno ya igualan 48px desde el bitmap
+    for (int s = 0; s < SIZE_COUNT; ++s) mu_check(outlineError[s] < bitmapError[s]);
+
+    freeOutlineData(&outline);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST(test_msdf_at_16px_beats_sdf_on_corners) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, sdfTestFontPath, 0, &face));
+
+    // Glifos de esquinas agudas, donde el SDF de un canal las redondea
+    static const char* charset = "AHKMNVWXZ4";
+    static const int sizes[] = { 16, 24 };
+    enum { SIZE_COUNT = sizeof(sizes) / sizeof(sizes[0]) };
+    double sdfError[SIZE_COUNT] = {0}, msdfError[SIZE_COUNT] = {0};
+    OutlineDataC outline;
+    initOutlineData(&outline, 4);
+    int failures = 0;
+
+    for (const char* c = charset; *c; ++c) {
+        if (load_unhinted(face, (FT_ULong)*c, SDF_TEST_REFERENCE_PX) != 0 ||
+            FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) { failures++; continue; }
+        const FT_Bitmap* bm = &face->glyph->bitmap;
+        Reference ref = { (unsigned char*)malloc((size_t)bm->pitch * bm->rows), (int)bm->width, (int)bm->rows,
+                          bm->pitch, face->glyph->bitmap_left, face->glyph->bitmap_top };
+        for (size_t i = 0; i < (size_t)bm->pitch * bm->rows; ++i) ref.coverage[i] = bm->buffer[i];
+
+        for (int s = 0; s < SIZE_COUNT; ++s) {
+            SdfSample sample;
+            if (outline_sdf(face, (FT_ULong)*c, sizes[s], &outline, &sample) == 0) {
+                sdfError[s] += reconstruction_error(&sample, &ref);
+                free_sdf_bitmap(sample.data);
+            } else failures++;
+            if (outline_msdf(face, (FT_ULong)*c, sizes[s], &sample) == 0) {
+                msdfError[s] += reconstruction_error(&sample, &ref);
+                free_sdf_bitmap(sample.data);
+            } else failures++;
+        }
+        free(ref.coverage);
+    }
+
+    double glyphs = (double)strlen(charset);
+    printf("\nError medio de cobertura a %dpx (SDF / MSDF):", SDF_TEST_REFERENCE_PX);
+    for (int s = 0; s < SIZE_COUNT; ++s) printf(" %dpx %.4f/%.4f", sizes[s], sdfError[s] / glyphs, msdfError[s] / glyphs);
+    printf("\n");
+
+    mu_assert_int_eq(0, failures);
+    for (int s = 0; s < SIZE_COUNT; ++s) mu_check(msdfError[s] < sdfError[s]);
+    mu_check(msdfError[0] < sdfError[1]); // MSDF a 16px ya supera al SDF a 24px
+
+    freeOutlineData(&outline);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST(test_coverage_sdf_quality_versus_size) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, sdfTestFontPath, 0, &face));
+
+    static const char* charset = "AaBgQRe@&%8sw";
+    static const int sizes[] = { 16, 24, 32, 48 };
+    enum { SIZE_COUNT = sizeof(sizes) / sizeof(sizes[0]) };
+    double thresholdError[SIZE_COUNT] = {0}, coverageError[SIZE_COUNT] = {0};
+    int failures = 0;
+
+    for (const char* c = charset; *c; ++c) {
+        if (load_unhinted(face, (FT_ULong)*c, SDF_TEST_REFERENCE_PX) != 0 ||
+            FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) { failures++; continue; }
+        const FT_Bitmap* bm = &face->glyph->bitmap;
+        Reference ref = { (unsigned char*)malloc((size_t)bm->pitch * bm->rows), (int)bm->width, (int)bm->rows,
+                          bm->pitch, face->glyph->bitmap_left, face->glyph->bitmap_top };
+        for (size_t i = 0; i < (size_t)bm->pitch * bm->rows; ++i) ref.coverage[i] = bm->buffer[i];
+
+        for (int s = 0; s < SIZE_COUNT; ++s) {
+            SdfSample sample;
+            if (bitmap_sdf(face, (FT_ULong)*c, sizes[s], &sample) == 0) {
+                thresholdError[s] += reconstruction_error(&sample, &ref);
+                free_sdf_bitmap(sample.data);
+            } else failures++;
+            if (coverage_sdf(face, (FT_ULong)*c, sizes[s], &sample) == 0) {
+                coverageError[s] += reconstruction_error(&sample, &ref);
+                free_sdf_bitmap(sample.data);
+            } else failures++;
+        }
+        free(ref.coverage);
+    }
+
+    double glyphs = (double)strlen(charset);
+    printf("\nError medio de cobertura a %dpx (umbral 128 / EDT antialiasado):", SDF_TEST_REFERENCE_PX);
+    for (int s = 0; s < SIZE_COUNT; ++s) printf(" %dpx %.4f/%.4f", sizes[s], thresholdError[s] / glyphs, coverageError[s] / glyphs);
+    printf("\n");
+
+    mu_assert_int_eq(0, failures);
+    for (int s = 0; s < SIZE_COUNT; ++s) mu_check(coverageError[s] < thresholdError[s]);
+    mu_check(coverageError[1] <= thresholdError[3]); // Con la cobertura, 24px rinden como 48px umbralizados
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+// El lote sobre una página de atlas da los mismos bytes que un glifo cada vez,
+// con cualquier número de hilos, y no toca nada fuera de los rectángulos
+MU_TEST(test_coverage_sdf_batch_into_page) {
+    FT_Library library;
+    FT_Face face;
+    mu_assert_int_eq(0, FT_Init_FreeType(&library));
+    mu_assert_int_eq(0, FT_New_Face(library, sdfTestFontPath, 0, &face));
+
+    enum { PAGE_W = 256, PAGE_H = 128, PAGE_STRIDE = 260, GLYPHS = 13, SENTINEL = 0x5A };
+    static const char* charset = "AaBgQRe@&%8sw";
+    SdfBatchGlyph glyphs[GLYPHS + 1];
+    unsigned char* bitmaps[GLYPHS] = {0};
+    int penX = 0, penY = 0, rowHeight = 0;
+    for (int i = 0; i < GLYPHS; ++i) {
+        mu_assert_int_eq(0, load_unhinted(face, (FT_ULong)charset[i], 24));
+        mu_assert_int_eq(0, FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL));
+        const FT_Bitmap* bm = &face->glyph->bitmap;
+        bitmaps[i] = (unsigned char*)malloc((size_t)bm->pitch * bm->rows);
+        memcpy(bitmaps[i], bm->buffer, (size_t)bm->pitch * bm->rows);
+        SdfBatchGlyph g = { bitmaps[i], (int)bm->width, (int)bm->rows, bm->pitch, 3, 0, 0 };
+        int w = g.width + 2 * g.padding, h = g.height + 2 * g.padding;
+        if (penX + w + 1 > PAGE_W) { // Estantes, con un texel de separación
+            penX = 0;
+            penY += rowHeight + 1;
+            rowHeight = 0;
+        }
+        g.dst_x = penX;
+        g.dst_y = penY;
+        penX += w + 1;
+        rowHeight = h > rowHeight ? h : rowHeight;
+        glyphs[i] = g;
+    }
+    mu_check(penY + rowHeight <= PAGE_H);
+    glyphs[GLYPHS] = glyphs[0]; // Fuera de la página: se salta
+    glyphs[GLYPHS].dst_x = PAGE_W - 4;
+
+    unsigned char* pages[2];
+    SdfPageRegion dirty[2];
+    static const int threads[2] = { 1, 4 };
+    for (int p = 0; p < 2; ++p) {
+        pages[p] = (unsigned char*)malloc((size_t)PAGE_STRIDE * PAGE_H);
+        memset(pages[p], SENTINEL, (size_t)PAGE_STRIDE * PAGE_H);
+        mu_assert_int_eq(1, generate_sdf_batch_into_page(glyphs, GLYPHS + 1, SDF_TEST_SPREAD, pages[p], PAGE_W, PAGE_H,
+                                                         PAGE_STRIDE, threads[p], &dirty[p]));
+    }
+    mu_check(memcmp(pages[0], pages[1], (size_t)PAGE_STRIDE * PAGE_H) == 0);
+    mu_assert_int_eq(0, dirty[0].x);
+    mu_assert_int_eq(0, dirty[0].y);
+    mu_assert_int_eq(penY + rowHeight, dirty[0].height);
+    mu_assert_int_eq(dirty[0].width, dirty[1].width);
+
+    int mismatches = 0, covered = 0;
+    for (int i = 0; i < GLYPHS; ++i) {
+        const SdfBatchGlyph* g = &glyphs[i];
+        int w, h;
+        unsigned char* single = generate_sdf_from_coverage(g->coverage, g->width, g->height, g->pitch, g->padding,
+                                                           SDF_TEST_SPREAD, &w, &h);
+        mu_check(single != NULL);
+        for (int y = 0; y < h; ++y) {
+            mismatches += memcmp(pages[1] + (size_t)(g->dst_y + y) * PAGE_STRIDE + g->dst_x, single + (size_t)y * w, (size_t)w) != 0;
+        }
+        covered += w * h;
+        free_sdf_bitmap(single);
+    }
+    mu_assert_int_eq(0, mismatches);
+    int untouched = 0;
+    for (size_t i = 0; i < (size_t)PAGE_STRIDE * PAGE_H; ++i) untouched += pages[1][i] == SENTINEL;
+    mu_check(untouched >= PAGE_STRIDE * PAGE_H - covered); // Los separadores y el relleno del stride siguen igual
+
+    SdfPageRegion none;
+    mu_assert_int_eq(-1, generate_sdf_batch_into_page(glyphs, GLYPHS, SDF_TEST_SPREAD, pages[0], PAGE_W, PAGE_H,
+                                                      PAGE_W - 1, 1, &none));
+    mu_assert_int_eq(0, none.width);
+
+    for (int i = 0; i < GLYPHS; ++i) free(bitmaps[i]);
+    free(pages[0]);
+    free(pages[1]);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+MU_TEST_SUITE(outline_sdf_tests) {
+    MU_RUN_TEST(test_square_contract);
+    MU_RUN_TEST(test_msdf_square_keeps_corners);
+    MU_RUN_TEST(test_font_glyph_matches_bitmap_contract);
+    MU_RUN_TEST(test_outline_sdf_at_24px_matches_bitmap_sdf_at_48px);
+    MU_RUN_TEST(test_msdf_at_16px_beats_sdf_on_corners);
+    MU_RUN_TEST(test_coverage_sdf_quality_versus_size);
+    MU_RUN_TEST(test_coverage_sdf_batch_into_page);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(outline_sdf_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
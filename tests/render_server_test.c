@@ -0,0 +1,221 @@
+#define _GNU_SOURCE // F_GET_SEALS
+#include "minunit.h"
+#include "render_server.h"
+#include "freetype_handler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+// Cliente de prueba: levanta el servidor en un hilo sobre un socket local y lo
+// maneja con la misma API de cliente que usarían los servidores de aplicación.
+
+static const char* testFontPathForServer = "tests/fonts/test_font.ttf";
+static char testSocketPath[108];
+static RenderServer testServer;
+static pthread_t serverThread;
+static int clientFd = -1;
+
+static void* server_thread_main(void* arg) {
+    (void)arg;
+    renderServerRun(&testServer);
+    return NULL;
+}
+
+static int start_test_server(void) {
+    snprintf(testSocketPath, sizeof(testSocketPath), "/tmp/texto_test_%d.sock", (int)getpid());
+    if (initFreeType() != 0 || loadFonts(testFontPathForServer, NULL) != 0) return -1;
+    if (renderServerOpen(&testServer, testSocketPath) != 0) return -1;
+    if (pthread_create(&serverThread, NULL, server_thread_main, NULL) != 0) return -1;
+    clientFd = renderClientConnect(testSocketPath);
+    return clientFd >= 0 ? 0 : -1;
+}
+
+static void stop_test_server(void) {
+    RenderResponse response;
+    if (clientFd >= 0) {
+        renderClientRequest(clientFd, RENDER_REQ_SHUTDOWN, 0, NULL, &response, NULL);
+        close(clientFd);
+        clientFd = -1;
+    }
+    pthread_join(serverThread, NULL);
+    renderServerClose(&testServer);
+    cleanupFreeType();
+}
+
+static RenderResponse get_stats(void) {
+    RenderResponse stats;
+    memset(&stats, 0, sizeof(stats));
+    renderClientRequest(clientFd, RENDER_REQ_STATS, 0, NULL, &stats, NULL);
+    return stats;
+}
+
+MU_TEST(test_measure_returns_layout_without_pixels) {
+    RenderResponse response;
+    int pixelFd = 123;
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_MEASURE, 32, "Hola", &response, &pixelFd));
+    mu_assert_int_eq(-1, pixelFd); // MEASURE no adjunta memfd
+    mu_check(response.width > 0);
+    mu_check(response.height > 0);
+    mu_check(response.baseline > 0);
+    mu_assert_int_eq(4, (int)response.glyphCount);
+}
+
+MU_TEST(test_render_returns_pixels_in_memfd) {
+    RenderResponse response;
+    int pixelFd = -1;
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_RENDER, 32, "Hola\nmundo", &response, &pixelFd));
+    mu_check(pixelFd >= 0);
+    mu_check(response.stride >= response.width);
+    mu_assert_int_eq(0, (int)(response.stride % 4));
+
+    RenderResponse single_line;
+    renderClientRequest(clientFd, RENDER_REQ_MEASURE, 32, "Hola", &single_line, NULL);
+    mu_check(response.height > single_line.height); // Dos líneas
+
+    struct stat st;
+    mu_assert_int_eq(0, fstat(pixelFd, &st));
+    size_t size = (size_t)response.stride * response.height;
+    mu_assert_int_eq((int)size, (int)st.st_size);
+
+    unsigned char* pixels = (unsigned char*)mmap(NULL, size, PROT_READ, MAP_SHARED, pixelFd, 0);
+    mu_check(pixels != MAP_FAILED);
+    if (pixels != MAP_FAILED) {
+        size_t inked = 0;
+        for (size_t i = 0; i < size; ++i) if (pixels[i] > 0) inked++;
+        mu_check(inked > 0);
+        mu_check(inked < size); // Hay fondo además de tinta
+        munmap(pixels, size);
+    }
+    close(pixelFd);
+}
+
+MU_TEST(test_glyph_cache_stays_warm_across_requests) {
+    RenderResponse response;
+    int pixelFd = -1;
+    renderClientRequest(clientFd, RENDER_REQ_RENDER, 24, "abcabc", &response, &pixelFd);
+    if (pixelFd >= 0) close(pixelFd);
+    RenderResponse before = get_stats();
+
+    renderClientRequest(clientFd, RENDER_REQ_RENDER, 24, "cabcab", &response, &pixelFd);
+    if (pixelFd >= 0) close(pixelFd);
+    RenderResponse after = get_stats();
+
+    mu_check(after.cacheMisses == before.cacheMisses); // Ningún glifo nuevo
+    mu_check(after.cacheHits > before.cacheHits);
+}
+
+MU_TEST(test_render_counts_each_miss_once) {
+    RenderResponse before = get_stats();
+    RenderResponse response;
+    int pixelFd = -1;
+    renderClientRequest(clientFd, RENDER_REQ_RENDER, 20, "xyz", &response, &pixelFd);
+    if (pixelFd >= 0) close(pixelFd);
+    RenderResponse after = get_stats();
+    mu_check(after.cacheMisses == before.cacheMisses + 3); // La composición no cuenta
+}
+
+MU_TEST(test_empty_render_memfd_is_sealed) {
+    RenderResponse response;
+    int pixelFd = -1;
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_RENDER, 32, "", &response, &pixelFd));
+    mu_check(pixelFd >= 0);
+    mu_assert_int_eq(0, (int)response.width);
+    int seals = fcntl(pixelFd, F_GET_SEALS);
+    mu_check(seals >= 0 && (seals & F_SEAL_GROW) && (seals & F_SEAL_WRITE));
+    close(pixelFd);
+}
+
+MU_TEST(test_pixel_size_out_of_range_is_rejected) {
+    RenderResponse response;
+    mu_assert_int_eq(-4, renderClientRequest(clientFd, RENDER_REQ_MEASURE, RENDER_SERVER_MAX_PIXEL_SIZE + 1, "ok", &response, NULL));
+    mu_assert_int_eq(-4, renderClientRequest(clientFd, RENDER_REQ_RENDER, 1u << 30, "ok", &response, NULL));
+    mu_assert_int_eq(-4, renderClientRequest(clientFd, RENDER_REQ_MEASURE, RENDER_SERVER_MIN_PIXEL_SIZE - 1, "ok", &response, NULL));
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_MEASURE, 0, "ok", &response, NULL)); // 0 = por defecto
+}
+
+static void set_recv_timeout(int fd, int seconds) {
+    struct timeval tv = { seconds, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+MU_TEST(test_stalled_client_does_not_block_others) {
+    int stalled = renderClientConnect(testSocketPath);
+    mu_check(stalled >= 0);
+    if (stalled < 0) return;
+    set_recv_timeout(stalled, 2);
+    set_recv_timeout(clientFd, 2); // Si el servidor se bloquea, el test falla en vez de colgarse
+
+    const char* text = "lento";
+    RenderRequestHeader header = { RENDER_REQ_MEASURE, 32, (uint32_t)strlen(text) };
+    // Media cabecera y se detiene
+    mu_assert_int_eq(6, (int)write(stalled, &header, 6));
+
+    RenderResponse response;
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_MEASURE, 32, "Hola", &response, NULL));
+    mu_assert_int_eq(4, (int)response.glyphCount);
+
+    // Resto de la cabecera y parte del texto: sigue sin bloquear al otro cliente
+    mu_assert_int_eq((int)sizeof(header) - 6, (int)write(stalled, (const char*)&header + 6, sizeof(header) - 6));
+    mu_assert_int_eq(2, (int)write(stalled, text, 2));
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_MEASURE, 32, "ok", &response, NULL));
+
+    // Al completar la petición, el cliente lento recibe su respuesta
+    mu_assert_int_eq(3, (int)write(stalled, text + 2, 3));
+    memset(&response, 0, sizeof(response));
+    mu_assert_int_eq((int)sizeof(response), (int)recv(stalled, &response, sizeof(response), MSG_WAITALL));
+    mu_assert_int_eq(0, response.status);
+    mu_assert_int_eq(5, (int)response.glyphCount);
+    close(stalled);
+}
+
+MU_TEST(test_stats_reports_latency_percentiles) {
+    RenderResponse before = get_stats();
+    RenderResponse response;
+    for (int i = 0; i < 20; ++i) {
+        renderClientRequest(clientFd, RENDER_REQ_MEASURE, 32, "latencia", &response, NULL);
+    }
+    RenderResponse stats = get_stats();
+    mu_check(stats.requestCount == before.requestCount + 20); // STATS no cuenta
+    mu_check(stats.p50LatencyNs > 0);
+    mu_check(stats.p50LatencyNs <= stats.p99LatencyNs);
+}
+
+MU_TEST(test_unknown_request_type_is_rejected) {
+    RenderResponse response;
+    mu_check(renderClientRequest(clientFd, (RenderRequestType)99, 0, NULL, &response, NULL) != 0);
+    // La conexión sigue siendo válida tras el error
+    mu_assert_int_eq(0, renderClientRequest(clientFd, RENDER_REQ_MEASURE, 32, "ok", &response, NULL));
+}
+
+MU_TEST_SUITE(render_server_suite) {
+    MU_RUN_TEST(test_measure_returns_layout_without_pixels);
+    MU_RUN_TEST(test_render_returns_pixels_in_memfd);
+    MU_RUN_TEST(test_glyph_cache_stays_warm_across_requests);
+    MU_RUN_TEST(test_render_counts_each_miss_once);
+    MU_RUN_TEST(test_empty_render_memfd_is_sealed);
+    MU_RUN_TEST(test_pixel_size_out_of_range_is_rejected);
+    MU_RUN_TEST(test_stalled_client_does_not_block_others);
+    MU_RUN_TEST(test_stats_reports_latency_percentiles);
+    MU_RUN_TEST(test_unknown_request_type_is_rejected);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    if (start_test_server() != 0) {
+        fprintf(stderr, "ERROR_SETUP_RENDER_SERVER_TESTS: No se pudo iniciar el servidor con '%s'.\n", testFontPathForServer);
+        return 1;
+    }
+    MU_RUN_SUITE(render_server_suite);
+    MU_REPORT();
+    stop_test_server();
+    return MU_EXIT_CODE;
+}
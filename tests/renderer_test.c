@@ -193,6 +193,110 @@ MU_TEST(test_multiple_wraps) {
 }
 
 
+// Mock with glyph indices (= codepoint) so the pair table applies
+MinimalGlyphInfo mock_get_glyph_metrics_indexed(FT_ULong codepoint) {
+    MinimalGlyphInfo info = mock_get_glyph_metrics(codepoint);
+    info.glyphIndex = (unsigned int)codepoint;
+    return info;
+}
+
+MU_TEST(test_kerning_moves_pen_and_wrap) {
+    printf("Running test_kerning_moves_pen_and_wrap...\n");
+    KerningTable kerning;
+    memset(&kerning, 0, sizeof(kerning));
+    mu_check(kerningTableSet(&kerning, 'A', 'V', -20.0f) == 0);  // -0.06 scaled
+    mu_check(kerningTableSet(&kerning, '6', '7', -100.0f) == 0); // -0.3 scaled: '7' fits on the first line
+
+    TextLayoutInfo layout = calculateTextLayoutKerned("AVA", 1, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                                      TEST_LINE_HEIGHT, mock_get_glyph_metrics_indexed, &kerning);
+    mu_check(floats_are_close(layout.cursor_pos.x, TEST_START_X + MOCK_ADVANCE_X_SCALED - 20.0f * TEST_SCALE));
+    layout = calculateTextLayoutKerned("AVA", 3, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                       TEST_LINE_HEIGHT, mock_get_glyph_metrics_indexed, &kerning);
+    mu_check(fabs(layout.cursor_pos.x - (TEST_START_X + 3 * MOCK_ADVANCE_X_SCALED - 20.0f * TEST_SCALE)) < 1e-5);
+
+    // Without a table (or without glyph indices) only the advances count
+    layout = calculateTextLayoutKerned("AVA", 1, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                       TEST_LINE_HEIGHT, mock_get_glyph_metrics_indexed, NULL);
+    mu_check(floats_are_close(layout.cursor_pos.x, TEST_START_X + MOCK_ADVANCE_X_SCALED));
+    layout = calculateTextLayoutKerned("AVA", 1, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                       TEST_LINE_HEIGHT, mock_get_glyph_metrics, &kerning);
+    mu_check(floats_are_close(layout.cursor_pos.x, TEST_START_X + MOCK_ADVANCE_X_SCALED));
+
+    // The wrap check includes the pair: '7' no longer wraps (see test_simple_wrap)
+    layout = calculateTextLayoutKerned("1234567", 6, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                       TEST_LINE_HEIGHT, mock_get_glyph_metrics_indexed, &kerning);
+    mu_check(fabs(layout.cursor_pos.x - (TEST_START_X + 5 * MOCK_ADVANCE_X_SCALED)) < 1e-5);
+    mu_check(floats_are_close(layout.cursor_pos.y, TEST_START_Y));
+    freeKerningTable(&kerning);
+}
+
+MU_TEST(test_shaped_layout_clusters) {
+    printf("Running test_shaped_layout_clusters...\n");
+    // "ffi12345e" + U+0301: an "ffi" ligature, then a glyph the font lacks
+    // ('1', glyphIndex 0) and 'e' with a combining mark in its cluster
+    const char* text = "ffi12345e\xCC\x81";
+    const float advance = MOCK_ADVANCE_X_SCALED / TEST_SCALE;
+    ShapedGlyph glyphs[] = {
+        { 500, 'f', 0, advance, 0.0f, 0.0f },
+        { 0,   '1', 3, 0.0f,    0.0f, 0.0f }, // Advance from get_glyph_metrics
+        { 12,  '2', 4, advance, 0.0f, 0.0f },
+        { 13,  '3', 5, advance, 0.0f, 0.0f },
+        { 14,  '4', 6, advance, 0.0f, 0.0f },
+        { 15,  '5', 7, advance, 0.0f, 0.0f },
+        { 70,  'e', 8, advance, 0.0f, 0.0f },
+        { 900, 0x301, 8, 0.0f,  -2.0f, 5.0f },
+    };
+    ShapedText shaped = { glyphs, 8, 8 };
+
+    // Inside the ligature: the cursor sits on the whole cluster
+    TextLayoutInfo layout = calculateTextLayoutShaped(text, 1, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                                      TEST_LINE_HEIGHT, &shaped, mock_get_glyph_metrics);
+    mu_check(layout.cursor_is_over_char == 1);
+    mu_check(layout.cursor_cluster_byte == 0);
+    mu_check(layout.glyph_info_under_cursor.glyphIndex == 500);
+    mu_check(floats_are_close(layout.cursor_pos.x, TEST_START_X));
+
+    // Six glyphs fill the line (as in test_simple_wrap): 'e' and its mark wrap together
+    layout = calculateTextLayoutShaped(text, 9, TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                       TEST_LINE_HEIGHT, &shaped, mock_get_glyph_metrics);
+    mu_check(layout.cursor_cluster_byte == 8);
+    mu_check(layout.codepoint_under_cursor == 'e');
+    mu_check(floats_are_close(layout.cursor_pos.x, TEST_START_X));
+    mu_check(floats_are_close(layout.cursor_pos.y, TEST_START_Y - TEST_LINE_HEIGHT));
+
+    layout = calculateTextLayoutShaped(text, strlen(text), TEST_START_X, TEST_START_Y, TEST_SCALE, TEST_MAX_LINE_WIDTH,
+                                       TEST_LINE_HEIGHT, &shaped, mock_get_glyph_metrics);
+    mu_check(layout.cursor_is_over_char == 0);
+    mu_check(floats_are_close(layout.cursor_pos.x, TEST_START_X + MOCK_ADVANCE_X_SCALED));
+    mu_check(floats_are_close(layout.cursor_pos.y, TEST_START_Y - TEST_LINE_HEIGHT));
+}
+
+// Longer than one decode chunk (256 bytes), with a 2-byte character across
+// the boundary: offsets keep counting from the start of the text
+MU_TEST(test_layout_across_decode_chunks) {
+    printf("Running test_layout_across_decode_chunks...\n");
+    char text[1 + 2 * 200 + 1];
+    text[0] = 'a';
+    for (int i = 0; i < 200; ++i) memcpy(text + 1 + 2 * i, "\xC3\xA9", 2); // é
+    text[sizeof(text) - 1] = '\0';
+    const float wide = 1000.0f; // No wrapping
+
+    TextLayoutInfo layout = calculateTextLayout(text, 1 + 2 * 150, TEST_START_X, TEST_START_Y, TEST_SCALE, wide,
+                                                TEST_LINE_HEIGHT, mock_get_glyph_metrics);
+    mu_check(layout.cursor_is_over_char == 1);
+    mu_check(layout.codepoint_under_cursor == 0xE9);
+    mu_check(fabs(layout.cursor_pos.x - (TEST_START_X + 151 * MOCK_ADVANCE_X_SCALED)) < 1e-3);
+
+    layout = calculateTextLayout(text, 256, TEST_START_X, TEST_START_Y, TEST_SCALE, wide, TEST_LINE_HEIGHT,
+                                 mock_get_glyph_metrics); // Second byte of an é: not a character start
+    mu_check(layout.cursor_is_over_char == 0);
+
+    layout = calculateTextLayout(text, strlen(text), TEST_START_X, TEST_START_Y, TEST_SCALE, wide, TEST_LINE_HEIGHT,
+                                 mock_get_glyph_metrics);
+    mu_check(layout.cursor_is_over_char == 0);
+    mu_check(fabs(layout.cursor_pos.x - (TEST_START_X + 201 * MOCK_ADVANCE_X_SCALED)) < 1e-3);
+}
+
 // --- Test Suite Setup ---
 MU_TEST_SUITE(renderer_layout_test_suite) {
     MU_RUN_TEST(test_empty_string);
@@ -204,6 +308,9 @@ MU_TEST_SUITE(renderer_layout_test_suite) {
     MU_RUN_TEST(test_cursor_at_wrap_point_after_char_that_causes_wrap);
     MU_RUN_TEST(test_cursor_at_end_of_wrapped_line);
     MU_RUN_TEST(test_multiple_wraps);
+    MU_RUN_TEST(test_kerning_moves_pen_and_wrap);
+    MU_RUN_TEST(test_shaped_layout_clusters);
+    MU_RUN_TEST(test_layout_across_decode_chunks);
 }
 
 // --- Main function to run tests ---
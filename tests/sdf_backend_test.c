@@ -0,0 +1,255 @@
+#include "minunit.h"
+#include "sdf_backend.h"
+#include "sdf_generator.h" // free_sdf_bitmap
+#include "config.h"        // GLYPH_LOAD_PIXEL_SIZE
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* backendTestFontPath = "tests/fonts/test_font.ttf";
+#define BACKEND_TEST_PADDING 4
+#define BACKEND_TEST_SPREAD 2.0f
+#define BACKEND_TEST_REFERENCE_PX 192 // Cobertura de FreeType contra la que se compara
+
+static FT_Library library;
+static FT_Face face;
+
+static int open_face(void) {
+    if (FT_Init_FreeType(&library) != 0) return -1;
+    if (FT_New_Face(library, backendTestFontPath, 0, &face) != 0) {
+        FT_Done_FreeType(library);
+        return -1;
+    }
+    return 0;
+}
+
+static void close_face(void) {
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+// Deja el slot como lo deja glyph_manager antes de pedir el SDF
+static int load_glyph(FT_ULong c, FT_UInt* outIndex) {
+    *outIndex = FT_Get_Char_Index(face, c);
+    FT_Set_Pixel_Sizes(face, 0, GLYPH_LOAD_PIXEL_SIZE);
+    return FT_Load_Glyph(face, *outIndex, FT_LOAD_NO_HINTING);
+}
+
+static float median3(float r, float g, float b) {
+    return fmaxf(fminf(r, g), fminf(fmaxf(r, g), b));
+}
+
+static float sample_bilinear(const SdfGlyphImage* s, float tx, float ty) {
+    float x = tx - 0.5f, y = ty - 0.5f;
+    int x0 = (int)floorf(x), y0 = (int)floorf(y);
+    float fx = x - x0, fy = y - y0;
+    float filtered[3];
+    for (int ch = 0; ch < s->channels; ++ch) {
+        float v[2][2];
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                int xi = x0 + dx, yi = y0 + dy;
+                xi = xi < 0 ? 0 : (xi >= s->width ? s->width - 1 : xi);
+                yi = yi < 0 ? 0 : (yi >= s->height ? s->height - 1 : yi);
+                v[dy][dx] = s->data[(yi * s->width + xi) * s->channels + ch];
+            }
+        }
+        filtered[ch] = (v[0][0] * (1 - fx) + v[0][1] * fx) * (1 - fy) + (v[1][0] * (1 - fx) + v[1][1] * fx) * fy;
+    }
+    return s->channels == 3 ? median3(filtered[0], filtered[1], filtered[2]) : filtered[0];
+}
+
+// Error absoluto medio de cobertura al reconstruir el glifo a
+// BACKEND_TEST_REFERENCE_PX desde el SDF (rampa de 1 px en el borde). Si el
+// backend no respetara el contrato (polaridad, padding, left/top, texelSize),
+// la reconstrucción quedaría desplazada o invertida y el error se dispararía.
+static double reconstruction_error(const SdfGlyphImage* s, FT_ULong c) {
+    FT_Set_Pixel_Sizes(face, 0, BACKEND_TEST_REFERENCE_PX);
+    if (FT_Load_Char(face, c, FT_LOAD_NO_HINTING | FT_LOAD_RENDER) != 0) return 1.0;
+    const FT_Bitmap* ref = &face->glyph->bitmap;
+    float texelsPerRefPx = (float)GLYPH_LOAD_PIXEL_SIZE / BACKEND_TEST_REFERENCE_PX / s->texelSize;
+    double total = 0.0;
+    for (int v = 0; v < (int)ref->rows; ++v) {
+        for (int u = 0; u < (int)ref->width; ++u) {
+            float refX = (float)face->glyph->bitmap_left + u + 0.5f, refY = (float)face->glyph->bitmap_top - v - 0.5f;
+            float tx = refX * texelsPerRefPx - (float)(s->left - s->padding);
+            float ty = (float)(s->top + s->padding) - refY * texelsPerRefPx;
+            float distance = (sample_bilinear(s, tx, ty) / 255.0f * 2.0f - 1.0f) * BACKEND_TEST_SPREAD / texelsPerRefPx;
+            float alpha = 0.5f - distance;
+            alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+            total += fabsf(alpha - ref->buffer[v * ref->pitch + u] / 255.0f);
+        }
+    }
+    return total / ((double)ref->width * ref->rows);
+}
+
+MU_TEST(test_backend_names_round_trip) {
+    for (int i = 0; i < SDF_BACKEND_COUNT; ++i) {
+        SdfBackend parsed = SDF_BACKEND_COUNT;
+        mu_assert_int_eq(0, sdfBackendFromName(sdfBackendName((SdfBackend)i), &parsed));
+        mu_assert_int_eq(i, (int)parsed);
+    }
+    SdfBackend untouched = SDF_BACKEND_MSDF;
+    mu_assert_int_eq(-1, sdfBackendFromName("edt", &untouched));
+    mu_assert_int_eq(-1, sdfBackendFromName(NULL, &untouched));
+    mu_assert_int_eq(SDF_BACKEND_MSDF, (int)untouched);
+}
+
+MU_TEST(test_every_backend_honours_contract) {
+    if (open_face() != 0) {
+        mu_fail("No se pudo abrir la fuente de prueba.");
+        return;
+    }
+    for (int b = 0; b < SDF_BACKEND_COUNT; ++b) {
+        FT_UInt index;
+        mu_assert_int_eq(0, load_glyph('H', &index));
+        SdfGlyphImage img;
+        int status = generateGlyphSdf((SdfBackend)b, face, index, BACKEND_TEST_PADDING, BACKEND_TEST_SPREAD, &img);
+        if (status != 0) {
+            fprintf(stderr, "Backend %s sin SDF\n", sdfBackendName((SdfBackend)b));
+            mu_fail("Un backend no generó el SDF de 'H'.");
+            continue;
+        }
+        // La cara vuelve siempre a GLYPH_LOAD_PIXEL_SIZE
+        mu_assert_int_eq(GLYPH_LOAD_PIXEL_SIZE, face->size->metrics.y_ppem);
+        mu_assert_int_eq(b == SDF_BACKEND_MSDF ? 3 : 1, img.channels);
+        mu_check(img.width > 2 * BACKEND_TEST_PADDING && img.height > 2 * BACKEND_TEST_PADDING);
+        for (int ch = 0; ch < img.channels; ++ch) mu_assert_int_eq(255, img.data[ch]); // Esquina: exterior saturado
+
+        double error = reconstruction_error(&img, 'H');
+        printf("  %-9s %3dx%-3d texel %.2fpx  error %.4f\n", sdfBackendName((SdfBackend)b),
+               img.width, img.height, img.texelSize, error);
+        // El umbral a 128 es el único que no usa la cobertura ni el contorno: escalonado
+        mu_check(error < (b == SDF_BACKEND_THRESHOLD ? 0.08 : 0.03));
+        free_sdf_bitmap(img.data);
+    }
+    close_face();
+}
+
+MU_TEST(test_every_backend_honours_requested_size) {
+    if (open_face() != 0) {
+        mu_fail("No se pudo abrir la fuente de prueba.");
+        return;
+    }
+    static const int sizes[] = { 16, 64 };
+    for (int b = 0; b < SDF_BACKEND_COUNT; ++b) {
+        int previousWidth = 0;
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+            FT_UInt index;
+            mu_assert_int_eq(0, load_glyph('H', &index));
+            SdfGlyphImage img;
+            mu_assert_int_eq(0, generateGlyphSdfAtSize((SdfBackend)b, face, index, sizes[i], BACKEND_TEST_PADDING,
+                                                       BACKEND_TEST_SPREAD, &img));
+            mu_check(fabsf(img.texelSize - (float)GLYPH_LOAD_PIXEL_SIZE / sizes[i]) < 1e-6f);
+            mu_check(img.width > previousWidth);
+            previousWidth = img.width;
+            double error = reconstruction_error(&img, 'H');
+            // Más resolución, menos error; el umbral a 128 va aparte (escalonado)
+            double maxError = sizes[i] < GLYPH_LOAD_PIXEL_SIZE ? 0.04 : 0.01;
+            if (b == SDF_BACKEND_THRESHOLD) maxError *= 5.0;
+            mu_check(error < maxError);
+            free_sdf_bitmap(img.data);
+        }
+    }
+    close_face();
+}
+
+MU_TEST(test_trim_keeps_one_saturated_ring) {
+    // 8x6 saturado con un texel interior en (3, 2)
+    unsigned char* data = (unsigned char*)malloc(8 * 6);
+    memset(data, 255, 8 * 6);
+    data[2 * 8 + 3] = 0;
+    SdfGlyphImage img = { data, 8, 6, 10, 20, 4, 1, 1.0f };
+    mu_assert_int_eq(8 * 6 - 3 * 3, trimSdfImage(&img));
+    mu_assert_int_eq(3, img.width);
+    mu_assert_int_eq(3, img.height);
+    mu_assert_int_eq(12, img.left); // Dos columnas menos a la izquierda
+    mu_assert_int_eq(19, img.top);  // Una fila menos arriba
+    mu_assert_int_eq(4, img.padding);
+    mu_assert_int_eq(0, img.data[1 * 3 + 1]);
+    mu_assert_int_eq(255, img.data[0]);
+    mu_assert_int_eq(0, trimSdfImage(&img)); // Ya no queda nada que quitar
+    free(data);
+
+    // Todo exterior: se deja tal cual
+    unsigned char empty[4 * 4];
+    memset(empty, 255, sizeof(empty));
+    SdfGlyphImage blank = { empty, 4, 4, 0, 0, 1, 1, 1.0f };
+    mu_assert_int_eq(0, trimSdfImage(&blank));
+    mu_assert_int_eq(4, blank.width);
+}
+
+// Con el padding derivado del spread y el recorte, menos texels que con el
+// padding fijo de 4 y la misma reconstrucción
+MU_TEST(test_derived_padding_and_trim_save_texels) {
+    if (open_face() != 0) {
+        mu_fail("No se pudo abrir la fuente de prueba.");
+        return;
+    }
+    const char* charset = "AaBgQRe@&%8sw.,-";
+    int padding = sdfPaddingForSpread(BACKEND_TEST_SPREAD);
+    mu_assert_int_eq(3, padding);
+    for (int b = 0; b < SDF_BACKEND_COUNT; ++b) {
+        long fixedTexels = 0, trimmedTexels = 0;
+        double fixedError = 0.0, trimmedError = 0.0;
+        for (const char* c = charset; *c; ++c) {
+            FT_UInt index;
+            SdfGlyphImage fixed, trimmed;
+            mu_assert_int_eq(0, load_glyph((FT_ULong)*c, &index));
+            mu_assert_int_eq(0, generateGlyphSdf((SdfBackend)b, face, index, 4, BACKEND_TEST_SPREAD, &fixed));
+            mu_assert_int_eq(0, load_glyph((FT_ULong)*c, &index));
+            mu_assert_int_eq(0, generateGlyphSdf((SdfBackend)b, face, index, padding, BACKEND_TEST_SPREAD, &trimmed));
+            trimSdfImage(&trimmed);
+            // El borde sigue saturado
+            for (int ch = 0; ch < trimmed.channels; ++ch) {
+                mu_assert_int_eq(255, trimmed.data[ch]);
+                mu_assert_int_eq(255, trimmed.data[(trimmed.width * trimmed.height - 1) * trimmed.channels + ch]);
+            }
+            fixedTexels += (long)fixed.width * fixed.height;
+            trimmedTexels += (long)trimmed.width * trimmed.height;
+            fixedError += reconstruction_error(&fixed, (FT_ULong)*c);
+            trimmedError += reconstruction_error(&trimmed, (FT_ULong)*c);
+            free_sdf_bitmap(fixed.data);
+            free_sdf_bitmap(trimmed.data);
+        }
+        printf("  %-9s texels %6ld -> %6ld (%.1f%%)  error %.4f -> %.4f\n", sdfBackendName((SdfBackend)b),
+               fixedTexels, trimmedTexels, 100.0 * (fixedTexels - trimmedTexels) / fixedTexels,
+               fixedError / strlen(charset), trimmedError / strlen(charset));
+        mu_check(trimmedTexels < fixedTexels);
+        mu_check(fabs(trimmedError - fixedError) / strlen(charset) < 1e-3);
+    }
+    close_face();
+}
+
+MU_TEST(test_space_has_no_sdf) {
+    if (open_face() != 0) {
+        mu_fail("No se pudo abrir la fuente de prueba.");
+        return;
+    }
+    for (int b = 0; b < SDF_BACKEND_COUNT; ++b) {
+        FT_UInt index;
+        mu_assert_int_eq(0, load_glyph(' ', &index));
+        SdfGlyphImage img;
+        mu_assert_int_eq(-1, generateGlyphSdf((SdfBackend)b, face, index, BACKEND_TEST_PADDING, BACKEND_TEST_SPREAD, &img));
+        mu_check(img.data == NULL);
+    }
+    close_face();
+}
+
+MU_TEST_SUITE(sdf_backend_tests) {
+    MU_RUN_TEST(test_backend_names_round_trip);
+    MU_RUN_TEST(test_every_backend_honours_contract);
+    MU_RUN_TEST(test_every_backend_honours_requested_size);
+    MU_RUN_TEST(test_trim_keeps_one_saturated_ring);
+    MU_RUN_TEST(test_derived_padding_and_trim_save_texels);
+    MU_RUN_TEST(test_space_has_no_sdf);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(sdf_backend_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
@@ -2,7 +2,19 @@
 #include "tessellation_handler.h" // For Point2D, ContourC, TessellationResult
 #include "freetype_handler.h"   // For OutlineDataC and its helpers
 #include <stdlib.h>
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
+
+// Este test se enlaza con -Wl,--wrap=malloc,--wrap=realloc,--wrap=calloc
+// (ver Makefile): cuenta las peticiones al sistema de nuestro código y de libtess2.
+static size_t mallocCalls = 0;
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __wrap_malloc(size_t size) { mallocCalls++; return __real_malloc(size); }
+void* __wrap_realloc(void* ptr, size_t size) { mallocCalls++; return __real_realloc(ptr, size); }
+void* __wrap_calloc(size_t n, size_t size) { mallocCalls++; return __real_calloc(n, size); }
 
 // Note: FT_Library and FT_Face are not directly used here but freetype_handler.h
 // is needed for OutlineDataC structure. If tests were to build real OutlineDataC
@@ -12,12 +24,9 @@
 static OutlineDataC create_test_outline_data(Point2D* points, int point_count) {
     OutlineDataC outline;
     initOutlineData(&outline, 1); // Initialize with capacity for 1 contour
-    ContourC* contour = &outline.contours[outline.count++]; // Manually get and increment
-                                                          // This is a simplified way, addContourToOutline is better
-                                                          // but requires more setup.
-    initContour(contour, point_count);
+    beginOutlineContour(&outline);
     for(int i=0; i < point_count; ++i) {
-        addPointToContour(contour, points[i]);
+        addOutlinePoint(&outline, points[i]);
     }
     return outline;
 }
@@ -74,11 +83,132 @@ MU_TEST(test_triangle_tessellation) {
     freeOutlineData(&outline);
 }
 
+MU_TEST(test_reset_reuses_outline_buffers) {
+    Point2D square_points[] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+    Point2D hole_points[] = {{0.25f, 0.25f}, {0.75f, 0.25f}, {0.75f, 0.75f}, {0.25f, 0.75f}};
+    OutlineDataC outline = create_test_outline_data(square_points, 4);
+    beginOutlineContour(&outline);
+    for (int i = 0; i < 4; ++i) addOutlinePoint(&outline, hole_points[i]);
+
+    // Dos contornos contiguos en el mismo buffer
+    mu_assert_int_eq(8, (int)outline.pointCount);
+    mu_assert_int_eq(4, (int)outline.contours[1].start);
+    mu_check(outlineContourPoints(&outline, &outline.contours[1])[0].x == 0.25f);
+
+    TessellationResult result = generateGlyphTessellation(&outline);
+    mu_assert_int_eq(8, result.elementCount); // Cuadrado con agujero
+    free(result.vertices);
+    free(result.elements);
+
+    Point2D* pointsBefore = outline.points;
+    size_t capacityBefore = outline.pointCapacity;
+    resetOutlineData(&outline);
+    mu_assert_int_eq(0, (int)outline.count);
+    mu_assert_int_eq(0, (int)outline.pointCount);
+    beginOutlineContour(&outline);
+    for (int i = 0; i < 4; ++i) addOutlinePoint(&outline, square_points[i]);
+    mu_check(outline.points == pointsBefore); // Sin realloc al reutilizar
+    mu_check(outline.pointCapacity == capacityBefore);
+    mu_assert_int_eq(0, (int)outline.contours[0].start);
+
+    result = generateGlyphTessellation(&outline);
+    mu_assert_int_eq(2, result.elementCount);
+    free(result.vertices);
+    free(result.elements);
+    freeOutlineData(&outline);
+}
+// Estrella de 5 puntas autointersecante: obliga a libtess2 a crear vértices
+static void build_star_outline(OutlineDataC* outline, float radius) {
+    resetOutlineData(outline);
+    beginOutlineContour(outline);
+    for (int i = 0; i < 5; ++i) {
+        int k = (i * 2) % 5;
+        float angle = 1.5707963f + (float)k * 1.2566371f;
+        addOutlinePoint(outline, (Point2D){ radius * cosf(angle), radius * sinf(angle) });
+    }
+}
+
+static void build_square_with_hole(OutlineDataC* outline, float size) {
+    Point2D outer[] = {{0.0f, 0.0f}, {size, 0.0f}, {size, size}, {0.0f, size}};
+    Point2D inner[] = {{size * 0.25f, size * 0.25f}, {size * 0.75f, size * 0.25f},
+                       {size * 0.75f, size * 0.75f}, {size * 0.25f, size * 0.75f}};
+    resetOutlineData(outline);
+    beginOutlineContour(outline);
+    for (int i = 0; i < 4; ++i) addOutlinePoint(outline, outer[i]);
+    beginOutlineContour(outline);
+    for (int i = 0; i < 4; ++i) addOutlinePoint(outline, inner[i]);
+}
+
+MU_TEST(test_context_matches_one_shot_tessellation) {
+    TessellationContext ctx;
+    mu_assert_int_eq(0, initTessellationContext(&ctx, 0));
+    OutlineDataC outline;
+    initOutlineData(&outline, 2);
+    TESSreal vertices[256];
+    TESSindex indices[384];
+    GlyphMeshBuffer mesh = { vertices, 128, indices, 384, 0, 0 };
+
+    build_square_with_hole(&outline, 1.0f);
+    size_t mallocsBefore = mallocCalls;
+    TessellationResult reference = generateGlyphTessellation(&outline);
+    mu_check(mallocCalls > mallocsBefore); // El contador ve los mallocs de la ruta clásica
+    mu_assert_int_eq(TESS_CONTEXT_OK, tessellateOutlineInto(&ctx, &outline, &mesh));
+    mu_assert_int_eq(reference.vertexCount, mesh.vertexCount);
+    mu_assert_int_eq(reference.elementCount * 3, mesh.indexCount);
+    mu_check(memcmp(reference.vertices, vertices, (size_t)mesh.vertexCount * 2 * sizeof(TESSreal)) == 0);
+    mu_check(memcmp(reference.elements, indices, (size_t)mesh.indexCount * sizeof(TESSindex)) == 0);
+    free(reference.vertices);
+    free(reference.elements);
+
+    // Buffer insuficiente: informa del tamaño necesario sin escribir
+    GlyphMeshBuffer tiny = { vertices, 2, indices, 3, 0, 0 };
+    mu_assert_int_eq(TESS_CONTEXT_BUFFER_TOO_SMALL, tessellateOutlineInto(&ctx, &outline, &tiny));
+    mu_assert_int_eq(8, tiny.vertexCount);
+
+    freeOutlineData(&outline);
+    freeTessellationContext(&ctx);
+}
+
+MU_TEST(test_context_does_no_mallocs_per_glyph) {
+    TessellationContext ctx;
+    mu_assert_int_eq(0, initTessellationContext(&ctx, 0));
+    OutlineDataC outline;
+    initOutlineData(&outline, 2);
+    TESSreal vertices[256];
+    TESSindex indices[384];
+    GlyphMeshBuffer mesh = { vertices, 128, indices, 384, 0, 0 };
+
+    // Calentamiento: la arena y el outline alcanzan su tamaño de régimen
+    build_star_outline(&outline, 10.0f);
+    mu_assert_int_eq(TESS_CONTEXT_OK, tessellateOutlineInto(&ctx, &outline, &mesh));
+    build_square_with_hole(&outline, 10.0f);
+    mu_assert_int_eq(TESS_CONTEXT_OK, tessellateOutlineInto(&ctx, &outline, &mesh));
+
+    size_t mallocsBefore = mallocCalls;
+    size_t chunksBefore = ctx.arena.backingAllocations;
+    size_t requestsBefore = ctx.arena.requests;
+    int failures = 0;
+    for (int i = 0; i < 200; ++i) {
+        if (i % 2) build_star_outline(&outline, 5.0f + (float)i);
+        else build_square_with_hole(&outline, 5.0f + (float)i);
+        if (tessellateOutlineInto(&ctx, &outline, &mesh) != TESS_CONTEXT_OK || mesh.indexCount == 0) failures++;
+    }
+    mu_assert_int_eq(0, failures);
+    mu_assert_int_eq(0, (int)(mallocCalls - mallocsBefore));
+    mu_assert_int_eq((int)chunksBefore, (int)ctx.arena.backingAllocations);
+    mu_check(ctx.arena.requests > requestsBefore); // libtess2 sí pasa por la arena
+
+    freeOutlineData(&outline);
+    freeTessellationContext(&ctx);
+}
 
 MU_TEST_SUITE(tessellation_tests) {
     MU_RUN_TEST(test_null_tessellation);
     MU_RUN_TEST(test_square_tessellation);
     MU_RUN_TEST(test_triangle_tessellation);
+    MU_RUN_TEST(test_reset_reuses_outline_buffers);
+    MU_RUN_TEST(test_context_matches_one_shot_tessellation);
+    MU_RUN_TEST(test_context_does_no_mallocs_per_glyph);
 }
 
 int main(int argc, char *argv[]) {
@@ -34,6 +34,7 @@ void renderText(GLuint program, const char* text, size_t cursorBytePos) { // Mod
     (void)program; (void)text; (void)cursorBytePos; /* Dummy */
 }
 void cleanupGlyphCache() { /* Dummy */ }
+void cleanupTextShaper(void) { /* Dummy */ }
 void cleanupOpenGL(GLuint program) { (void)program; /* Dummy */ }
 void cleanupFreeType() { /* Dummy */ }
 
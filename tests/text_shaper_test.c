@@ -0,0 +1,176 @@
+#include "minunit.h"
+#include "text_shaper.h"
+#include "kerning.h"
+#include FT_ADVANCES_H
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* shaperTestFontPath = "tests/fonts/test_font.ttf";
+static FT_Library library;
+static FT_Face face;
+
+static void shaper_setup(void) {
+    FT_Init_FreeType(&library);
+    FT_New_Face(library, shaperTestFontPath, 0, &face);
+    buildKerningTable(face, 48, &fontKerningTable);
+    initTextShaper(face, 48);
+    shapeCacheEnabled = 1;
+}
+
+static void shaper_teardown(void) {
+    cleanupTextShaper();
+    freeKerningTable(&fontKerningTable);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+static int sameShapedText(const ShapedText* a, const ShapedText* b) {
+    if (a->count != b->count) return 0;
+    for (int i = 0; i < a->count; ++i) {
+        const ShapedGlyph* x = &a->glyphs[i];
+        const ShapedGlyph* y = &b->glyphs[i];
+        if (x->glyphIndex != y->glyphIndex || x->codepoint != y->codepoint || x->cluster != y->cluster ||
+            x->advanceX != y->advanceX || x->offsetX != y->offsetX || x->offsetY != y->offsetY) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Un glifo por carácter, clusters en bytes, y (sin HarfBuzz) avance de FreeType más el kerning del par
+MU_TEST(test_shape_glyphs_clusters_and_kerning) {
+    mu_check(textShaperReady());
+    const char* text = "AVA añ";
+    ShapedText shaped = {0};
+    mu_assert_int_eq(0, shapeText(text, strlen(text), &shaped));
+    mu_assert_int_eq(6, shaped.count);
+    const uint32_t clusters[] = { 0, 1, 2, 3, 4, 5 };
+    const FT_ULong codepoints[] = { 'A', 'V', 'A', ' ', 'a', 0xF1 };
+    for (int i = 0; i < 6; ++i) {
+        mu_assert_int_eq((int)clusters[i], (int)shaped.glyphs[i].cluster);
+        mu_assert_int_eq((int)codepoints[i], (int)shaped.glyphs[i].codepoint);
+        mu_assert_int_eq((int)FT_Get_Char_Index(face, codepoints[i]), (int)shaped.glyphs[i].glyphIndex);
+    }
+
+    if (!textShaperHasHarfBuzz()) {
+        for (int i = 0; i < 6; ++i) {
+            FT_Fixed advance;
+            mu_assert_int_eq(0, FT_Get_Advance(face, shaped.glyphs[i].glyphIndex, FT_LOAD_DEFAULT, &advance));
+            float expected = (float)advance / 65536.0f;
+            // El kerning no cruza espacios (cada palabra se forma por separado)
+            if (i + 1 < 6 && i != 2 && i != 3) {
+                expected += kerningLookup(&fontKerningTable, shaped.glyphs[i].glyphIndex, shaped.glyphs[i + 1].glyphIndex);
+            }
+            mu_check(fabsf(shaped.glyphs[i].advanceX - expected) < 1e-4f);
+        }
+    }
+    // A-V se acerca
+    FT_Fixed plainA;
+    FT_Get_Advance(face, shaped.glyphs[0].glyphIndex, FT_LOAD_DEFAULT, &plainA);
+    mu_check(shaped.glyphs[0].advanceX < (float)plainA / 65536.0f - 1.0f);
+
+    // Un codepoint que no está en la fuente: glifo 0, el renderer lo busca por codepoint
+    const char* missing = "\xE0\xA4\x95"; // U+0915 (devanagari, no está en la fuente de test)
+    mu_assert_int_eq(0, shapeText(missing, strlen(missing), &shaped));
+    mu_check(shaped.count >= 1);
+    mu_assert_int_eq(0, (int)shaped.glyphs[0].glyphIndex);
+    mu_assert_int_eq(0x915, (int)shaped.glyphs[0].codepoint);
+    freeShapedText(&shaped);
+}
+
+// Las palabras repetidas salen de la caché con el mismo resultado que sin ella
+MU_TEST(test_word_cache_hits_and_matches_uncached) {
+    const char* text = "the cat and the cat and the hat";
+    clearShapeCache();
+    ShapeCacheStats before = getShapeCacheStats();
+    ShapedText cached = {0};
+    mu_assert_int_eq(0, shapeText(text, strlen(text), &cached));
+    ShapeCacheStats after = getShapeCacheStats();
+    // Palabras: the cat and the cat and the hat + 7 espacios = 15; distintas: the, cat, and, hat, ' '
+    mu_assert_int_eq(5, (int)(after.misses - before.misses));
+    mu_assert_int_eq(10, (int)(after.hits - before.hits));
+    mu_assert_int_eq(5, after.words);
+
+    // Los clusters se desplazan con la posición de cada aparición
+    mu_assert_int_eq(12, (int)cached.glyphs[12].cluster); // La segunda "the"
+    mu_assert_int_eq('t', (int)cached.glyphs[12].codepoint);
+
+    shapeCacheEnabled = 0;
+    ShapedText uncached = {0};
+    mu_assert_int_eq(0, shapeText(text, strlen(text), &uncached));
+    shapeCacheEnabled = 1;
+    mu_check(sameShapedText(&cached, &uncached));
+
+    // Segunda pasada con la caché llena: todo aciertos
+    before = getShapeCacheStats();
+    mu_assert_int_eq(0, shapeText(text, strlen(text), &cached));
+    after = getShapeCacheStats();
+    mu_assert_int_eq(0, (int)(after.misses - before.misses));
+    mu_check(sameShapedText(&cached, &uncached));
+
+    freeShapedText(&cached);
+    freeShapedText(&uncached);
+}
+
+// Otros módulos cambian el tamaño de la cara (niveles de SDF): el shaper lo restablece
+MU_TEST(test_shape_after_face_size_change) {
+    const char* text = "\xD8\xB3\xD9\x84\xD8\xA7\xD9\x85 Wave"; // "سلام Wave"
+    ShapedText first = {0}, second = {0};
+    mu_assert_int_eq(0, shapeText(text, strlen(text), &first));
+    mu_check(first.count >= 4);
+    for (int i = 0; i < first.count; ++i) mu_check(first.glyphs[i].glyphIndex != 0); // La fuente tiene árabe
+    mu_assert_int_eq(12, (int)first.glyphs[first.count - 1].cluster); // La 'e' de Wave: 8 bytes de árabe, el espacio y "Wav"
+
+    FT_Set_Pixel_Sizes(face, 0, 20);
+    shapeCacheEnabled = 0;
+    mu_assert_int_eq(0, shapeText(text, strlen(text), &second));
+    shapeCacheEnabled = 1;
+    mu_check(sameShapedText(&first, &second));
+    freeShapedText(&first);
+    freeShapedText(&second);
+}
+
+// Con HarfBuzz, "fi" es la ligadura de 'liga' y la marca combinante comparte
+// el cluster de su base; sin él, un glifo por codepoint
+MU_TEST(test_ligature_and_mark_clusters) {
+    ShapedText shaped = {0};
+    mu_assert_int_eq(0, shapeText("fi", 2, &shaped));
+    if (textShaperHasHarfBuzz()) {
+        mu_assert_int_eq(1, shaped.count);
+        mu_assert_int_eq((int)FT_Get_Name_Index(face, "fi"), (int)shaped.glyphs[0].glyphIndex);
+        mu_assert_int_eq(0, (int)shaped.glyphs[0].cluster);
+        mu_assert_int_eq('f', (int)shaped.glyphs[0].codepoint);
+    } else {
+        mu_assert_int_eq(2, shaped.count);
+        mu_assert_int_eq(1, (int)shaped.glyphs[1].cluster);
+    }
+
+    const char* marked = "e\xCC\x81x"; // e + U+0301 (acento agudo combinante) + x
+    mu_assert_int_eq(0, shapeText(marked, strlen(marked), &shaped));
+    if (textShaperHasHarfBuzz()) {
+        mu_check(shaped.count == 2 || shaped.count == 3); // La fuente puede componer "é"
+        for (int i = 0; i + 1 < shaped.count; ++i) mu_assert_int_eq(0, (int)shaped.glyphs[i].cluster);
+        mu_assert_int_eq(3, (int)shaped.glyphs[shaped.count - 1].cluster);
+    } else {
+        mu_assert_int_eq(3, shaped.count);
+        mu_assert_int_eq(1, (int)shaped.glyphs[1].cluster);
+    }
+    freeShapedText(&shaped);
+}
+
+MU_TEST_SUITE(text_shaper_tests) {
+    MU_SUITE_CONFIGURE(&shaper_setup, &shaper_teardown);
+    MU_RUN_TEST(test_shape_glyphs_clusters_and_kerning);
+    MU_RUN_TEST(test_word_cache_hits_and_matches_uncached);
+    MU_RUN_TEST(test_shape_after_face_size_change);
+    MU_RUN_TEST(test_ligature_and_mark_clusters);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(text_shaper_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,133 @@
+#include "minunit.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Este test se compila siempre con -DTEXT3D_TRACE (ver Makefile).
+
+static void traced_leaf(void) {
+    TRACE_SCOPE("traced_leaf");
+}
+
+static void traced_parent(void) {
+    TRACE_SCOPE("traced_parent");
+    traced_leaf();
+    traced_leaf();
+}
+
+static void* traced_worker(void* arg) {
+    int iterations = *(int*)arg;
+    for (int i = 0; i < iterations; ++i) traced_leaf();
+    return NULL;
+}
+
+static char* read_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* buf = (char*)malloc((size_t)len + 1);
+    if (buf && fread(buf, 1, (size_t)len, f) != (size_t)len) { free(buf); buf = NULL; }
+    if (buf) buf[len] = '\0';
+    fclose(f);
+    return buf;
+}
+
+static int count_occurrences(const char* haystack, const char* needle) {
+    int n = 0;
+    for (const char* p = strstr(haystack, needle); p; p = strstr(p + 1, needle)) n++;
+    return n;
+}
+
+MU_TEST(test_idle_zones_record_nothing) {
+    traceStop();
+    traceReset();
+    traced_parent();
+    mu_check(traceEventCount() == 0);
+}
+
+MU_TEST(test_nested_zones_are_recorded) {
+    traceReset();
+    traceStart();
+    traced_parent();
+    traceStop();
+    mu_check(traceEventCount() == 3); // parent + 2 leaf
+}
+
+MU_TEST(test_each_thread_gets_its_own_buffer) {
+    traceReset();
+    traceStart();
+    int iterations = 100;
+    pthread_t threads[4];
+    for (int i = 0; i < 4; ++i) pthread_create(&threads[i], NULL, traced_worker, &iterations);
+    for (int i = 0; i < 4; ++i) pthread_join(threads[i], NULL);
+    traceStop();
+    mu_check(traceEventCount() == 400);
+}
+
+static void run_traced_workers(int count, int iterations) {
+    pthread_t threads[8];
+    for (int i = 0; i < count; ++i) pthread_create(&threads[i], NULL, traced_worker, &iterations);
+    for (int i = 0; i < count; ++i) pthread_join(threads[i], NULL);
+}
+
+MU_TEST(test_exited_threads_recycle_their_buffers) {
+    traceReset();
+    traceStart();
+    run_traced_workers(8, 10);
+    long afterFirst = traceBufferCount();
+    run_traced_workers(8, 10);
+    run_traced_workers(8, 10);
+    traceStop();
+    mu_check(traceBufferCount() == afterFirst); // Cada tanda reutiliza los anillos de la anterior
+    mu_check(afterFirst <= 8 + 1);               // Los hilos de la tanda + el principal
+    mu_check(traceEventCount() == 240);          // Los eventos de hilos terminados se conservan
+}
+
+MU_TEST(test_ring_keeps_latest_events_on_overflow) {
+    traceReset();
+    traceStart();
+    for (int i = 0; i < TRACE_RING_CAPACITY + 10; ++i) traced_leaf();
+    traceStop();
+    mu_check(traceEventCount() == TRACE_RING_CAPACITY);
+}
+
+MU_TEST(test_flush_writes_chrome_trace_json) {
+    traceReset();
+    traceStart();
+    traced_parent();
+    traceStop();
+
+    const char* path = "build/trace_test.json";
+    mu_assert_int_eq(0, traceFlush(path));
+    char* json = read_file(path);
+    mu_check(json != NULL);
+    if (!json) return;
+    mu_check(strncmp(json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 39) == 0);
+    mu_assert_int_eq(1, count_occurrences(json, "\"name\":\"traced_parent\""));
+    mu_assert_int_eq(2, count_occurrences(json, "\"name\":\"traced_leaf\""));
+    mu_assert_int_eq(3, count_occurrences(json, "\"ph\":\"X\""));
+    mu_check(strstr(json, "]}") != NULL);
+    free(json);
+    remove(path);
+}
+
+MU_TEST_SUITE(trace_suite) {
+    MU_RUN_TEST(test_idle_zones_record_nothing);
+    MU_RUN_TEST(test_nested_zones_are_recorded);
+    MU_RUN_TEST(test_each_thread_gets_its_own_buffer);
+    MU_RUN_TEST(test_exited_threads_recycle_their_buffers);
+    MU_RUN_TEST(test_ring_keeps_latest_events_on_overflow);
+    MU_RUN_TEST(test_flush_writes_chrome_trace_json);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(trace_suite);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}
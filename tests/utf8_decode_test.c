@@ -0,0 +1,179 @@
+#include "minunit.h"
+#include "utf8_decode.h"
+#include "utils.h" // utf8_to_codepoint, la referencia
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_BYTES 300
+
+static uint32_t fuzzState = 0x12345678u;
+
+static uint32_t fuzzNext(void) { // xorshift32: mismas entradas en cada ejecución
+    fuzzState ^= fuzzState << 13;
+    fuzzState ^= fuzzState >> 17;
+    fuzzState ^= fuzzState << 5;
+    return fuzzState;
+}
+
+// Texto aleatorio con tramos largos de ASCII y de 2, 3 y 4 bytes (para que
+// entren en la ruta vectorial) y bytes sueltos de cualquier valor: secuencias
+// cortadas, continuaciones huérfanas, 0xF8-0xFF, algún 0
+static size_t fuzzText(unsigned char* out, size_t maxBytes) {
+    size_t length = fuzzNext() % maxBytes;
+    size_t i = 0;
+    while (i < length) {
+        uint32_t r = fuzzNext();
+        size_t run = 1 + (r >> 8) % 24;
+        switch (r % 8) {
+            case 0: case 1: case 2: // ASCII
+                for (size_t k = 0; k < run && i < length; ++k) out[i++] = (unsigned char)(0x20 + fuzzNext() % 0x5F);
+                break;
+            case 3: // 2 bytes (latín, árabe...)
+                for (size_t k = 0; k < run && i + 2 <= length; ++k) {
+                    out[i++] = (unsigned char)(0xC2 + fuzzNext() % 30);
+                    out[i++] = (unsigned char)(0x80 + fuzzNext() % 64);
+                }
+                break;
+            case 4: // 3 bytes
+                for (size_t k = 0; k < run && i + 3 <= length; ++k) {
+                    out[i++] = (unsigned char)(0xE0 + fuzzNext() % 16);
+                    out[i++] = (unsigned char)(0x80 + fuzzNext() % 64);
+                    out[i++] = (unsigned char)(0x80 + fuzzNext() % 64);
+                }
+                break;
+            case 5: // 4 bytes
+                for (size_t k = 0; k < run && i + 4 <= length; ++k) {
+                    out[i++] = (unsigned char)(0xF0 + fuzzNext() % 8);
+                    for (int c = 0; c < 3; ++c) out[i++] = (unsigned char)(0x80 + fuzzNext() % 64);
+                }
+                break;
+            case 6: // Cualquier byte
+                out[i++] = (unsigned char)(fuzzNext() & 0xFF);
+                break;
+            default: // Solo de vez en cuando un 0, que corta el texto
+                out[i++] = (fuzzNext() % 16 == 0) ? 0 : (unsigned char)(0x80 + fuzzNext() % 128);
+                break;
+        }
+    }
+    out[i] = 0;
+    return i;
+}
+
+// Compara con el bucle de utf8_to_codepoint; devuelve 1 si coinciden
+static int decodeMatchesReference(const unsigned char* text, size_t length) {
+    static uint32_t codepoints[FUZZ_MAX_BYTES + 1], offsets[FUZZ_MAX_BYTES + 1];
+    size_t used;
+    size_t count = utf8DecodeBuffer((const char*)text, length, codepoints, offsets, &used);
+    const char* s = (const char*)text;
+    size_t n = 0;
+    FT_ULong cp;
+    const char* start = s;
+    while ((cp = utf8_to_codepoint(&s)) != 0) {
+        if (n >= count || codepoints[n] != cp || offsets[n] != (uint32_t)(start - (const char*)text)) return 0;
+        n++;
+        start = s;
+    }
+    return n == count && used == (size_t)(start - (const char*)text);
+}
+
+MU_TEST(test_known_sequences) {
+    const char* text = "A\xC3\xB1\xE2\x82\xAC\xF0\x9D\x84\x9E" "b"; // A ñ € 𝄞 b
+    uint32_t codepoints[16], offsets[16];
+    mu_assert_int_eq(5, (int)utf8DecodeBuffer(text, strlen(text), codepoints, offsets, NULL));
+    const uint32_t expected[] = { 'A', 0xF1, 0x20AC, 0x1D11E, 'b' };
+    const uint32_t expectedOffsets[] = { 0, 1, 3, 6, 10 };
+    for (int i = 0; i < 5; ++i) {
+        mu_assert_int_eq((int)expected[i], (int)codepoints[i]);
+        mu_assert_int_eq((int)expectedOffsets[i], (int)offsets[i]);
+    }
+    // Cortada por length: U+FFFD y un byte, como con un 0 detrás
+    mu_assert_int_eq(2, (int)utf8DecodeBuffer("\xE2\x82\xAC", 2, codepoints, NULL, NULL));
+    mu_assert_int_eq(0xFFFD, (int)codepoints[0]);
+    mu_assert_int_eq(0xFFFD, (int)codepoints[1]);
+    mu_assert_int_eq(1, (int)utf8DecodeBuffer("x\0yz", 4, codepoints, NULL, NULL)); // Para en el 0
+    size_t used = 0;
+    mu_assert_int_eq(2, (int)utf8DecodeBuffer("ab\xC0\x80" "cd", 6, codepoints, NULL, &used)); // Y en U+0000 sobrelargo
+    mu_assert_int_eq(2, (int)used);
+    mu_assert_int_eq(0, (int)utf8DecodeBuffer(NULL, 4, codepoints, NULL, NULL));
+}
+
+// Textos largos de un solo tipo (ASCII, 2, 3 y 4 bytes) y con un error en
+// cada posición de un bloque: recorren todos los caminos de la ruta SSE2
+MU_TEST(test_simd_paths_match_reference) {
+    static unsigned char text[FUZZ_MAX_BYTES + 1];
+    static const char* patterns[] = { "The quick brown fox. ", "\xD8\xB3\xD9\x84\xD8\xA7\xD9\x85 ",
+                                      "\xE2\x82\xAC\xE2\x80\x94x", "\xF0\x9F\x98\x80 a" };
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); ++p) {
+        size_t patternLength = strlen(patterns[p]), length = 0;
+        while (length + patternLength < 200) {
+            memcpy(text + length, patterns[p], patternLength);
+            length += patternLength;
+        }
+        text[length] = 0;
+        mu_check(decodeMatchesReference(text, length));
+        for (size_t bad = 0; bad < 40; ++bad) {
+            static const unsigned char corrupt[] = { 0x80, 0xC3, 0xE2, 0xF0, 0xFF, 'a' };
+            unsigned char saved = text[bad];
+            for (size_t c = 0; c < sizeof(corrupt); ++c) {
+                text[bad] = corrupt[c];
+                mu_check(decodeMatchesReference(text, length));
+            }
+            text[bad] = saved;
+        }
+        // U+0000 sobrelargo en medio de un bloque: acaba el texto, como un 0
+        memcpy(text + 21, "\xE0\x80\x80", 3);
+        mu_check(decodeMatchesReference(text, length));
+    }
+}
+
+// Paridad con utf8_to_codepoint en entradas aleatorias, con y sin SIMD
+MU_TEST(test_fuzz_parity_with_utf8_to_codepoint) {
+    static unsigned char text[FUZZ_MAX_BYTES + 1];
+    int mismatches = 0;
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        size_t length = fuzzText(text, FUZZ_MAX_BYTES);
+        utf8SimdEnabled = 1;
+        mismatches += !decodeMatchesReference(text, length);
+        utf8SimdEnabled = 0;
+        mismatches += !decodeMatchesReference(text, length);
+    }
+    utf8SimdEnabled = 1;
+    mu_assert_int_eq(0, mismatches);
+}
+
+// Decodificar por trozos de utf8ChunkLength da lo mismo que de una vez
+MU_TEST(test_chunked_decode_matches_whole) {
+    static unsigned char text[FUZZ_MAX_BYTES + 1];
+    static uint32_t whole[FUZZ_MAX_BYTES], chunked[FUZZ_MAX_BYTES];
+    int mismatches = 0;
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        fuzzText(text, FUZZ_MAX_BYTES);
+        size_t length = strlen((const char*)text); // Sin ceros: cada trozo sigue tras el anterior
+        size_t count = utf8DecodeBuffer((const char*)text, length, whole, NULL, NULL);
+        size_t chunkedCount = 0;
+        size_t chunkBytes = 4 + fuzzNext() % 40;
+        for (size_t start = 0; start < length;) {
+            size_t chunk = utf8ChunkLength((const char*)text + start, length - start, chunkBytes);
+            chunkedCount += utf8DecodeBuffer((const char*)text + start, chunk, chunked + chunkedCount, NULL, NULL);
+            start += chunk;
+        }
+        mismatches += chunkedCount != count || memcmp(whole, chunked, count * sizeof(uint32_t)) != 0;
+    }
+    mu_assert_int_eq(0, mismatches);
+}
+
+MU_TEST_SUITE(utf8_decode_tests) {
+    MU_RUN_TEST(test_known_sequences);
+    MU_RUN_TEST(test_simd_paths_match_reference);
+    MU_RUN_TEST(test_fuzz_parity_with_utf8_to_codepoint);
+    MU_RUN_TEST(test_chunked_decode_matches_whole);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    MU_RUN_SUITE(utf8_decode_tests);
+    MU_REPORT();
+    return MU_EXIT_CODE;
+}